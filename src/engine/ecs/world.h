@@ -26,3 +26,9 @@ void WorldClear(world_t *world);
 static inline archetype_t *WorldGetArchetype(world_t *world, uint32_t id) {
   return &world->archetypes[id];
 }
+
+// Archetype currently holding a live entity (caller checks liveness).
+static inline archetype_t *WorldGetEntityArchetype(world_t *world,
+                                                   entity_t entity) {
+  return &world->archetypes[world->entityLocations[entity.id].archetype];
+}
@@ -24,6 +24,8 @@ typedef struct {
 
   uint32_t layerMask;   // collision layers (optional but useful)
   uint32_t collideMask; // what this can collide with
+
+  bool isStatic; // bounds computed once at spawn; skipped by per-tick refresh
 } CollisionInstance;
 
 static inline bool AABB_Overlap(BoundingBox a, BoundingBox b) {
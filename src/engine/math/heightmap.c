@@ -1,11 +1,44 @@
+#define _POSIX_C_SOURCE 200809L
 #include "heightmap.h"
+#include "heightmap_internal.h"
+#include "../util/profiler.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+static void freePyramid(HeightMap *hm) {
+  for (uint32_t l = 0; l < hm->levelCount; l++) {
+    free(hm->levels[l].minH);
+    free(hm->levels[l].maxH);
+    hm->levels[l] = (HeightMapLevel){0};
+  }
+  hm->levelCount = 0;
+}
 
 void HeightMap_Free(HeightMap *hm) {
   if (!hm)
     return;
 
-  free(hm->samples);
+  freePyramid(hm);
+#if !defined(_WIN32)
+  if (hm->mapping)
+    munmap(hm->mapping, hm->mappingSize);
+  else
+#endif
+    free(hm->samples);
   hm->samples = NULL;
+  hm->mapping = NULL;
+  hm->mappingSize = 0;
 
   hm->width = 0;
   hm->height = 0;
@@ -13,23 +46,84 @@ void HeightMap_Free(HeightMap *hm) {
   hm->origin = (Vector3){0};
 }
 
-HeightMap HeightMap_FromMesh(Mesh mesh, Matrix transform) {
-  HeightMap hm = {0};
+// Grid spacing for rasterized terrain; part of the cache key.
+#define HM_CELL_SIZE 0.25f
+
+// Rows per rasterization band; bands are filled in parallel and never
+// share a row, so no two threads write the same sample.
+#define HM_BAND_ROWS 32
+
+// Grid-space bounds of one triangle; ix0 > ix1 marks a degenerate one.
+typedef struct {
+  int ix0, ix1, iz0, iz1;
+} TriSpan;
+
+void HeightMap_RasterizeTriangle(float *samples, uint32_t stride,
+                                 Vector3 origin, float cellSize, Vector3 v0,
+                                 Vector3 v1, Vector3 v2, int x0, int x1,
+                                 int z0, int z1) {
+  Vector2 a = {v0.x, v0.z};
+  Vector2 b = {v1.x, v1.z};
+  Vector2 c = {v2.x, v2.z};
+
+  float denom = (b.y - c.y) * (a.x - c.x) + (c.x - b.x) * (a.y - c.y);
+  if (fabsf(denom) < 1e-6f)
+    return;
+
+  for (int z = z0; z <= z1; z++) {
+    for (int x = x0; x <= x1; x++) {
+      float wx = origin.x + x * cellSize;
+      float wz = origin.z + z * cellSize;
+
+      Vector2 p = {wx, wz};
 
-  // ---- 1. Transform vertices ----
-  Vector3 *verts = (Vector3 *)mesh.vertices;
-  unsigned short *indices = (unsigned short *)mesh.indices;
+      float u = ((b.y - c.y) * (p.x - c.x) + (c.x - b.x) * (p.y - c.y)) / denom;
+      float v = ((c.y - a.y) * (p.x - c.x) + (a.x - c.x) * (p.y - c.y)) / denom;
+      float w = 1.0f - u - v;
+
+      if (u < 0 || v < 0 || w < 0)
+        continue;
+
+      float h = u * v0.y + v * v1.y + w * v2.y;
+
+      float *cell = &samples[z * stride + x];
+      if (h > *cell)
+        *cell = h;
+    }
+  }
+}
+
+HeightMapMeshData HeightMap_MeshData(Mesh mesh) {
+  return (HeightMapMeshData){
+      .vertices = mesh.vertices,
+      .vertexCount = mesh.vertexCount,
+      .indices16 = mesh.indices,
+      .indices32 = NULL,
+      .triangleCount = mesh.triangleCount,
+  };
+}
+
+HeightMap HeightMap_FromMesh(Mesh mesh, Matrix transform) {
+  PROF_BEGIN("HeightMap_FromMesh");
+  HeightMapMeshData data = HeightMap_MeshData(mesh);
+  HeightMap hm = HeightMap_FromMeshData(&data, transform);
+  PROF_END();
+  return hm;
+}
 
-  int vertexCount = mesh.vertexCount;
-  int triCount = mesh.triangleCount;
+Vector3 *HeightMap_TransformVertices(const HeightMapMeshData *data,
+                                     Matrix transform, Vector3 *outMin,
+                                     Vector3 *outMax) {
+  const Vector3 *verts = (const Vector3 *)data->vertices;
+  int vertexCount = data->vertexCount;
 
   Vector3 *tverts = malloc(sizeof(Vector3) * vertexCount);
 
+#pragma omp parallel for
   for (int i = 0; i < vertexCount; i++) {
     tverts[i] = Vector3Transform(verts[i], transform);
   }
 
-  // ---- 2. Compute bounds in XZ ----
   Vector3 min = tverts[0];
   Vector3 max = tverts[0];
 
@@ -43,84 +137,277 @@ HeightMap HeightMap_FromMesh(Mesh mesh, Matrix transform) {
     max.z = fmaxf(max.z, tverts[i].z);
   }
 
+  *outMin = min;
+  *outMax = max;
+  return tverts;
+}
+
+HeightMap HeightMap_FromMeshData(const HeightMapMeshData *data,
+                                 Matrix transform) {
+  HeightMap hm = {0};
+  int triCount = data->triangleCount;
+
+  // ---- 1-2. Transform vertices, compute bounds in XZ ----
+  Vector3 min, max;
+  Vector3 *tverts = HeightMap_TransformVertices(data, transform, &min, &max);
+
   // ---- 3. Grid resolution ----
 
-  hm.cellSize = 0.25f; // you can tweak this later
+  hm.cellSize = HM_CELL_SIZE;
   hm.origin = (Vector3){min.x, 0.0f, min.z};
 
   hm.width = (uint32_t)ceilf((max.x - min.x) / hm.cellSize) + 1;
   hm.height = (uint32_t)ceilf((max.z - min.z) / hm.cellSize) + 1;
 
-  hm.samples = malloc(sizeof(float) * hm.width * hm.height);
+  uint32_t sampleCount = hm.width * hm.height;
+  hm.samples = malloc(sizeof(float) * sampleCount);
 
   // Clear heightmap
-  for (uint32_t i = 0; i < hm.width * hm.height; i++) {
+#pragma omp parallel for
+  for (uint32_t i = 0; i < sampleCount; i++) {
     hm.samples[i] = -FLT_MAX;
   }
 
-  // ---- 4. Rasterize triangles ----
+  // ---- 4. Triangle spans ----
+  TriSpan *spans = malloc(sizeof(TriSpan) * (triCount > 0 ? triCount : 1));
+
+#pragma omp parallel for
   for (int t = 0; t < triCount; t++) {
-    int i0 = indices[t * 3 + 0];
-    int i1 = indices[t * 3 + 1];
-    int i2 = indices[t * 3 + 2];
+    Vector3 v0 = tverts[HeightMap_MeshIndex(data, t * 3 + 0)];
+    Vector3 v1 = tverts[HeightMap_MeshIndex(data, t * 3 + 1)];
+    Vector3 v2 = tverts[HeightMap_MeshIndex(data, t * 3 + 2)];
 
-    Vector3 v0 = tverts[i0];
-    Vector3 v1 = tverts[i1];
-    Vector3 v2 = tverts[i2];
+    float denom = (v1.z - v2.z) * (v0.x - v2.x) + (v2.x - v1.x) * (v0.z - v2.z);
+    if (fabsf(denom) < 1e-6f) {
+      spans[t] = (TriSpan){1, 0, 1, 0};
+      continue;
+    }
 
     float minTx = fminf(v0.x, fminf(v1.x, v2.x));
     float maxTx = fmaxf(v0.x, fmaxf(v1.x, v2.x));
     float minTz = fminf(v0.z, fminf(v1.z, v2.z));
     float maxTz = fmaxf(v0.z, fmaxf(v1.z, v2.z));
 
-    int ix0 = (int)((minTx - hm.origin.x) / hm.cellSize);
-    int ix1 = (int)((maxTx - hm.origin.x) / hm.cellSize);
-    int iz0 = (int)((minTz - hm.origin.z) / hm.cellSize);
-    int iz1 = (int)((maxTz - hm.origin.z) / hm.cellSize);
-
-    ix0 = Clamp(ix0, 0, hm.width - 1);
-    ix1 = Clamp(ix1, 0, hm.width - 1);
-    iz0 = Clamp(iz0, 0, hm.height - 1);
-    iz1 = Clamp(iz1, 0, hm.height - 1);
-
-    Vector2 a = {v0.x, v0.z};
-    Vector2 b = {v1.x, v1.z};
-    Vector2 c = {v2.x, v2.z};
-
-    float denom = (b.y - c.y) * (a.x - c.x) + (c.x - b.x) * (a.y - c.y);
+    spans[t] = (TriSpan){
+        Clamp((int)((minTx - hm.origin.x) / hm.cellSize), 0, hm.width - 1),
+        Clamp((int)((maxTx - hm.origin.x) / hm.cellSize), 0, hm.width - 1),
+        Clamp((int)((minTz - hm.origin.z) / hm.cellSize), 0, hm.height - 1),
+        Clamp((int)((maxTz - hm.origin.z) / hm.cellSize), 0, hm.height - 1),
+    };
+  }
 
-    if (fabsf(denom) < 1e-6f)
-      continue;
+  // ---- 5. Rasterize triangles, one row band per thread ----
+  int bandCount = (int)((hm.height + HM_BAND_ROWS - 1) / HM_BAND_ROWS);
+
+#pragma omp parallel for schedule(dynamic)
+  for (int band = 0; band < bandCount; band++) {
+    int zLo = band * HM_BAND_ROWS;
+    int zHi = zLo + HM_BAND_ROWS - 1;
+
+    for (int t = 0; t < triCount; t++) {
+      const TriSpan *span = &spans[t];
+      if (span->ix0 > span->ix1 || span->iz1 < zLo || span->iz0 > zHi)
+        continue;
+
+      HeightMap_RasterizeTriangle(
+          hm.samples, hm.width, hm.origin, hm.cellSize,
+          tverts[HeightMap_MeshIndex(data, t * 3 + 0)],
+          tverts[HeightMap_MeshIndex(data, t * 3 + 1)],
+          tverts[HeightMap_MeshIndex(data, t * 3 + 2)], span->ix0, span->ix1,
+          span->iz0 > zLo ? span->iz0 : zLo, span->iz1 < zHi ? span->iz1 : zHi);
+    }
+  }
 
-    for (int z = iz0; z <= iz1; z++) {
-      for (int x = ix0; x <= ix1; x++) {
-        float wx = hm.origin.x + x * hm.cellSize;
-        float wz = hm.origin.z + z * hm.cellSize;
+  free(spans);
+  free(tverts);
+  HeightMap_BuildPyramid(&hm);
+  return hm;
+}
 
-        Vector2 p = {wx, wz};
+/* ------------------------------------------------------------------ */
+/* On-disk cache                                                       */
+/* ------------------------------------------------------------------ */
+
+#define HM_CACHE_MAGIC 0x50414d48u // "HMAP"
+#define HM_CACHE_VERSION 1u
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t key; // hashMesh() of the source mesh
+  uint32_t width;
+  uint32_t height;
+  float cellSize;
+  float origin[3];
+} HeightMapCacheHeader; // followed by width * height floats
+
+// 64-bit FNV-1a.
+static uint64_t hashBytes(uint64_t h, const void *data, size_t size) {
+  const unsigned char *p = data;
+  for (size_t i = 0; i < size; i++) {
+    h ^= p[i];
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
 
-        float u =
-            ((b.y - c.y) * (p.x - c.x) + (c.x - b.x) * (p.y - c.y)) / denom;
-        float v =
-            ((c.y - a.y) * (p.x - c.x) + (a.x - c.x) * (p.y - c.y)) / denom;
-        float w = 1.0f - u - v;
+static uint64_t hashMesh(const HeightMapMeshData *data, Matrix transform) {
+  uint64_t h = 0xcbf29ce484222325ull;
+  uint32_t version = HM_CACHE_VERSION;
+  float cellSize = HM_CELL_SIZE;
+  h = hashBytes(h, &version, sizeof(version));
+  h = hashBytes(h, &cellSize, sizeof(cellSize));
+  h = hashBytes(h, &transform, sizeof(transform));
+  h = hashBytes(h, &data->vertexCount, sizeof(data->vertexCount));
+  h = hashBytes(h, &data->triangleCount, sizeof(data->triangleCount));
+  h = hashBytes(h, data->vertices, sizeof(float) * 3 * data->vertexCount);
+  if (data->indices32)
+    h = hashBytes(h, data->indices32,
+                  sizeof(uint32_t) * 3 * data->triangleCount);
+  else if (data->indices16)
+    h = hashBytes(h, data->indices16,
+                  sizeof(unsigned short) * 3 * data->triangleCount);
+  return h;
+}
 
-        if (u < 0 || v < 0 || w < 0)
-          continue;
+// key NULL accepts a cache built from any mesh.
+static bool headerMatches(const HeightMapCacheHeader *hdr, const uint64_t *key,
+                          size_t fileSize) {
+  return hdr->magic == HM_CACHE_MAGIC && hdr->version == HM_CACHE_VERSION &&
+         (!key || hdr->key == *key) &&
+         fileSize == sizeof(*hdr) + sizeof(float) * (size_t)hdr->width *
+                                        hdr->height;
+}
 
-        float h = u * v0.y + v * v1.y + w * v2.y;
+static void applyHeader(HeightMap *hm, const HeightMapCacheHeader *hdr) {
+  hm->width = hdr->width;
+  hm->height = hdr->height;
+  hm->cellSize = hdr->cellSize;
+  hm->origin = (Vector3){hdr->origin[0], hdr->origin[1], hdr->origin[2]};
+}
 
-        float *cell = &hm.samples[z * hm.width + x];
-        if (h > *cell)
-          *cell = h;
+#if defined(_WIN32)
+static bool loadCache(const char *path, const uint64_t *key, HeightMap *out) {
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return false;
+
+  HeightMapCacheHeader hdr;
+  bool ok = false;
+  if (fread(&hdr, sizeof(hdr), 1, f) == 1 && fseek(f, 0, SEEK_END) == 0) {
+    long size = ftell(f);
+    if (size > 0 && headerMatches(&hdr, key, (size_t)size)) {
+      size_t n = (size_t)hdr.width * hdr.height;
+      float *samples = malloc(sizeof(float) * n);
+      fseek(f, (long)sizeof(hdr), SEEK_SET);
+      if (samples && fread(samples, sizeof(float), n, f) == n) {
+        applyHeader(out, &hdr);
+        out->samples = samples;
+        ok = true;
+      } else {
+        free(samples);
       }
     }
   }
+  fclose(f);
+  return ok;
+}
+#else
+static bool loadCache(const char *path, const uint64_t *key, HeightMap *out) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(HeightMapCacheHeader)) {
+    close(fd);
+    return false;
+  }
 
-  free(tverts);
+  size_t size = (size_t)st.st_size;
+  void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+    return false;
+
+  const HeightMapCacheHeader *hdr = map;
+  if (!headerMatches(hdr, key, size)) {
+    munmap(map, size);
+    return false;
+  }
+
+  applyHeader(out, hdr);
+  out->samples = (float *)((char *)map + sizeof(*hdr));
+  out->mapping = map;
+  out->mappingSize = size;
+  return true;
+}
+#endif
+
+// Writes to a temporary file and renames it so a crash mid-write never
+// leaves a truncated cache behind.
+static void saveCache(const char *path, uint64_t key, const HeightMap *hm) {
+  char tmp[512];
+  if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp))
+    return;
+
+  FILE *f = fopen(tmp, "wb");
+  if (!f)
+    return;
+
+  HeightMapCacheHeader hdr = {
+      HM_CACHE_MAGIC,
+      HM_CACHE_VERSION,
+      key,
+      hm->width,
+      hm->height,
+      hm->cellSize,
+      {hm->origin.x, hm->origin.y, hm->origin.z},
+  };
+  size_t n = (size_t)hm->width * hm->height;
+  bool ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+            fwrite(hm->samples, sizeof(float), n, f) == n;
+  ok = (fclose(f) == 0) && ok;
+
+  if (!ok || rename(tmp, path) != 0)
+    remove(tmp);
+}
+
+HeightMap HeightMap_FromMeshCached(Mesh mesh, Matrix transform,
+                                   const char *cachePath) {
+  HeightMapMeshData data = HeightMap_MeshData(mesh);
+  return HeightMap_FromMeshDataCached(&data, transform, cachePath);
+}
+
+HeightMap HeightMap_FromMeshDataCached(const HeightMapMeshData *data,
+                                       Matrix transform,
+                                       const char *cachePath) {
+  if (!cachePath)
+    return HeightMap_FromMeshData(data, transform);
+
+  PROF_BEGIN("HeightMap_FromMeshCached");
+  uint64_t key = hashMesh(data, transform);
+
+  HeightMap hm = {0};
+  if (loadCache(cachePath, &key, &hm)) {
+    HeightMap_BuildPyramid(&hm);
+  } else {
+    PROF_ZONE("HeightMap_FromMesh", hm = HeightMap_FromMeshData(data, transform));
+    saveCache(cachePath, key, &hm);
+  }
+  PROF_END();
   return hm;
 }
 
+bool HeightMap_LoadCache(const char *cachePath, HeightMap *out) {
+  HeightMap hm = {0};
+  if (!loadCache(cachePath, NULL, &hm))
+    return false;
+  HeightMap_BuildPyramid(&hm);
+  *out = hm;
+  return true;
+}
+
 float HeightMap_GetHeightSmooth(const HeightMap *hm, float x, float z) {
   float fx = (x - hm->origin.x) / hm->cellSize;
   float fz = (z - hm->origin.z) / hm->cellSize;
@@ -154,6 +441,10 @@ static float catmullRomInterpolate(float p0, float p1, float p2, float p3,
           (-p0 + 3 * p1 - 3 * p2 + p3) * t * t * t);
 }
 
+float HeightMap_CatmullRom(float p0, float p1, float p2, float p3, float t) {
+  return catmullRomInterpolate(p0, p1, p2, p3, t);
+}
+
 float HeightMap_GetHeightCatmullRom(const HeightMap *hm, float x, float z) {
   float fx = (x - hm->origin.x) / hm->cellSize;
   float fz = (z - hm->origin.z) / hm->cellSize;
@@ -181,3 +472,493 @@ float HeightMap_GetHeightCatmullRom(const HeightMap *hm, float x, float z) {
 
   return catmullRomInterpolate(col[0], col[1], col[2], col[3], tz);
 }
+
+/* ------------------------------------------------------------------ */
+/* Batched sampling                                                    */
+/* ------------------------------------------------------------------ */
+
+// Derivative of catmullRomInterpolate with respect to t.
+static float catmullRomDerivative(float p0, float p1, float p2, float p3,
+                                  float t) {
+  return 0.5f * ((-p0 + p2) + 2 * (2 * p0 - 5 * p1 + 4 * p2 - p3) * t +
+                 3 * (-p0 + 3 * p1 - 3 * p2 + p3) * t * t);
+}
+
+// Scalar reference for one sample. dhdx/dhdz are world-space slopes and may
+// be NULL. Near the border it mirrors GetHeightCatmullRom's bilinear fallback
+// and takes the gradient by central differences.
+static void sampleOne(const HeightMap *hm, float x, float z, float *h,
+                      float *dhdx, float *dhdz) {
+  float fx = (x - hm->origin.x) / hm->cellSize;
+  float fz = (z - hm->origin.z) / hm->cellSize;
+
+  int ix = (int)floorf(fx);
+  int iz = (int)floorf(fz);
+
+  if (ix < 1 || iz < 1 || ix >= (int)hm->width - 2 ||
+      iz >= (int)hm->height - 2) {
+    *h = HeightMap_GetHeightSmooth(hm, x, z);
+    if (dhdx) {
+      float e = hm->cellSize * 0.5f;
+      *dhdx = (HeightMap_GetHeightSmooth(hm, x + e, z) -
+               HeightMap_GetHeightSmooth(hm, x - e, z)) / (2.0f * e);
+      *dhdz = (HeightMap_GetHeightSmooth(hm, x, z + e) -
+               HeightMap_GetHeightSmooth(hm, x, z - e)) / (2.0f * e);
+    }
+    return;
+  }
+
+  float tx = fx - ix;
+  float tz = fz - iz;
+
+  float col[4], dcol[4];
+  for (int j = 0; j < 4; j++) {
+    const float *row = &hm->samples[(iz - 1 + j) * hm->width + (ix - 1)];
+    col[j] = catmullRomInterpolate(row[0], row[1], row[2], row[3], tx);
+    if (dhdx)
+      dcol[j] = catmullRomDerivative(row[0], row[1], row[2], row[3], tx);
+  }
+
+  *h = catmullRomInterpolate(col[0], col[1], col[2], col[3], tz);
+  if (dhdx) {
+    *dhdx = catmullRomInterpolate(dcol[0], dcol[1], dcol[2], dcol[3], tz) /
+            hm->cellSize;
+    *dhdz = catmullRomDerivative(col[0], col[1], col[2], col[3], tz) /
+            hm->cellSize;
+  }
+}
+
+#if defined(__AVX2__)
+#define HM_LANES 8
+typedef __m256 hmVecF;
+typedef __m256i hmVecI;
+#define HM_SET1(v) _mm256_set1_ps(v)
+#define HM_LOADU(p) _mm256_loadu_ps(p)
+#define HM_STOREU(p, v) _mm256_storeu_ps(p, v)
+#define HM_ADD(a, b) _mm256_add_ps(a, b)
+#define HM_SUB(a, b) _mm256_sub_ps(a, b)
+#define HM_MUL(a, b) _mm256_mul_ps(a, b)
+#define HM_DIV(a, b) _mm256_div_ps(a, b)
+#define HM_FLOOR(a) _mm256_floor_ps(a)
+#define HM_TOINT(a) _mm256_cvttps_epi32(a)
+#define HM_TOFLOAT(a) _mm256_cvtepi32_ps(a)
+#define HM_SET1I(v) _mm256_set1_epi32(v)
+#define HM_ADDI(a, b) _mm256_add_epi32(a, b)
+#define HM_MULLOI(a, b) _mm256_mullo_epi32(a, b)
+#define HM_GATHER(base, idx) _mm256_i32gather_ps(base, idx, 4)
+
+// True when every lane satisfies 1 <= i < hi.
+static inline bool hmAllInterior(hmVecI i, int hi) {
+  __m256i lo = _mm256_cmpgt_epi32(HM_SET1I(1), i);
+  __m256i up = _mm256_cmpgt_epi32(i, HM_SET1I(hi - 1));
+  return _mm256_testz_si256(_mm256_or_si256(lo, up), _mm256_or_si256(lo, up));
+}
+#elif defined(__SSE2__)
+#define HM_LANES 4
+typedef __m128 hmVecF;
+typedef __m128i hmVecI;
+#define HM_SET1(v) _mm_set1_ps(v)
+#define HM_LOADU(p) _mm_loadu_ps(p)
+#define HM_STOREU(p, v) _mm_storeu_ps(p, v)
+#define HM_ADD(a, b) _mm_add_ps(a, b)
+#define HM_SUB(a, b) _mm_sub_ps(a, b)
+#define HM_MUL(a, b) _mm_mul_ps(a, b)
+#define HM_DIV(a, b) _mm_div_ps(a, b)
+#define HM_TOINT(a) _mm_cvttps_epi32(a)
+#define HM_TOFLOAT(a) _mm_cvtepi32_ps(a)
+#define HM_SET1I(v) _mm_set1_epi32(v)
+#define HM_ADDI(a, b) _mm_add_epi32(a, b)
+
+// SSE2 has no floor or 32-bit mullo; emulate both.
+static inline __m128 HM_FLOOR(__m128 a) {
+  __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+  return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+}
+
+static inline __m128i HM_MULLOI(__m128i a, __m128i b) {
+  __m128i even = _mm_mul_epu32(a, b);
+  __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// No hardware gather before AVX2: four scalar loads.
+static inline __m128 HM_GATHER(const float *base, __m128i idx) {
+  int32_t k[4];
+  _mm_storeu_si128((__m128i *)k, idx);
+  return _mm_setr_ps(base[k[0]], base[k[1]], base[k[2]], base[k[3]]);
+}
+
+static inline bool hmAllInterior(hmVecI i, int hi) {
+  __m128i lo = _mm_cmplt_epi32(i, HM_SET1I(1));
+  __m128i up = _mm_cmpgt_epi32(i, HM_SET1I(hi - 1));
+  return _mm_movemask_epi8(_mm_or_si128(lo, up)) == 0;
+}
+#endif
+
+#ifdef HM_LANES
+static inline hmVecF hmCatmullRom(hmVecF p0, hmVecF p1, hmVecF p2, hmVecF p3,
+                                  hmVecF t) {
+  hmVecF a = HM_MUL(HM_SET1(2.0f), p1);
+  hmVecF b = HM_ADD(HM_SUB(HM_SET1(0.0f), p0), p2);
+  hmVecF c = HM_SUB(HM_ADD(HM_SUB(HM_MUL(HM_SET1(2.0f), p0),
+                                  HM_MUL(HM_SET1(5.0f), p1)),
+                           HM_MUL(HM_SET1(4.0f), p2)),
+                    p3);
+  hmVecF d = HM_ADD(HM_SUB(HM_ADD(HM_SUB(HM_SET1(0.0f), p0),
+                                  HM_MUL(HM_SET1(3.0f), p1)),
+                           HM_MUL(HM_SET1(3.0f), p2)),
+                    p3);
+  // Same evaluation order as the scalar path so results match bit for bit.
+  hmVecF r = HM_ADD(HM_ADD(HM_ADD(a, HM_MUL(b, t)), HM_MUL(HM_MUL(c, t), t)),
+                    HM_MUL(HM_MUL(HM_MUL(d, t), t), t));
+  return HM_MUL(HM_SET1(0.5f), r);
+}
+
+static inline hmVecF hmCatmullRomDerivative(hmVecF p0, hmVecF p1, hmVecF p2,
+                                            hmVecF p3, hmVecF t) {
+  hmVecF b = HM_ADD(HM_SUB(HM_SET1(0.0f), p0), p2);
+  hmVecF c = HM_SUB(HM_ADD(HM_SUB(HM_MUL(HM_SET1(2.0f), p0),
+                                  HM_MUL(HM_SET1(5.0f), p1)),
+                           HM_MUL(HM_SET1(4.0f), p2)),
+                    p3);
+  hmVecF d = HM_ADD(HM_SUB(HM_ADD(HM_SUB(HM_SET1(0.0f), p0),
+                                  HM_MUL(HM_SET1(3.0f), p1)),
+                           HM_MUL(HM_SET1(3.0f), p2)),
+                    p3);
+  hmVecF r = HM_ADD(HM_ADD(b, HM_MUL(HM_MUL(HM_SET1(2.0f), c), t)),
+                    HM_MUL(HM_MUL(HM_MUL(HM_SET1(3.0f), d), t), t));
+  return HM_MUL(HM_SET1(0.5f), r);
+}
+
+// Samples HM_LANES points starting at x/z. Returns false without writing
+// anything if any lane needs the border fallback.
+static bool sampleLanes(const HeightMap *hm, const float *x, const float *z,
+                        float *h, float *dhdx, float *dhdz) {
+  hmVecF cs = HM_SET1(hm->cellSize);
+  hmVecF fx = HM_DIV(HM_SUB(HM_LOADU(x), HM_SET1(hm->origin.x)), cs);
+  hmVecF fz = HM_DIV(HM_SUB(HM_LOADU(z), HM_SET1(hm->origin.z)), cs);
+  hmVecF flx = HM_FLOOR(fx);
+  hmVecF flz = HM_FLOOR(fz);
+  hmVecI ix = HM_TOINT(flx);
+  hmVecI iz = HM_TOINT(flz);
+
+  if (!hmAllInterior(ix, (int)hm->width - 2) ||
+      !hmAllInterior(iz, (int)hm->height - 2))
+    return false;
+
+  hmVecF tx = HM_SUB(fx, flx);
+  hmVecF tz = HM_SUB(fz, flz);
+
+  // Index of the patch's top-left sample, (ix - 1, iz - 1).
+  hmVecI w = HM_SET1I((int)hm->width);
+  hmVecI base = HM_ADDI(HM_MULLOI(HM_ADDI(iz, HM_SET1I(-1)), w),
+                        HM_ADDI(ix, HM_SET1I(-1)));
+
+  hmVecF col[4], dcol[4];
+  for (int j = 0; j < 4; j++) {
+    hmVecI r = HM_ADDI(base, HM_MULLOI(HM_SET1I(j), w));
+    hmVecF p0 = HM_GATHER(hm->samples, r);
+    hmVecF p1 = HM_GATHER(hm->samples, HM_ADDI(r, HM_SET1I(1)));
+    hmVecF p2 = HM_GATHER(hm->samples, HM_ADDI(r, HM_SET1I(2)));
+    hmVecF p3 = HM_GATHER(hm->samples, HM_ADDI(r, HM_SET1I(3)));
+    col[j] = hmCatmullRom(p0, p1, p2, p3, tx);
+    if (dhdx)
+      dcol[j] = hmCatmullRomDerivative(p0, p1, p2, p3, tx);
+  }
+
+  HM_STOREU(h, hmCatmullRom(col[0], col[1], col[2], col[3], tz));
+  if (dhdx) {
+    HM_STOREU(dhdx,
+              HM_DIV(hmCatmullRom(dcol[0], dcol[1], dcol[2], dcol[3], tz), cs));
+    HM_STOREU(dhdz, HM_DIV(hmCatmullRomDerivative(col[0], col[1], col[2],
+                                                  col[3], tz),
+                           cs));
+  }
+  return true;
+}
+#endif
+
+void HeightMap_SampleBatch(const HeightMap *hm, const float *x, const float *z,
+                           float *out, int n) {
+  HeightMap_SampleBatchGradient(hm, x, z, out, NULL, NULL, n);
+}
+
+void HeightMap_SampleBatchGradient(const HeightMap *hm, const float *x,
+                                   const float *z, float *out, float *dhdx,
+                                   float *dhdz, int n) {
+  if (!dhdx || !dhdz)
+    dhdx = dhdz = NULL;
+
+  int i = 0;
+#ifdef HM_LANES
+  for (; i + HM_LANES <= n; i += HM_LANES) {
+    if (sampleLanes(hm, x + i, z + i, out + i, dhdx ? dhdx + i : NULL,
+                    dhdz ? dhdz + i : NULL))
+      continue;
+    for (int k = i; k < i + HM_LANES; k++)
+      sampleOne(hm, x[k], z[k], &out[k], dhdx ? &dhdx[k] : NULL,
+                dhdz ? &dhdz[k] : NULL);
+  }
+#endif
+  for (; i < n; i++)
+    sampleOne(hm, x[i], z[i], &out[i], dhdx ? &dhdx[i] : NULL,
+              dhdz ? &dhdz[i] : NULL);
+}
+
+void HeightMap_SampleBatchNormal(const HeightMap *hm, const float *x,
+                                 const float *z, float *out, Vector3 *normals,
+                                 int n) {
+  enum { CHUNK = 256 };
+  float dx[CHUNK], dz[CHUNK];
+
+  for (int i = 0; i < n; i += CHUNK) {
+    int m = (n - i < CHUNK) ? n - i : CHUNK;
+    HeightMap_SampleBatchGradient(hm, x + i, z + i, out + i, dx, dz, m);
+    for (int k = 0; k < m; k++)
+      normals[i + k] = Vector3Normalize((Vector3){-dx[k], 1.0f, -dz[k]});
+  }
+}
+
+/* ------------------------------------------------------------------ */
+/* Min/max pyramid and ray queries                                     */
+/* ------------------------------------------------------------------ */
+
+// Bicubic Catmull-Rom weights go negative with a total mass of at most
+// 2 * 1.125 * 0.125, so the surface can overshoot its 4x4 patch by that
+// fraction of the patch's range.
+#define HM_OVERSHOOT 0.28125f
+
+#define HM_REFINE_STEPS 8 // surface samples per leaf cell
+#define HM_BISECT_ITERS 10
+
+static HeightMapLevel allocLevel(uint32_t w, uint32_t h) {
+  HeightMapLevel l = {w, h, NULL, NULL};
+  l.minH = malloc(sizeof(float) * w * h);
+  l.maxH = malloc(sizeof(float) * w * h);
+  return l;
+}
+
+void HeightMap_BuildPyramid(HeightMap *hm) {
+  freePyramid(hm);
+  if (!hm->samples || hm->width < 2 || hm->height < 2)
+    return;
+
+  int sw = (int)hm->width, sh = (int)hm->height;
+  uint32_t w = hm->width - 1, h = hm->height - 1;
+
+  HeightMapLevel *l0 = &hm->levels[0];
+  *l0 = allocLevel(w, h);
+#pragma omp parallel for
+  for (uint32_t cz = 0; cz < h; cz++) {
+    for (uint32_t cx = 0; cx < w; cx++) {
+      float lo = FLT_MAX, hi = -FLT_MAX;
+      for (int j = -1; j <= 2; j++) {
+        int sz = Clamp((int)cz + j, 0, sh - 1);
+        for (int i = -1; i <= 2; i++) {
+          int sx = Clamp((int)cx + i, 0, sw - 1);
+          float v = hm->samples[sz * sw + sx];
+          lo = fminf(lo, v);
+          hi = fmaxf(hi, v);
+        }
+      }
+      float pad = (hi - lo) * HM_OVERSHOOT;
+      l0->minH[cz * w + cx] = lo - pad;
+      l0->maxH[cz * w + cx] = hi + pad;
+    }
+  }
+  hm->levelCount = 1;
+
+  while ((w > 1 || h > 1) && hm->levelCount < HEIGHTMAP_MAX_LEVELS) {
+    const HeightMapLevel *src = &hm->levels[hm->levelCount - 1];
+    uint32_t nw = (w + 1) / 2, nh = (h + 1) / 2;
+    HeightMapLevel *dst = &hm->levels[hm->levelCount];
+    *dst = allocLevel(nw, nh);
+
+    for (uint32_t z = 0; z < nh; z++) {
+      for (uint32_t x = 0; x < nw; x++) {
+        float lo = FLT_MAX, hi = -FLT_MAX;
+        for (uint32_t j = 0; j < 2; j++) {
+          uint32_t sz = z * 2 + j;
+          if (sz >= h)
+            break;
+          for (uint32_t i = 0; i < 2; i++) {
+            uint32_t sx = x * 2 + i;
+            if (sx >= w)
+              break;
+            lo = fminf(lo, src->minH[sz * w + sx]);
+            hi = fmaxf(hi, src->maxH[sz * w + sx]);
+          }
+        }
+        dst->minH[z * nw + x] = lo;
+        dst->maxH[z * nw + x] = hi;
+      }
+    }
+
+    w = nw;
+    h = nh;
+    hm->levelCount++;
+  }
+}
+
+// Narrows [t0, t1] to where o + d*t lies inside [lo, hi] on one axis.
+static bool clipSlab(float o, float d, float lo, float hi, float *t0,
+                     float *t1) {
+  if (fabsf(d) < 1e-12f)
+    return o >= lo && o <= hi;
+
+  float a = (lo - o) / d;
+  float b = (hi - o) / d;
+  if (a > b) {
+    float tmp = a;
+    a = b;
+    b = tmp;
+  }
+  *t0 = fmaxf(*t0, a);
+  *t1 = fminf(*t1, b);
+  return *t0 <= *t1;
+}
+
+// Height of the ray above the surface at t.
+static float rayClearance(const HeightMap *hm, Vector3 o, Vector3 d,
+                          float t) {
+  return o.y + d.y * t -
+         HeightMap_GetHeightCatmullRom(hm, o.x + d.x * t, o.z + d.z * t);
+}
+
+// Finds the first surface crossing of o + d*t inside one leaf cell.
+static bool refineCell(const HeightMap *hm, Vector3 o, Vector3 d, float ta,
+                       float tb, float *outT) {
+  if (rayClearance(hm, o, d, ta) <= 0.0f) {
+    *outT = ta;
+    return true;
+  }
+
+  float prev = ta;
+  for (int k = 1; k <= HM_REFINE_STEPS; k++) {
+    float tk = ta + (tb - ta) * (float)k / HM_REFINE_STEPS;
+    if (rayClearance(hm, o, d, tk) > 0.0f) {
+      prev = tk;
+      continue;
+    }
+
+    float lo = prev, hi = tk;
+    for (int it = 0; it < HM_BISECT_ITERS; it++) {
+      float mid = 0.5f * (lo + hi);
+      if (rayClearance(hm, o, d, mid) > 0.0f)
+        lo = mid;
+      else
+        hi = mid;
+    }
+    *outT = hi;
+    return true;
+  }
+  return false;
+}
+
+// Walks o + d*t over [t0, t1] through the pyramid, skipping every node
+// the ray passes entirely above and refining only the leaves it may touch.
+static bool traceSurface(const HeightMap *hm, Vector3 o, Vector3 d, float t0,
+                         float t1, float *outT) {
+  if (!hm->samples || hm->levelCount == 0)
+    return false;
+
+  float cs = hm->cellSize;
+  float x0 = hm->origin.x, z0 = hm->origin.z;
+  // Stay just inside the last sample row; the samplers return 0 on it.
+  float x1 = x0 + ((float)(hm->width - 1) - 1e-3f) * cs;
+  float z1 = z0 + ((float)(hm->height - 1) - 1e-3f) * cs;
+
+  if (!clipSlab(o.x, d.x, x0, x1, &t0, &t1) ||
+      !clipSlab(o.z, d.z, z0, z1, &t0, &t1))
+    return false;
+
+  // Step past a node boundary by a sliver of a cell; a vertical ray sits
+  // in one leaf, so a single step covers it.
+  float lenXZ = sqrtf(d.x * d.x + d.z * d.z);
+  float nudge = (lenXZ > 1e-12f) ? cs * 1e-3f / lenXZ : (t1 - t0) + 1.0f;
+
+  int top = (int)hm->levelCount - 1;
+  int level = top;
+  float t = t0;
+
+  while (t <= t1) {
+    const HeightMapLevel *L = &hm->levels[level];
+    float ns = cs * (float)(1u << level);
+
+    float px = o.x + d.x * t, pz = o.z + d.z * t;
+    int nx = Clamp((int)floorf((px - x0) / ns), 0, (int)L->width - 1);
+    int nz = Clamp((int)floorf((pz - z0) / ns), 0, (int)L->height - 1);
+
+    float bx0 = x0 + (float)nx * ns, bz0 = z0 + (float)nz * ns;
+    float tExit = t1;
+    if (d.x > 0.0f)
+      tExit = fminf(tExit, (bx0 + ns - o.x) / d.x);
+    else if (d.x < 0.0f)
+      tExit = fminf(tExit, (bx0 - o.x) / d.x);
+    if (d.z > 0.0f)
+      tExit = fminf(tExit, (bz0 + ns - o.z) / d.z);
+    else if (d.z < 0.0f)
+      tExit = fminf(tExit, (bz0 - o.z) / d.z);
+    if (tExit < t)
+      tExit = t;
+
+    float ya = o.y + d.y * t;
+    float yb = o.y + d.y * tExit;
+    uint32_t idx = (uint32_t)nz * L->width + (uint32_t)nx;
+
+    if (fminf(ya, yb) > L->maxH[idx]) {
+      t = tExit + nudge;
+      if (level < top)
+        level++;
+      continue;
+    }
+    if (fmaxf(ya, yb) < L->minH[idx]) {
+      *outT = t; // already below the surface on entry
+      return true;
+    }
+    if (level > 0) {
+      level--;
+      continue;
+    }
+
+    if (refineCell(hm, o, d, t, tExit, outT))
+      return true;
+    t = tExit + nudge;
+    if (level < top)
+      level++;
+  }
+  return false;
+}
+
+RayCollision HeightMap_Raycast(const HeightMap *hm, Ray ray, float maxDist) {
+  RayCollision hit = {0};
+  Vector3 dir = Vector3Normalize(ray.direction);
+
+  float t;
+  if (!traceSurface(hm, ray.position, dir, 0.0f, maxDist, &t))
+    return hit;
+
+  hit.hit = true;
+  hit.distance = t;
+  hit.point = Vector3Add(ray.position, Vector3Scale(dir, t));
+
+  float h;
+  HeightMap_SampleBatchNormal(hm, &hit.point.x, &hit.point.z, &h,
+                              &hit.normal, 1);
+  hit.point.y = h;
+  return hit;
+}
+
+bool HeightMap_SegmentIntersect(const HeightMap *hm, Vector3 a, Vector3 b,
+                                Vector3 *outPoint) {
+  Vector3 d = Vector3Subtract(b, a);
+
+  float t;
+  if (!traceSurface(hm, a, d, 0.0f, 1.0f, &t))
+    return false;
+
+  if (outPoint)
+    *outPoint = Vector3Add(a, Vector3Scale(d, t));
+  return true;
+}
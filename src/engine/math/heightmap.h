@@ -6,6 +6,17 @@
 #include <float.h>
 #include <stdint.h>
 
+#define HEIGHTMAP_MAX_LEVELS 16
+
+// One level of the min/max pyramid. Level 0 holds one node per cell (the
+// quad between four samples); each level above halves the resolution.
+typedef struct {
+  uint32_t width;
+  uint32_t height;
+  float *minH; // conservative lower bound of the surface over the node
+  float *maxH; // conservative upper bound
+} HeightMapLevel;
+
 typedef struct {
   uint32_t width;  // grid width (X)
   uint32_t height; // grid height (Z)
@@ -14,9 +25,66 @@ typedef struct {
   Vector3 origin; // world-space origin (min corner)
 
   float *samples; // size = width * height
+
+  HeightMapLevel levels[HEIGHTMAP_MAX_LEVELS];
+  uint32_t levelCount;
+
+  void *mapping;      // set when samples live in a mapped cache file
+  size_t mappingSize;
 } HeightMap;
 
+// Triangle soup to rasterize. At most one of indices16/indices32 is set;
+// with neither, vertices are consumed three at a time.
+typedef struct {
+  const float *vertices; // xyz triples
+  int vertexCount;
+  const unsigned short *indices16;
+  const uint32_t *indices32;
+  int triangleCount;
+} HeightMapMeshData;
+
+// A raylib mesh as rasterizer input. raylib meshes carry 16-bit indices;
+// fill indices32 directly for meshes past 65k vertices.
+HeightMapMeshData HeightMap_MeshData(Mesh mesh);
+HeightMap HeightMap_FromMeshData(const HeightMapMeshData *data,
+                                 Matrix transform);
 HeightMap HeightMap_FromMesh(Mesh mesh, Matrix transform);
+// As HeightMap_FromMesh, but reuses the samples stored at cachePath when they
+// were built from the same mesh and transform, and writes them otherwise.
+// Cached samples are memory-mapped and must be treated as read-only.
+HeightMap HeightMap_FromMeshCached(Mesh mesh, Matrix transform,
+                                   const char *cachePath);
+HeightMap HeightMap_FromMeshDataCached(const HeightMapMeshData *data,
+                                       Matrix transform,
+                                       const char *cachePath);
+// Loads the samples stored at cachePath by HeightMap_FromMeshCached without
+// checking which mesh they were built from, for callers with no real mesh
+// to check against. False when the file is missing or malformed.
+bool HeightMap_LoadCache(const char *cachePath, HeightMap *out);
 float HeightMap_GetHeightSmooth(const HeightMap *hm, float x, float z);
 float HeightMap_GetHeightCatmullRom(const HeightMap *hm, float x, float z);
+
+// Batched Catmull-Rom sampling; results match HeightMap_GetHeightCatmullRom.
+// Uses AVX2 gathers (8 lanes) or SSE2 (4 lanes) when the build targets them,
+// otherwise a scalar loop. Lanes near the border take the scalar path.
+void HeightMap_SampleBatch(const HeightMap *hm, const float *x, const float *z,
+                           float *out, int n);
+// As above, also writing world-space slopes dh/dx and dh/dz.
+void HeightMap_SampleBatchGradient(const HeightMap *hm, const float *x,
+                                   const float *z, float *out, float *dhdx,
+                                   float *dhdz, int n);
+// As above, converting the slopes to unit surface normals.
+void HeightMap_SampleBatchNormal(const HeightMap *hm, const float *x,
+                                 const float *z, float *out, Vector3 *normals,
+                                 int n);
+
+// (Re)builds the min/max pyramid; HeightMap_FromMesh calls this already.
+// Call again after editing samples.
+void HeightMap_BuildPyramid(HeightMap *hm);
+// First hit of the ray with the Catmull-Rom surface within maxDist.
+RayCollision HeightMap_Raycast(const HeightMap *hm, Ray ray, float maxDist);
+// First point where the segment a->b touches or dips below the surface.
+bool HeightMap_SegmentIntersect(const HeightMap *hm, Vector3 a, Vector3 b,
+                                Vector3 *outPoint);
+
 void HeightMap_Free(HeightMap *hm);
@@ -0,0 +1,27 @@
+#pragma once
+#include "heightmap.h"
+
+// Helpers shared by the dense and tiled heightmap builders.
+
+static inline uint32_t HeightMap_MeshIndex(const HeightMapMeshData *data,
+                                           int i) {
+  if (data->indices32)
+    return data->indices32[i];
+  if (data->indices16)
+    return data->indices16[i];
+  return (uint32_t)i;
+}
+
+// Transforms every vertex and returns a malloc'd copy plus its bounds.
+Vector3 *HeightMap_TransformVertices(const HeightMapMeshData *data,
+                                     Matrix transform, Vector3 *outMin,
+                                     Vector3 *outMax);
+
+// Max-rasterizes one triangle into a row-major grid whose sample (0, 0) sits
+// at origin, touching only samples in [x0, x1] x [z0, z1].
+void HeightMap_RasterizeTriangle(float *samples, uint32_t stride,
+                                 Vector3 origin, float cellSize, Vector3 v0,
+                                 Vector3 v1, Vector3 v2, int x0, int x1,
+                                 int z0, int z1);
+
+float HeightMap_CatmullRom(float p0, float p1, float p2, float p3, float t);
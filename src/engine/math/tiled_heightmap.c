@@ -0,0 +1,317 @@
+#include "tiled_heightmap.h"
+#include "heightmap_internal.h"
+
+TiledHeightMapDesc TiledHeightMap_DefaultDesc(void) {
+  return (TiledHeightMapDesc){
+      .cellSize = 0.25f,
+      .tileCells = TILED_HM_DEFAULT_TILE_CELLS,
+      .quantize = true,
+      .maxResidentTiles = TILED_HM_DEFAULT_MAX_RESIDENT,
+  };
+}
+
+/* ------------------------------------------------------------------ */
+/* Construction                                                        */
+/* ------------------------------------------------------------------ */
+
+// Sample-space bounds of triangle t, clamped to the grid.
+static void triSampleBounds(const TiledHeightMap *thm, uint32_t t, int *ix0,
+                            int *ix1, int *iz0, int *iz1) {
+  Vector3 v0 = thm->verts[thm->indices[t * 3 + 0]];
+  Vector3 v1 = thm->verts[thm->indices[t * 3 + 1]];
+  Vector3 v2 = thm->verts[thm->indices[t * 3 + 2]];
+
+  float minX = fminf(v0.x, fminf(v1.x, v2.x));
+  float maxX = fmaxf(v0.x, fmaxf(v1.x, v2.x));
+  float minZ = fminf(v0.z, fminf(v1.z, v2.z));
+  float maxZ = fmaxf(v0.z, fmaxf(v1.z, v2.z));
+
+  *ix0 = Clamp((int)((minX - thm->origin.x) / thm->cellSize), 0,
+               (int)thm->width - 1);
+  *ix1 = Clamp((int)((maxX - thm->origin.x) / thm->cellSize), 0,
+               (int)thm->width - 1);
+  *iz0 = Clamp((int)((minZ - thm->origin.z) / thm->cellSize), 0,
+               (int)thm->height - 1);
+  *iz1 = Clamp((int)((maxZ - thm->origin.z) / thm->cellSize), 0,
+               (int)thm->height - 1);
+}
+
+// Tiles share their edge samples, so sample s belongs to tile s / T and,
+// on a boundary, also to the tile before it.
+static void sampleRangeToTiles(int s0, int s1, int tileCells, uint32_t count,
+                               int *t0, int *t1) {
+  *t0 = s0 > 0 ? (s0 - 1) / tileCells : 0;
+  *t1 = s1 / tileCells;
+  if (*t1 >= (int)count)
+    *t1 = (int)count - 1;
+}
+
+TiledHeightMap TiledHeightMap_Create(const HeightMapMeshData *data,
+                                     Matrix transform,
+                                     const TiledHeightMapDesc *desc) {
+  TiledHeightMap thm = {0};
+  int triCount = data->triangleCount;
+
+  Vector3 min, max;
+  thm.verts = HeightMap_TransformVertices(data, transform, &min, &max);
+
+  // Copy indices as 32-bit so every source layout rasterizes the same way
+  thm.indices = malloc(sizeof(uint32_t) * 3 * (triCount > 0 ? triCount : 1));
+  for (int i = 0; i < triCount * 3; i++)
+    thm.indices[i] = HeightMap_MeshIndex(data, i);
+
+  thm.cellSize = desc->cellSize;
+  thm.origin = (Vector3){min.x, 0.0f, min.z};
+  thm.tileCells = desc->tileCells;
+  thm.quantized = desc->quantize;
+  thm.maxResidentTiles = desc->maxResidentTiles;
+
+  uint32_t cellsX = (uint32_t)ceilf((max.x - min.x) / thm.cellSize);
+  uint32_t cellsZ = (uint32_t)ceilf((max.z - min.z) / thm.cellSize);
+  thm.tilesX = cellsX / thm.tileCells + 1;
+  thm.tilesZ = cellsZ / thm.tileCells + 1;
+  thm.width = thm.tilesX * thm.tileCells + 1;
+  thm.height = thm.tilesZ * thm.tileCells + 1;
+
+  uint32_t tileCount = thm.tilesX * thm.tilesZ;
+  thm.tiles = calloc(tileCount, sizeof(HeightTile));
+
+  // Bin triangles per tile (count, prefix sum, fill)
+  for (int pass = 0; pass < 2; pass++) {
+    for (int t = 0; t < triCount; t++) {
+      int ix0, ix1, iz0, iz1, tx0, tx1, tz0, tz1;
+      triSampleBounds(&thm, t, &ix0, &ix1, &iz0, &iz1);
+      sampleRangeToTiles(ix0, ix1, thm.tileCells, thm.tilesX, &tx0, &tx1);
+      sampleRangeToTiles(iz0, iz1, thm.tileCells, thm.tilesZ, &tz0, &tz1);
+
+      for (int tz = tz0; tz <= tz1; tz++) {
+        for (int tx = tx0; tx <= tx1; tx++) {
+          HeightTile *tile = &thm.tiles[tz * thm.tilesX + tx];
+          if (pass == 1)
+            thm.tileTris[tile->firstTri + tile->triCount] = (uint32_t)t;
+          tile->triCount++;
+        }
+      }
+    }
+
+    if (pass == 0) {
+      uint32_t total = 0;
+      for (uint32_t i = 0; i < tileCount; i++) {
+        thm.tiles[i].firstTri = total;
+        total += thm.tiles[i].triCount;
+        thm.tiles[i].triCount = 0;
+      }
+      thm.tileTris = malloc(sizeof(uint32_t) * (total > 0 ? total : 1));
+    }
+  }
+
+  return thm;
+}
+
+static void evictTile(TiledHeightMap *thm, HeightTile *tile) {
+  free(tile->quantized);
+  free(tile->samples);
+  tile->quantized = NULL;
+  tile->samples = NULL;
+  atomic_store_explicit(&tile->resident, false, memory_order_relaxed);
+  thm->residentCount--;
+}
+
+void TiledHeightMap_Free(TiledHeightMap *thm) {
+  if (!thm)
+    return;
+
+  for (uint32_t i = 0; i < thm->tilesX * thm->tilesZ; i++) {
+    free(thm->tiles[i].quantized);
+    free(thm->tiles[i].samples);
+  }
+  free(thm->tiles);
+  free(thm->verts);
+  free(thm->indices);
+  free(thm->tileTris);
+  *thm = (TiledHeightMap){0};
+}
+
+/* ------------------------------------------------------------------ */
+/* Tile residency                                                      */
+/* ------------------------------------------------------------------ */
+
+static void buildTile(TiledHeightMap *thm, HeightTile *tile, int tx, int tz) {
+  int T = thm->tileCells;
+  int side = T + 1;
+  float *samples = malloc(sizeof(float) * side * side);
+  for (int i = 0; i < side * side; i++)
+    samples[i] = -FLT_MAX;
+
+  int sx0 = tx * T, sz0 = tz * T;
+  Vector3 tileOrigin = {thm->origin.x + sx0 * thm->cellSize, 0.0f,
+                        thm->origin.z + sz0 * thm->cellSize};
+
+  for (uint32_t k = 0; k < tile->triCount; k++) {
+    uint32_t t = thm->tileTris[tile->firstTri + k];
+    int ix0, ix1, iz0, iz1;
+    triSampleBounds(thm, t, &ix0, &ix1, &iz0, &iz1);
+
+    HeightMap_RasterizeTriangle(
+        samples, (uint32_t)side, tileOrigin, thm->cellSize,
+        thm->verts[thm->indices[t * 3 + 0]],
+        thm->verts[thm->indices[t * 3 + 1]],
+        thm->verts[thm->indices[t * 3 + 2]], Clamp(ix0 - sx0, 0, T),
+        Clamp(ix1 - sx0, 0, T), Clamp(iz0 - sz0, 0, T), Clamp(iz1 - sz0, 0, T));
+  }
+
+  if (!thm->quantized) {
+    tile->samples = samples;
+  } else {
+    // Uncovered samples collapse to the tile minimum
+    float lo = FLT_MAX, hi = -FLT_MAX;
+    for (int i = 0; i < side * side; i++) {
+      if (samples[i] == -FLT_MAX)
+        continue;
+      lo = fminf(lo, samples[i]);
+      hi = fmaxf(hi, samples[i]);
+    }
+    if (lo > hi)
+      lo = hi = 0.0f;
+
+    tile->offset = lo;
+    tile->scale = (hi - lo) / 65535.0f;
+    tile->quantized = malloc(sizeof(uint16_t) * side * side);
+    for (int i = 0; i < side * side; i++) {
+      float h = samples[i] == -FLT_MAX ? lo : samples[i];
+      tile->quantized[i] =
+          tile->scale > 0.0f
+              ? (uint16_t)Clamp(roundf((h - lo) / tile->scale), 0, 65535)
+              : 0;
+    }
+    free(samples);
+  }
+
+  // Release: a reader that sees resident also sees the samples above
+  atomic_store_explicit(&tile->resident, true, memory_order_release);
+  thm->residentCount++;
+}
+
+// Tiles are built lazily by whichever thread samples them first. The
+// acquire load pairs with the release in buildTile, so the fast path never
+// reads a tile's samples before they are written.
+static HeightTile *residentTile(TiledHeightMap *thm, int tx, int tz) {
+  HeightTile *tile = &thm->tiles[tz * thm->tilesX + tx];
+  if (!atomic_load_explicit(&tile->resident, memory_order_acquire)) {
+#pragma omp critical(tiled_heightmap)
+    {
+      if (!atomic_load_explicit(&tile->resident, memory_order_relaxed))
+        buildTile(thm, tile, tx, tz);
+    }
+  }
+  return tile;
+}
+
+void TiledHeightMap_Stream(TiledHeightMap *thm, const Vector3 *points, int n,
+                           float radius) {
+  uint32_t stamp = ++thm->streamStamp;
+  float tileSpan = thm->tileCells * thm->cellSize;
+
+  for (int i = 0; i < n; i++) {
+    int tx0 = (int)floorf((points[i].x - radius - thm->origin.x) / tileSpan);
+    int tx1 = (int)floorf((points[i].x + radius - thm->origin.x) / tileSpan);
+    int tz0 = (int)floorf((points[i].z - radius - thm->origin.z) / tileSpan);
+    int tz1 = (int)floorf((points[i].z + radius - thm->origin.z) / tileSpan);
+    tx0 = Clamp(tx0, 0, (int)thm->tilesX - 1);
+    tx1 = Clamp(tx1, 0, (int)thm->tilesX - 1);
+    tz0 = Clamp(tz0, 0, (int)thm->tilesZ - 1);
+    tz1 = Clamp(tz1, 0, (int)thm->tilesZ - 1);
+
+    for (int tz = tz0; tz <= tz1; tz++)
+      for (int tx = tx0; tx <= tx1; tx++)
+        residentTile(thm, tx, tz)->lastUse = stamp;
+  }
+
+  // Evict the stalest tiles; anything streamed this call stays
+  uint32_t tileCount = thm->tilesX * thm->tilesZ;
+  while (thm->residentCount > thm->maxResidentTiles) {
+    HeightTile *oldest = NULL;
+    for (uint32_t i = 0; i < tileCount; i++) {
+      HeightTile *tile = &thm->tiles[i];
+      if (!atomic_load_explicit(&tile->resident, memory_order_relaxed) ||
+          tile->lastUse == stamp)
+        continue;
+      if (!oldest || tile->lastUse < oldest->lastUse)
+        oldest = tile;
+    }
+    if (!oldest)
+      break;
+    evictTile(thm, oldest);
+  }
+}
+
+/* ------------------------------------------------------------------ */
+/* Sampling                                                            */
+/* ------------------------------------------------------------------ */
+
+static float sampleAt(TiledHeightMap *thm, int sx, int sz) {
+  int T = thm->tileCells;
+  int tx = sx / T, tz = sz / T;
+  if (tx >= (int)thm->tilesX)
+    tx = (int)thm->tilesX - 1;
+  if (tz >= (int)thm->tilesZ)
+    tz = (int)thm->tilesZ - 1;
+
+  HeightTile *tile = residentTile(thm, tx, tz);
+  int i = (sz - tz * T) * (T + 1) + (sx - tx * T);
+  return thm->quantized ? tile->offset + tile->quantized[i] * tile->scale
+                        : tile->samples[i];
+}
+
+float TiledHeightMap_GetHeightSmooth(TiledHeightMap *thm, float x, float z) {
+  float fx = (x - thm->origin.x) / thm->cellSize;
+  float fz = (z - thm->origin.z) / thm->cellSize;
+
+  int x0 = (int)floorf(fx);
+  int z0 = (int)floorf(fz);
+  int x1 = x0 + 1;
+  int z1 = z0 + 1;
+
+  if (x0 < 0 || z0 < 0 || x1 >= (int)thm->width || z1 >= (int)thm->height)
+    return 0.0f;
+
+  float tx = fx - x0;
+  float tz = fz - z0;
+
+  float h0 = Lerp(sampleAt(thm, x0, z0), sampleAt(thm, x1, z0), tx);
+  float h1 = Lerp(sampleAt(thm, x0, z1), sampleAt(thm, x1, z1), tx);
+
+  return Lerp(h0, h1, tz);
+}
+
+float TiledHeightMap_GetHeightCatmullRom(TiledHeightMap *thm, float x,
+                                         float z) {
+  float fx = (x - thm->origin.x) / thm->cellSize;
+  float fz = (z - thm->origin.z) / thm->cellSize;
+
+  int ix = (int)floorf(fx);
+  int iz = (int)floorf(fz);
+
+  if (ix < 1 || iz < 1 || ix >= (int)thm->width - 2 ||
+      iz >= (int)thm->height - 2)
+    return TiledHeightMap_GetHeightSmooth(thm, x, z);
+
+  float tx = fx - ix;
+  float tz = fz - iz;
+
+  float col[4];
+  for (int j = 0; j < 4; j++) {
+    int sz = iz - 1 + j;
+    col[j] = HeightMap_CatmullRom(
+        sampleAt(thm, ix - 1, sz), sampleAt(thm, ix, sz),
+        sampleAt(thm, ix + 1, sz), sampleAt(thm, ix + 2, sz), tx);
+  }
+
+  return HeightMap_CatmullRom(col[0], col[1], col[2], col[3], tz);
+}
+
+void TiledHeightMap_SampleBatch(TiledHeightMap *thm, const float *x,
+                                const float *z, float *out, int n) {
+  for (int i = 0; i < n; i++)
+    out[i] = TiledHeightMap_GetHeightCatmullRom(thm, x[i], z[i]);
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "heightmap.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+
+// Heightmap split into fixed-size tiles that are rasterized on first use and
+// evicted when the resident budget is exceeded. Sampling matches HeightMap;
+// only the tiles a query touches need to be in memory.
+//
+// Sampling may run from several threads at once; missing tiles are built
+// under a lock. TiledHeightMap_Stream evicts (frees) tiles, so it must not
+// run while any other thread is sampling the same map.
+
+#define TILED_HM_DEFAULT_TILE_CELLS 64
+#define TILED_HM_DEFAULT_MAX_RESIDENT 256
+
+typedef struct {
+  float cellSize;      // world units per cell
+  int tileCells;       // cells per tile side
+  bool quantize;       // store 16-bit heights with per-tile offset/scale
+  int maxResidentTiles;
+} TiledHeightMapDesc;
+
+typedef struct {
+  _Atomic bool resident; // published with release once the samples exist
+  uint32_t lastUse; // stream stamp of the last TiledHeightMap_Stream touch
+
+  float offset; // quantized: height = offset + q * scale
+  float scale;
+  uint16_t *quantized; // (tileCells + 1)^2 samples, edges shared
+  float *samples;      // used instead of quantized when not quantizing
+
+  uint32_t firstTri; // range in TiledHeightMap.tileTris
+  uint32_t triCount;
+} HeightTile;
+
+typedef struct {
+  uint32_t width;  // total samples (X)
+  uint32_t height; // total samples (Z)
+  float cellSize;
+  Vector3 origin;
+
+  int tileCells;
+  uint32_t tilesX;
+  uint32_t tilesZ;
+  bool quantized;
+  HeightTile *tiles;
+
+  // Source geometry, kept so evicted tiles can be rebuilt
+  Vector3 *verts;
+  uint32_t *indices;
+  uint32_t *tileTris; // triangle ids grouped per tile
+
+  uint32_t streamStamp;
+  int residentCount;
+  int maxResidentTiles;
+} TiledHeightMap;
+
+TiledHeightMapDesc TiledHeightMap_DefaultDesc(void);
+TiledHeightMap TiledHeightMap_Create(const HeightMapMeshData *data,
+                                     Matrix transform,
+                                     const TiledHeightMapDesc *desc);
+void TiledHeightMap_Free(TiledHeightMap *thm);
+
+// Makes every tile within radius of the given points resident, then evicts
+// least recently streamed tiles beyond the budget. Call once per frame, from
+// one thread, with no sampling in flight.
+void TiledHeightMap_Stream(TiledHeightMap *thm, const Vector3 *points, int n,
+                           float radius);
+
+float TiledHeightMap_GetHeightSmooth(TiledHeightMap *thm, float x, float z);
+float TiledHeightMap_GetHeightCatmullRom(TiledHeightMap *thm, float x,
+                                         float z);
+void TiledHeightMap_SampleBatch(TiledHeightMap *thm, const float *x,
+                                const float *z, float *out, int n);
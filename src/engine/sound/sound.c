@@ -9,6 +9,11 @@ static const char *s_loopPaths[LOOP_SOUND_COUNT] = {
 
 SoundSystem_t InitSoundSystem(void) {
   SoundSystem_t sys = {0};
+#ifdef GAME_HEADLESS
+  // No audio device. Zeroed sounds and streams have no buffers, which every
+  // raylib playback call ignores, so the rest of this module runs unchanged.
+  return sys;
+#endif
   InitAudioDevice();
 
   sys.assets[SOUND_FOOTSTEP].sound     = LoadSound("assets/audio/mech_step_1.wav");
@@ -43,6 +48,9 @@ SoundSystem_t InitSoundSystem(void) {
 }
 
 void ShutdownSoundSystem(SoundSystem_t *sys) {
+#ifdef GAME_HEADLESS
+  return;
+#endif
   for (int i = 0; i < SOUND_COUNT; i++) {
     for (int j = 0; j < SOUND_ALIASES; j++)
       UnloadSoundAlias(sys->assets[i].alias[j]);
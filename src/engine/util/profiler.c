@@ -0,0 +1,224 @@
+#define _POSIX_C_SOURCE 200809L
+#include "profiler.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+  const char      *name;
+  uint64_t         start; // ns since the profiler epoch
+  uint64_t         end;   // 0 while the zone is open
+  uint16_t         depth;
+  _Atomic uint32_t seq;   // event index + 1; 0 while the owner writes it
+} ProfEvent;
+
+typedef struct {
+  ProfEvent        events[PROF_RING_SIZE];
+  _Atomic uint32_t head;  // total zones begun; the slot is head % size
+  uint32_t         stack[PROF_MAX_DEPTH]; // event index per open zone
+  int              depth;
+  uint32_t         frameStart; // head at the last Prof_FrameEnd
+  int              id;
+  const char      *name;
+} ProfThread;
+
+static pthread_mutex_t      s_lock = PTHREAD_MUTEX_INITIALIZER;
+static ProfThread          *s_threads[PROF_MAX_THREADS];
+static _Atomic int          s_threadCount = 0;
+static _Thread_local ProfThread *s_self   = NULL;
+static _Thread_local bool   s_full        = false; // thread table was full
+
+static uint64_t s_epoch     = 0;
+static uint64_t s_lastFrame = 0;
+static float    s_frameMs   = 0.0f;
+
+static ProfZoneStats s_stats[PROF_MAX_ZONES];
+static int           s_statCount = 0;
+
+static uint64_t NowNs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static ProfThread *Self(void) {
+  if (s_self || s_full) return s_self;
+
+  pthread_mutex_lock(&s_lock);
+  if (!s_epoch) s_epoch = NowNs();
+  int n = atomic_load(&s_threadCount);
+  if (n < PROF_MAX_THREADS) {
+    ProfThread *t = calloc(1, sizeof(ProfThread));
+    t->id         = n;
+    s_threads[n]  = t;
+    atomic_store(&s_threadCount, n + 1);
+    s_self = t;
+  } else {
+    s_full = true;
+  }
+  pthread_mutex_unlock(&s_lock);
+  return s_self;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Recording                                                         */
+/* ------------------------------------------------------------------ */
+
+void Prof_Begin(const char *name) {
+  ProfThread *t = Self();
+  if (!t) return;
+
+  uint32_t   idx = atomic_load_explicit(&t->head, memory_order_relaxed);
+  ProfEvent *ev  = &t->events[idx % PROF_RING_SIZE];
+  atomic_store_explicit(&ev->seq, 0, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  ev->name  = name;
+  ev->depth = (uint16_t)t->depth;
+  ev->end   = 0;
+  ev->start = NowNs() - s_epoch;
+  atomic_store_explicit(&ev->seq, idx + 1, memory_order_release);
+  atomic_store_explicit(&t->head, idx + 1, memory_order_release);
+
+  if (t->depth < PROF_MAX_DEPTH) t->stack[t->depth] = idx;
+  t->depth++;
+}
+
+void Prof_End(void) {
+  ProfThread *t = s_self;
+  if (!t || t->depth == 0) return;
+  t->depth--;
+  if (t->depth >= PROF_MAX_DEPTH) return;
+
+  uint32_t idx = t->stack[t->depth];
+  // Overwritten by the ring wrapping inside one long zone: drop it
+  if (atomic_load_explicit(&t->head, memory_order_relaxed) - idx > PROF_RING_SIZE)
+    return;
+  ProfEvent *ev = &t->events[idx % PROF_RING_SIZE];
+  atomic_store_explicit(&ev->seq, 0, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  ev->end = NowNs() - s_epoch;
+  atomic_store_explicit(&ev->seq, idx + 1, memory_order_release);
+}
+
+void Prof_SetThreadName(const char *name) {
+  ProfThread *t = Self();
+  if (t) t->name = name;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Frame summary                                                     */
+/* ------------------------------------------------------------------ */
+
+static ProfZoneStats *StatFor(const char *name, int depth) {
+  for (int i = 0; i < s_statCount; i++)
+    if (s_stats[i].name == name || strcmp(s_stats[i].name, name) == 0)
+      return &s_stats[i];
+  if (s_statCount == PROF_MAX_ZONES) return NULL;
+  s_stats[s_statCount] = (ProfZoneStats){.name = name, .depth = depth};
+  return &s_stats[s_statCount++];
+}
+
+void Prof_FrameEnd(void) {
+  ProfThread *t = Self();
+  if (!t) return;
+
+  uint64_t now = NowNs() - s_epoch;
+  if (s_lastFrame) s_frameMs = (float)(now - s_lastFrame) * 1e-6f;
+  s_lastFrame = now;
+
+  for (int i = 0; i < s_statCount; i++) {
+    s_stats[i].ms    = 0.0f;
+    s_stats[i].calls = 0;
+  }
+
+  uint32_t head  = atomic_load_explicit(&t->head, memory_order_relaxed);
+  uint32_t first = t->frameStart;
+  if (head - first > PROF_RING_SIZE) first = head - PROF_RING_SIZE;
+  for (uint32_t i = first; i != head; i++) {
+    const ProfEvent *ev = &t->events[i % PROF_RING_SIZE];
+    if (!ev->end) continue; // still open; counted in the frame it closes
+    ProfZoneStats *st = StatFor(ev->name, ev->depth);
+    if (!st) continue;
+    st->ms += (float)(ev->end - ev->start) * 1e-6f;
+    st->calls++;
+  }
+  // Zones still open carry over, so the next frame starts at the oldest
+  t->frameStart = t->depth > 0 && t->depth <= PROF_MAX_DEPTH ? t->stack[0] : head;
+
+  for (int i = 0; i < s_statCount; i++) {
+    ProfZoneStats *st = &s_stats[i];
+    st->avgMs = st->avgMs * 0.9f + st->ms * 0.1f;
+    st->maxMs = st->ms > st->maxMs * 0.995f ? st->ms : st->maxMs * 0.995f;
+  }
+}
+
+int Prof_GetStats(const ProfZoneStats **out) {
+  *out = s_stats;
+  return s_statCount;
+}
+
+float Prof_FrameMs(void) { return s_frameMs; }
+
+/* ------------------------------------------------------------------ */
+/*  chrome://tracing export                                           */
+/* ------------------------------------------------------------------ */
+
+static void WriteJsonString(FILE *f, const char *s) {
+  fputc('"', f);
+  for (; *s; s++) {
+    if (*s == '"' || *s == '\\') fputc('\\', f);
+    if ((unsigned char)*s >= 0x20) fputc(*s, f);
+  }
+  fputc('"', f);
+}
+
+// Copies event i of a thread that may still be recording. False if the
+// slot was being written or has moved on to a newer event meanwhile.
+static bool ReadEvent(ProfThread *t, uint32_t i, ProfEvent *out) {
+  ProfEvent *ev  = &t->events[i % PROF_RING_SIZE];
+  uint32_t   seq = atomic_load_explicit(&ev->seq, memory_order_acquire);
+  if (seq != i + 1) return false;
+  out->name  = ev->name;
+  out->start = ev->start;
+  out->end   = ev->end;
+  out->depth = ev->depth;
+  atomic_thread_fence(memory_order_acquire);
+  return atomic_load_explicit(&ev->seq, memory_order_relaxed) == seq;
+}
+
+bool Prof_WriteChromeTrace(const char *path) {
+  FILE *f = fopen(path, "w");
+  if (!f) return false;
+
+  fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f);
+  bool first = true;
+  int  count = atomic_load(&s_threadCount);
+  for (int ti = 0; ti < count; ti++) {
+    ProfThread *t = s_threads[ti];
+
+    fprintf(f, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,"
+               "\"args\":{\"name\":", first ? "" : ",\n", t->id);
+    WriteJsonString(f, t->name ? t->name : (ti == 0 ? "Main" : "Worker"));
+    fputs("}}", f);
+    first = false;
+
+    // Other threads keep recording; events they overwrite or are still
+    // writing while we copy are skipped
+    uint32_t head  = atomic_load_explicit(&t->head, memory_order_acquire);
+    uint32_t start = head > PROF_RING_SIZE ? head - PROF_RING_SIZE : 0;
+    for (uint32_t i = start; i != head; i++) {
+      ProfEvent ev;
+      if (!ReadEvent(t, i, &ev) || !ev.end) continue;
+      fputs(",\n{\"ph\":\"X\",\"cat\":\"game\",\"name\":", f);
+      WriteJsonString(f, ev.name);
+      fprintf(f, ",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", t->id,
+              ev.start * 1e-3, (ev.end - ev.start) * 1e-3);
+    }
+  }
+  fputs("\n]}\n", f);
+  fclose(f);
+  return true;
+}
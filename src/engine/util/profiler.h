@@ -0,0 +1,51 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Frame profiler. Named zones nest and are timed with the monotonic clock
+// into a fixed ring per thread, so recording never allocates or locks after
+// a thread's first zone. The main thread's zones are summed per frame for
+// the on-screen overlay, and every thread's ring can be written out as a
+// chrome://tracing (Trace Event Format) JSON file.
+//
+// The PROF_* macros compile to nothing unless GAME_PROFILER is defined.
+
+#define PROF_RING_SIZE   8192 // zones kept per thread
+#define PROF_MAX_DEPTH   32
+#define PROF_MAX_THREADS 16
+#define PROF_MAX_ZONES   96   // distinct zone names in the frame summary
+
+typedef struct {
+  const char *name;
+  int         depth; // nesting level the zone was first seen at
+  int         calls; // in the last frame
+  float       ms;    // total in the last frame
+  float       avgMs; // smoothed over recent frames
+  float       maxMs; // recent peak, decaying
+} ProfZoneStats;
+
+// name must stay valid for the life of the program (use literals).
+void Prof_Begin(const char *name);
+void Prof_End(void);
+// Labels the calling thread in trace dumps.
+void Prof_SetThreadName(const char *name);
+
+// Closes the calling thread's frame and rebuilds the summary from its
+// zones. Call once per rendered frame on the main thread.
+void Prof_FrameEnd(void);
+// Summary of the last frame, in first-seen order (parents before children).
+int   Prof_GetStats(const ProfZoneStats **out);
+float Prof_FrameMs(void); // wall time between the last two Prof_FrameEnd calls
+
+// Writes every thread's recorded zones. False if the file can't be opened.
+bool Prof_WriteChromeTrace(const char *path);
+
+#ifdef GAME_PROFILER
+#define PROF_BEGIN(name)      Prof_Begin(name)
+#define PROF_END()            Prof_End()
+#define PROF_ZONE(name, stmt) do { Prof_Begin(name); stmt; Prof_End(); } while (0)
+#else
+#define PROF_BEGIN(name)      ((void)0)
+#define PROF_END()            ((void)0)
+#define PROF_ZONE(name, stmt) do { stmt; } while (0)
+#endif
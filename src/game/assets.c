@@ -0,0 +1,466 @@
+#include "assets.h"
+#include "raymath.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GLB_MAGIC      0x46546c67u // "glTF"
+#define GLB_CHUNK_JSON 0x4e4f534au // "JSON"
+#define GLB_CHUNK_BIN  0x004e4942u // "BIN\0"
+
+#define GLTF_UNSIGNED_BYTE  5121
+#define GLTF_UNSIGNED_SHORT 5123
+#define GLTF_UNSIGNED_INT   5125
+#define GLTF_FLOAT          5126
+#define GLTF_TRIANGLES      4
+
+/* ------------------------------------------------------------------ */
+/*  glTF JSON                                                         */
+/* ------------------------------------------------------------------ */
+
+// Just enough JSON walking to reach the few glTF members read here.
+
+static const char *SkipValue(const char *p) {
+  int depth = 0;
+  for (; *p; p++) {
+    if (*p == '"') {
+      for (p++; *p && *p != '"'; p++)
+        if (*p == '\\' && p[1]) p++;
+      if (!*p) return p;
+    } else if (*p == '{' || *p == '[') {
+      depth++;
+    } else if (*p == '}' || *p == ']') {
+      if (depth-- == 0) return p; // end of the enclosing container
+    } else if (*p == ',' && depth == 0) {
+      return p;
+    }
+  }
+  return p;
+}
+
+// Start of element n of the array that opens at arr ('['), or NULL.
+static const char *ArrayElement(const char *arr, int n) {
+  const char *p = arr + 1;
+  for (int i = 0; i < n; i++) {
+    p = SkipValue(p);
+    if (*p != ',') return NULL;
+    p++;
+  }
+  while (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t') p++;
+  return *p && *p != ']' ? p : NULL;
+}
+
+// Value of "key" among the members of the object that opens at obj.
+static const char *ObjectMember(const char *obj, const char *key) {
+  size_t      len = strlen(key);
+  const char *p   = obj + 1;
+  while (*p && *p != '}') {
+    while (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t' || *p == ',')
+      p++;
+    if (*p != '"') return NULL;
+    bool match = strncmp(p + 1, key, len) == 0 && p[len + 1] == '"';
+    p = strchr(p + 1, '"');
+    if (!p) return NULL;
+    p = strchr(p, ':');
+    if (!p) return NULL;
+    p++;
+    while (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t') p++;
+    if (match) return p;
+    p = SkipValue(p);
+  }
+  return NULL;
+}
+
+// Integer member "key" of obj. fallback stands in when it is absent; a
+// negative fallback makes the member required.
+static bool ReadIndex(const char *obj, const char *key, long fallback,
+                      long *out) {
+  const char *v = ObjectMember(obj, key);
+  if (!v) {
+    *out = fallback;
+    return fallback >= 0;
+  }
+  char *end;
+  *out = strtol(v, &end, 10);
+  return end != v && *out >= 0;
+}
+
+// Element n of the top-level array "key", when it is an object.
+static const char *RootElement(const char *root, const char *key, long n) {
+  const char *arr = ObjectMember(root, key);
+  const char *obj = arr && *arr == '[' ? ArrayElement(arr, (int)n) : NULL;
+  return obj && *obj == '{' ? obj : NULL;
+}
+
+typedef struct {
+  unsigned char       *file;
+  char                *json; // NUL-terminated, starting at the root object
+  const unsigned char *bin;  // .glb BIN chunk, inside file
+  uint32_t             binSize;
+} GltfFile;
+
+// The JSON chunk of a .glb (plus its BIN chunk), or the whole file for
+// .gltf. Free with UnloadGltf.
+static bool LoadGltf(const char *path, GltfFile *out) {
+  *out           = (GltfFile){0};
+  int size       = 0;
+  out->file      = LoadFileData(path, &size);
+  if (!out->file) return false;
+
+  uint32_t hdr[5];
+  if (size >= (int)sizeof(hdr)) memcpy(hdr, out->file, sizeof(hdr));
+  if (size >= (int)sizeof(hdr) && hdr[0] == GLB_MAGIC) {
+    // header: magic, version, length; then chunk length, chunk type
+    if (hdr[4] == GLB_CHUNK_JSON && hdr[3] <= (uint32_t)size - sizeof(hdr)) {
+      out->json = malloc(hdr[3] + 1);
+      memcpy(out->json, out->file + sizeof(hdr), hdr[3]);
+      out->json[hdr[3]] = '\0';
+
+      // Chunks are 4-byte aligned; the BIN chunk, if any, comes next
+      size_t   next = sizeof(hdr) + ((hdr[3] + 3u) & ~3u);
+      uint32_t chunk[2];
+      if (next + sizeof(chunk) <= (size_t)size) {
+        memcpy(chunk, out->file + next, sizeof(chunk));
+        if (chunk[1] == GLB_CHUNK_BIN &&
+            chunk[0] <= (size_t)size - next - sizeof(chunk)) {
+          out->bin     = out->file + next + sizeof(chunk);
+          out->binSize = chunk[0];
+        }
+      }
+    }
+  } else {
+    out->json = malloc((size_t)size + 1);
+    memcpy(out->json, out->file, (size_t)size);
+    out->json[size] = '\0';
+  }
+
+  if (!out->json) {
+    UnloadFileData(out->file);
+    return false;
+  }
+  char *root = out->json;
+  while (*root && *root != '{') root++;
+  memmove(out->json, root, strlen(root) + 1);
+  return true;
+}
+
+static void UnloadGltf(GltfFile *gltf) {
+  UnloadFileData(gltf->file);
+  free(gltf->json);
+  *gltf = (GltfFile){0};
+}
+
+/* ------------------------------------------------------------------ */
+/*  glTF triangles                                                    */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+  const unsigned char *data;
+  size_t               size;
+  unsigned char       *owned; // loaded from an external file
+} GltfBytes;
+
+// Bytes of buffers[n]: the .glb BIN chunk, or a file beside the glTF.
+// Embedded data: URIs are not supported.
+static bool BufferBytes(const GltfFile *gltf, const char *path, long n,
+                        GltfBytes *out) {
+  const char *buf = RootElement(gltf->json, "buffers", n);
+  if (!buf) return false;
+
+  const char *uri = ObjectMember(buf, "uri");
+  if (!uri) {
+    *out = (GltfBytes){gltf->bin, gltf->binSize, NULL};
+    return gltf->bin != NULL;
+  }
+  const char *end = *uri == '"' ? strchr(uri + 1, '"') : NULL;
+  if (!end || strncmp(uri + 1, "data:", 5) == 0) return false;
+
+  const char *slash = strrchr(path, '/');
+  const char *back  = strrchr(path, '\\');
+  if (back > slash) slash = back;
+  int  dirLen = slash ? (int)(slash - path + 1) : 0;
+  char file[512];
+  if (snprintf(file, sizeof(file), "%.*s%.*s", dirLen, path,
+               (int)(end - uri - 1), uri + 1) >= (int)sizeof(file))
+    return false;
+
+  int size   = 0;
+  out->owned = LoadFileData(file, &size);
+  out->data  = out->owned;
+  out->size  = (size_t)size;
+  return out->owned != NULL;
+}
+
+typedef struct {
+  GltfBytes bytes;
+  size_t    offset; // first element
+  size_t    stride;
+  long      count;
+  long      componentType;
+} GltfAccessor;
+
+static size_t ComponentSize(long componentType) {
+  switch (componentType) {
+  case GLTF_UNSIGNED_BYTE:  return 1;
+  case GLTF_UNSIGNED_SHORT: return 2;
+  case GLTF_UNSIGNED_INT:
+  case GLTF_FLOAT:          return 4;
+  default:                  return 0;
+  }
+}
+
+// Opens accessors[n], which must be of the given type ("VEC3", "SCALAR")
+// with that many components, and checks every element lies in its buffer.
+static bool OpenAccessor(const GltfFile *gltf, const char *path, long n,
+                         const char *type, int components,
+                         GltfAccessor *out) {
+  *out            = (GltfAccessor){0};
+  const char *acc = RootElement(gltf->json, "accessors", n);
+  if (!acc || ObjectMember(acc, "sparse")) return false;
+
+  size_t      typeLen = strlen(type);
+  const char *t       = ObjectMember(acc, "type");
+  if (!t || *t != '"' || strncmp(t + 1, type, typeLen) != 0 ||
+      t[typeLen + 1] != '"')
+    return false;
+
+  long viewIndex, accOffset, bufIndex, viewOffset, viewLength, stride;
+  if (!ReadIndex(acc, "bufferView", -1, &viewIndex) ||
+      !ReadIndex(acc, "byteOffset", 0, &accOffset) ||
+      !ReadIndex(acc, "count", -1, &out->count) ||
+      !ReadIndex(acc, "componentType", -1, &out->componentType))
+    return false;
+
+  const char *view = RootElement(gltf->json, "bufferViews", viewIndex);
+  if (!view || !ReadIndex(view, "buffer", -1, &bufIndex) ||
+      !ReadIndex(view, "byteOffset", 0, &viewOffset) ||
+      !ReadIndex(view, "byteLength", -1, &viewLength) ||
+      !ReadIndex(view, "byteStride", 0, &stride))
+    return false;
+
+  size_t elemSize = ComponentSize(out->componentType) * components;
+  if (elemSize == 0) return false;
+  out->offset = (size_t)viewOffset + (size_t)accOffset;
+  out->stride = stride ? (size_t)stride : elemSize;
+  if (out->count > 0 && (size_t)accOffset + (out->count - 1) * out->stride +
+                                elemSize > (size_t)viewLength)
+    return false;
+
+  if (!BufferBytes(gltf, path, bufIndex, &out->bytes)) return false;
+  if ((size_t)viewOffset + (size_t)viewLength > out->bytes.size) {
+    UnloadFileData(out->bytes.owned);
+    return false;
+  }
+  return true;
+}
+
+static void CloseAccessor(GltfAccessor *acc) {
+  UnloadFileData(acc->bytes.owned);
+  acc->bytes.owned = NULL;
+}
+
+static uint32_t AccessorIndex(const GltfAccessor *acc, long i) {
+  const unsigned char *p = acc->bytes.data + acc->offset + i * acc->stride;
+  if (acc->componentType == GLTF_UNSIGNED_BYTE) return p[0];
+  if (acc->componentType == GLTF_UNSIGNED_SHORT) {
+    uint16_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+// Copies the POSITION and index accessors of one primitive into out.
+static bool ReadPrimitive(const GltfFile *gltf, const char *path,
+                          const char *prim, AssetTriangles *out) {
+  const char *attrs = ObjectMember(prim, "attributes");
+  long        posIndex, mode;
+  if (!attrs || *attrs != '{' || !ReadIndex(attrs, "POSITION", -1, &posIndex) ||
+      !ReadIndex(prim, "mode", GLTF_TRIANGLES, &mode) || mode != GLTF_TRIANGLES)
+    return false;
+
+  GltfAccessor pos;
+  if (!OpenAccessor(gltf, path, posIndex, "VEC3", 3, &pos)) return false;
+  bool ok = pos.componentType == GLTF_FLOAT && pos.count > 0;
+  if (ok) {
+    out->vertexCount = (int)pos.count;
+    out->vertices    = malloc(sizeof(float) * 3 * pos.count);
+    ok               = out->vertices != NULL;
+    for (long i = 0; ok && i < pos.count; i++)
+      memcpy(&out->vertices[i * 3], pos.bytes.data + pos.offset + i * pos.stride,
+             sizeof(float) * 3);
+  }
+  CloseAccessor(&pos);
+  if (!ok) return false;
+
+  long indexIndex;
+  if (!ObjectMember(prim, "indices")) {
+    out->triangleCount = out->vertexCount / 3;
+    return out->triangleCount > 0;
+  }
+  GltfAccessor idx;
+  if (!ReadIndex(prim, "indices", -1, &indexIndex) ||
+      !OpenAccessor(gltf, path, indexIndex, "SCALAR", 1, &idx))
+    return false;
+  ok = idx.componentType != GLTF_FLOAT && idx.count >= 3;
+  if (ok) {
+    out->triangleCount = (int)(idx.count / 3);
+    out->indices = malloc(sizeof(uint32_t) * 3 * (out->triangleCount + 1));
+    ok           = out->indices != NULL;
+    for (long i = 0; ok && i < out->triangleCount * 3L; i++) {
+      out->indices[i] = AccessorIndex(&idx, i);
+      ok              = out->indices[i] < (uint32_t)out->vertexCount;
+    }
+  }
+  CloseAccessor(&idx);
+  return ok;
+}
+
+bool Assets_LoadTriangles(const char *path, AssetTriangles *out) {
+  *out = (AssetTriangles){0};
+  GltfFile gltf;
+  if (!LoadGltf(path, &gltf)) return false;
+
+  const char *mesh  = RootElement(gltf.json, "meshes", 0);
+  const char *prims = mesh ? ObjectMember(mesh, "primitives") : NULL;
+  const char *prim  = prims && *prims == '[' ? ArrayElement(prims, 0) : NULL;
+  bool        ok = prim && *prim == '{' && ReadPrimitive(&gltf, path, prim, out);
+  UnloadGltf(&gltf);
+
+  if (!ok) {
+    Assets_FreeTriangles(out);
+    TraceLog(LOG_WARNING, "ASSETS: [%s] no glTF triangles read", path);
+  }
+  return ok;
+}
+
+void Assets_FreeTriangles(AssetTriangles *tris) {
+  free(tris->vertices);
+  free(tris->indices);
+  *tris = (AssetTriangles){0};
+}
+
+#ifndef GAME_HEADLESS
+
+Model Assets_LoadModel(const char *path) { return LoadModel(path); }
+
+Model Assets_CubeModel(float width, float height, float length) {
+  return LoadModelFromMesh(GenMeshCube(width, height, length));
+}
+
+Shader Assets_LoadShader(const char *vsPath, const char *fsPath) {
+  return LoadShader(vsPath, fsPath);
+}
+
+int Assets_ShaderLocation(Shader shader, const char *uniformName) {
+  return GetShaderLocation(shader, uniformName);
+}
+
+#else
+
+/* ------------------------------------------------------------------ */
+/*  Box mesh                                                          */
+/* ------------------------------------------------------------------ */
+
+// Eight corners and twelve triangles, CPU side only. vaoId/vboId stay
+// unset, which UnloadMesh skips.
+static Mesh BoxMesh(BoundingBox b) {
+  static const unsigned short tris[36] = {
+      0, 2, 1, 0, 3, 2, // -z
+      4, 5, 6, 4, 6, 7, // +z
+      0, 1, 5, 0, 5, 4, // -y
+      3, 7, 6, 3, 6, 2, // +y
+      0, 4, 7, 0, 7, 3, // -x
+      1, 2, 6, 1, 6, 5, // +x
+  };
+  Mesh mesh          = {0};
+  mesh.vertexCount   = 8;
+  mesh.triangleCount = 12;
+  mesh.vertices      = MemAlloc(sizeof(float) * 3 * 8);
+  mesh.indices       = MemAlloc(sizeof(tris));
+  memcpy(mesh.indices, tris, sizeof(tris));
+  for (int i = 0; i < 8; i++) {
+    mesh.vertices[i * 3 + 0] = (i & 1) ^ ((i >> 1) & 1) ? b.max.x : b.min.x;
+    mesh.vertices[i * 3 + 1] = (i & 2) ? b.max.y : b.min.y;
+    mesh.vertices[i * 3 + 2] = (i & 4) ? b.max.z : b.min.z;
+  }
+  return mesh;
+}
+
+/* ------------------------------------------------------------------ */
+/*  glTF bounds                                                       */
+/* ------------------------------------------------------------------ */
+
+static bool ReadVec3(const char *arr, Vector3 *out) {
+  if (!arr || *arr != '[') return false;
+  char *end;
+  out->x = strtof(arr + 1, &end);
+  if (*end != ',') return false;
+  out->y = strtof(end + 1, &end);
+  if (*end != ',') return false;
+  out->z = strtof(end + 1, &end);
+  return true;
+}
+
+// Union of the POSITION accessor bounds over every mesh primitive, in mesh
+// space (node transforms are not applied).
+static bool GltfBounds(const char *json, BoundingBox *out) {
+  const char *accessors = ObjectMember(json, "accessors");
+  if (!accessors || *accessors != '[') return false;
+
+  bool        found = false;
+  const char *p     = json;
+  while ((p = strstr(p, "\"POSITION\"")) != NULL) {
+    p += strlen("\"POSITION\"");
+    while (*p == ' ' || *p == ':') p++;
+    const char *acc = ArrayElement(accessors, atoi(p));
+    Vector3     mn, mx;
+    if (!acc || *acc != '{' || !ReadVec3(ObjectMember(acc, "min"), &mn) ||
+        !ReadVec3(ObjectMember(acc, "max"), &mx))
+      continue;
+    if (!found) {
+      *out  = (BoundingBox){mn, mx};
+      found = true;
+    } else {
+      out->min = Vector3Min(out->min, mn);
+      out->max = Vector3Max(out->max, mx);
+    }
+  }
+  return found;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Loaders                                                           */
+/* ------------------------------------------------------------------ */
+
+Model Assets_LoadModel(const char *path) {
+  // Same fallback as LoadModel: a unit cube when the file gives nothing
+  BoundingBox b    = {{-0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, 0.5f}};
+  GltfFile    gltf;
+  bool        loaded = LoadGltf(path, &gltf);
+  if (!loaded || !GltfBounds(gltf.json, &b))
+    TraceLog(LOG_WARNING, "ASSETS: [%s] no glTF bounds, using unit cube", path);
+  if (loaded) UnloadGltf(&gltf);
+  return LoadModelFromMesh(BoxMesh(b));
+}
+
+Model Assets_CubeModel(float width, float height, float length) {
+  Vector3 h = {width * 0.5f, height * 0.5f, length * 0.5f};
+  return LoadModelFromMesh(BoxMesh((BoundingBox){Vector3Negate(h), h}));
+}
+
+Shader Assets_LoadShader(const char *vsPath, const char *fsPath) {
+  (void)vsPath;
+  (void)fsPath;
+  return (Shader){0};
+}
+
+int Assets_ShaderLocation(Shader shader, const char *uniformName) {
+  (void)shader;
+  (void)uniformName;
+  return -1;
+}
+
+#endif
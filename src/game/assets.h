@@ -0,0 +1,29 @@
+#pragma once
+#include "raylib.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Model and shader loading for gameplay code. The windowed build forwards
+// to raylib. GAME_HEADLESS builds never touch the GPU: a model loads as a
+// CPU-only box spanning its glTF POSITION bounds, and shaders are empty
+// handles with no uniforms. Either kind of model is freed with UnloadModel.
+
+Model  Assets_LoadModel(const char *path);
+Model  Assets_CubeModel(float width, float height, float length);
+Shader Assets_LoadShader(const char *vsPath, const char *fsPath);
+int    Assets_ShaderLocation(Shader shader, const char *uniformName);
+
+// Triangles of the first primitive of a glTF file's first mesh, the one
+// raylib loads as meshes[0], in mesh space with 32-bit indices. raylib
+// narrows glTF indices to 16 bits, so terrain over 65k vertices has to be
+// read from here. Handles .glb and .gltf with external buffers; false (and
+// nothing to free) when the file has no such primitive.
+typedef struct {
+  float    *vertices; // xyz triples
+  int       vertexCount;
+  uint32_t *indices;  // NULL when the primitive is not indexed
+  int       triangleCount;
+} AssetTriangles;
+
+bool Assets_LoadTriangles(const char *path, AssetTriangles *out);
+void Assets_FreeTriangles(AssetTriangles *tris);
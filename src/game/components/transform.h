@@ -1,6 +1,7 @@
 
 #pragma once
 #include "raylib.h"
+#include <stdint.h>
 
 typedef struct {
   Vector3 value;
@@ -10,3 +11,15 @@ typedef struct {
   float yaw;
   float pitch;
 } Orientation;
+
+// Last-tick snapshot used to interpolate rendering between fixed sim ticks.
+typedef struct {
+  Vector3 position;
+  Orientation orientation;
+  uint32_t generation; // entity generation at snapshot; UINT32_MAX = none
+} PrevTransform;
+
+typedef struct {
+  PrevTransform *entries; // indexed by entity id
+  uint32_t capacity;
+} TransformHistory;
@@ -5,6 +5,8 @@
 #include "components/renderable.h"
 #include "game.h"
 #include "level_creater_helper.h"
+#include "nav_grid/nav_bake.h"
+#include "world_spawn.h"
 #include <dirent.h>
 #include <math.h>
 #include <stdio.h>
@@ -22,6 +24,55 @@ static void NavmapPathFromLevel(const char *levelPath, char *out, int maxLen) {
   else strncat(out, ".navmap.png", maxLen - (int)strlen(out) - 1);
 }
 
+// Previews the baked walls in the painted navmap: geometry becomes WALL
+// (FENCE for shoot-through wall segments, nothing for walk-through ones),
+// stale painted walls are erased and every other annotation is kept. The
+// image stays at 2 m per cell; the game bakes at the level's own "navcell"
+// on load.
+static void EditorBakeNav(EditorState *ed, GameWorld *gw) {
+  static NavBakeBox  boxes[EDITOR_MAX_BOXES];
+  static NavBakeWall walls[EDITOR_MAX_WALLSEGS];
+  for (int i = 0; i < ed->placedCount; i++)
+    boxes[i] = (NavBakeBox){ed->placed[i].position,
+                            Vector3Scale(ed->placed[i].scale, 0.5f)};
+  int wallCount = 0;
+  for (int i = 0; i < ed->wallSegCount; i++) {
+    EditorPlacedWallSeg *w = &ed->placedWallSegs[i];
+    if (!w->blockPlayer) continue; // walk-through, like the game's bake
+    walls[wallCount++] = (NavBakeWall){w->ax, w->az, w->bx, w->bz, w->yBottom,
+                                       w->yTop, w->radius, w->blockProjectiles};
+  }
+  NavBakeInput in = {boxes, ed->placedCount, walls, wallCount,
+                     &gw->terrainHeightMap};
+
+  NavBakeParams params = NavBake_DefaultParams();
+  params.agentRadius = ed->navRadius;
+  params.maxSlope    = ed->navSlope;
+  params.lowCover  = 0.0f; // walls only, cover stays hand-painted here
+  params.highCover = 0.0f;
+
+  NavGrid grid;
+  NavBake_Run(&grid, &in, &params);
+
+  unsigned char *px = (unsigned char *)ed->navImage.data;
+  for (int gz = 0; gz < 180 && gz < grid.height; gz++) {
+    for (int gx = 0; gx < 180 && gx < grid.width; gx++) {
+      unsigned char *c = &px[((179 - gz) * 180 + gx) * 4];
+      NavCellType    t = grid.cells[NavGrid_Index(&grid, gx, gz)].type;
+      bool paintedWall  = c[0] < 10 && c[1] < 10 && c[2] < 10;
+      bool paintedFence = c[0] < 50 && c[1] > 200 && c[2] > 200;
+      if (t == NAV_CELL_WALL) {
+        c[0] = 0;   c[1] = 0;   c[2] = 0;
+      } else if (t == NAV_CELL_FENCE) {
+        c[0] = 0;   c[1] = 255; c[2] = 255;
+      } else if (paintedWall || paintedFence) {
+        c[0] = 255; c[1] = 255; c[2] = 255;
+      }
+    }
+  }
+  NavGrid_Destroy(&grid);
+}
+
 /* ---- Editor-side model cache (load-on-demand, persists across editor sessions) ---- */
 #define ED_MODEL_CACHE_CAP 32
 typedef struct { char path[256]; Model model; bool loaded; } EdModelEntry;
@@ -126,9 +177,7 @@ void EditorInit(EditorState *ed, GameWorld *gw, world_t *world) {
   strncpy(ed->propPlaceModel, "assets/models/obstacle.glb",
           sizeof(ed->propPlaceModel) - 1);
 
-  HeightMap_Free(&gw->terrainHeightMap);
-  gw->terrainHeightMap =
-      HeightMap_FromMesh(gw->terrainModel.meshes[0], MatrixIdentity());
+  LoadTerrainHeightMap(gw);
 
   ed->missionType       = MISSION_WAVES;
   ed->healthBarFade     = true;
@@ -181,6 +230,11 @@ void EditorInit(EditorState *ed, GameWorld *gw, world_t *world) {
   ed->navPaintType   = 0;
   ed->navPaletteOpen = false;
   ed->navBrushSize   = 1;
+  ed->navBake        = true;
+  ed->navCellSize    = 2.0f;
+  ed->navMesh        = false;
+  ed->navRadius      = NavBake_DefaultParams().agentRadius;
+  ed->navSlope       = NavBake_DefaultParams().maxSlope;
   if (ed->navImageLoaded) UnloadImage(ed->navImage);
   ed->navImage = GenImageColor(180, 180, WHITE);
   ImageFormat(&ed->navImage, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
@@ -195,20 +249,15 @@ static bool RaycastTerrain(EditorState *ed, GameWorld *gw, Vector3 *out) {
                     (float)GetScreenHeight() / 2.0f};
   Ray ray = GetScreenToWorldRay(center, ed->camera);
 
-  for (float t = 1.0f; t < 600.0f; t += 0.5f) {
-    Vector3 p = Vector3Add(ray.position, Vector3Scale(ray.direction, t));
-    if (p.x < -200 || p.x > 200 || p.z < -200 || p.z > 200)
-      break;
-    float terrainY =
-        HeightMap_GetHeightCatmullRom(&gw->terrainHeightMap, p.x, p.z);
-    if (p.y <= terrainY) {
-      out->x = p.x;
-      out->z = p.z;
-      out->y = terrainY + ed->boxScale * 0.5f;
-      return true;
-    }
-  }
-  return false;
+  RayCollision hit = HeightMap_Raycast(&gw->terrainHeightMap, ray, 600.0f);
+  if (!hit.hit || hit.point.x < -200 || hit.point.x > 200 ||
+      hit.point.z < -200 || hit.point.z > 200)
+    return false;
+
+  out->x = hit.point.x;
+  out->z = hit.point.z;
+  out->y = hit.point.y + ed->boxScale * 0.5f;
+  return true;
 }
 
 // Ray-picks the nearest placed box from the screen center. Returns index or -1.
@@ -419,8 +468,7 @@ void EditorLoad(EditorState *ed, GameWorld *gw, world_t *world, const char *path
       UnloadModel(gw->terrainModel);
       gw->terrainModel = LoadModel(terrainPath);
       strncpy(gw->terrainModelPath, terrainPath, sizeof(gw->terrainModelPath)-1);
-      HeightMap_Free(&gw->terrainHeightMap);
-      gw->terrainHeightMap = HeightMap_FromMesh(gw->terrainModel.meshes[0], MatrixIdentity());
+      LoadTerrainHeightMap(gw);
       s_navHeightCacheValid = false;
     }
   }
@@ -440,6 +488,23 @@ void EditorLoad(EditorState *ed, GameWorld *gw, world_t *world, const char *path
     ed->healthBarFade = (hpf != 0.0f);
   }
 
+  // Nav bake settings
+  {
+    NavBakeParams defaults = NavBake_DefaultParams();
+    float nb = 0.0f, nc = 2.0f, nm = 0.0f;
+    float nr = defaults.agentRadius, ns = defaults.maxSlope;
+    JsonReadFloat(text, "navbake",   &nb);
+    JsonReadFloat(text, "navcell",   &nc);
+    JsonReadFloat(text, "navmesh",   &nm);
+    JsonReadFloat(text, "navradius", &nr);
+    JsonReadFloat(text, "navslope",  &ns);
+    ed->navBake     = (nb != 0.0f);
+    ed->navCellSize = nc;
+    ed->navMesh     = (nm != 0.0f);
+    ed->navRadius   = nr;
+    ed->navSlope    = ns;
+  }
+
   // Wave composition
   {
     ed->edWaveCount = 0;
@@ -901,12 +966,10 @@ void EditorUpdate(EditorState *ed, GameWorld *gw, world_t *world) {
         int histCap = EDITOR_MAX_BOXES + EDITOR_MAX_SPAWNERS + EDITOR_MAX_PROPS +
                       EDITOR_MAX_INFOBOXES + EDITOR_MAX_WALLSEGS;
         if (ed->wallSegCount < EDITOR_MAX_WALLSEGS && ed->historyTop < histCap) {
-          float terrYA = HeightMap_GetHeightCatmullRom(&gw->terrainHeightMap,
-                                                       ed->wallSegPendingA.x,
-                                                       ed->wallSegPendingA.z);
-          float terrYB = HeightMap_GetHeightCatmullRom(&gw->terrainHeightMap,
-                                                       ed->wallSegPendingB.x,
-                                                       ed->wallSegPendingB.z);
+          float terrYA = TerrainHeight(gw, ed->wallSegPendingA.x,
+                                         ed->wallSegPendingA.z);
+          float terrYB = TerrainHeight(gw, ed->wallSegPendingB.x,
+                                         ed->wallSegPendingB.z);
           float yBottom = fminf(terrYA, terrYB);
           EditorPlacedWallSeg *ws = &ed->placedWallSegs[ed->wallSegCount++];
           ws->ax               = ed->wallSegPendingA.x;
@@ -1302,8 +1365,7 @@ void EditorUpdate(EditorState *ed, GameWorld *gw, world_t *world) {
             UnloadModel(gw->terrainModel);
             gw->terrainModel = LoadModel(newPath);
             strncpy(gw->terrainModelPath, newPath, sizeof(gw->terrainModelPath)-1);
-            HeightMap_Free(&gw->terrainHeightMap);
-            gw->terrainHeightMap = HeightMap_FromMesh(gw->terrainModel.meshes[0], MatrixIdentity());
+            LoadTerrainHeightMap(gw);
             s_navHeightCacheValid = false;
           }
           ed->terrainPickerOpen = false;
@@ -1439,6 +1501,7 @@ void EditorUpdate(EditorState *ed, GameWorld *gw, world_t *world) {
       }
     } else {
       if (IsKeyPressed(KEY_P)) ed->navPaletteOpen = true;
+      if (IsKeyPressed(KEY_B)) EditorBakeNav(ed, gw);
 
       float scroll = GetMouseWheelMove();
       if (scroll > 0.0f && ed->navBrushSize < 5) ed->navBrushSize++;
@@ -1887,8 +1950,7 @@ void EditorUpdate(EditorState *ed, GameWorld *gw, world_t *world) {
         }
       } else if (ed->placeType == 4 && ed->infoBoxCount < EDITOR_MAX_INFOBOXES
                  && !ed->infoBoxEditOpen) {
-        float hy = HeightMap_GetHeightCatmullRom(
-            &gw->terrainHeightMap, ed->hitPos.x, ed->hitPos.z);
+        float hy = TerrainHeight(gw, ed->hitPos.x, ed->hitPos.z);
         ed->infoBoxPendingPos = (Vector3){
             ed->hitPos.x,
             hy + ed->infoBoxHalfExtent,
@@ -1898,8 +1960,7 @@ void EditorUpdate(EditorState *ed, GameWorld *gw, world_t *world) {
         ed->infoBoxEditOpen   = true;
         EnableCursor();
       } else if (ed->placeType == 5) {
-        float hy = HeightMap_GetHeightCatmullRom(
-            &gw->terrainHeightMap, ed->hitPos.x, ed->hitPos.z);
+        float hy = TerrainHeight(gw, ed->hitPos.x, ed->hitPos.z);
         ed->edSpawnPoint    = (Vector3){ed->hitPos.x, hy + 1.8f, ed->hitPos.z};
         ed->edHasSpawnPoint = true;
       } else if (ed->placeType == 6 && !ed->wallSegDialogOpen) {
@@ -2118,8 +2179,7 @@ void EditorRender(EditorState *ed, GameWorld *gw) {
       DrawCubeWires(ed->hitPos, s, s, s, GREEN);
     } else if (ed->placeType == 4) {
       float s = ed->infoBoxHalfExtent * 2.0f;
-      float hy = HeightMap_GetHeightCatmullRom(
-          &gw->terrainHeightMap, ed->hitPos.x, ed->hitPos.z);
+      float hy = TerrainHeight(gw, ed->hitPos.x, ed->hitPos.z);
       Vector3 gp = {ed->hitPos.x, hy + ed->infoBoxHalfExtent, ed->hitPos.z};
       DrawCube(gp, s, s, s, (Color){0, 200, 180, 35});
       DrawCubeWires(gp, s, s, s, (Color){0, 220, 200, 200});
@@ -2168,8 +2228,7 @@ void EditorRender(EditorState *ed, GameWorld *gw) {
         for (int gx = 0; gx < 180; gx++) {
           float wx = gx * 2.0f - 180.0f + 1.0f;
           float wz = gz * 2.0f - 180.0f + 1.0f;
-          s_navHeightCache[gz][gx] =
-              HeightMap_GetHeightCatmullRom(&gw->terrainHeightMap, wx, wz);
+          s_navHeightCache[gz][gx] = TerrainHeight(gw, wx, wz);
         }
       s_navHeightCacheValid = true;
     }
@@ -2265,7 +2324,7 @@ void EditorRender(EditorState *ed, GameWorld *gw) {
                         typeNames[pt], ed->navBrushSize),
              20, 48, 18, typeColors[pt]);
     DrawText("[LMB] Paint  [RMB] Erase  [Scroll] Brush size  [P] Palette  "
-             "[N] Exit  [Ctrl+S] Save  [ESC] Menu",
+             "[B] Bake walls  [N] Exit  [Ctrl+S] Save  [ESC] Menu",
              20, GetScreenHeight() - 28, 14, WHITE);
 
     if (ed->navPaletteOpen) {
@@ -3082,8 +3141,12 @@ void EditorSave(EditorState *ed, GameWorld *gw, const char *path) {
   NavmapPathFromLevel(path, navPath, sizeof(navPath));
   const char *missionStr = (ed->missionType == MISSION_EXPLORATION) ? "exploration" : "waves";
   fprintf(f, "{\n  \"terrain\": \"%s\",\n  \"navmap\": \"%s\",\n  \"mission\": \"%s\",\n"
-             "  \"hpfade\": %d,\n  \"boxes\": [\n",
-          gw->terrainModelPath, navPath, missionStr, ed->healthBarFade ? 1 : 0);
+             "  \"hpfade\": %d,\n  \"navbake\": %d,\n  \"navcell\": %.2f,\n"
+             "  \"navmesh\": %d,\n  \"navradius\": %.2f,\n  \"navslope\": %.2f,\n"
+             "  \"boxes\": [\n",
+          gw->terrainModelPath, navPath, missionStr, ed->healthBarFade ? 1 : 0,
+          ed->navBake ? 1 : 0, ed->navCellSize, ed->navMesh ? 1 : 0,
+          ed->navRadius, ed->navSlope);
   for (int i = 0; i < ed->placedCount; i++) {
     EditorPlacedBox *b = &ed->placed[i];
     const char *comma = (i < ed->placedCount - 1) ? "," : "";
@@ -171,6 +171,11 @@ typedef struct {
   int  navBrushSize;    // 1–5 cells (radius = brushSize-1)
   Image navImage;
   bool navImageLoaded;
+  bool  navBake;     // saved as "navbake"; bake the grid from geometry on load
+  float navCellSize; // saved as "navcell"; baked grid resolution in metres
+  bool  navMesh;     // saved as "navmesh"; path over merged polygons
+  float navRadius;   // saved as "navradius"; agent radius the bake pads by
+  float navSlope;    // saved as "navslope"; steepest walkable rise per run
 
   // Box array tool ([A] key in box-place mode)
   bool    arrayDialogOpen;
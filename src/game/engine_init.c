@@ -2,15 +2,20 @@
 #include "component_registry_setup.h"
 #include "rlgl.h"
 
+// GAME_HEADLESS builds open no window, so there is no GL context either.
 Engine EngineInit(void) {
+#ifndef GAME_HEADLESS
   SetConfigFlags(FLAG_VSYNC_HINT);
   InitWindow(1280, 720, "ECS FPS Test");
   DisableCursor();
   SetExitKey(KEY_NULL);
   SetTargetFPS(60);
+#endif
 
   Engine engine = {0};
+#ifndef GAME_HEADLESS
   rlSetClipPlanes(0.1f, 5000.0f);
+#endif
   engine.camera.fovy = 75.0f;
   engine.camera.projection = CAMERA_PERSPECTIVE;
 
@@ -26,5 +31,7 @@ Engine EngineInit(void) {
 
 void EngineShutdown(Engine *engine) {
   ComponentRegistry_Shutdown(&engine->componentRegistry);
+#ifndef GAME_HEADLESS
   CloseWindow();
+#endif
 }
@@ -5,15 +5,25 @@
 #include "../engine/ecs/component_registry.h"
 #include "../engine/ecs/world.h"
 #include "../engine/math/heightmap.h"
+#include "../engine/math/tiled_heightmap.h"
 #include "../engine/sound/sound.h"
 #include "systems/message_system.h"
 #include "../engine/util/bitset.h"
 #include "components/components.h"
 #include "ecs_get.h"
 #include "game.h"
+#include "nav_grid/flow_field.h"
 #include "nav_grid/nav.h"
+#include "nav_grid/nav_clearance.h"
+#include "nav_grid/nav_hierarchy.h"
+#include "nav_grid/nav_mesh.h"
+#include "nav_grid/nav_occupancy.h"
+#include "nav_grid/nav_visibility.h"
 #include "raylib.h"
 #include "raymath.h"
+#include "systems/ai_scheduler.h"
+#include "systems/crowd.h"
+#include "systems/tactical_map.h"
 #include "systems/systems.h"
 #include <math.h>
 #include <stdint.h>
@@ -23,12 +33,18 @@
 #define PLAYER_RADIUS 0.35f
 #define PLAYER_HEIGHT 2.0f
 
+// Fixed-timestep simulation: ticks per second and the most ticks a single
+// frame may run to catch up before the backlog is dropped.
+#define SIM_DEFAULT_TICK_RATE 60
+#define SIM_MAX_TICKS_PER_FRAME 5
+
 enum CollisionLayer {
   LAYER_PLAYER = 0,
   LAYER_WORLD = 1,
   LAYER_ENEMY = 2,
   LAYER_BULLET = 3,
-  LAYER_TRIGGER = 4
+  LAYER_TRIGGER = 4,
+  LAYER_PICKUP = 5 // health orbs / coolant (spatial index only, no collider)
 };
 
 typedef enum {
@@ -78,6 +94,14 @@ typedef struct {
   ComponentRegistry componentRegistry;
 } Engine;
 
+// Scratch for SampleArchetypeGround: entity XZ in, terrain height out.
+typedef struct {
+  float   *x;
+  float   *z;
+  float   *y;
+  uint32_t capacity;
+} GroundSamples;
+
 typedef enum { LOCKSTATE_IDLE = 0, LOCKSTATE_ACQUIRING, LOCKSTATE_LOCKED, LOCKSTATE_BURSTING } RocketLockState;
 typedef enum { HOOKSTATE_IDLE = 0, HOOKSTATE_FLYING, HOOKSTATE_PULLING } HookState;
 
@@ -121,10 +145,17 @@ typedef struct GameWorld {
 
   float fov;
   float inputCooldown;
+
+  int simTickRate;       // fixed simulation ticks per second
+  float simAccumulator;  // unsimulated frame time carried to the next frame
+  float renderAlpha;     // 0..1 blend between previous and current tick
+  TransformHistory transformHistory;
+
   int resWidth;
   int resHeight;
   bool fullscreen;
   bool debugView;
+  bool profilerView; // F10 per-zone timing overlay
   enum gameState settingsPrevState;
 
   uint32_t playerArchId, bulletArchId, enemyCapsuleArchId, enemyGruntArchId,
@@ -159,7 +190,11 @@ typedef struct GameWorld {
   Model rangerTorso;
   Model rangerLegs;
 
-  HeightMap terrainHeightMap;
+  HeightMap terrainHeightMap;  // dense; raycasts, segment tests, nav bakes
+  TiledHeightMap terrainTiles; // streamed around actors; height queries
+  Vector3 *terrainStreamPoints;
+  int terrainStreamCap;
+  GroundSamples groundSamples;
   Model terrainModel;
   char terrainModelPath[256];
   Model obstaclesModel;
@@ -167,6 +202,15 @@ typedef struct GameWorld {
   Model infoBoxMarkerModel;
 
   NavGrid navGrid;
+  NavHierarchy navHierarchy; // HPA* clusters over navGrid
+  NavMesh navMesh;           // polygon layer over navGrid, when the level asks
+  NavClearance navClearance; // distance to the nearest wall per navGrid cell
+  NavVisibility playerVis;   // navGrid cells the player can see
+  NavOccupancy navClaims;    // positions enemies have settled on
+  TacticalMap tactical;      // layered position scores for enemy AI
+  FlowField playerFlow; // cost-to-player field shared by chasing enemies
+  CrowdGrid crowd;
+  AiScheduler aiScheduler; // LOD buckets for enemy state machines
 
   Shader outlineShader;
   int outlineColorLoc;
@@ -202,7 +246,27 @@ static float LerpAngle(float from, float to, float t) {
   return from + difference * t;
 }
 
+// Terrain height at (x, z). Reads the streamed tiles when the level built
+// them and the dense map otherwise (headless cache-only loads).
+static inline float TerrainHeight(GameWorld *gw, float x, float z) {
+  if (gw->terrainTiles.tiles)
+    return TiledHeightMap_GetHeightCatmullRom(&gw->terrainTiles, x, z);
+  return HeightMap_GetHeightCatmullRom(&gw->terrainHeightMap, x, z);
+}
+
+static inline void TerrainHeightBatch(GameWorld *gw, const float *x,
+                                      const float *z, float *out, int n) {
+  if (gw->terrainTiles.tiles)
+    TiledHeightMap_SampleBatch(&gw->terrainTiles, x, z, out, n);
+  else
+    HeightMap_SampleBatch(&gw->terrainHeightMap, x, z, out, n);
+}
+
 void RunGameLoop(Engine *engine, GameWorld *game);
+// The parts of RunGameLoop's level states that need no window; the
+// headless runner drives a level through these alone.
+void LoadLevel(Engine *engine, GameWorld *game);
+void UpdateLevelFrame(Engine *engine, GameWorld *game, float dt);
 
 Engine EngineInit(void);
 void EngineShutdown(Engine *engine);
@@ -1,3 +1,4 @@
+#include "../engine/util/profiler.h"
 #include "components/muzzle.h"
 #include "editor.h"
 #include "game.h"
@@ -270,7 +271,7 @@ void EnemyBenchmarkSystem(world_t *world, GameWorld *game, float dt) {
 
       float x = GetRandomValue(-150, 150);
       float z = GetRandomValue(-150, 150);
-      float y = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap, x, z);
+      float y = TerrainHeight(game, x, z);
       SpawnEnemyGrunt(world, game, (Vector3){x, y, z});
     }
 
@@ -302,15 +303,219 @@ void EnemyBenchmarkSystem(world_t *world, GameWorld *game, float dt) {
   }
 }
 
+// One fixed simulation step of the level. Everything that moves entities or
+// advances gameplay timers lives here so results do not depend on frame rate.
+static void SimulateLevelTick(Engine *engine, GameWorld *game, float dt) {
+  world_t *world = engine->world;
+  PROF_BEGIN("SimulateLevelTick");
+
+  PROF_ZONE("TransformSnapshot",
+            TransformSnapshotSystem(world, &game->transformHistory));
+
+  PROF_ZONE("TerrainStream", TerrainStreamSystem(world, game));
+
+  PROF_ZONE("WaveSystem", WaveSystem_Update(world, game, dt));
+  PROF_ZONE("InfoBoxTrigger", InfoBoxTriggerSystem(world, game));
+  PROF_ZONE("TimerSystem", TimerSystem(&engine->timerPool, dt));
+
+  PROF_ZONE("ApplyGravity", ApplyGravity(world, game, dt));
+
+  PROF_ZONE("CollisionSync", CollisionSyncSystem(world));
+
+  PROF_ZONE("PlayerMoveAndCollide", PlayerMoveAndCollide(world, game, dt));
+
+  PROF_ZONE("SpatialIndex", SpatialIndexSystem(world, game));
+
+  // Deliver queued paths before state machines run
+  PROF_ZONE("PathQueueFlush", EnemyPathQueue_Flush(world, NAV_PATHS_PER_FRAME));
+  PROF_ZONE("NavDynamic", NavDynamicSystem(world, game));
+  PROF_ZONE("PlayerFlowField", PlayerFlowFieldSystem(world, game));
+  PROF_ZONE("PlayerVisibility", PlayerVisibilitySystem(world, game));
+  PROF_ZONE("TacticalMap", TacticalMapSystem(world, game));
+
+  AiScheduler_BeginTick(&game->aiScheduler);
+  PROF_ZONE("GruntAI",
+            EnemyGruntAISystem(world, game,
+                               WorldGetArchetype(world, game->enemyGruntArchId),
+                               dt));
+  PROF_ZONE("RangerAI",
+            EnemyRangerAISystem(world, game,
+                                WorldGetArchetype(world, game->enemyRangerArchId),
+                                dt));
+  PROF_ZONE("MeleeAI",
+            EnemyMeleeAISystem(world, game,
+                               WorldGetArchetype(world, game->enemyMeleeArchId),
+                               dt));
+  PROF_ZONE("DroneAI",
+            EnemyDroneAISystem(world, game,
+                               WorldGetArchetype(world, game->enemyDroneArchId),
+                               dt));
+  PROF_ZONE("OutOfBounds", OutOfBoundsSystem(world, game, dt));
+  PROF_ZONE("Crowd", CrowdSystem(world, game, dt));
+
+  PROF_ZONE("EnemyAim",
+            EnemyAimSystem(world, game,
+                           WorldGetArchetype(world, game->enemyGruntArchId), dt));
+  PROF_ZONE("RangerAim",
+            EnemyRangerAimSystem(world, game,
+                                 WorldGetArchetype(world, game->enemyRangerArchId),
+                                 dt));
+
+  PROF_ZONE("RangerFire",
+            EnemyRangerFireSystem(world, game,
+                                  WorldGetArchetype(world, game->enemyRangerArchId),
+                                  dt));
+  PROF_ZONE("EnemyFire",
+            EnemyFireSystem(world, game,
+                            WorldGetArchetype(world, game->enemyGruntArchId)));
+
+  PROF_BEGIN("Movement");
+  MovementSystem(world, WorldGetArchetype(world, game->enemyGruntArchId), dt);
+  MovementSystem(world, WorldGetArchetype(world, game->enemyRangerArchId), dt);
+  MovementSystem(world, WorldGetArchetype(world, game->enemyMeleeArchId), dt);
+  PROF_END();
+
+  PROF_ZONE("BulletSystem",
+            BulletSystem(world, game, WorldGetArchetype(world, game->bulletArchId),
+                         dt));
+
+  PROF_ZONE("ParticleSystem",
+            ParticleSystem(world, WorldGetArchetype(world, game->particleArchId),
+                           dt));
+  PROF_ZONE("CoolantSystem", CoolantSystem(world, game, dt));
+  PROF_ZONE("HealthOrbSystem", HealthOrbSystem(world, game, dt));
+  PROF_ZONE("TargetDummy", TargetDummySystem(world, game, dt));
+
+  PROF_BEGIN("Missiles");
+  MovementSystem(world, WorldGetArchetype(world, game->missileArchId), dt);
+  HomingMissileSystem(world, game,
+                      WorldGetArchetype(world, game->missileArchId), dt);
+  PROF_END();
+
+  PROF_END();
+}
+
+// Tears down the current level and spawns game->targetLevelPath.
+void LoadLevel(Engine *engine, GameWorld *game) {
+  world_t *world = engine->world;
+
+  EnemyPathQueue_Reset();
+  NavDynamic_Reset();
+  SpatialIndex_Reset();
+  HeightMap_Free(&game->terrainHeightMap);
+  TiledHeightMap_Free(&game->terrainTiles);
+  TerrainStream_Free(game);
+  GroundSamples_Free(game);
+  FlowField_Destroy(&game->playerFlow);
+  NavMesh_Destroy(&game->navMesh);
+  NavClearance_Destroy(&game->navClearance);
+  NavVisibility_Destroy(&game->playerVis);
+  TacticalMap_Destroy(&game->tactical);
+  NavOccupancy_Destroy(&game->navClaims);
+  NavHierarchy_Destroy(&game->navHierarchy);
+  NavGrid_Destroy(&game->navGrid);
+  CrowdGrid_Destroy(&game->crowd);
+  WorldClear(world);
+
+  PROF_ZONE("SpawnLevelFromFile",
+            SpawnLevelFromFile(world, game, game->targetLevelPath));
+  WaveSystem_Init(game);
+
+  TransformHistory_Clear(&game->transformHistory);
+  game->simAccumulator = 0.0f;
+  game->renderAlpha = 1.0f;
+
+  game->inputCooldown = 0.4f;
+  game->gameState = GAMESTATE_INLEVEL;
+}
+
+// One rendered frame of a level, short of drawing it: per-frame player
+// input, the fixed-step simulation ticks it owes, and the camera.
+void UpdateLevelFrame(Engine *engine, GameWorld *game, float dt) {
+  world_t  *world  = engine->world;
+  Camera3D *camera = &engine->camera;
+
+  camera->fovy = game->fov;
+  PROF_ZONE("SoundSystem",
+            UpdateSoundSystem(&game->soundSystem, world, game, dt));
+  PROF_ZONE("MessageSystem", MessageSystem_Update(&game->messageSystem, dt));
+
+  if (game->inputCooldown > 0.0f) game->inputCooldown -= dt;
+
+  // Input-driven player systems run once per rendered frame so edge
+  // triggered keys and mouse look are never dropped or repeated.
+  PROF_BEGIN("PlayerInput");
+  PlayerControlSystem(world, game, game->player, dt);
+
+  if (game->inputCooldown <= 0.0f) {
+    PlayerWeaponSystem(world, game, game->player, dt);
+    PlayerShootSystem(world, game, game->player, dt);
+    RocketLauncherSystem(world, game, game->player, camera, dt);
+    BlunderbussSystem(world, game, game->player, camera, dt);
+  }
+  PlayerWeaponSwitchSystem(world, game, game->player);
+  PROF_END();
+
+  float tickDt = 1.0f / (float)game->simTickRate;
+  game->simAccumulator += dt;
+
+  int ticks = 0;
+  while (game->simAccumulator >= tickDt &&
+         ticks < SIM_MAX_TICKS_PER_FRAME) {
+    SimulateLevelTick(engine, game, tickDt);
+    game->simAccumulator -= tickDt;
+    ticks++;
+  }
+  // Too far behind (hitch, breakpoint): drop the backlog, keep the phase
+  if (game->simAccumulator >= tickDt)
+    game->simAccumulator = fmodf(game->simAccumulator, tickDt);
+
+  game->renderAlpha = game->simAccumulator / tickDt;
+
+  Orientation *ori =
+      ECS_GET(world, game->player, Orientation, COMP_ORIENTATION);
+  Position *pos = ECS_GET(world, game->player, Position, COMP_POSITION);
+
+  // Position is blended between ticks; look direction is sampled per
+  // frame above so it is used as-is.
+  camera->position = TransformHistory_LerpPosition(
+      &game->transformHistory, game->player, pos->value,
+      game->renderAlpha);
+  // camera->position.y += PLAYER_HEIGHT;
+  camera->target =
+      Vector3Add(camera->position, (Vector3){
+                                       cosf(ori->pitch) * sinf(ori->yaw),
+                                       sinf(ori->pitch),
+                                       cosf(ori->pitch) * cosf(ori->yaw),
+                                   });
+  camera->up = (Vector3){0, 1, 0};
+
+  // Damage flash: trigger on health drop, fade out over ~0.8s
+  {
+    Health *ph = ECS_GET(world, game->player, Health, COMP_HEALTH);
+    if (ph) {
+      if (game->prevPlayerHealth < 0.0f)
+        game->prevPlayerHealth = ph->current;
+      if (ph->current < game->prevPlayerHealth)
+        game->damageFlash = 1.0f;
+      game->prevPlayerHealth = ph->current;
+    }
+    game->damageFlash -= dt * 1.25f;
+    if (game->damageFlash < 0.0f) game->damageFlash = 0.0f;
+  }
+}
+
 void RunGameLoop(Engine *engine, GameWorld *game) {
   world_t *world = engine->world;
   Camera3D *camera = &engine->camera;
   static EditorState editorState = {0};
 
   LevelHelper_SetGame(game);
+  Prof_SetThreadName("Main");
 
   while (!WindowShouldClose()) {
     float dt = GetFrameTime();
+    PROF_BEGIN("Frame");
 
     switch (game->gameState) {
 
@@ -333,16 +538,7 @@ void RunGameLoop(Engine *engine, GameWorld *game) {
                GetScreenHeight() / 2, 30, RAYWHITE);
       EndDrawing();
 
-      EnemyPathQueue_Reset();
-      HeightMap_Free(&game->terrainHeightMap);
-      NavGrid_Destroy(&game->navGrid);
-      WorldClear(world);
-
-      SpawnLevelFromFile(world, game, game->targetLevelPath);
-      WaveSystem_Init(game);
-
-      game->inputCooldown = 0.4f;
-      game->gameState = GAMESTATE_INLEVEL;
+      LoadLevel(engine, game);
       DisableCursor();
       break;
     } break;
@@ -363,102 +559,9 @@ void RunGameLoop(Engine *engine, GameWorld *game) {
     } break;
 
     case GAMESTATE_INLEVEL: {
-      camera->fovy = game->fov;
-      UpdateSoundSystem(&game->soundSystem, world, game, dt);
-      WaveSystem_Update(world, game, dt);
-      InfoBoxTriggerSystem(world, game);
-      MessageSystem_Update(&game->messageSystem, dt);
-      TimerSystem(&engine->timerPool, dt);
-
-      if (game->inputCooldown > 0.0f) game->inputCooldown -= dt;
+      UpdateLevelFrame(engine, game, dt);
 
-      PlayerControlSystem(world, game, game->player, dt);
-
-      ApplyGravity(world, game, dt);
-
-      if (game->inputCooldown <= 0.0f) {
-        PlayerWeaponSystem(world, game, game->player, dt);
-        PlayerShootSystem(world, game, game->player, dt);
-        RocketLauncherSystem(world, game, game->player, camera, dt);
-        BlunderbussSystem(world, game, game->player, camera, dt);
-      }
-      PlayerWeaponSwitchSystem(world, game, game->player);
-
-      CollisionSyncSystem(world);
-
-      PlayerMoveAndCollide(world, game, dt);
-
-      // Deliver queued paths before state machines run
-      EnemyPathQueue_Flush(world, NAV_PATHS_PER_FRAME);
-
-      EnemyGruntAISystem(world, game,
-                         WorldGetArchetype(world, game->enemyGruntArchId), dt);
-      EnemyRangerAISystem(world, game,
-                          WorldGetArchetype(world, game->enemyRangerArchId), dt);
-      EnemyMeleeAISystem(world, game,
-                         WorldGetArchetype(world, game->enemyMeleeArchId), dt);
-      EnemyDroneAISystem(world, game,
-                         WorldGetArchetype(world, game->enemyDroneArchId), dt);
-      OutOfBoundsSystem(world, game, dt);
-
-      EnemyAimSystem(world, game,
-                     WorldGetArchetype(world, game->enemyGruntArchId), dt);
-      EnemyRangerAimSystem(world, game,
-                           WorldGetArchetype(world, game->enemyRangerArchId), dt);
-
-      EnemyRangerFireSystem(
-          world, game, WorldGetArchetype(world, game->enemyRangerArchId), dt);
-      EnemyFireSystem(world, game,
-                      WorldGetArchetype(world, game->enemyGruntArchId));
-
-      MovementSystem(world, WorldGetArchetype(world, game->enemyGruntArchId),
-                     dt);
-      MovementSystem(world, WorldGetArchetype(world, game->enemyRangerArchId),
-                     dt);
-      MovementSystem(world, WorldGetArchetype(world, game->enemyMeleeArchId),
-                     dt);
-
-      BulletSystem(world, game, WorldGetArchetype(world, game->bulletArchId),
-                   dt);
-
-      ParticleSystem(world, WorldGetArchetype(world, game->particleArchId), dt);
-      CoolantSystem(world, game, dt);
-      HealthOrbSystem(world, game, dt);
-      TargetDummySystem(world, game, dt);
-
-      MovementSystem(world, WorldGetArchetype(world, game->missileArchId), dt);
-      HomingMissileSystem(world, game,
-                          WorldGetArchetype(world, game->missileArchId), dt);
-
-      Orientation *ori =
-          ECS_GET(world, game->player, Orientation, COMP_ORIENTATION);
-      Position *pos = ECS_GET(world, game->player, Position, COMP_POSITION);
-
-      camera->position = pos->value;
-      // camera->position.y += PLAYER_HEIGHT;
-      camera->target =
-          Vector3Add(camera->position, (Vector3){
-                                           cosf(ori->pitch) * sinf(ori->yaw),
-                                           sinf(ori->pitch),
-                                           cosf(ori->pitch) * cosf(ori->yaw),
-                                       });
-      camera->up = (Vector3){0, 1, 0};
-
-      // Damage flash: trigger on health drop, fade out over ~0.8s
-      {
-        Health *ph = ECS_GET(world, game->player, Health, COMP_HEALTH);
-        if (ph) {
-          if (game->prevPlayerHealth < 0.0f)
-            game->prevPlayerHealth = ph->current;
-          if (ph->current < game->prevPlayerHealth)
-            game->damageFlash = 1.0f;
-          game->prevPlayerHealth = ph->current;
-        }
-        game->damageFlash -= dt * 1.25f;
-        if (game->damageFlash < 0.0f) game->damageFlash = 0.0f;
-      }
-
-      RenderLevelSystem(world, game, camera);
+      PROF_ZONE("RenderLevel", RenderLevelSystem(world, game, camera));
 
       {
         Active *pa = ECS_GET(world, game->player, Active, COMP_ACTIVE);
@@ -471,6 +574,14 @@ void RunGameLoop(Engine *engine, GameWorld *game) {
       }
 
       if (IsKeyPressed(KEY_F12)) game->debugView = !game->debugView;
+      if (IsKeyPressed(KEY_F10)) game->profilerView = !game->profilerView;
+      if (IsKeyPressed(KEY_F11)) {
+        const char *tracePath = "profile_trace.json";
+        if (Prof_WriteChromeTrace(tracePath))
+          printf("Profiler: wrote %s\n", tracePath);
+        else
+          printf("Profiler: could not write %s\n", tracePath);
+      }
 
       if (IsKeyPressed(KEY_ESCAPE)) {
         game->gameState = GAMESTATE_PAUSED;
@@ -529,5 +640,8 @@ void RunGameLoop(Engine *engine, GameWorld *game) {
       }
     } break;
     }
+
+    PROF_END();
+    Prof_FrameEnd();
   }
 }
@@ -0,0 +1,43 @@
+#include "input.h"
+
+#ifndef GAME_HEADLESS
+
+bool    Input_KeyDown(int key)          { return IsKeyDown(key); }
+bool    Input_KeyPressed(int key)       { return IsKeyPressed(key); }
+bool    Input_MouseDown(int button)     { return IsMouseButtonDown(button); }
+bool    Input_MousePressed(int button)  { return IsMouseButtonPressed(button); }
+bool    Input_MouseReleased(int button) { return IsMouseButtonReleased(button); }
+Vector2 Input_MouseDelta(void)          { return GetMouseDelta(); }
+
+#else
+
+static InputFrame s_cur;
+static InputFrame s_prev;
+
+void Input_Push(const InputFrame *frame) {
+  s_prev = s_cur;
+  s_cur  = *frame;
+}
+
+static bool KeyIn(const InputFrame *f, int key) {
+  return key >= 0 && key < INPUT_MAX_KEYS && f->keys[key];
+}
+
+static bool ButtonIn(const InputFrame *f, int button) {
+  return button >= 0 && button < INPUT_MAX_BUTTONS && f->buttons[button];
+}
+
+bool Input_KeyDown(int key) { return KeyIn(&s_cur, key); }
+bool Input_KeyPressed(int key) {
+  return KeyIn(&s_cur, key) && !KeyIn(&s_prev, key);
+}
+bool Input_MouseDown(int button) { return ButtonIn(&s_cur, button); }
+bool Input_MousePressed(int button) {
+  return ButtonIn(&s_cur, button) && !ButtonIn(&s_prev, button);
+}
+bool Input_MouseReleased(int button) {
+  return !ButtonIn(&s_cur, button) && ButtonIn(&s_prev, button);
+}
+Vector2 Input_MouseDelta(void) { return s_cur.mouseDelta; }
+
+#endif
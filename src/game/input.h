@@ -0,0 +1,29 @@
+#pragma once
+#include "raylib.h"
+#include <stdbool.h>
+
+// Player input as the gameplay systems read it. The windowed build forwards
+// straight to raylib. GAME_HEADLESS builds have no window to poll, so the
+// headless runner pushes one InputFrame per frame instead.
+
+#define INPUT_MAX_KEYS    400 // above every raylib KeyboardKey
+#define INPUT_MAX_BUTTONS (MOUSE_BUTTON_BACK + 1)
+
+typedef struct {
+  bool    keys[INPUT_MAX_KEYS];
+  bool    buttons[INPUT_MAX_BUTTONS];
+  Vector2 mouseDelta;
+} InputFrame;
+
+bool    Input_KeyDown(int key);
+bool    Input_KeyPressed(int key);
+bool    Input_MouseDown(int button);
+bool    Input_MousePressed(int button);
+bool    Input_MouseReleased(int button);
+Vector2 Input_MouseDelta(void);
+
+#ifdef GAME_HEADLESS
+// Makes frame current. Pressed/released edges compare it with the frame
+// pushed before.
+void Input_Push(const InputFrame *frame);
+#endif
@@ -1,5 +1,6 @@
 
 #include "level_creater_helper.h"
+#include "assets.h"
 #include "components/components.h"
 #include "components/muzzle.h"
 #include "components/renderable.h"
@@ -191,7 +192,7 @@ entity_t SpawnPlayer(world_t *world, GameWorld *gw, Vector3 position) {
 
   ModelCollectionInit(mc, 2);
 
-  Model playerBody = LoadModelFromMesh(GenMeshCube(.05f, .05f, .05f));
+  Model playerBody = Assets_CubeModel(.05f, .05f, .05f);
 
   ModelCollectionInit(mc, 5); // body + 4 guns
 
@@ -347,8 +348,7 @@ entity_t SpawnEnemyGrunt(world_t *world, GameWorld *game, Vector3 position) {
 
   entity_t e = WorldCreateEntity(world, &arch->mask);
 
-  position.y = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                             position.x, position.z);
+  position.y = TerrainHeight(game, position.x, position.z);
 
   /* -------- Basic State -------- */
 
@@ -463,8 +463,7 @@ entity_t SpawnEnemyRanger(world_t *world, GameWorld *game, Vector3 position) {
   archetype_t *arch = WorldGetArchetype(world, game->enemyRangerArchId);
   entity_t e = WorldCreateEntity(world, &arch->mask);
 
-  position.y = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                             position.x, position.z);
+  position.y = TerrainHeight(game, position.x, position.z);
 
   ECS_GET(world, e, Position, COMP_POSITION)->value = position;
   ECS_GET(world, e, Active, COMP_ACTIVE)->value = true;
@@ -673,10 +672,7 @@ entity_t SpawnTrigger(world_t *world, uint32_t triggerArchId, Vector3 position,
   ci->layerMask = 1 << LAYER_TRIGGER; // define if needed
   ci->collideMask = 0xFFFFFFFF;       // detect everything
 
-  Position *pos = ECS_GET(world, e, Position, COMP_POSITION);
-
-  ci->worldBounds.min = Vector3Subtract(pos->value, aabb->halfExtents);
-  ci->worldBounds.max = Vector3Add(pos->value, aabb->halfExtents);
+  CollisionMarkStatic(world, e);
 
   OnCollision *oc = ECS_GET(world, e, OnCollision, COMP_ONCOLLISION);
 
@@ -741,11 +737,7 @@ entity_t SpawnBoxModel(world_t *world, GameWorld *gw, Vector3 position,
   ci->layerMask = 1 << LAYER_WORLD;
   ci->collideMask = (1 << LAYER_PLAYER) | (1 << LAYER_BULLET);
 
-  Position *pos = ECS_GET(world, e, Position, COMP_POSITION);
-
-  ci->worldBounds.min = Vector3Subtract(pos->value, aabb->halfExtents);
-  ci->worldBounds.max = Vector3Add(pos->value, aabb->halfExtents);
-  Collision_UpdateAABB(ci, aabb, position);
+  CollisionMarkStatic(world, e);
   return e;
 }
 
@@ -914,7 +906,7 @@ entity_t SpawnWallSegment(world_t *world, GameWorld *gw, Vector3 position,
   if (blockPlayer)      ci->collideMask |= 1 << LAYER_PLAYER;
   if (blockProjectiles) ci->collideMask |= 1 << LAYER_BULLET;
 
-  Collision_UpdateWallSegment(ci, wall, position);
+  CollisionMarkStatic(world, e);
 
   return e;
 }
@@ -947,8 +939,7 @@ entity_t SpawnEnemyMelee(world_t *world, GameWorld *game, Vector3 position) {
   archetype_t *arch = WorldGetArchetype(world, game->enemyMeleeArchId);
   entity_t e = WorldCreateEntity(world, &arch->mask);
 
-  position.y = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                             position.x, position.z);
+  position.y = TerrainHeight(game, position.x, position.z);
 
   ECS_GET(world, e, Active, COMP_ACTIVE)->value = true;
   ECS_GET(world, e, Position, COMP_POSITION)->value = position;
@@ -1072,8 +1063,7 @@ entity_t SpawnEnemyDrone(world_t *world, GameWorld *game, Vector3 position) {
   archetype_t *arch = WorldGetArchetype(world, game->enemyDroneArchId);
   entity_t e = WorldCreateEntity(world, &arch->mask);
 
-  position.y = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                             position.x, position.z) + 3.0f;
+  position.y = TerrainHeight(game, position.x, position.z) + 3.0f;
 
   ECS_GET(world, e, Active,    COMP_ACTIVE)->value    = true;
   ECS_GET(world, e, Position,  COMP_POSITION)->value  = position;
@@ -1145,8 +1135,7 @@ static void Target_OnDeath(world_t *world, entity_t entity) {
 
 static void SpawnTargetCommon(world_t *world, GameWorld *game, entity_t e,
                               Vector3 position, float health, float shield, float yaw) {
-  position.y = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                             position.x, position.z);
+  position.y = TerrainHeight(game, position.x, position.z);
 
   ECS_GET(world, e, Active,      COMP_ACTIVE)->value      = true;
   ECS_GET(world, e, Position,    COMP_POSITION)->value    = position;
@@ -1206,6 +1195,7 @@ entity_t SpawnTargetStatic(world_t *world, GameWorld *game, Vector3 position,
   archetype_t *arch = WorldGetArchetype(world, game->targetStaticArchId);
   entity_t e = WorldCreateEntity(world, &arch->mask);
   SpawnTargetCommon(world, game, e, position, health, shield, yaw);
+  CollisionMarkStatic(world, e);
   TargetDummy *td = ECS_GET(world, e, TargetDummy, COMP_TARGET_DUMMY);
   td->healthDropCount  = healthDropCount;
   td->coolantDropCount = coolantDropCount;
@@ -1219,8 +1209,8 @@ entity_t SpawnTargetPatrol(world_t *world, GameWorld *game,
   archetype_t *arch = WorldGetArchetype(world, game->targetPatrolArchId);
   entity_t e = WorldCreateEntity(world, &arch->mask);
 
-  posA.y = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap, posA.x, posA.z);
-  posB.y = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap, posB.x, posB.z);
+  posA.y = TerrainHeight(game, posA.x, posA.z);
+  posB.y = TerrainHeight(game, posB.x, posB.z);
 
   SpawnTargetCommon(world, game, e, posA, health, shield, yaw);
 
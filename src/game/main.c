@@ -54,14 +54,21 @@ static Vector3 ResolveModelRotation(const Orientation *entityOri,
 
 /* ================= Main ================= */
 
+// GameHeadless has its own entry point in src/headless.
+#ifndef GAME_HEADLESS
 int main(void) {
 
 
   Engine engine = EngineInit();
   SetupComponentRegistry(&engine.componentRegistry, &engine);
   GameWorld game = GameWorldCreate(&engine, engine.world);
+  PathService_Start(0);
   EnableCursor();
   RunGameLoop(&engine, &game);
+  PathService_Stop();
+  SpatialIndex_Reset();
+  TransformHistory_Free(&game.transformHistory);
   EngineShutdown(&engine);
   return 0;
 }
+#endif
@@ -0,0 +1,227 @@
+#include "flow_field.h"
+#include "nav_clearance.h"
+#include <string.h>
+
+static const int s_dirs[8][2] = {{1,0},{-1,0},{0,1},{0,-1},{1,1},{-1,1},{1,-1},{-1,-1}};
+
+static void LayerInit(FlowLayer *layer, const NavGrid *grid) {
+  layer->width  = grid->width;
+  layer->height = grid->height;
+  layer->goalX  = -1;
+  layer->goalY  = -1;
+  layer->cost   = malloc(sizeof(uint32_t) * grid->width * grid->height);
+}
+
+void FlowField_Init(FlowField *ff, const NavGrid *grid) {
+  memset(ff, 0, sizeof(*ff));
+  LayerInit(&ff->ready, grid);
+  LayerInit(&ff->building, grid);
+}
+
+void FlowField_Destroy(FlowField *ff) {
+  free(ff->ready.cost);
+  free(ff->building.cost);
+  free(ff->heap);
+  memset(ff, 0, sizeof(*ff));
+}
+
+/* ------------------------------------------------------------------ */
+/*  Open set (binary min-heap, stale entries skipped on pop)          */
+/* ------------------------------------------------------------------ */
+
+static void HeapPush(FlowField *ff, uint32_t cost, int cell) {
+  if (ff->heapSize >= ff->heapCap) {
+    ff->heapCap = ff->heapCap ? ff->heapCap * 2 : 1024;
+    ff->heap    = realloc(ff->heap, sizeof(FlowHeapEntry) * ff->heapCap);
+  }
+  int pos = ff->heapSize++;
+  while (pos > 0) {
+    int parent = (pos - 1) / 2;
+    if (ff->heap[parent].cost <= cost) break;
+    ff->heap[pos] = ff->heap[parent];
+    pos = parent;
+  }
+  ff->heap[pos] = (FlowHeapEntry){cost, cell};
+}
+
+static FlowHeapEntry HeapPop(FlowField *ff) {
+  FlowHeapEntry top  = ff->heap[0];
+  FlowHeapEntry last = ff->heap[--ff->heapSize];
+  int pos = 0;
+  while (true) {
+    int child = 2 * pos + 1;
+    if (child >= ff->heapSize) break;
+    if (child + 1 < ff->heapSize &&
+        ff->heap[child + 1].cost < ff->heap[child].cost)
+      child++;
+    if (last.cost <= ff->heap[child].cost) break;
+    ff->heap[pos] = ff->heap[child];
+    pos = child;
+  }
+  if (ff->heapSize > 0) ff->heap[pos] = last;
+  return top;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Integration                                                       */
+/* ------------------------------------------------------------------ */
+
+static inline bool Walkable(const NavGrid *grid, int idx) {
+  NavCellType t = grid->cells[idx].type;
+  return t != NAV_CELL_WALL && t != NAV_CELL_BLOCKED && t != NAV_CELL_FENCE;
+}
+
+// Walkable and wide enough for the agents the layer was integrated for.
+// The goal cell is exempt from the clearance requirement, as in A*.
+static inline bool Passable(const FlowLayer *layer, const NavGrid *grid,
+                            int idx) {
+  if (!Walkable(grid, idx)) return false;
+  return !layer->minClearance || !grid->clearance ||
+         grid->clearance->dist2[idx] >= layer->minClearance ||
+         idx == layer->goalY * grid->width + layer->goalX;
+}
+
+static void StartBuild(FlowField *ff, NavGrid *grid, int gx, int gy,
+                       Vector3 goal) {
+  FlowLayer *b = &ff->building;
+  for (int i = 0; i < b->width * b->height; i++) b->cost[i] = FLOW_UNREACHED;
+  b->goalX        = gx;
+  b->goalY        = gy;
+  b->goalPos      = goal;
+  b->minClearance = ff->minClearance;
+
+  int goalIdx      = NavGrid_Index(grid, gx, gy);
+  b->cost[goalIdx] = 0;
+  ff->heapSize     = 0;
+  if (Walkable(grid, goalIdx)) HeapPush(ff, 0, goalIdx);
+  ff->isBuilding = true;
+}
+
+void FlowField_SetGoal(FlowField *ff, NavGrid *grid, Vector3 goal) {
+  int gx, gy;
+  if (!NavGrid_WorldToCell(grid, goal, &gx, &gy)) return;
+
+  if (ff->hasReady && ff->ready.goalX == gx && ff->ready.goalY == gy &&
+      !ff->readyStale) {
+    ff->ready.goalPos = goal;
+    ff->isBuilding    = false; // player stepped back before the rebuild ended
+    return;
+  }
+  if (ff->isBuilding && ff->building.goalX == gx && ff->building.goalY == gy) {
+    ff->building.goalPos = goal;
+    return;
+  }
+  StartBuild(ff, grid, gx, gy, goal);
+}
+
+void FlowField_Invalidate(FlowField *ff, NavGrid *grid) {
+  const FlowLayer *cur = ff->isBuilding ? &ff->building : &ff->ready;
+  if (!ff->isBuilding && !ff->hasReady) return;
+  ff->readyStale = ff->hasReady;
+  StartBuild(ff, grid, cur->goalX, cur->goalY, cur->goalPos);
+}
+
+void FlowField_SetClearance(FlowField *ff, NavGrid *grid, uint16_t minClearance) {
+  if (ff->minClearance == minClearance) return;
+  ff->minClearance = minClearance;
+  FlowField_Invalidate(ff, grid);
+}
+
+bool FlowField_Step(FlowField *ff, NavGrid *grid, int budget) {
+  if (!ff->isBuilding) return false;
+
+  FlowLayer *b = &ff->building;
+  int expanded = 0;
+  while (ff->heapSize > 0 && expanded < budget) {
+    FlowHeapEntry top = HeapPop(ff);
+    if (top.cost > b->cost[top.cell]) continue; // superseded entry
+    expanded++;
+
+    int cx = top.cell % grid->width;
+    int cy = top.cell / grid->width;
+    // Cost of stepping from a neighbour into this cell, as in A*
+    uint32_t enter = grid->cells[top.cell].cost;
+
+    for (int i = 0; i < 8; i++) {
+      int nx = cx + s_dirs[i][0];
+      int ny = cy + s_dirs[i][1];
+      if (!NavGrid_InBounds(grid, nx, ny)) continue;
+
+      int nIdx = NavGrid_Index(grid, nx, ny);
+      bool diagonal = s_dirs[i][0] != 0 && s_dirs[i][1] != 0;
+      if (diagonal && (!Passable(b, grid, NavGrid_Index(grid, nx, cy)) ||
+                       !Passable(b, grid, NavGrid_Index(grid, cx, ny))))
+        continue;
+
+      uint32_t c = top.cost + (diagonal ? 14u : 10u) + enter;
+      if (c < b->cost[nIdx]) {
+        b->cost[nIdx] = c;
+        // A* may start inside a blocked or narrow cell but never enters
+        // one, so those get a cost but are never expanded through
+        if (Passable(b, grid, nIdx)) HeapPush(ff, c, nIdx);
+      }
+    }
+  }
+
+  if (ff->heapSize > 0) return false;
+
+  // Publish: the finished layer becomes the steering field
+  FlowLayer tmp = ff->ready;
+  ff->ready      = *b;
+  *b             = tmp;
+  ff->hasReady   = true;
+  ff->readyStale = false;
+  ff->isBuilding = false;
+  return true;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Steering                                                          */
+/* ------------------------------------------------------------------ */
+
+bool FlowField_Direction(const FlowField *ff, NavGrid *grid, Vector3 pos,
+                         Vector3 *outDir) {
+  if (!ff->hasReady) return false;
+
+  const FlowLayer *r = &ff->ready;
+  int cx, cy;
+  if (!NavGrid_WorldToCell(grid, pos, &cx, &cy)) return false;
+
+  int idx = NavGrid_Index(grid, cx, cy);
+  if (r->cost[idx] == FLOW_UNREACHED) return false;
+
+  Vector3 target;
+  if (cx == r->goalX && cy == r->goalY) {
+    target = r->goalPos;
+  } else {
+    uint32_t best    = r->cost[idx];
+    int      bestIdx = -1;
+    bool     escaping = !Passable(r, grid, idx); // pushed into a blocked cell
+    for (int i = 0; i < 8; i++) {
+      int nx = cx + s_dirs[i][0];
+      int ny = cy + s_dirs[i][1];
+      if (!NavGrid_InBounds(grid, nx, ny)) continue;
+
+      int nIdx = NavGrid_Index(grid, nx, ny);
+      if (r->cost[nIdx] >= best || !Passable(r, grid, nIdx)) continue;
+
+      // Don't cut corners the integration couldn't
+      bool diagonal = s_dirs[i][0] != 0 && s_dirs[i][1] != 0;
+      if (diagonal && !escaping && (!Passable(r, grid, NavGrid_Index(grid, nx, cy)) ||
+                       !Passable(r, grid, NavGrid_Index(grid, cx, ny))))
+        continue;
+
+      best    = r->cost[nIdx];
+      bestIdx = nIdx;
+    }
+    if (bestIdx < 0) return false;
+    target = NavGrid_CellCenter(grid, bestIdx % grid->width,
+                                bestIdx / grid->width);
+  }
+
+  Vector3 d = {target.x - pos.x, 0.0f, target.z - pos.z};
+  float len = sqrtf(d.x * d.x + d.z * d.z);
+  if (len < 1e-4f) return false;
+  *outDir = (Vector3){d.x / len, 0.0f, d.z / len};
+  return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "nav.h"
+
+// Cost-to-goal field over a NavGrid, shared by every agent heading to the
+// same goal. Integration is a reverse Dijkstra with the same move costs as
+// NavGrid_FindPath, spread across frames via FlowField_Step. Steering keeps
+// using the last completed field until the new one finishes. With a
+// clearance requirement set, cells narrower than the agents are treated
+// like walls, as in NavGrid_FindPathRadius.
+
+#define FLOW_UNREACHED UINT32_MAX
+
+typedef struct {
+  uint32_t cost;
+  int32_t  cell;
+} FlowHeapEntry;
+
+typedef struct {
+  int       width;
+  int       height;
+  int       goalX, goalY;
+  Vector3   goalPos;
+  uint16_t  minClearance; // requirement the layer was integrated with
+  uint32_t *cost;         // integrated cost per cell
+} FlowLayer;
+
+typedef struct {
+  FlowLayer ready;    // last completed field; valid when hasReady
+  FlowLayer building; // field being integrated; valid when isBuilding
+  bool      hasReady;
+  bool      readyStale; // grid changed since ready was integrated
+  bool      isBuilding;
+  uint16_t  minClearance; // NavClearance dist2 a cell needs; 0 for any
+
+  FlowHeapEntry *heap; // open set with lazy deletion
+  int            heapSize;
+  int            heapCap;
+} FlowField;
+
+void FlowField_Init(FlowField *ff, const NavGrid *grid);
+void FlowField_Destroy(FlowField *ff);
+
+// Starts a rebuild when goal moves to a different cell than the current
+// (or in-progress) field's goal.
+void FlowField_SetGoal(FlowField *ff, NavGrid *grid, Vector3 goal);
+// Restarts integration toward the current goal after grid cells change.
+// Steering keeps the old field until the rebuild completes.
+void FlowField_Invalidate(FlowField *ff, NavGrid *grid);
+// Sets the clearance (a NavClearance_Required value) agents following the
+// field need, rebuilding it when that changes. Ignored without a clearance
+// field on the grid.
+void FlowField_SetClearance(FlowField *ff, NavGrid *grid, uint16_t minClearance);
+// Runs at most budget node expansions. Returns true once a rebuild completes.
+bool FlowField_Step(FlowField *ff, NavGrid *grid, int budget);
+
+// Unit XZ direction to steer from pos, toward the cheapest neighbouring
+// cell or, inside the goal cell, the goal itself. False if pos is off the
+// grid, unreachable, or no field has completed yet.
+bool FlowField_Direction(const FlowField *ff, NavGrid *grid, Vector3 pos,
+                         Vector3 *outDir);
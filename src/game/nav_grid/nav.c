@@ -1,20 +1,38 @@
 #include "nav.h"
+#include "../../engine/util/profiler.h"
+#include "nav_clearance.h"
+#include "nav_hierarchy.h"
+#include "nav_mesh.h"
 #include <string.h>
 
 void NavGrid_Init(NavGrid *grid, int width, int height, float cellSize,
                   Vector3 origin) {
-  grid->width    = width;
-  grid->height   = height;
-  grid->cellSize = cellSize;
-  grid->origin   = origin;
-  grid->cells    = malloc(sizeof(NavCell) * width * height);
+  grid->width       = width;
+  grid->height      = height;
+  grid->cellSize    = cellSize;
+  grid->origin      = origin;
+  grid->cells       = malloc(sizeof(NavCell) * width * height);
+  grid->hierarchy   = NULL;
+  grid->mesh        = NULL;
+  grid->clearance   = NULL;
+  grid->occupancy   = NULL;
+  grid->searchMode  = NAV_SEARCH_JPS;
+  grid->jumpFlags   = malloc(width * height);
+  grid->revision    = 0;
+  grid->bakedRadius = 0.0f;
   for (int i = 0; i < width * height; i++) {
     grid->cells[i].type = NAV_CELL_EMPTY;
     grid->cells[i].cost = 1;
+    grid->jumpFlags[i]  = 1;
   }
 }
 
-void NavGrid_Destroy(NavGrid *grid) { free(grid->cells); }
+void NavGrid_Destroy(NavGrid *grid) {
+  free(grid->cells);
+  free(grid->jumpFlags);
+  grid->cells     = NULL;
+  grid->jumpFlags = NULL;
+}
 
 bool NavGrid_WorldToCell(NavGrid *g, Vector3 worldPos, int *outX, int *outY) {
   float localX = worldPos.x - g->origin.x;
@@ -32,18 +50,79 @@ Vector3 NavGrid_CellCenter(NavGrid *g, int x, int y) {
                    g->origin.z + y * g->cellSize + g->cellSize * 0.5f};
 }
 
+static inline bool CellWalkable(const NavGrid *grid, int idx) {
+  NavCellType t = grid->cells[idx].type;
+  return t != NAV_CELL_WALL && t != NAV_CELL_BLOCKED && t != NAV_CELL_FENCE;
+}
+
+// A cell is flat when it and every walkable neighbour cost 1, so jump point
+// pruning is exact around it. Weighted cells and their rims are expanded
+// cell by cell instead.
+static void RefreshJumpFlag(NavGrid *g, int x, int y) {
+  if (!NavGrid_InBounds(g, x, y)) return;
+  bool flat = true;
+  for (int ny = y - 1; ny <= y + 1 && flat; ny++) {
+    for (int nx = x - 1; nx <= x + 1; nx++) {
+      if (!NavGrid_InBounds(g, nx, ny)) continue;
+      int i = NavGrid_Index(g, nx, ny);
+      if (CellWalkable(g, i) && g->cells[i].cost != 1) { flat = false; break; }
+    }
+  }
+  int idx = NavGrid_Index(g, x, y);
+  g->jumpFlags[idx] = flat && CellWalkable(g, idx);
+}
+
+uint8_t NavGrid_TypeCost(NavCellType type) {
+  switch (type) {
+  case NAV_CELL_WALL:
+  case NAV_CELL_BLOCKED:
+  case NAV_CELL_FENCE:      return 255;
+  case NAV_CELL_COVER_LOW:  return 2;
+  case NAV_CELL_COVER_HIGH: return 3;
+  case NAV_CELL_SNIPE:      return 2;
+  case NAV_CELL_FLANK:      return 2;
+  default:                  return 1;
+  }
+}
+
 void NavGrid_SetCell(NavGrid *g, int x, int y, NavCellType type) {
   if (!NavGrid_InBounds(g, x, y)) return;
   int idx = NavGrid_Index(g, x, y);
   g->cells[idx].type = type;
-  if (type == NAV_CELL_WALL || type == NAV_CELL_FENCE) g->cells[idx].cost = 255;
+  g->cells[idx].cost = NavGrid_TypeCost(type);
+  g->revision++;
+  for (int ny = y - 1; ny <= y + 1; ny++)
+    for (int nx = x - 1; nx <= x + 1; nx++) RefreshJumpFlag(g, nx, ny);
+  if (g->hierarchy) NavHierarchy_CellChanged(g->hierarchy, x, y);
+  if (g->mesh) g->mesh->dirty = true;
+  if (g->clearance) NavClearance_CellChanged(g->clearance, x, y);
+}
+
+void NavGrid_EndEdits(NavGrid *g) {
+  if (g->mesh && g->mesh->dirty) NavMesh_Build(g->mesh, g);
+}
+
+void NavGrid_RefreshJumpFlags(NavGrid *g) {
+  for (int y = 0; y < g->height; y++)
+    for (int x = 0; x < g->width; x++) RefreshJumpFlag(g, x, y);
 }
 
 void NavPath_Init(NavPath *path, int initialCapacity) {
   path->count        = 0;
   path->capacity     = initialCapacity;
   path->points       = malloc(sizeof(Vector3) * initialCapacity);
+  path->remaining    = malloc(sizeof(float) * initialCapacity);
   path->currentIndex = 0;
+  path->revision     = 0;
+}
+
+void NavPath_Reserve(NavPath *path, int capacity) {
+  if (capacity <= path->capacity && path->points && path->remaining) return;
+  int cap = path->capacity > 0 ? path->capacity : 16;
+  while (cap < capacity) cap *= 2;
+  path->points    = realloc(path->points,    sizeof(Vector3) * cap);
+  path->remaining = realloc(path->remaining, sizeof(float)   * cap);
+  path->capacity  = cap;
 }
 
 void NavPath_Clear(NavPath *path) {
@@ -53,21 +132,64 @@ void NavPath_Clear(NavPath *path) {
 
 void NavPath_Destroy(NavPath *path) {
   free(path->points);
+  free(path->remaining);
   path->points       = NULL;
+  path->remaining    = NULL;
   path->capacity     = 0;
   path->count        = 0;
   path->currentIndex = 0;
 }
 
 /* ------------------------------------------------------------------ */
-/*  A* — static buffers (no per-call malloc)                          */
+/*  A* search context                                                 */
 /* ------------------------------------------------------------------ */
 
-#define NAV_MAX_CELLS (180 * 180)
+#define NAV_UNREACHED 0x3fffffff
 
-static AStarNode s_nodes[NAV_MAX_CELLS];
-static int       s_heap[NAV_MAX_CELLS]; // stores node indices
-static int       s_heapSize;
+void NavSearch_Init(NavSearchContext *ctx, int cellCount) {
+  memset(ctx, 0, sizeof(*ctx));
+  NavSearch_Reserve(ctx, cellCount);
+}
+
+void NavSearch_Destroy(NavSearchContext *ctx) {
+  free(ctx->nodes);
+  free(ctx->stamps);
+  free(ctx->heap);
+  memset(ctx, 0, sizeof(*ctx));
+}
+
+void NavSearch_Reserve(NavSearchContext *ctx, int cellCount) {
+  if (cellCount <= ctx->capacity) return;
+  ctx->nodes    = realloc(ctx->nodes,  sizeof(AStarNode)    * cellCount);
+  ctx->heap     = realloc(ctx->heap,   sizeof(NavHeapEntry) * cellCount);
+  ctx->stamps   = realloc(ctx->stamps, sizeof(uint32_t)     * cellCount);
+  // New stamps must never match a live generation
+  memset(ctx->stamps + ctx->capacity, 0,
+         sizeof(uint32_t) * (cellCount - ctx->capacity));
+  ctx->capacity = cellCount;
+}
+
+// O(1) reset: bump the generation so every stamp goes stale.
+static void SearchBegin(NavSearchContext *ctx) {
+  ctx->heapSize = 0;
+  ctx->expanded = 0;
+  if (++ctx->generation == 0) {
+    memset(ctx->stamps, 0, sizeof(uint32_t) * ctx->capacity);
+    ctx->generation = 1;
+  }
+}
+
+// Returns the node, initialising it on first touch this search.
+static inline AStarNode *SearchNode(NavSearchContext *ctx, int idx) {
+  AStarNode *n = &ctx->nodes[idx];
+  if (ctx->stamps[idx] != ctx->generation) {
+    ctx->stamps[idx] = ctx->generation;
+    n->gCost     = NAV_UNREACHED;
+    n->parent    = -1;
+    n->heapIndex = NAV_NODE_UNVISITED;
+  }
+  return n;
+}
 
 static inline int Heuristic(int x1, int y1, int x2, int y2) {
   int dx = abs(x1 - x2);
@@ -77,70 +199,120 @@ static inline int Heuristic(int x1, int y1, int x2, int y2) {
 
 /* Binary min-heap (keyed on fCost, break ties with hCost) */
 
-static inline bool HeapLess(int a, int b) {
-  if (s_nodes[a].fCost != s_nodes[b].fCost)
-    return s_nodes[a].fCost < s_nodes[b].fCost;
-  return s_nodes[a].hCost < s_nodes[b].hCost;
+static inline bool HeapLess(const NavHeapEntry *a, const NavHeapEntry *b) {
+  if (a->fCost != b->fCost) return a->fCost < b->fCost;
+  return a->hCost < b->hCost;
+}
+
+static inline void HeapPlace(NavSearchContext *ctx, int pos, NavHeapEntry e) {
+  ctx->heap[pos]                = e;
+  ctx->nodes[e.node].heapIndex  = pos;
 }
 
-static void HeapSiftUp(int pos) {
+static void HeapSiftUp(NavSearchContext *ctx, int pos) {
+  NavHeapEntry e = ctx->heap[pos];
   while (pos > 0) {
     int parent = (pos - 1) / 2;
-    if (HeapLess(s_heap[pos], s_heap[parent])) {
-      int tmp       = s_heap[pos];
-      s_heap[pos]   = s_heap[parent];
-      s_heap[parent]= tmp;
-      s_nodes[s_heap[pos]].heapIndex    = pos;
-      s_nodes[s_heap[parent]].heapIndex = parent;
-      pos = parent;
-    } else break;
+    if (!HeapLess(&e, &ctx->heap[parent])) break;
+    HeapPlace(ctx, pos, ctx->heap[parent]);
+    pos = parent;
   }
+  HeapPlace(ctx, pos, e);
 }
 
-static void HeapSiftDown(int pos) {
+static void HeapSiftDown(NavSearchContext *ctx, int pos) {
+  NavHeapEntry e = ctx->heap[pos];
   while (true) {
     int left  = 2 * pos + 1;
     int right = 2 * pos + 2;
-    int best  = pos;
-    if (left  < s_heapSize && HeapLess(s_heap[left],  s_heap[best])) best = left;
-    if (right < s_heapSize && HeapLess(s_heap[right], s_heap[best])) best = right;
-    if (best == pos) break;
-    int tmp        = s_heap[pos];
-    s_heap[pos]    = s_heap[best];
-    s_heap[best]   = tmp;
-    s_nodes[s_heap[pos]].heapIndex  = pos;
-    s_nodes[s_heap[best]].heapIndex = best;
+    int best  = -1;
+    const NavHeapEntry *bestE = &e;
+    if (left  < ctx->heapSize && HeapLess(&ctx->heap[left],  bestE)) { best = left;  bestE = &ctx->heap[left]; }
+    if (right < ctx->heapSize && HeapLess(&ctx->heap[right], bestE)) { best = right; }
+    if (best < 0) break;
+    HeapPlace(ctx, pos, ctx->heap[best]);
     pos = best;
   }
+  HeapPlace(ctx, pos, e);
 }
 
-static void HeapPush(int nodeIdx) {
-  s_heap[s_heapSize]               = nodeIdx;
-  s_nodes[nodeIdx].heapIndex       = s_heapSize;
-  s_heapSize++;
-  HeapSiftUp(s_heapSize - 1);
+static void HeapPush(NavSearchContext *ctx, int node, int fCost, int hCost) {
+  int pos = ctx->heapSize++;
+  ctx->heap[pos] = (NavHeapEntry){fCost, hCost, node};
+  HeapSiftUp(ctx, pos);
 }
 
-static int HeapPop(void) {
-  int top = s_heap[0];
-  s_heapSize--;
-  if (s_heapSize > 0) {
-    s_heap[0]                         = s_heap[s_heapSize];
-    s_nodes[s_heap[0]].heapIndex      = 0;
-    HeapSiftDown(0);
+static int HeapPop(NavSearchContext *ctx) {
+  int top = ctx->heap[0].node;
+  ctx->heapSize--;
+  if (ctx->heapSize > 0) {
+    ctx->heap[0] = ctx->heap[ctx->heapSize];
+    HeapSiftDown(ctx, 0);
   }
-  s_nodes[top].heapIndex = -1;
+  ctx->nodes[top].heapIndex = NAV_NODE_CLOSED;
   return top;
 }
 
-// Call after updating node's fCost downward.
-static void HeapDecrease(int nodeIdx) {
-  int pos = s_nodes[nodeIdx].heapIndex;
-  if (pos >= 0) HeapSiftUp(pos);
+// Call after lowering a queued node's gCost.
+static void HeapDecrease(NavSearchContext *ctx, int node, int fCost) {
+  int pos = ctx->nodes[node].heapIndex;
+  ctx->heap[pos].fCost = fCost;
+  HeapSiftUp(ctx, pos);
 }
 
-bool NavGrid_FindPath(NavGrid *grid, Vector3 startWorld, Vector3 goalWorld,
+// Writes the parent chain ending at goalIndex to outPath as [start ... goal].
+static bool BuildPath(NavGrid *grid, NavSearchContext *ctx, int goalIndex,
                       NavPath *outPath) {
+  NavPath_Clear(outPath);
+  int current = goalIndex;
+  while (current != -1) {
+    NavPath_Reserve(outPath, outPath->count + 1);
+    outPath->points[outPath->count++] = NavGrid_CellCenter(
+        grid, current % grid->width, current / grid->width);
+    current = ctx->nodes[current].parent;
+  }
+
+  // Reverse to [start ... goal]
+  for (int i = 0; i < outPath->count / 2; i++) {
+    Vector3 tmp                             = outPath->points[i];
+    outPath->points[i]                      = outPath->points[outPath->count-1-i];
+    outPath->points[outPath->count - 1 - i] = tmp;
+  }
+  return true;
+}
+
+// The cells one search may enter: walkable and, for agents with a radius
+// (NavSearchContext.minClearance), clear enough. Start and goal are exempt
+// from the clearance test. A* and JPS share it, corner rule included, so
+// they agree on which routes exist.
+typedef struct {
+  const NavGrid  *g;
+  const uint16_t *dist2;    // clearance field, read only when minClear is set
+  uint16_t        minClear;
+  int             start;
+  int             goal;
+} SearchArea;
+
+static inline bool WalkableAt(const SearchArea *a, int x, int y) {
+  const NavGrid *g = a->g;
+  if (x < 0 || y < 0 || x >= g->width || y >= g->height) return false;
+  int idx = y * g->width + x;
+  return CellWalkable(g, idx) &&
+         (!a->minClear || a->dist2[idx] >= a->minClear || idx == a->goal ||
+          idx == a->start);
+}
+
+static SearchArea SearchAreaFor(const NavGrid *grid,
+                                const NavSearchContext *ctx, int start,
+                                int goal) {
+  uint16_t minClear = grid->clearance ? ctx->minClearance : 0;
+  return (SearchArea){grid, minClear ? grid->clearance->dist2 : NULL,
+                      minClear, start, goal};
+}
+
+bool NavGrid_FindPathAStar(NavGrid *grid, NavSearchContext *ctx,
+                           Vector3 startWorld, Vector3 goalWorld,
+                           NavPath *outPath) {
   outPath->count        = 0;
   outPath->currentIndex = 0;
 
@@ -148,119 +320,418 @@ bool NavGrid_FindPath(NavGrid *grid, Vector3 startWorld, Vector3 goalWorld,
   if (!NavGrid_WorldToCell(grid, startWorld, &startX, &startY)) return false;
   if (!NavGrid_WorldToCell(grid, goalWorld,  &goalX,  &goalY))  return false;
 
-  int total = grid->width * grid->height;
-
-  // Initialise node buffer for this search
-  for (int y = 0; y < grid->height; y++) {
-    for (int x = 0; x < grid->width; x++) {
-      int idx           = NavGrid_Index(grid, x, y);
-      s_nodes[idx].x           = x;
-      s_nodes[idx].y           = y;
-      s_nodes[idx].gCost       = 999999;
-      s_nodes[idx].hCost       = 0;
-      s_nodes[idx].fCost       = 999999;
-      s_nodes[idx].parentIndex = -1;
-      s_nodes[idx].open        = false;
-      s_nodes[idx].closed      = false;
-      s_nodes[idx].heapIndex   = -1;
-    }
-  }
-
-  s_heapSize = 0;
+  NavSearch_Reserve(ctx, grid->width * grid->height);
+  SearchBegin(ctx);
 
   int startIndex = NavGrid_Index(grid, startX, startY);
   int goalIndex  = NavGrid_Index(grid, goalX,  goalY);
 
-  s_nodes[startIndex].gCost = 0;
-  s_nodes[startIndex].hCost = Heuristic(startX, startY, goalX, goalY);
-  s_nodes[startIndex].fCost = s_nodes[startIndex].hCost;
-  s_nodes[startIndex].open  = true;
-  HeapPush(startIndex);
+  SearchNode(ctx, startIndex)->gCost = 0;
+  SearchNode(ctx, goalIndex);
+  int startH = Heuristic(startX, startY, goalX, goalY);
+  HeapPush(ctx, startIndex, startH, startH);
 
   const int dirs[8][2] = {{1,0},{-1,0},{0,1},{0,-1},{1,1},{-1,1},{1,-1},{-1,-1}};
+  SearchArea area = SearchAreaFor(grid, ctx, startIndex, goalIndex);
 
-  while (s_heapSize > 0) {
-    int currentIndex = HeapPop();
+  while (ctx->heapSize > 0) {
+    int currentIndex = HeapPop(ctx);
     if (currentIndex == goalIndex) break;
+    ctx->expanded++;
 
-    s_nodes[currentIndex].open   = false;
-    s_nodes[currentIndex].closed = true;
-
-    int cx = s_nodes[currentIndex].x;
-    int cy = s_nodes[currentIndex].y;
+    int cx = currentIndex % grid->width;
+    int cy = currentIndex / grid->width;
+    int curG = ctx->nodes[currentIndex].gCost;
 
     for (int i = 0; i < 8; i++) {
       int nx = cx + dirs[i][0];
       int ny = cy + dirs[i][1];
-      if (!NavGrid_InBounds(grid, nx, ny)) continue;
+      if (!WalkableAt(&area, nx, ny)) continue;
 
       int neighborIndex = NavGrid_Index(grid, nx, ny);
-      { NavCellType _t = grid->cells[neighborIndex].type;
-        if (_t == NAV_CELL_WALL || _t == NAV_CELL_BLOCKED || _t == NAV_CELL_FENCE) continue; }
-      if (s_nodes[neighborIndex].closed) continue;
+      AStarNode *nb = SearchNode(ctx, neighborIndex);
+      if (nb->heapIndex == NAV_NODE_CLOSED) continue;
 
       bool isDiagonal = (dirs[i][0] != 0 && dirs[i][1] != 0);
       if (isDiagonal) {
-        int adj1 = NavGrid_Index(grid, cx + dirs[i][0], cy);
-        int adj2 = NavGrid_Index(grid, cx, cy + dirs[i][1]);
-        if (grid->cells[adj1].type == NAV_CELL_WALL || grid->cells[adj1].type == NAV_CELL_FENCE ||
-            grid->cells[adj1].type == NAV_CELL_BLOCKED ||
-            grid->cells[adj2].type == NAV_CELL_WALL || grid->cells[adj2].type == NAV_CELL_FENCE ||
-            grid->cells[adj2].type == NAV_CELL_BLOCKED) continue;
+        if (!WalkableAt(&area, cx + dirs[i][0], cy) ||
+            !WalkableAt(&area, cx, cy + dirs[i][1]))
+          continue;
       }
 
       int moveCost = isDiagonal ? 14 : 10;
-      int newG     = s_nodes[currentIndex].gCost + moveCost
-                     + grid->cells[neighborIndex].cost;
-
-      if (!s_nodes[neighborIndex].open) {
-        s_nodes[neighborIndex].gCost       = newG;
-        s_nodes[neighborIndex].hCost       = Heuristic(nx, ny, goalX, goalY);
-        s_nodes[neighborIndex].fCost       = newG + s_nodes[neighborIndex].hCost;
-        s_nodes[neighborIndex].parentIndex = currentIndex;
-        s_nodes[neighborIndex].open        = true;
-        HeapPush(neighborIndex);
-      } else if (newG < s_nodes[neighborIndex].gCost) {
-        s_nodes[neighborIndex].gCost       = newG;
-        s_nodes[neighborIndex].fCost       = newG + s_nodes[neighborIndex].hCost;
-        s_nodes[neighborIndex].parentIndex = currentIndex;
-        HeapDecrease(neighborIndex);
+      int newG     = curG + moveCost + grid->cells[neighborIndex].cost;
+
+      if (nb->heapIndex == NAV_NODE_UNVISITED) {
+        int h = Heuristic(nx, ny, goalX, goalY);
+        nb->gCost  = newG;
+        nb->parent = currentIndex;
+        HeapPush(ctx, neighborIndex, newG + h, h);
+      } else if (newG < nb->gCost) {
+        int h = Heuristic(nx, ny, goalX, goalY);
+        nb->gCost  = newG;
+        nb->parent = currentIndex;
+        HeapDecrease(ctx, neighborIndex, newG + h);
       }
     }
   }
 
-  if (s_nodes[goalIndex].parentIndex == -1 && goalIndex != startIndex)
+  if (ctx->nodes[goalIndex].parent == -1 && goalIndex != startIndex)
     return false;
 
-  // Reconstruct path
-  NavPath_Clear(outPath);
-  if (outPath->capacity == 0 || outPath->points == NULL) {
-    outPath->capacity = 16;
-    outPath->points   = malloc(sizeof(Vector3) * 16);
-    if (!outPath->points) return false;
+  return BuildPath(grid, ctx, goalIndex, outPath);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Jump point search                                                 */
+/* ------------------------------------------------------------------ */
+
+static inline int Sign(int v) { return (v > 0) - (v < 0); }
+
+// Scans from (x, y) in direction (dx, dy) and returns the first jump point,
+// or -1 if the line is blocked. Stops on the goal, on a forced neighbour,
+// and on the first cell that isn't flat so weighted areas get A* treatment.
+// *steps receives the number of cells moved.
+static int Jump(const SearchArea *a, int x, int y, int dx, int dy, int *steps) {
+  for (int n = 1;; n++) {
+    int nx = x + dx, ny = y + dy;
+    if (!WalkableAt(a, nx, ny)) return -1;
+    if (dx != 0 && dy != 0 && (!WalkableAt(a, nx, y) || !WalkableAt(a, x, ny)))
+      return -1;
+    x = nx;
+    y = ny;
+
+    int idx = y * a->g->width + x;
+    *steps  = n;
+    if (idx == a->goal || !a->g->jumpFlags[idx]) return idx;
+
+    int unused;
+    if (dx != 0 && dy != 0) {
+      if (Jump(a, x, y, dx, 0, &unused) >= 0 ||
+          Jump(a, x, y, 0, dy, &unused) >= 0)
+        return idx;
+    } else if (dx != 0) {
+      if ((WalkableAt(a, x, y - 1) && !WalkableAt(a, x - dx, y - 1)) ||
+          (WalkableAt(a, x, y + 1) && !WalkableAt(a, x - dx, y + 1)))
+        return idx;
+    } else {
+      if ((WalkableAt(a, x - 1, y) && !WalkableAt(a, x - 1, y - dy)) ||
+          (WalkableAt(a, x + 1, y) && !WalkableAt(a, x + 1, y - dy)))
+        return idx;
+    }
   }
+}
+
+// Directions worth jumping in from a flat cell reached along (dx, dy).
+// Corner cutting is forbidden, so moving straight also opens both sides.
+static int PrunedDirs(const SearchArea *a, int x, int y, int dx, int dy,
+                      int dirs[8][2]) {
+  int n = 0;
+  if (dx != 0 && dy != 0) {
+    bool v = WalkableAt(a, x, y + dy);
+    bool h = WalkableAt(a, x + dx, y);
+    if (v)      { dirs[n][0] = 0;  dirs[n][1] = dy; n++; }
+    if (h)      { dirs[n][0] = dx; dirs[n][1] = 0;  n++; }
+    if (v && h) { dirs[n][0] = dx; dirs[n][1] = dy; n++; }
+    return n;
+  }
+  // Rotate so (fx, fy) is forward and (sx, sy) one side
+  int fx = dx, fy = dy, sx = dy != 0, sy = dx != 0;
+  bool next = WalkableAt(a, x + fx, y + fy);
+  bool sideA = WalkableAt(a, x + sx, y + sy);
+  bool sideB = WalkableAt(a, x - sx, y - sy);
+  if (next) {
+    dirs[n][0] = fx; dirs[n][1] = fy; n++;
+    if (sideA) { dirs[n][0] = fx + sx; dirs[n][1] = fy + sy; n++; }
+    if (sideB) { dirs[n][0] = fx - sx; dirs[n][1] = fy - sy; n++; }
+  }
+  if (sideA) { dirs[n][0] =  sx; dirs[n][1] =  sy; n++; }
+  if (sideB) { dirs[n][0] = -sx; dirs[n][1] = -sy; n++; }
+  return n;
+}
+
+// Like BuildPath, but parents are jump points; fills in the cells between.
+static bool BuildJumpPath(NavGrid *grid, NavSearchContext *ctx, int goalIndex,
+                          NavPath *outPath) {
+  NavPath_Clear(outPath);
   int current = goalIndex;
   while (current != -1) {
-    if (outPath->count >= outPath->capacity) {
-      outPath->capacity *= 2;
-      outPath->points = realloc(outPath->points,
-                                sizeof(Vector3) * outPath->capacity);
+    int parent = ctx->nodes[current].parent;
+    int cx = current % grid->width, cy = current / grid->width;
+    int steps = 1, dx = 0, dy = 0;
+    if (parent != -1) {
+      int px = parent % grid->width, py = parent / grid->width;
+      dx    = Sign(px - cx);
+      dy    = Sign(py - cy);
+      steps = abs(px - cx) > abs(py - cy) ? abs(px - cx) : abs(py - cy);
+    }
+    // current and the cells leading back toward (not including) parent
+    NavPath_Reserve(outPath, outPath->count + steps);
+    for (int i = 0; i < steps; i++) {
+      outPath->points[outPath->count++] =
+          NavGrid_CellCenter(grid, cx + dx * i, cy + dy * i);
     }
-    outPath->points[outPath->count++] =
-        NavGrid_CellCenter(grid, s_nodes[current].x, s_nodes[current].y);
-    current = s_nodes[current].parentIndex;
+    current = parent;
   }
 
-  // Reverse to [start ... goal]
   for (int i = 0; i < outPath->count / 2; i++) {
     Vector3 tmp                             = outPath->points[i];
     outPath->points[i]                      = outPath->points[outPath->count-1-i];
     outPath->points[outPath->count - 1 - i] = tmp;
   }
+  return true;
+}
+
+bool NavGrid_FindPathJPS(NavGrid *grid, NavSearchContext *ctx,
+                         Vector3 startWorld, Vector3 goalWorld,
+                         NavPath *outPath) {
+  if (!grid->jumpFlags)
+    return NavGrid_FindPathAStar(grid, ctx, startWorld, goalWorld, outPath);
+
+  outPath->count        = 0;
+  outPath->currentIndex = 0;
+
+  int startX, startY, goalX, goalY;
+  if (!NavGrid_WorldToCell(grid, startWorld, &startX, &startY)) return false;
+  if (!NavGrid_WorldToCell(grid, goalWorld,  &goalX,  &goalY))  return false;
+
+  NavSearch_Reserve(ctx, grid->width * grid->height);
+  SearchBegin(ctx);
+
+  int startIndex = NavGrid_Index(grid, startX, startY);
+  int goalIndex  = NavGrid_Index(grid, goalX,  goalY);
+
+  SearchNode(ctx, startIndex)->gCost = 0;
+  SearchNode(ctx, goalIndex);
+  int startH = Heuristic(startX, startY, goalX, goalY);
+  HeapPush(ctx, startIndex, startH, startH);
+
+  const int allDirs[8][2] = {{1,0},{-1,0},{0,1},{0,-1},{1,1},{-1,1},{1,-1},{-1,-1}};
+  SearchArea area = SearchAreaFor(grid, ctx, startIndex, goalIndex);
+
+  while (ctx->heapSize > 0) {
+    int currentIndex = HeapPop(ctx);
+    if (currentIndex == goalIndex) break;
+    ctx->expanded++;
+
+    int cx     = currentIndex % grid->width;
+    int cy     = currentIndex / grid->width;
+    int curG   = ctx->nodes[currentIndex].gCost;
+    int parent = ctx->nodes[currentIndex].parent;
+
+    // Prune only on flat cells with a travel direction; elsewhere try all 8
+    int dirs[8][2];
+    int dirCount = 8;
+    if (parent != -1 && grid->jumpFlags[currentIndex]) {
+      dirCount = PrunedDirs(&area, cx, cy,
+                            Sign(cx - parent % grid->width),
+                            Sign(cy - parent / grid->width), dirs);
+    } else {
+      memcpy(dirs, allDirs, sizeof(dirs));
+    }
+
+    for (int i = 0; i < dirCount; i++) {
+      int steps;
+      int jp = Jump(&area, cx, cy, dirs[i][0], dirs[i][1], &steps);
+      if (jp < 0) continue;
+
+      AStarNode *nb = SearchNode(ctx, jp);
+      if (nb->heapIndex == NAV_NODE_CLOSED) continue;
+
+      // Every cell before the jump point is flat, so costs 1 to enter
+      int moveCost = (dirs[i][0] != 0 && dirs[i][1] != 0) ? 14 : 10;
+      int newG     = curG + (steps - 1) * (moveCost + 1) + moveCost +
+                 grid->cells[jp].cost;
+
+      int jx = jp % grid->width, jy = jp / grid->width;
+      if (nb->heapIndex == NAV_NODE_UNVISITED) {
+        int h = Heuristic(jx, jy, goalX, goalY);
+        nb->gCost  = newG;
+        nb->parent = currentIndex;
+        HeapPush(ctx, jp, newG + h, h);
+      } else if (newG < nb->gCost) {
+        int h = Heuristic(jx, jy, goalX, goalY);
+        nb->gCost  = newG;
+        nb->parent = currentIndex;
+        HeapDecrease(ctx, jp, newG + h);
+      }
+    }
+  }
+
+  if (ctx->nodes[goalIndex].parent == -1 && goalIndex != startIndex)
+    return false;
+
+  return BuildJumpPath(grid, ctx, goalIndex, outPath);
+}
+
+bool NavGrid_FindPathCells(NavGrid *grid, NavSearchContext *ctx,
+                           Vector3 startWorld, Vector3 goalWorld,
+                           NavPath *outPath) {
+  if (grid->searchMode == NAV_SEARCH_JPS)
+    return NavGrid_FindPathJPS(grid, ctx, startWorld, goalWorld, outPath);
+  return NavGrid_FindPathAStar(grid, ctx, startWorld, goalWorld, outPath);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Path post-processing                                              */
+/* ------------------------------------------------------------------ */
+
+void NavPath_UpdateLengths(NavPath *path) {
+  if (path->count <= 0) return;
+  NavPath_Reserve(path, path->count);
+  path->remaining[path->count - 1] = 0.0f;
+  for (int i = path->count - 2; i >= 0; i--) {
+    float dx = path->points[i + 1].x - path->points[i].x;
+    float dz = path->points[i + 1].z - path->points[i].z;
+    path->remaining[i] = path->remaining[i + 1] + sqrtf(dx * dx + dz * dz);
+  }
+}
+
+void NavPath_Assign(NavPath *path, const Vector3 *points, int count) {
+  NavPath_Clear(path);
+  if (count <= 0) return;
+  NavPath_Reserve(path, count);
+  memcpy(path->points, points, sizeof(Vector3) * count);
+  path->count = count;
+  NavPath_UpdateLengths(path);
+}
+
+static inline bool Passable(const NavGrid *g, int x, int y, int maxCost,
+                            uint16_t minClear) {
+  if (x < 0 || y < 0 || x >= g->width || y >= g->height) return false;
+  int idx = y * g->width + x;
+  return CellWalkable(g, idx) && g->cells[idx].cost <= maxCost &&
+         (!minClear || g->clearance->dist2[idx] >= minClear);
+}
+
+// Walks every cell the centre-to-centre segment touches. Passing exactly
+// through a corner needs both side cells, matching the no-corner-cut rule.
+static bool SegmentPassable(const NavGrid *g, int x0, int y0, int x1, int y1,
+                            int maxCost, uint16_t minClear) {
+  int dx = abs(x1 - x0), dy = abs(y1 - y0);
+  int sx = x1 > x0 ? 1 : -1, sy = y1 > y0 ? 1 : -1;
+  int x = x0, y = y0;
+  int n   = dx + dy;
+  int err = dx - dy;
+  dx *= 2;
+  dy *= 2;
+  while (n > 0) {
+    if (err > 0) {
+      x += sx; err -= dy; n--;
+    } else if (err < 0) {
+      y += sy; err += dx; n--;
+    } else {
+      if (!Passable(g, x + sx, y, maxCost, minClear) ||
+          !Passable(g, x, y + sy, maxCost, minClear))
+        return false;
+      x += sx; y += sy; err += dx - dy; n -= 2;
+    }
+    if (!Passable(g, x, y, maxCost, minClear)) return false;
+  }
+  return true;
+}
+
+static void SmoothPath(NavGrid *grid, NavPath *path, uint16_t minClear) {
+  if (path->count > 2) {
+    int ax, ay, px, py, cx, cy;
+    NavGrid_WorldToCell(grid, path->points[0], &ax, &ay);
+    NavGrid_WorldToCell(grid, path->points[1], &px, &py);
+    int spanCost = grid->cells[NavGrid_Index(grid, px, py)].cost;
+    int out      = 1;
+
+    for (int i = 2; i < path->count; i++) {
+      NavGrid_WorldToCell(grid, path->points[i], &cx, &cy);
+      int cost = grid->cells[NavGrid_Index(grid, cx, cy)].cost;
+      if (cost > spanCost) spanCost = cost;
+
+      if (!SegmentPassable(grid, ax, ay, cx, cy, spanCost, minClear)) {
+        // Keep the last waypoint that was still visible as a corner
+        path->points[out++] = path->points[i - 1];
+        ax       = px;
+        ay       = py;
+        spanCost = cost;
+      }
+      px = cx;
+      py = cy;
+    }
+    path->points[out++] = path->points[path->count - 1];
+    path->count         = out;
+  }
+  NavPath_UpdateLengths(path);
+}
 
+void NavPath_Smooth(NavGrid *grid, NavPath *path) {
+  SmoothPath(grid, path, 0);
+}
+
+bool NavPath_IsClear(NavGrid *grid, const NavPath *path, Vector3 from) {
+  if (path->currentIndex >= path->count) return true;
+  // Check from the segment's own start when there is one, as smoothing did
+  Vector3 a = path->currentIndex > 0 ? path->points[path->currentIndex - 1] : from;
+  int ax, ay, bx, by;
+  if (!NavGrid_WorldToCell(grid, a, &ax, &ay)) return false;
+  for (int i = path->currentIndex; i < path->count; i++) {
+    if (!NavGrid_WorldToCell(grid, path->points[i], &bx, &by)) return false;
+    if (!SegmentPassable(grid, ax, ay, bx, by, 255, 0)) return false;
+    ax = bx;
+    ay = by;
+  }
   return true;
 }
 
+bool NavGrid_FindPathCtx(NavGrid *grid, NavSearchContext *ctx,
+                         Vector3 startWorld, Vector3 goalWorld,
+                         NavPath *outPath) {
+  PROF_BEGIN("NavGrid_FindPath");
+  bool found;
+  if (grid->mesh && !grid->mesh->dirty) {
+    found = NavMesh_FindPath(grid->mesh, startWorld, goalWorld, outPath);
+  } else {
+    found = grid->hierarchy
+                ? NavHierarchy_FindPath(grid->hierarchy, ctx, startWorld,
+                                        goalWorld, outPath)
+                : NavGrid_FindPathCells(grid, ctx, startWorld, goalWorld,
+                                        outPath);
+    if (found) NavPath_Smooth(grid, outPath);
+  }
+  PROF_END();
+  return found;
+}
+
+bool NavGrid_FindPathRadius(NavGrid *grid, NavSearchContext *ctx,
+                            Vector3 startWorld, Vector3 goalWorld, float radius,
+                            NavPath *outPath) {
+  // A baked grid's walls already keep bakedRadius of the agent clear
+  float    extra = radius - grid->bakedRadius;
+  uint16_t need  = grid->clearance && extra > 0.0f
+                       ? NavClearance_Required(grid->clearance, extra)
+                       : 0;
+  if (need) {
+    PROF_BEGIN("NavGrid_FindPathRadius");
+    ctx->minClearance = need;
+    bool found = grid->hierarchy
+                     ? NavHierarchy_FindPath(grid->hierarchy, ctx, startWorld,
+                                             goalWorld, outPath)
+                     : NavGrid_FindPathCells(grid, ctx, startWorld, goalWorld,
+                                             outPath);
+    ctx->minClearance = 0;
+    if (found) SmoothPath(grid, outPath, need);
+    PROF_END();
+    if (found) return true;
+  }
+  // Squeezing through beats standing still
+  return NavGrid_FindPathCtx(grid, ctx, startWorld, goalWorld, outPath);
+}
+
+// Default context for callers that don't own one; one per thread.
+static _Thread_local NavSearchContext s_searchCtx;
+
+bool NavGrid_FindPath(NavGrid *grid, Vector3 startWorld, Vector3 goalWorld,
+                      NavPath *outPath) {
+  return NavGrid_FindPathCtx(grid, &s_searchCtx, startWorld, goalWorld,
+                             outPath);
+}
+
 /*
   White (255,255,255) NAV_CELL_EMPTY
   Black (0,0,0)       NAV_CELL_WALL
@@ -284,28 +755,32 @@ bool NavGrid_LoadFromImage(NavGrid *grid, const char *fileName, float cellSize,
       Color c = pixels[y * width + x];
 
       NavCellType type = NAV_CELL_EMPTY;
-      uint8_t     cost = 1;
 
-      if      (c.r == 0   && c.g == 0   && c.b == 0)   { type = NAV_CELL_WALL;       cost = 255; }
-      else if (c.r == 0   && c.g == 0   && c.b == 255) { type = NAV_CELL_COVER_LOW;  cost = 2;   }
-      else if (c.r == 0   && c.g == 255 && c.b == 0)   { type = NAV_CELL_COVER_HIGH; cost = 3;   }
-      else if (c.r == 255 && c.g == 0   && c.b == 0)   { type = NAV_CELL_BLOCKED;    cost = 255; }
-      else if (c.r == 255 && c.g == 255 && c.b == 0)   { type = NAV_CELL_SNIPE;  cost = 2;   }
-      else if (c.r == 255 && c.g == 0   && c.b == 255) { type = NAV_CELL_FLANK;  cost = 2;   }
-      else if (c.r == 0   && c.g == 255 && c.b == 255) { type = NAV_CELL_FENCE;  cost = 255; }
+      if      (c.r == 0   && c.g == 0   && c.b == 0)   type = NAV_CELL_WALL;
+      else if (c.r == 0   && c.g == 0   && c.b == 255) type = NAV_CELL_COVER_LOW;
+      else if (c.r == 0   && c.g == 255 && c.b == 0)   type = NAV_CELL_COVER_HIGH;
+      else if (c.r == 255 && c.g == 0   && c.b == 0)   type = NAV_CELL_BLOCKED;
+      else if (c.r == 255 && c.g == 255 && c.b == 0)   type = NAV_CELL_SNIPE;
+      else if (c.r == 255 && c.g == 0   && c.b == 255) type = NAV_CELL_FLANK;
+      else if (c.r == 0   && c.g == 255 && c.b == 255) type = NAV_CELL_FENCE;
 
       int idx = NavGrid_Index(grid, x, flippedY);
       grid->cells[idx].type = type;
-      grid->cells[idx].cost = cost;
+      grid->cells[idx].cost = NavGrid_TypeCost(type);
     }
   }
 
+  NavGrid_RefreshJumpFlags(grid);
+
   UnloadImageColors(pixels);
   UnloadImage(img);
   return true;
 }
 
 bool NavGrid_HasLOS(NavGrid *g, Vector3 from, Vector3 to) {
+  if (g->clearance && NavClearance_SegmentClear(g->clearance, from, to))
+    return true;
+  if (g->mesh && !g->mesh->dirty) return NavMesh_HasLOS(g->mesh, from, to);
   int x0, y0, x1, y1;
   if (!NavGrid_WorldToCell(g, from, &x0, &y0)) return false;
   if (!NavGrid_WorldToCell(g, to,   &x1, &y1)) return false;
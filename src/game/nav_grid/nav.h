@@ -18,9 +18,11 @@ typedef enum {
 
 typedef struct {
   Vector3 *points;
+  float *remaining; // XZ length from points[i] to the end of the path
   int count;
   int capacity;
   int currentIndex;
+  uint32_t revision; // NavGrid.revision the points were planned against
 } NavPath;
 
 typedef struct {
@@ -28,23 +30,60 @@ typedef struct {
   uint8_t cost;
 } NavCell;
 
+// Compact per-cell A* record (12 bytes). Whether it belongs to the current
+// search is tracked by NavSearchContext.stamps, so a reset is O(1).
 typedef struct {
-  int x, y;
-  int gCost;
-  int hCost;
-  int fCost;
-  int parentIndex;
-  bool open;
-  bool closed;
-  int  heapIndex; // position in the open-set heap; -1 if not present
+  int32_t gCost;
+  int32_t parent;    // cell index, -1 for none
+  int32_t heapIndex; // open-set position, or NAV_NODE_UNVISITED/CLOSED
 } AStarNode;
 
+#define NAV_NODE_UNVISITED (-1)
+#define NAV_NODE_CLOSED    (-2)
+
+typedef struct {
+  int32_t fCost;
+  int32_t hCost;
+  int32_t node;
+} NavHeapEntry;
+
+// Scratch state for one search at a time. Grows to fit whichever grid it is
+// used with; give each thread its own.
+typedef struct {
+  AStarNode    *nodes;
+  uint32_t     *stamps;   // node valid iff stamps[i] == generation
+  NavHeapEntry *heap;
+  int           heapSize;
+  int           capacity;
+  uint32_t      generation;
+  int           expanded; // nodes expanded by the last search
+  uint16_t      minClearance; // NavClearance dist2 a cell needs; 0 = any
+} NavSearchContext;
+
+struct NavHierarchy;
+struct NavMesh;
+struct NavClearance;
+struct NavOccupancy;
+
+typedef enum {
+  NAV_SEARCH_ASTAR = 0,
+  NAV_SEARCH_JPS, // jump point search on flat areas, A* steps elsewhere
+} NavSearchMode;
+
 typedef struct {
   int width;
   int height;
   float cellSize;
   Vector3 origin;
   NavCell *cells;
+  struct NavHierarchy *hierarchy; // optional HPA* layer, see nav_hierarchy.h
+  struct NavMesh *mesh;           // optional polygon layer, see nav_mesh.h
+  struct NavClearance *clearance; // optional distance-to-wall field
+  struct NavOccupancy *occupancy; // optional position claims
+  NavSearchMode searchMode;       // cell-level search, JPS by default
+  uint8_t *jumpFlags;             // 1 = flat cell, see NavGrid_RefreshJumpFlags
+  uint32_t revision;              // bumped by every NavGrid_SetCell
+  float bakedRadius;              // obstacles already grown by this, see NavBake
 } NavGrid;
 
 static inline int NavGrid_Index(NavGrid *g, int x, int y) {
@@ -57,16 +96,74 @@ static inline bool NavGrid_InBounds(NavGrid *g, int x, int y) {
 
 bool NavGrid_WorldToCell(NavGrid *g, Vector3 worldPos, int *outX, int *outY);
 Vector3 NavGrid_CellCenter(NavGrid *g, int x, int y);
+// Default step cost of each cell type, as NavGrid_LoadFromImage assigns it.
+uint8_t NavGrid_TypeCost(NavCellType type);
+// Sets the type and its default cost, and keeps the JPS flags and any
+// attached hierarchy current. Not safe while other threads are searching.
+// An attached mesh is marked dirty and ignored until NavGrid_EndEdits.
 void NavGrid_SetCell(NavGrid *g, int x, int y, NavCellType type);
+// Rebuilds an attached mesh after a batch of NavGrid_SetCell calls.
+void NavGrid_EndEdits(NavGrid *g);
+// Recomputes every cell's JPS flag. Call after writing cells directly;
+// NavGrid_SetCell and NavGrid_LoadFromImage keep them current.
+void NavGrid_RefreshJumpFlags(NavGrid *g);
 void NavGrid_Init(NavGrid *grid, int width, int height, float cellSize,
                   Vector3 origin);
 void NavGrid_Destroy(NavGrid *grid);
 void NavPath_Init(NavPath *path, int initialCapacity);
+void NavPath_Reserve(NavPath *path, int capacity);
 void NavPath_Clear(NavPath *path);
 void NavPath_Destroy(NavPath *path);
+// Replaces the path's points and recomputes remaining[].
+void NavPath_Assign(NavPath *path, const Vector3 *points, int count);
+// Recomputes remaining[] after points change.
+void NavPath_UpdateLengths(NavPath *path);
+// String pulling: drops every waypoint the agent can skip in a straight,
+// walkable line, leaving corner-to-corner segments. A shortcut may not cross
+// a cell costlier than those it replaces, so weighted areas stay avoided.
+void NavPath_Smooth(NavGrid *grid, NavPath *path);
+// True while every segment left to walk, from the agent's position through
+// the remaining waypoints, still crosses only walkable cells.
+bool NavPath_IsClear(NavGrid *grid, const NavPath *path, Vector3 from);
+
+void NavSearch_Init(NavSearchContext *ctx, int cellCount);
+void NavSearch_Reserve(NavSearchContext *ctx, int cellCount);
+void NavSearch_Destroy(NavSearchContext *ctx);
 
+// Plain cell-level A*; optimal for the grid's costs.
+bool NavGrid_FindPathAStar(NavGrid *grid, NavSearchContext *ctx,
+                           Vector3 startWorld, Vector3 goalWorld,
+                           NavPath *outPath);
+// Jump point search with the same path costs as NavGrid_FindPathAStar.
+// Cells near weighted ones are expanded one by one, as A* would.
+bool NavGrid_FindPathJPS(NavGrid *grid, NavSearchContext *ctx,
+                         Vector3 startWorld, Vector3 goalWorld,
+                         NavPath *outPath);
+// Cell-level search using grid->searchMode.
+bool NavGrid_FindPathCells(NavGrid *grid, NavSearchContext *ctx,
+                           Vector3 startWorld, Vector3 goalWorld,
+                           NavPath *outPath);
+// The attached mesh when there is one, else the attached hierarchy, else
+// NavGrid_FindPathCells. Cell paths are smoothed with NavPath_Smooth; mesh
+// paths come out of the funnel already straight.
+bool NavGrid_FindPathCtx(NavGrid *grid, NavSearchContext *ctx,
+                         Vector3 startWorld, Vector3 goalWorld,
+                         NavPath *outPath);
+// For an agent of the given world radius: the hierarchy or cell search of
+// NavGrid_FindPathCtx restricted to cells with enough clearance, smoothed
+// at the same clearance (the mesh assumes point agents and is skipped).
+// Start and goal cells are exempt, and grid->bakedRadius counts toward the
+// radius. Falls back to NavGrid_FindPathCtx when the grid has no clearance
+// field, the radius fits every walkable cell, or no route is wide enough.
+bool NavGrid_FindPathRadius(NavGrid *grid, NavSearchContext *ctx,
+                            Vector3 startWorld, Vector3 goalWorld, float radius,
+                            NavPath *outPath);
+// Uses a per-thread context owned by nav.c.
 bool NavGrid_FindPath(NavGrid *grid, Vector3 startWorld, Vector3 goalWorld,
                       NavPath *outPath);
 bool NavGrid_LoadFromImage(NavGrid *grid, const char *fileName, float cellSize,
                            Vector3 origin);
+// Walls and blocked cells stop line of sight. Open lines are confirmed from
+// the clearance field when there is one; otherwise uses the attached mesh
+// when there is one.
 bool NavGrid_HasLOS(NavGrid *g, Vector3 from, Vector3 to);
@@ -0,0 +1,347 @@
+#include "nav_bake.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// Below this many cells the bake runs single-threaded
+#define NAV_BAKE_OMP_MIN_CELLS 4096
+// Geometry must reach this far into a cell to count as touching it
+#define NAV_BAKE_EPSILON 1e-3f
+
+NavBakeParams NavBake_DefaultParams(void) {
+  return (NavBakeParams){
+      .cellSize    = 2.0f,
+      .origin      = {-180.0f, 0.0f, -180.0f},
+      .size        = 360.0f,
+      .agentRadius = 0.5f,
+      .agentHeight = 2.0f,
+      .stepHeight  = 0.4f,
+      .maxSlope    = 1.0f,
+      .lowCover    = 0.9f,
+      .highCover   = 1.8f,
+  };
+}
+
+/* ------------------------------------------------------------------ */
+/*  Rasterization                                                     */
+/* ------------------------------------------------------------------ */
+
+static float GroundAt(const HeightMap *hm, float x, float z) {
+  return (hm && hm->samples) ? HeightMap_GetHeightSmooth(hm, x, z) : 0.0f;
+}
+
+static float SegmentDistXZ(const NavBakeWall *w, float x, float z) {
+  float dx = w->bx - w->ax, dz = w->bz - w->az;
+  float len2 = dx * dx + dz * dz;
+  float t = len2 > 1e-8f ? ((x - w->ax) * dx + (z - w->az) * dz) / len2 : 0.0f;
+  t = fminf(fmaxf(t, 0.0f), 1.0f);
+  float px = w->ax + t * dx - x, pz = w->az + t * dz - z;
+  return sqrtf(px * px + pz * pz);
+}
+
+static float PointBoxDist(float x, float z, float cx, float cz, float half) {
+  float dx = fmaxf(fabsf(x - cx) - half, 0.0f);
+  float dz = fmaxf(fabsf(z - cz) - half, 0.0f);
+  return sqrtf(dx * dx + dz * dz);
+}
+
+// Distance from the wall's centre line to the cell square (cx, cz) +- half.
+// Disjoint convex shapes are closest at a vertex of one of them.
+static float SegmentSquareDist(const NavBakeWall *w, float cx, float cz,
+                               float half) {
+  // Slab clip: does the segment cross the square?
+  float t0 = 0.0f, t1 = 1.0f;
+  float d[2]  = {w->bx - w->ax, w->bz - w->az};
+  float p0[2] = {w->ax - cx, w->az - cz};
+  bool  hit   = true;
+  for (int k = 0; k < 2 && hit; k++) {
+    if (fabsf(d[k]) < 1e-8f) {
+      hit = fabsf(p0[k]) <= half;
+      continue;
+    }
+    float ta = (-half - p0[k]) / d[k];
+    float tb = ( half - p0[k]) / d[k];
+    if (ta > tb) { float t = ta; ta = tb; tb = t; }
+    t0 = fmaxf(t0, ta);
+    t1 = fminf(t1, tb);
+    hit = t0 <= t1;
+  }
+  if (hit) return 0.0f;
+
+  float best = fminf(PointBoxDist(w->ax, w->az, cx, cz, half),
+                     PointBoxDist(w->bx, w->bz, cx, cz, half));
+  for (int c = 0; c < 4; c++) {
+    float x = cx + ((c & 1) ? half : -half);
+    float z = cz + ((c & 2) ? half : -half);
+    best    = fminf(best, SegmentDistXZ(w, x, z));
+  }
+  return best;
+}
+
+// Cover level an obstacle of the given top height gives: 0 none, 1 low, 2 high
+static int CoverLevel(const NavBakeParams *p, float heightAboveGround) {
+  if (p->highCover > 0.0f && heightAboveGround >= p->highCover) return 2;
+  if (p->lowCover > 0.0f && heightAboveGround >= p->lowCover) return 1;
+  return 0;
+}
+
+// Applies one obstacle to a cell: returns true once the cell is blocked.
+// dist is from the cell centre to the obstacle; touches is whether the
+// obstacle itself overlaps the cell, so thin walls between two cell
+// centres still block.
+static bool Obstruct(const NavBakeParams *p, float dist, bool touches,
+                     float bottom, float top, float ground, bool blocksLOS,
+                     NavCell *cell, int *cover) {
+  // Overhead or step-over obstacles don't touch the walkable column
+  if (bottom >= ground + p->agentHeight || top <= ground + p->stepHeight)
+    return false;
+
+  if (touches || dist <= p->agentRadius) {
+    NavCellType t = blocksLOS ? NAV_CELL_WALL : NAV_CELL_FENCE;
+    // A wall anywhere in the cell beats a fence
+    if (cell->type != NAV_CELL_WALL) cell->type = t;
+    return cell->type == NAV_CELL_WALL;
+  }
+  if (blocksLOS && dist <= p->agentRadius + p->cellSize) {
+    int c = CoverLevel(p, top - ground);
+    if (c > *cover) *cover = c;
+  }
+  return false;
+}
+
+static void BakeRow(NavGrid *grid, const NavBakeInput *in,
+                    const NavBakeParams *p, int y) {
+  float cs    = grid->cellSize;
+  float z     = grid->origin.z + (y + 0.5f) * cs;
+  float reach = p->agentRadius + cs; // widest band an obstacle affects
+
+  for (int x = 0; x < grid->width; x++) {
+    float    wx     = grid->origin.x + (x + 0.5f) * cs;
+    float    ground = GroundAt(in->terrain, wx, z);
+    NavCell *cell   = &grid->cells[NavGrid_Index(grid, x, y)];
+    cell->type      = NAV_CELL_EMPTY;
+
+    // Slope from central differences across the cell
+    if (in->terrain && in->terrain->samples && p->maxSlope > 0.0f) {
+      float h  = 0.5f * cs;
+      float gx = (GroundAt(in->terrain, wx + h, z) -
+                  GroundAt(in->terrain, wx - h, z)) / cs;
+      float gz = (GroundAt(in->terrain, wx, z + h) -
+                  GroundAt(in->terrain, wx, z - h)) / cs;
+      // Impassable but see-through: terrain LOS is the heightmap's job
+      if (gx * gx + gz * gz > p->maxSlope * p->maxSlope)
+        cell->type = NAV_CELL_FENCE;
+    }
+
+    int  cover   = 0;
+    bool blocked = false;
+    for (int i = 0; i < in->boxCount && !blocked; i++) {
+      const NavBakeBox *b = &in->boxes[i];
+      float dx = fabsf(wx - b->center.x) - b->halfExtents.x;
+      float dz = fabsf(z - b->center.z) - b->halfExtents.z;
+      if (dx > reach || dz > reach) continue;
+      bool touches = dx < 0.5f * cs - NAV_BAKE_EPSILON &&
+                     dz < 0.5f * cs - NAV_BAKE_EPSILON;
+      dx = fmaxf(dx, 0.0f);
+      dz = fmaxf(dz, 0.0f);
+      blocked = Obstruct(p, sqrtf(dx * dx + dz * dz), touches,
+                         b->center.y - b->halfExtents.y,
+                         b->center.y + b->halfExtents.y, ground, true, cell,
+                         &cover);
+    }
+    for (int i = 0; i < in->wallCount && !blocked; i++) {
+      const NavBakeWall *w = &in->walls[i];
+      if (wx < fminf(w->ax, w->bx) - w->radius - reach ||
+          wx > fmaxf(w->ax, w->bx) + w->radius + reach ||
+          z < fminf(w->az, w->bz) - w->radius - reach ||
+          z > fmaxf(w->az, w->bz) + w->radius + reach)
+        continue;
+      float dist    = fmaxf(SegmentDistXZ(w, wx, z) - w->radius, 0.0f);
+      bool  touches = SegmentSquareDist(w, wx, z, 0.5f * cs) <
+                      w->radius - NAV_BAKE_EPSILON;
+      blocked = Obstruct(p, dist, touches, w->yBottom, w->yTop, ground,
+                         w->blocksLOS, cell, &cover);
+    }
+
+    if (cell->type == NAV_CELL_EMPTY && cover > 0)
+      cell->type = cover == 2 ? NAV_CELL_COVER_HIGH : NAV_CELL_COVER_LOW;
+    cell->cost = NavGrid_TypeCost(cell->type);
+  }
+}
+
+void NavBake_Run(NavGrid *grid, const NavBakeInput *in, const NavBakeParams *p) {
+  int n = (int)ceilf(p->size / p->cellSize);
+  if (n < 1) n = 1;
+  NavGrid_Init(grid, n, n, p->cellSize, p->origin);
+
+#pragma omp parallel for schedule(dynamic, 4) if (n * n >= NAV_BAKE_OMP_MIN_CELLS)
+  for (int y = 0; y < n; y++) BakeRow(grid, in, p, y);
+
+  NavGrid_RefreshJumpFlags(grid);
+  grid->bakedRadius = p->agentRadius;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Designer paint                                                    */
+/* ------------------------------------------------------------------ */
+
+void NavBake_ApplyPaint(NavGrid *grid, NavGrid *paint) {
+  if (!paint->cells) return;
+  for (int y = 0; y < grid->height; y++) {
+    for (int x = 0; x < grid->width; x++) {
+      int px, py;
+      if (!NavGrid_WorldToCell(paint, NavGrid_CellCenter(grid, x, y), &px, &py))
+        continue;
+      NavCellType t    = paint->cells[NavGrid_Index(paint, px, py)].type;
+      NavCell    *cell = &grid->cells[NavGrid_Index(grid, x, y)];
+      bool walkable = cell->type != NAV_CELL_WALL &&
+                      cell->type != NAV_CELL_BLOCKED &&
+                      cell->type != NAV_CELL_FENCE;
+
+      if (t == NAV_CELL_BLOCKED ||
+          (walkable && (t == NAV_CELL_COVER_LOW || t == NAV_CELL_COVER_HIGH ||
+                        t == NAV_CELL_SNIPE || t == NAV_CELL_FLANK))) {
+        cell->type = t;
+        cell->cost = NavGrid_TypeCost(t);
+      }
+    }
+  }
+  NavGrid_RefreshJumpFlags(grid);
+}
+
+/* ------------------------------------------------------------------ */
+/*  On-disk cache                                                     */
+/* ------------------------------------------------------------------ */
+
+#define NAV_BAKE_MAGIC   0x4256414eu // "NAVB"
+#define NAV_BAKE_VERSION 1u
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t key; // BakeKey() of the input and params
+  uint32_t width;
+  uint32_t height;
+  float    cellSize;
+  float    origin[3];
+} NavBakeCacheHeader; // followed by width * height cell types, one byte each
+
+// 64-bit FNV-1a.
+static uint64_t HashBytes(uint64_t h, const void *data, size_t size) {
+  const unsigned char *bytes = data;
+  for (size_t i = 0; i < size; i++) {
+    h ^= bytes[i];
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+// FNV-style over 32-bit words, for the large terrain sample array
+static uint64_t HashWords(uint64_t h, const uint32_t *words, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    h ^= words[i];
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+static uint64_t BakeKey(const NavBakeInput *in, const NavBakeParams *p) {
+  uint64_t h       = 0xcbf29ce484222325ull;
+  uint32_t version = NAV_BAKE_VERSION;
+  h = HashBytes(h, &version, sizeof(version));
+  h = HashBytes(h, p, sizeof(*p));
+  h = HashBytes(h, &in->boxCount, sizeof(in->boxCount));
+  if (in->boxCount > 0)
+    h = HashBytes(h, in->boxes, sizeof(NavBakeBox) * in->boxCount);
+  h = HashBytes(h, &in->wallCount, sizeof(in->wallCount));
+  // Field by field: the struct has padding
+  for (int i = 0; i < in->wallCount; i++) {
+    const NavBakeWall *w = &in->walls[i];
+    float f[7] = {w->ax, w->az, w->bx, w->bz, w->yBottom, w->yTop, w->radius};
+    h = HashBytes(h, f, sizeof(f));
+    h = HashBytes(h, &w->blocksLOS, sizeof(w->blocksLOS));
+  }
+  const HeightMap *hm = in->terrain;
+  if (hm && hm->samples) {
+    h = HashBytes(h, &hm->width, sizeof(hm->width));
+    h = HashBytes(h, &hm->height, sizeof(hm->height));
+    h = HashBytes(h, &hm->cellSize, sizeof(hm->cellSize));
+    h = HashBytes(h, &hm->origin, sizeof(hm->origin));
+    h = HashWords(h, (const uint32_t *)hm->samples,
+                  (size_t)hm->width * hm->height);
+  }
+  return h;
+}
+
+static bool LoadCache(NavGrid *grid, const char *path, uint64_t key) {
+  FILE *f = fopen(path, "rb");
+  if (!f) return false;
+
+  NavBakeCacheHeader hdr;
+  bool ok = false;
+  if (fread(&hdr, sizeof(hdr), 1, f) == 1 && hdr.magic == NAV_BAKE_MAGIC &&
+      hdr.version == NAV_BAKE_VERSION && hdr.key == key && hdr.width > 0 &&
+      hdr.height > 0) {
+    size_t   n     = (size_t)hdr.width * hdr.height;
+    uint8_t *types = malloc(n);
+    if (types && fread(types, 1, n, f) == n) {
+      NavGrid_Init(grid, (int)hdr.width, (int)hdr.height, hdr.cellSize,
+                   (Vector3){hdr.origin[0], hdr.origin[1], hdr.origin[2]});
+      for (size_t i = 0; i < n; i++) {
+        grid->cells[i].type = (NavCellType)types[i];
+        grid->cells[i].cost = NavGrid_TypeCost(grid->cells[i].type);
+      }
+      NavGrid_RefreshJumpFlags(grid);
+      ok = true;
+    }
+    free(types);
+  }
+  fclose(f);
+  return ok;
+}
+
+// Writes to a temporary file and renames it so a crash mid-write never
+// leaves a truncated cache behind.
+static void SaveCache(const NavGrid *grid, const char *path, uint64_t key) {
+  char tmp[512];
+  if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp)) return;
+
+  FILE *f = fopen(tmp, "wb");
+  if (!f) return;
+
+  NavBakeCacheHeader hdr = {
+      NAV_BAKE_MAGIC,
+      NAV_BAKE_VERSION,
+      key,
+      (uint32_t)grid->width,
+      (uint32_t)grid->height,
+      grid->cellSize,
+      {grid->origin.x, grid->origin.y, grid->origin.z},
+  };
+  size_t   n     = (size_t)grid->width * grid->height;
+  uint8_t *types = malloc(n);
+  bool     ok    = types != NULL;
+  if (ok) {
+    for (size_t i = 0; i < n; i++) types[i] = (uint8_t)grid->cells[i].type;
+    ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1 && fwrite(types, 1, n, f) == n;
+  }
+  free(types);
+  ok = (fclose(f) == 0) && ok;
+
+  if (!ok || rename(tmp, path) != 0) remove(tmp);
+}
+
+void NavBake_RunCached(NavGrid *grid, const NavBakeInput *in,
+                       const NavBakeParams *p, const char *cachePath) {
+  if (!cachePath) {
+    NavBake_Run(grid, in, p);
+    return;
+  }
+  uint64_t key = BakeKey(in, p);
+  if (LoadCache(grid, cachePath, key)) {
+    grid->bakedRadius = p->agentRadius;
+    return;
+  }
+  NavBake_Run(grid, in, p);
+  SaveCache(grid, cachePath, key);
+}
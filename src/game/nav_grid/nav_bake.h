@@ -0,0 +1,55 @@
+#pragma once
+#include "../../engine/math/heightmap.h"
+#include "nav.h"
+
+// Builds a NavGrid from level geometry instead of a painted navmap. Boxes
+// and wall segments are grown by the agent radius and rasterized, terrain
+// steeper than maxSlope is made impassable, and walkable cells beside tall
+// enough obstacles are tagged as cover. Rows are baked in parallel.
+
+typedef struct {
+  Vector3 center;
+  Vector3 halfExtents;
+} NavBakeBox;
+
+typedef struct {
+  float ax, az, bx, bz; // world XZ endpoints
+  float yBottom, yTop;  // world Y
+  float radius;         // half-thickness
+  bool  blocksLOS;      // false bakes as NAV_CELL_FENCE (shoot-through)
+} NavBakeWall;
+
+typedef struct {
+  const NavBakeBox  *boxes;
+  int                boxCount;
+  const NavBakeWall *walls;
+  int                wallCount;
+  const HeightMap   *terrain; // optional; flat ground at y = 0 without it
+} NavBakeInput;
+
+typedef struct {
+  float   cellSize;    // world units per cell
+  Vector3 origin;      // min corner of the grid
+  float   size;        // world extent along X and Z
+  float   agentRadius; // obstacles grow by this much
+  float   agentHeight; // obstacles starting higher above ground are ignored
+  float   stepHeight;  // obstacles lower than this are walked over
+  float   maxSlope;    // rise over run; steeper terrain is impassable
+  float   lowCover;    // obstacle height above ground for COVER_LOW, 0 = off
+  float   highCover;   // obstacle height above ground for COVER_HIGH, 0 = off
+} NavBakeParams;
+
+// The arena the painted 180x180 navmaps covered, at their 2 m resolution
+NavBakeParams NavBake_DefaultParams(void);
+
+// Initializes grid (any previous contents must be destroyed) and bakes it.
+void NavBake_Run(NavGrid *grid, const NavBakeInput *in, const NavBakeParams *p);
+// As NavBake_Run, but reuses cachePath when it was baked from the same
+// input and params, and writes it otherwise.
+void NavBake_RunCached(NavGrid *grid, const NavBakeInput *in,
+                       const NavBakeParams *p, const char *cachePath);
+
+// Copies designer annotations from a painted grid of any resolution:
+// BLOCKED everywhere, and cover, snipe and flank marks onto walkable cells.
+// Painted walls are ignored, the geometry is authoritative.
+void NavBake_ApplyPaint(NavGrid *grid, NavGrid *paint);
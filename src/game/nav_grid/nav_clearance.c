@@ -0,0 +1,169 @@
+#include "nav_clearance.h"
+#include <math.h>
+#include <string.h>
+
+#define CLEAR_CAP2 (NAV_CLEARANCE_MAX * NAV_CLEARANCE_MAX)
+#define CLEAR_INF  (1 << 20)
+
+static inline bool Blocked(const NavGrid *g, int x, int y) {
+  if (x < 0 || y < 0 || x >= g->width || y >= g->height) return true;
+  NavCellType t = g->cells[y * g->width + x].type;
+  return t == NAV_CELL_WALL || t == NAV_CELL_BLOCKED || t == NAV_CELL_FENCE;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Distance transform                                                */
+/*  Column pass: distance to the nearest blocked cell in the column.  */
+/*  Row pass: lower envelope of parabolas (Felzenszwalb-Huttenlocher). */
+/* ------------------------------------------------------------------ */
+
+static int32_t *s_col    = NULL; // squared column distances, region-sized
+static int32_t *s_f      = NULL; // one row of s_col
+static int32_t *s_v      = NULL; // envelope parabola positions
+static float   *s_z      = NULL; // envelope boundaries
+static int      s_cap    = 0;
+static int      s_rowCap = 0;
+
+static void Reserve(int cells, int rowLen) {
+  if (cells > s_cap) {
+    s_col = realloc(s_col, sizeof(int32_t) * cells);
+    s_cap = cells;
+  }
+  if (rowLen > s_rowCap) {
+    s_f      = realloc(s_f, sizeof(int32_t) * rowLen);
+    s_v      = realloc(s_v, sizeof(int32_t) * rowLen);
+    s_z      = realloc(s_z, sizeof(float) * (rowLen + 1));
+    s_rowCap = rowLen;
+  }
+}
+
+// Exact transform of region [x0, x1] x [y0, y1] (may reach one cell past
+// the grid, where everything is blocked), written back for the cells of
+// [wx0, wx1] x [wy0, wy1] inside the grid.
+static void DistanceTransform(NavClearance *c, int x0, int y0, int x1, int y1,
+                              int wx0, int wy0, int wx1, int wy1) {
+  const NavGrid *g = c->grid;
+  int w = x1 - x0 + 1, h = y1 - y0 + 1;
+  Reserve(w * h, w);
+
+  for (int i = 0; i < w; i++) {
+    int x = x0 + i, d = CLEAR_INF;
+    for (int j = 0; j < h; j++) {
+      d = Blocked(g, x, y0 + j) ? 0 : (d < CLEAR_INF ? d + 1 : CLEAR_INF);
+      s_col[j * w + i] = d;
+    }
+    d = CLEAR_INF;
+    for (int j = h - 1; j >= 0; j--) {
+      int *cell = &s_col[j * w + i];
+      d = *cell == 0 ? 0 : (d < CLEAR_INF ? d + 1 : CLEAR_INF);
+      if (d < *cell) *cell = d;
+    }
+    for (int j = 0; j < h; j++) {
+      int v = s_col[j * w + i];
+      s_col[j * w + i] = v < CLEAR_INF ? v * v : CLEAR_INF;
+    }
+  }
+
+  for (int j = 0; j < h; j++) {
+    int y = y0 + j;
+    if (y < wy0 || y > wy1 || y < 0 || y >= g->height) continue;
+    memcpy(s_f, &s_col[j * w], sizeof(int32_t) * w);
+
+    int k = 0;
+    s_v[0] = 0;
+    s_z[0] = -INFINITY;
+    s_z[1] = INFINITY;
+    for (int q = 1; q < w; q++) {
+      float s;
+      while (true) { // z[0] is -inf, so this stops at k == 0
+        int p = s_v[k];
+        s = ((float)(s_f[q] + q * q) - (float)(s_f[p] + p * p)) /
+            (2.0f * (q - p));
+        if (s > s_z[k]) break;
+        k--;
+      }
+      k++;
+      s_v[k]     = q;
+      s_z[k]     = s;
+      s_z[k + 1] = INFINITY;
+    }
+
+    k = 0;
+    for (int q = 0; q < w; q++) {
+      while (s_z[k + 1] < q) k++;
+      int x = x0 + q;
+      if (x < wx0 || x > wx1 || x < 0 || x >= g->width) continue;
+      int p  = s_v[k];
+      int d2 = (q - p) * (q - p) + s_f[p];
+      c->dist2[y * g->width + x] = (uint16_t)(d2 < CLEAR_CAP2 ? d2 : CLEAR_CAP2);
+    }
+  }
+}
+
+void NavClearance_Build(NavClearance *c, NavGrid *grid) {
+  c->grid  = grid;
+  c->dist2 = realloc(c->dist2, sizeof(uint16_t) * grid->width * grid->height);
+  DistanceTransform(c, -1, -1, grid->width, grid->height,
+                    0, 0, grid->width - 1, grid->height - 1);
+  grid->clearance = c;
+}
+
+void NavClearance_Destroy(NavClearance *c) {
+  if (c->grid && c->grid->clearance == c) c->grid->clearance = NULL;
+  free(c->dist2);
+  c->dist2 = NULL;
+  c->grid  = NULL;
+}
+
+void NavClearance_CellChanged(NavClearance *c, int x, int y) {
+  // Only cells within the cap can see the edit, and every blocker that
+  // matters to them lies within the cap again
+  const int m = NAV_CLEARANCE_MAX, r = 2 * NAV_CLEARANCE_MAX;
+  const NavGrid *g = c->grid;
+  int x0 = x - r < -1 ? -1 : x - r, x1 = x + r > g->width  ? g->width  : x + r;
+  int y0 = y - r < -1 ? -1 : y - r, y1 = y + r > g->height ? g->height : y + r;
+  DistanceTransform(c, x0, y0, x1, y1, x - m, y - m, x + m, y + m);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Queries                                                           */
+/* ------------------------------------------------------------------ */
+
+float NavClearance_At(const NavClearance *c, int x, int y) {
+  const NavGrid *g = c->grid;
+  if (!NavGrid_InBounds((NavGrid *)g, x, y)) return 0.0f;
+  float d = sqrtf((float)c->dist2[y * g->width + x]) - 0.5f;
+  return d > 0.0f ? d * g->cellSize : 0.0f;
+}
+
+uint16_t NavClearance_Required(const NavClearance *c, float radius) {
+  float d  = radius / c->grid->cellSize + 0.5f;
+  float d2 = ceilf(d * d - 1e-4f);
+  if (d2 <= 1.0f) return 0; // walkable cells are at least one cell from walls
+  return (uint16_t)(d2 < CLEAR_CAP2 ? d2 : CLEAR_CAP2);
+}
+
+// A cell walk along the segment may visit any cell whose centre is within
+// this many cells of the segment, plus the offset from a point to its cell
+#define CLEAR_SEGMENT_MARGIN 2.0f
+
+bool NavClearance_SegmentClear(const NavClearance *c, Vector3 from, Vector3 to) {
+  const NavGrid *g = c->grid;
+  float ox = (from.x - g->origin.x) / g->cellSize;
+  float oz = (from.z - g->origin.z) / g->cellSize;
+  float dx = (to.x - from.x) / g->cellSize;
+  float dz = (to.z - from.z) / g->cellSize;
+  float len = sqrtf(dx * dx + dz * dz);
+
+  float t = 0.0f; // distance travelled, in cells
+  while (true) {
+    float px = ox + (len > 0.0f ? dx * t / len : 0.0f);
+    float pz = oz + (len > 0.0f ? dz * t / len : 0.0f);
+    int   x = (int)floorf(px), y = (int)floorf(pz);
+    if (!NavGrid_InBounds((NavGrid *)g, x, y)) return false;
+    float step = sqrtf((float)c->dist2[y * g->width + x]) - CLEAR_SEGMENT_MARGIN;
+    if (step < 0.5f) return false;
+    if (t + step >= len) return true;
+    t += step;
+  }
+}
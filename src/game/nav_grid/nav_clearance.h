@@ -0,0 +1,33 @@
+#pragma once
+#include "nav.h"
+
+// Clearance field over a NavGrid: for every cell, the exact Euclidean
+// distance from its centre to the nearest unwalkable cell centre, with the
+// area outside the grid counted as unwalkable. Built with a separable
+// distance transform and kept current by NavGrid_SetCell, which recomputes
+// only the window an edit can reach. Distances saturate at
+// NAV_CLEARANCE_MAX cells, which bounds that window.
+
+#define NAV_CLEARANCE_MAX 8 // cells
+
+typedef struct NavClearance {
+  NavGrid  *grid;
+  uint16_t *dist2; // squared distance in cells, capped at NAV_CLEARANCE_MAX^2
+} NavClearance;
+
+// Builds the field and attaches it to grid, so radius-aware searches and
+// NavGrid_HasLOS can use it and NavGrid_SetCell keeps it current.
+void NavClearance_Build(NavClearance *c, NavGrid *grid);
+void NavClearance_Destroy(NavClearance *c);
+void NavClearance_CellChanged(NavClearance *c, int x, int y);
+
+// World distance from the cell centre to the nearest unwalkable cell's edge.
+float NavClearance_At(const NavClearance *c, int x, int y);
+// Smallest dist2 a cell needs for an agent of the given world radius to
+// stand at its centre. 0 when every walkable cell will do.
+uint16_t NavClearance_Required(const NavClearance *c, float radius);
+
+// True when the field alone proves every cell between from and to is clear,
+// stepping along the segment by the clearance at each point. False means
+// "unknown": the caller still has to walk the cells.
+bool NavClearance_SegmentClear(const NavClearance *c, Vector3 from, Vector3 to);
@@ -0,0 +1,547 @@
+#include "nav_hierarchy.h"
+#include "nav_clearance.h"
+#include <string.h>
+
+#define HPA_ENTRANCE_SPLIT 6 // openings this wide get an entrance at each end
+#define HPA_INF            0x3fffffff
+#define HPA_CELLS          (NAV_CLUSTER_SIZE * NAV_CLUSTER_SIZE)
+
+enum { SIDE_WEST, SIDE_EAST, SIDE_NORTH, SIDE_SOUTH }; // opposite = side ^ 1
+
+static const int s_dirs[8][2] = {{1,0},{-1,0},{0,1},{0,-1},{1,1},{-1,1},{1,-1},{-1,-1}};
+
+static inline bool Walkable(const NavGrid *grid, int idx) {
+  NavCellType t = grid->cells[idx].type;
+  return t != NAV_CELL_WALL && t != NAV_CELL_BLOCKED && t != NAV_CELL_FENCE;
+}
+
+// Radius-aware queries skip cells (and so entrances) narrower than the
+// agent; see NavSearchContext.minClearance.
+static inline bool Clear(const NavGrid *grid, int idx, uint16_t minClear) {
+  return !minClear || grid->clearance->dist2[idx] >= minClear;
+}
+
+static inline int Octile(int x1, int y1, int x2, int y2) {
+  int dx = abs(x1 - x2);
+  int dy = abs(y1 - y2);
+  return 10 * (dx + dy) - 6 * (dx < dy ? dx : dy);
+}
+
+static inline int ClusterAt(const NavHierarchy *h, int x, int y) {
+  return (y / NAV_CLUSTER_SIZE) * h->clustersX + x / NAV_CLUSTER_SIZE;
+}
+
+// Cluster across the given side of c, or -1 at the grid edge.
+static int ClusterNeighbor(const NavHierarchy *h, int c, int side) {
+  int cx = c % h->clustersX;
+  int cy = c / h->clustersX;
+  switch (side) {
+  case SIDE_WEST:  cx--; break;
+  case SIDE_EAST:  cx++; break;
+  case SIDE_NORTH: cy--; break;
+  default:         cy++; break;
+  }
+  if (cx < 0 || cy < 0 || cx >= h->clustersX || cy >= h->clustersY) return -1;
+  return cy * h->clustersX + cx;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Cluster-local Dijkstra                                            */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+  int32_t cost;
+  int32_t local;
+} LocalEntry;
+
+static void LocalPush(LocalEntry *heap, int *size, LocalEntry e) {
+  int pos = (*size)++;
+  while (pos > 0) {
+    int parent = (pos - 1) / 2;
+    if (heap[parent].cost <= e.cost) break;
+    heap[pos] = heap[parent];
+    pos = parent;
+  }
+  heap[pos] = e;
+}
+
+static LocalEntry LocalPop(LocalEntry *heap, int *size) {
+  LocalEntry top  = heap[0];
+  LocalEntry last = heap[--(*size)];
+  int pos = 0;
+  while (true) {
+    int child = 2 * pos + 1;
+    if (child >= *size) break;
+    if (child + 1 < *size && heap[child + 1].cost < heap[child].cost) child++;
+    if (last.cost <= heap[child].cost) break;
+    heap[pos] = heap[child];
+    pos = child;
+  }
+  if (*size > 0) heap[pos] = last;
+  return top;
+}
+
+static inline int LocalIndex(const NavGrid *grid, const NavCluster *c,
+                             int cell) {
+  int w = c->x1 - c->x0 + 1;
+  return (cell / grid->width - c->y0) * w + (cell % grid->width - c->x0);
+}
+
+// Dijkstra confined to cluster c, with A*'s move costs and corner rule.
+// Forward: dist is the cost from src to each cell. Reverse: the cost from
+// each cell to src. dist is indexed by cluster-local cell and is final for
+// every entrance cell; the search stops once those are all settled. With
+// minClear set, cells other than src also need that much clearance.
+// Returns the number of cells expanded.
+static int ClusterDijkstra(NavGrid *grid, const NavCluster *c, int src,
+                           bool reverse, uint16_t minClear, int32_t *dist) {
+  LocalEntry heap[HPA_CELLS * 8];
+  uint8_t    isEntrance[HPA_CELLS] = {0};
+  int        heapSize  = 0;
+  int        w         = c->x1 - c->x0 + 1;
+  int        expanded  = 0;
+  int        remaining = 0;
+
+  for (int i = 0; i < HPA_CELLS; i++) dist[i] = HPA_INF;
+  for (int i = 0; i < NAV_CLUSTER_NODES; i++) {
+    if (c->cell[i] < 0) continue;
+    int l = LocalIndex(grid, c, c->cell[i]);
+    if (!isEntrance[l]) remaining++;
+    isEntrance[l] = 1;
+  }
+
+  int sx = src % grid->width, sy = src / grid->width;
+  int sl = (sy - c->y0) * w + (sx - c->x0);
+  dist[sl] = 0;
+  // A* may start in a blocked cell but never enters one
+  if (!reverse || Walkable(grid, src)) LocalPush(heap, &heapSize, (LocalEntry){0, sl});
+
+  while (heapSize > 0) {
+    LocalEntry top = LocalPop(heap, &heapSize);
+    if (top.cost > dist[top.local]) continue;
+    expanded++;
+    if (isEntrance[top.local] && --remaining == 0) break;
+
+    int cx  = c->x0 + top.local % w;
+    int cy  = c->y0 + top.local / w;
+    int cur = NavGrid_Index(grid, cx, cy);
+
+    for (int i = 0; i < 8; i++) {
+      int nx = cx + s_dirs[i][0];
+      int ny = cy + s_dirs[i][1];
+      if (nx < c->x0 || ny < c->y0 || nx > c->x1 || ny > c->y1) continue;
+
+      int nIdx = NavGrid_Index(grid, nx, ny);
+      if (!Walkable(grid, nIdx) || !Clear(grid, nIdx, minClear)) continue;
+
+      bool diagonal = s_dirs[i][0] != 0 && s_dirs[i][1] != 0;
+      if (diagonal && (!Walkable(grid, NavGrid_Index(grid, nx, cy)) ||
+                       !Walkable(grid, NavGrid_Index(grid, cx, ny))))
+        continue;
+
+      int enter = grid->cells[reverse ? cur : nIdx].cost;
+      int c2    = top.cost + (diagonal ? 14 : 10) + enter;
+      int nl    = (ny - c->y0) * w + (nx - c->x0);
+      if (c2 < dist[nl]) {
+        dist[nl] = c2;
+        LocalPush(heap, &heapSize, (LocalEntry){c2, nl});
+      }
+    }
+  }
+  return expanded;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Building                                                          */
+/* ------------------------------------------------------------------ */
+
+// Openings along a border are separated by at least one closed cell, so an
+// even cluster size leaves at most NAV_SIDE_NODES of them per border.
+_Static_assert(NAV_CLUSTER_SIZE % 2 == 0,
+               "every border opening needs its own entrance slot");
+
+// Places entrances on the border between cluster a and its east or south
+// neighbour b. Every opening gets one entrance at its middle; wide ones
+// take one at each end instead while spare slots remain. Returns true if
+// either side's entrance cells changed.
+static bool BuildBorder(NavHierarchy *h, int a, int side) {
+  NavGrid    *grid = h->grid;
+  int         b    = ClusterNeighbor(h, a, side);
+  if (b < 0) return false;
+
+  NavCluster *ca    = &h->clusters[a];
+  NavCluster *cb    = &h->clusters[b];
+  int32_t    *slotA = &ca->cell[side * NAV_SIDE_NODES];
+  int32_t    *slotB = &cb->cell[(side ^ 1) * NAV_SIDE_NODES];
+
+  int32_t oldA[NAV_SIDE_NODES];
+  memcpy(oldA, slotA, sizeof(oldA));
+  for (int k = 0; k < NAV_SIDE_NODES; k++) slotA[k] = slotB[k] = -1;
+
+  bool east  = side == SIDE_EAST;
+  int  first = east ? ca->y0 : ca->x0;
+  int  last  = east ? ca->y1 : ca->x1;
+
+  // Collect the openings first so the split ends can't crowd any out
+  int runFirst[NAV_SIDE_NODES], runLast[NAV_SIDE_NODES];
+  int runs     = 0;
+  int runStart = -1;
+  for (int t = first; t <= last + 1; t++) {
+    bool open = false;
+    if (t <= last) {
+      int ia = east ? NavGrid_Index(grid, ca->x1, t) : NavGrid_Index(grid, t, ca->y1);
+      int ib = east ? NavGrid_Index(grid, cb->x0, t) : NavGrid_Index(grid, t, cb->y0);
+      open   = Walkable(grid, ia) && Walkable(grid, ib);
+    }
+    if (open && runStart < 0) runStart = t;
+    if (open || runStart < 0) continue;
+
+    // Opening [runStart, t-1] just closed
+    if (runs < NAV_SIDE_NODES) {
+      runFirst[runs]  = runStart;
+      runLast[runs++] = t - 1;
+    }
+    runStart = -1;
+  }
+
+  int spare = NAV_SIDE_NODES - runs;
+  int count = 0;
+  for (int r = 0; r < runs; r++) {
+    int ends[2], n = 0;
+    int len = runLast[r] - runFirst[r] + 1;
+    if (len >= HPA_ENTRANCE_SPLIT && spare > 0) {
+      ends[n++] = runFirst[r];
+      ends[n++] = runLast[r];
+      spare--;
+    } else {
+      ends[n++] = runFirst[r] + len / 2;
+    }
+    for (int e = 0; e < n; e++, count++) {
+      slotA[count] = east ? NavGrid_Index(grid, ca->x1, ends[e])
+                          : NavGrid_Index(grid, ends[e], ca->y1);
+      slotB[count] = east ? NavGrid_Index(grid, cb->x0, ends[e])
+                          : NavGrid_Index(grid, ends[e], cb->y0);
+    }
+  }
+  return memcmp(oldA, slotA, sizeof(oldA)) != 0;
+}
+
+static void BuildClusterCosts(NavHierarchy *h, int c) {
+  NavGrid    *grid = h->grid;
+  NavCluster *cl   = &h->clusters[c];
+  int32_t     dist[HPA_CELLS];
+
+  for (int i = 0; i < NAV_CLUSTER_NODES; i++) {
+    for (int j = 0; j < NAV_CLUSTER_NODES; j++) cl->cost[i][j] = -1;
+    if (cl->cell[i] < 0) continue;
+
+    ClusterDijkstra(grid, cl, cl->cell[i], false, 0, dist);
+    for (int j = 0; j < NAV_CLUSTER_NODES; j++) {
+      if (cl->cell[j] < 0) continue;
+      int32_t d = dist[LocalIndex(grid, cl, cl->cell[j])];
+      if (d < HPA_INF) cl->cost[i][j] = d;
+    }
+  }
+}
+
+void NavHierarchy_Build(NavHierarchy *h, NavGrid *grid) {
+  h->grid      = grid;
+  h->clustersX = (grid->width  + NAV_CLUSTER_SIZE - 1) / NAV_CLUSTER_SIZE;
+  h->clustersY = (grid->height + NAV_CLUSTER_SIZE - 1) / NAV_CLUSTER_SIZE;
+  h->clusters  = malloc(sizeof(NavCluster) * h->clustersX * h->clustersY);
+
+  for (int cy = 0; cy < h->clustersY; cy++) {
+    for (int cx = 0; cx < h->clustersX; cx++) {
+      NavCluster *c = &h->clusters[cy * h->clustersX + cx];
+      c->x0 = cx * NAV_CLUSTER_SIZE;
+      c->y0 = cy * NAV_CLUSTER_SIZE;
+      c->x1 = (cx + 1 < h->clustersX ? c->x0 + NAV_CLUSTER_SIZE : grid->width)  - 1;
+      c->y1 = (cy + 1 < h->clustersY ? c->y0 + NAV_CLUSTER_SIZE : grid->height) - 1;
+      for (int i = 0; i < NAV_CLUSTER_NODES; i++) c->cell[i] = -1;
+    }
+  }
+
+  int total = h->clustersX * h->clustersY;
+  for (int c = 0; c < total; c++) {
+    BuildBorder(h, c, SIDE_EAST);
+    BuildBorder(h, c, SIDE_SOUTH);
+  }
+  for (int c = 0; c < total; c++) BuildClusterCosts(h, c);
+
+  grid->hierarchy = h;
+}
+
+void NavHierarchy_Destroy(NavHierarchy *h) {
+  if (h->grid && h->grid->hierarchy == h) h->grid->hierarchy = NULL;
+  free(h->clusters);
+  memset(h, 0, sizeof(*h));
+}
+
+void NavHierarchy_CellChanged(NavHierarchy *h, int x, int y) {
+  if (!NavGrid_InBounds(h->grid, x, y)) return;
+
+  int         c  = ClusterAt(h, x, y);
+  NavCluster *cl = &h->clusters[c];
+
+  // A cell on the cluster's edge also decides that border's entrances
+  int  touched[4];
+  int  touchedCount = 0;
+  struct { bool onEdge; int owner; int side; } borders[4] = {
+    {x == cl->x0, ClusterNeighbor(h, c, SIDE_WEST),  SIDE_EAST},
+    {x == cl->x1, c,                                 SIDE_EAST},
+    {y == cl->y0, ClusterNeighbor(h, c, SIDE_NORTH), SIDE_SOUTH},
+    {y == cl->y1, c,                                 SIDE_SOUTH},
+  };
+  for (int i = 0; i < 4; i++) {
+    if (!borders[i].onEdge || borders[i].owner < 0) continue;
+    if (!BuildBorder(h, borders[i].owner, borders[i].side)) continue;
+    int other = borders[i].owner == c
+                    ? ClusterNeighbor(h, c, borders[i].side)
+                    : borders[i].owner;
+    if (other >= 0) touched[touchedCount++] = other;
+  }
+
+  BuildClusterCosts(h, c);
+  for (int i = 0; i < touchedCount; i++) BuildClusterCosts(h, touched[i]);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Queries                                                           */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+  int32_t fCost;
+  int32_t hCost; // ties go to the entry nearer the goal
+  int32_t node;
+} AbstractEntry;
+
+static inline bool AbstractLess(const AbstractEntry *a, const AbstractEntry *b) {
+  if (a->fCost != b->fCost) return a->fCost < b->fCost;
+  return a->hCost < b->hCost;
+}
+
+// Abstract-search scratch, one per thread like nav.c's default context.
+typedef struct {
+  int32_t       *g;
+  int32_t       *parent;
+  uint32_t      *stamps;
+  uint8_t       *closed;
+  int            capacity;
+  uint32_t       generation;
+  AbstractEntry *heap;
+  int            heapSize;
+  int            heapCap;
+  int32_t       *route; // entrance cells, start to goal
+  int            routeCap;
+  NavPath        segment;
+} HpaScratch;
+
+static _Thread_local HpaScratch s_scratch;
+
+static void ScratchBegin(HpaScratch *s, int nodeCount) {
+  if (nodeCount > s->capacity) {
+    s->g      = realloc(s->g,      sizeof(int32_t)  * nodeCount);
+    s->parent = realloc(s->parent, sizeof(int32_t)  * nodeCount);
+    s->closed = realloc(s->closed, sizeof(uint8_t)  * nodeCount);
+    s->stamps = realloc(s->stamps, sizeof(uint32_t) * nodeCount);
+    memset(s->stamps + s->capacity, 0,
+           sizeof(uint32_t) * (nodeCount - s->capacity));
+    s->capacity = nodeCount;
+  }
+  if (!s->segment.points) NavPath_Init(&s->segment, 64);
+  s->heapSize = 0;
+  if (++s->generation == 0) {
+    memset(s->stamps, 0, sizeof(uint32_t) * s->capacity);
+    s->generation = 1;
+  }
+}
+
+static void AbstractPush(HpaScratch *s, AbstractEntry e) {
+  if (s->heapSize >= s->heapCap) {
+    s->heapCap = s->heapCap ? s->heapCap * 2 : 256;
+    s->heap    = realloc(s->heap, sizeof(AbstractEntry) * s->heapCap);
+  }
+  int pos = s->heapSize++;
+  while (pos > 0) {
+    int parent = (pos - 1) / 2;
+    if (!AbstractLess(&e, &s->heap[parent])) break;
+    s->heap[pos] = s->heap[parent];
+    pos = parent;
+  }
+  s->heap[pos] = e;
+}
+
+static AbstractEntry AbstractPop(HpaScratch *s) {
+  AbstractEntry top  = s->heap[0];
+  AbstractEntry last = s->heap[--s->heapSize];
+  int pos = 0;
+  while (true) {
+    int child = 2 * pos + 1;
+    if (child >= s->heapSize) break;
+    if (child + 1 < s->heapSize && AbstractLess(&s->heap[child + 1], &s->heap[child]))
+      child++;
+    if (!AbstractLess(&s->heap[child], &last)) break;
+    s->heap[pos] = s->heap[child];
+    pos = child;
+  }
+  if (s->heapSize > 0) s->heap[pos] = last;
+  return top;
+}
+
+static void Relax(HpaScratch *s, int node, int32_t g, int32_t parent, int hCost) {
+  if (s->stamps[node] != s->generation) {
+    s->stamps[node] = s->generation;
+    s->g[node]      = HPA_INF;
+    s->closed[node] = 0;
+  }
+  if (s->closed[node] || g >= s->g[node]) return;
+  s->g[node]      = g;
+  s->parent[node] = parent;
+  AbstractPush(s, (AbstractEntry){g + hCost, hCost, node});
+}
+
+static void PathAppend(NavPath *path, Vector3 p) {
+  NavPath_Reserve(path, path->count + 1);
+  path->points[path->count++] = p;
+}
+
+bool NavHierarchy_FindPath(NavHierarchy *h, NavSearchContext *ctx,
+                           Vector3 startWorld, Vector3 goalWorld,
+                           NavPath *outPath) {
+  NavGrid *grid = h->grid;
+  outPath->count        = 0;
+  outPath->currentIndex = 0;
+
+  int sx, sy, gx, gy;
+  if (!NavGrid_WorldToCell(grid, startWorld, &sx, &sy)) return false;
+  if (!NavGrid_WorldToCell(grid, goalWorld,  &gx,  &gy)) return false;
+
+  int cs = ClusterAt(h, sx, sy);
+  int cg = ClusterAt(h, gx, gy);
+  if (cs == cg || (abs(sx - gx) < NAV_HPA_MIN_SPAN && abs(sy - gy) < NAV_HPA_MIN_SPAN))
+    return NavGrid_FindPathCells(grid, ctx, startWorld, goalWorld, outPath);
+
+  int      startIdx = NavGrid_Index(grid, sx, sy);
+  int      goalIdx  = NavGrid_Index(grid, gx, gy);
+  int      expanded = 0;
+  uint16_t minClear = grid->clearance ? ctx->minClearance : 0;
+
+  // Connect start and goal to the entrances of their clusters
+  NavCluster *clS = &h->clusters[cs];
+  NavCluster *clG = &h->clusters[cg];
+  int32_t     dist[HPA_CELLS];
+  int32_t     startCost[NAV_CLUSTER_NODES];
+  int32_t     goalCost[NAV_CLUSTER_NODES];
+
+  expanded += ClusterDijkstra(grid, clS, startIdx, false, minClear, dist);
+  for (int i = 0; i < NAV_CLUSTER_NODES; i++)
+    startCost[i] = clS->cell[i] >= 0 ? dist[LocalIndex(grid, clS, clS->cell[i])] : HPA_INF;
+  expanded += ClusterDijkstra(grid, clG, goalIdx, true, minClear, dist);
+  for (int i = 0; i < NAV_CLUSTER_NODES; i++)
+    goalCost[i] = clG->cell[i] >= 0 ? dist[LocalIndex(grid, clG, clG->cell[i])] : HPA_INF;
+
+  // Abstract A*: entrance nodes are cluster * NAV_CLUSTER_NODES + slot
+  HpaScratch *s      = &s_scratch;
+  int         nodes  = h->clustersX * h->clustersY * NAV_CLUSTER_NODES;
+  int         startN = nodes;
+  int         goalN  = nodes + 1;
+  ScratchBegin(s, nodes + 2);
+
+  Relax(s, startN, 0, -1, Octile(sx, sy, gx, gy));
+  bool found = false;
+  while (s->heapSize > 0) {
+    AbstractEntry top = AbstractPop(s);
+    int node = top.node;
+    if (s->closed[node]) continue;
+    s->closed[node] = 1;
+    expanded++;
+    if (node == goalN) { found = true; break; }
+
+    int32_t g = s->g[node];
+    if (node == startN) {
+      for (int i = 0; i < NAV_CLUSTER_NODES; i++) {
+        if (startCost[i] >= HPA_INF) continue;
+        int cell = clS->cell[i];
+        Relax(s, cs * NAV_CLUSTER_NODES + i, startCost[i], node,
+              Octile(cell % grid->width, cell / grid->width, gx, gy));
+      }
+      continue;
+    }
+
+    int         c    = node / NAV_CLUSTER_NODES;
+    int         slot = node % NAV_CLUSTER_NODES;
+    NavCluster *cl   = &h->clusters[c];
+
+    // Cluster costs are for point agents: a lower bound for wider ones,
+    // whose hops are refined at their clearance below
+    for (int j = 0; j < NAV_CLUSTER_NODES; j++) {
+      if (j == slot || cl->cost[slot][j] < 0) continue;
+      int cell = cl->cell[j];
+      if (!Clear(grid, cell, minClear)) continue;
+      Relax(s, c * NAV_CLUSTER_NODES + j, g + cl->cost[slot][j], node,
+            Octile(cell % grid->width, cell / grid->width, gx, gy));
+    }
+
+    // Step across the border to the paired entrance
+    int side = slot / NAV_SIDE_NODES;
+    int nb   = ClusterNeighbor(h, c, side);
+    if (nb >= 0) {
+      int pSlot = (side ^ 1) * NAV_SIDE_NODES + slot % NAV_SIDE_NODES;
+      int cell  = h->clusters[nb].cell[pSlot];
+      if (cell >= 0 && Clear(grid, cell, minClear))
+        Relax(s, nb * NAV_CLUSTER_NODES + pSlot,
+              g + 10 + grid->cells[cell].cost, node,
+              Octile(cell % grid->width, cell / grid->width, gx, gy));
+    }
+
+    if (c == cg && goalCost[slot] < HPA_INF)
+      Relax(s, goalN, g + goalCost[slot], node, 0);
+  }
+
+  if (!found) {
+    bool ok = NavGrid_FindPathCells(grid, ctx, startWorld, goalWorld, outPath);
+    ctx->expanded += expanded;
+    return ok;
+  }
+
+  // Collect the route's cells, goal first
+  int routeLen = 0;
+  for (int n = goalN; n >= 0; n = s->parent[n]) {
+    if (routeLen >= s->routeCap) {
+      s->routeCap = s->routeCap ? s->routeCap * 2 : 64;
+      s->route    = realloc(s->route, sizeof(int32_t) * s->routeCap);
+    }
+    int cell = n == goalN  ? goalIdx
+             : n == startN ? startIdx
+             : h->clusters[n / NAV_CLUSTER_NODES].cell[n % NAV_CLUSTER_NODES];
+    s->route[routeLen++] = cell;
+  }
+
+  // Refine hop by hop; border crossings are single steps
+  PathAppend(outPath, NavGrid_CellCenter(grid, sx, sy));
+  for (int i = routeLen - 1; i > 0; i--) {
+    int a = s->route[i], b = s->route[i - 1];
+    if (a == b) continue;
+
+    int ax = a % grid->width, ay = a / grid->width;
+    int bx = b % grid->width, by = b / grid->width;
+    if (abs(ax - bx) + abs(ay - by) == 1) {
+      PathAppend(outPath, NavGrid_CellCenter(grid, bx, by));
+      continue;
+    }
+
+    bool ok = NavGrid_FindPathCells(grid, ctx, NavGrid_CellCenter(grid, ax, ay),
+                                    NavGrid_CellCenter(grid, bx, by), &s->segment);
+    expanded += ctx->expanded;
+    if (!ok) {
+      ok = NavGrid_FindPathCells(grid, ctx, startWorld, goalWorld, outPath);
+      ctx->expanded += expanded;
+      return ok;
+    }
+    for (int k = 1; k < s->segment.count; k++)
+      PathAppend(outPath, s->segment.points[k]);
+  }
+
+  ctx->expanded = expanded;
+  return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "nav.h"
+
+// Hierarchical path-finding (HPA*) over a NavGrid. The grid is cut into
+// square clusters; walkable openings on each shared border become entrance
+// nodes, joined inside a cluster by precomputed path costs. Long queries
+// search that small graph and then refine only the hops on the chosen route
+// with NavGrid_FindPathCells. Results are near-optimal rather than optimal.
+
+#define NAV_CLUSTER_SIZE  10
+#define NAV_SIDE_NODES    (NAV_CLUSTER_SIZE / 2) // entrance slots per border
+#define NAV_CLUSTER_NODES (4 * NAV_SIDE_NODES)
+// Queries spanning fewer cells than this skip the hierarchy
+#define NAV_HPA_MIN_SPAN  (2 * NAV_CLUSTER_SIZE)
+
+typedef struct {
+  int     x0, y0, x1, y1;                             // inclusive cell bounds
+  int32_t cell[NAV_CLUSTER_NODES];                    // -1 = unused slot
+  int32_t cost[NAV_CLUSTER_NODES][NAV_CLUSTER_NODES]; // -1 = not connected
+} NavCluster;
+
+typedef struct NavHierarchy {
+  NavGrid    *grid;
+  int         clustersX;
+  int         clustersY;
+  NavCluster *clusters;
+} NavHierarchy;
+
+// Builds the abstraction and attaches it to grid, so NavGrid_FindPathCtx
+// uses it for long queries and NavGrid_SetCell keeps it current.
+void NavHierarchy_Build(NavHierarchy *h, NavGrid *grid);
+void NavHierarchy_Destroy(NavHierarchy *h);
+
+// Rebuilds only the clusters whose entrances or internal costs depend on
+// cell (x, y). Called by NavGrid_SetCell.
+void NavHierarchy_CellChanged(NavHierarchy *h, int x, int y);
+
+// Falls back to NavGrid_FindPathCells for short queries, and when the abstract graph
+// finds no route. ctx->expanded totals every phase of the query. Honours
+// ctx->minClearance: narrow entrances are skipped and every hop is refined
+// at that clearance, so wide agents keep the fast path.
+bool NavHierarchy_FindPath(NavHierarchy *h, NavSearchContext *ctx,
+                           Vector3 startWorld, Vector3 goalWorld,
+                           NavPath *outPath);
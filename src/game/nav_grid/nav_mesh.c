@@ -0,0 +1,494 @@
+#include "nav_mesh.h"
+#include <float.h>
+#include <string.h>
+
+static inline bool Walkable(const NavGrid *grid, int x, int y) {
+  if (!NavGrid_InBounds((NavGrid *)grid, x, y)) return false;
+  NavCellType t = grid->cells[y * grid->width + x].type;
+  return t != NAV_CELL_WALL && t != NAV_CELL_BLOCKED && t != NAV_CELL_FENCE;
+}
+
+// Same per-cell weighting as the grid's 10 + cost step, normalized so open
+// ground weighs 1 and world distance stays an admissible heuristic
+static inline float PolyWeight(const NavPoly *p) {
+  return (10.0f + p->cost) / 11.0f;
+}
+
+static inline Vector2 PolyCenter(const NavGrid *g, const NavPoly *p) {
+  return (Vector2){g->origin.x + (p->x0 + p->x1 + 1) * 0.5f * g->cellSize,
+                   g->origin.z + (p->y0 + p->y1 + 1) * 0.5f * g->cellSize};
+}
+
+/* ------------------------------------------------------------------ */
+/*  Build                                                             */
+/* ------------------------------------------------------------------ */
+
+static bool Free(const NavMesh *m, int x, int y, uint8_t cost) {
+  return Walkable(m->grid, x, y) &&
+         m->cellPoly[y * m->grid->width + x] < 0 &&
+         m->grid->cells[y * m->grid->width + x].cost == cost;
+}
+
+static void AddLink(NavMesh *m, int *cap, NavPortal link) {
+  if (m->linkCount >= *cap) {
+    *cap    = *cap ? *cap * 2 : 256;
+    m->links = realloc(m->links, sizeof(NavPortal) * *cap);
+  }
+  m->links[m->linkCount++] = link;
+}
+
+// Portals along one side of the polygon whose links are being appended.
+// Cells are addressed as (along, across): along runs over the side,
+// inside/outside are the across coordinates of the polygon's border cells
+// and of their neighbours.
+static void AddSidePortals(NavMesh *m, int *cap, bool alongX,
+                           int inside, int outside, int t0, int t1) {
+  const NavGrid *g  = m->grid;
+  float          cs = g->cellSize;
+  // World coordinate of the shared edge, across the side
+  float edge = alongX ? g->origin.z + (inside > outside ? inside : outside) * cs
+                      : g->origin.x + (inside > outside ? inside : outside) * cs;
+  float base   = alongX ? g->origin.x : g->origin.z;
+  float margin = NAV_MESH_MARGIN * cs;
+
+  int t = t0;
+  while (t <= t1) {
+    int ox = alongX ? t : outside, oy = alongX ? outside : t;
+    int q  = NavGrid_InBounds((NavGrid *)g, ox, oy)
+                 ? m->cellPoly[oy * g->width + ox] : -1;
+    int end = t;
+    while (end + 1 <= t1) {
+      int nx = alongX ? end + 1 : outside, ny = alongX ? outside : end + 1;
+      int nq = NavGrid_InBounds((NavGrid *)g, nx, ny)
+                   ? m->cellPoly[ny * g->width + nx] : -1;
+      if (nq != q) break;
+      end++;
+    }
+
+    if (q >= 0) {
+      float lo = base + t * cs, hi = base + (end + 1) * cs;
+      // Keep off walls at either end, so agents don't graze corners
+      #define OPEN(a, c) (alongX ? Walkable(g, a, c) : Walkable(g, c, a))
+      bool loOpen = OPEN(t - 1, inside) && OPEN(t - 1, outside);
+      bool hiOpen = OPEN(end + 1, inside) && OPEN(end + 1, outside);
+      #undef OPEN
+      float shrink = fminf(margin, 0.5f * (hi - lo));
+      if (!loOpen) lo += shrink;
+      if (!hiOpen) hi -= shrink;
+
+      NavPortal link = {.poly = q};
+      link.a = alongX ? (Vector2){lo, edge} : (Vector2){edge, lo};
+      link.b = alongX ? (Vector2){hi, edge} : (Vector2){edge, hi};
+      AddLink(m, cap, link);
+    }
+    t = end + 1;
+  }
+}
+
+void NavMesh_Build(NavMesh *mesh, NavGrid *grid) {
+  int cells = grid->width * grid->height;
+  mesh->grid      = grid;
+  mesh->cellPoly  = realloc(mesh->cellPoly, sizeof(int32_t) * cells);
+  mesh->polyCount = 0;
+  mesh->linkCount = 0;
+  mesh->dirty     = false;
+  for (int i = 0; i < cells; i++) mesh->cellPoly[i] = -1;
+
+  // Greedy rectangles: widest run first, then as many rows as match
+  int polyCap = 0;
+  for (int y = 0; y < grid->height; y++) {
+    for (int x = 0; x < grid->width; x++) {
+      if (!Walkable(grid, x, y) || mesh->cellPoly[y * grid->width + x] >= 0)
+        continue;
+      uint8_t cost = grid->cells[y * grid->width + x].cost;
+
+      int w = 1;
+      while (w < NAV_MESH_MAX_SPAN && Free(mesh, x + w, y, cost)) w++;
+      int h = 1;
+      while (h < NAV_MESH_MAX_SPAN) {
+        bool rowFree = true;
+        for (int i = 0; i < w && rowFree; i++) rowFree = Free(mesh, x + i, y + h, cost);
+        if (!rowFree) break;
+        h++;
+      }
+
+      if (mesh->polyCount >= polyCap) {
+        polyCap     = polyCap ? polyCap * 2 : 256;
+        mesh->polys = realloc(mesh->polys, sizeof(NavPoly) * polyCap);
+      }
+      int p = mesh->polyCount++;
+      mesh->polys[p] = (NavPoly){x, y, x + w - 1, y + h - 1, cost, 0, 0};
+      for (int yy = y; yy < y + h; yy++)
+        for (int xx = x; xx < x + w; xx++)
+          mesh->cellPoly[yy * grid->width + xx] = p;
+    }
+  }
+
+  int linkCap = 0;
+  for (int p = 0; p < mesh->polyCount; p++) {
+    NavPoly *poly   = &mesh->polys[p];
+    poly->firstLink = mesh->linkCount;
+    AddSidePortals(mesh, &linkCap, false, poly->x0, poly->x0 - 1, poly->y0, poly->y1);
+    AddSidePortals(mesh, &linkCap, false, poly->x1, poly->x1 + 1, poly->y0, poly->y1);
+    AddSidePortals(mesh, &linkCap, true,  poly->y0, poly->y0 - 1, poly->x0, poly->x1);
+    AddSidePortals(mesh, &linkCap, true,  poly->y1, poly->y1 + 1, poly->x0, poly->x1);
+    poly->linkCount = mesh->linkCount - poly->firstLink;
+  }
+
+  grid->mesh = mesh;
+}
+
+void NavMesh_Destroy(NavMesh *mesh) {
+  if (mesh->grid && mesh->grid->mesh == mesh) mesh->grid->mesh = NULL;
+  free(mesh->polys);
+  free(mesh->links);
+  free(mesh->cellPoly);
+  memset(mesh, 0, sizeof(*mesh));
+}
+
+/* ------------------------------------------------------------------ */
+/*  Polygon A*                                                        */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+  float   f, h;
+  int32_t node;
+} MeshEntry;
+
+// Search scratch, one per thread like nav.c's default context.
+typedef struct {
+  float     *g;
+  int32_t   *parent;
+  int32_t   *via;    // link used to enter the polygon
+  Vector2   *entry;  // where the route enters the polygon
+  uint32_t  *stamps;
+  uint8_t   *closed;
+  int        capacity;
+  uint32_t   generation;
+  MeshEntry *heap;
+  int        heapSize;
+  int        heapCap;
+  int32_t   *route;  // links, start to goal
+  int        routeCap;
+  Vector2   *left, *right; // funnel portals
+  int        portalCap;
+} MeshScratch;
+
+static _Thread_local MeshScratch s_scratch;
+
+static void ScratchBegin(MeshScratch *s, int nodeCount) {
+  if (nodeCount > s->capacity) {
+    s->g      = realloc(s->g,      sizeof(float)    * nodeCount);
+    s->parent = realloc(s->parent, sizeof(int32_t)  * nodeCount);
+    s->via    = realloc(s->via,    sizeof(int32_t)  * nodeCount);
+    s->entry  = realloc(s->entry,  sizeof(Vector2)  * nodeCount);
+    s->closed = realloc(s->closed, sizeof(uint8_t)  * nodeCount);
+    s->stamps = realloc(s->stamps, sizeof(uint32_t) * nodeCount);
+    memset(s->stamps + s->capacity, 0,
+           sizeof(uint32_t) * (nodeCount - s->capacity));
+    s->capacity = nodeCount;
+  }
+  s->heapSize = 0;
+  if (++s->generation == 0) {
+    memset(s->stamps, 0, sizeof(uint32_t) * s->capacity);
+    s->generation = 1;
+  }
+}
+
+static inline bool EntryLess(const MeshEntry *a, const MeshEntry *b) {
+  if (a->f != b->f) return a->f < b->f;
+  return a->h < b->h;
+}
+
+static void HeapPush(MeshScratch *s, MeshEntry e) {
+  if (s->heapSize >= s->heapCap) {
+    s->heapCap = s->heapCap ? s->heapCap * 2 : 256;
+    s->heap    = realloc(s->heap, sizeof(MeshEntry) * s->heapCap);
+  }
+  int pos = s->heapSize++;
+  while (pos > 0) {
+    int parent = (pos - 1) / 2;
+    if (!EntryLess(&e, &s->heap[parent])) break;
+    s->heap[pos] = s->heap[parent];
+    pos = parent;
+  }
+  s->heap[pos] = e;
+}
+
+static MeshEntry HeapPop(MeshScratch *s) {
+  MeshEntry top  = s->heap[0];
+  MeshEntry last = s->heap[--s->heapSize];
+  int pos = 0;
+  while (true) {
+    int child = 2 * pos + 1;
+    if (child >= s->heapSize) break;
+    if (child + 1 < s->heapSize && EntryLess(&s->heap[child + 1], &s->heap[child]))
+      child++;
+    if (!EntryLess(&s->heap[child], &last)) break;
+    s->heap[pos] = s->heap[child];
+    pos = child;
+  }
+  if (s->heapSize > 0) s->heap[pos] = last;
+  return top;
+}
+
+static void Touch(MeshScratch *s, int node) {
+  if (s->stamps[node] == s->generation) return;
+  s->stamps[node] = s->generation;
+  s->g[node]      = FLT_MAX;
+  s->closed[node] = 0;
+}
+
+// Where the straight line from p to goal crosses the portal, clamped to its
+// ends; keeps the search's entry points close to the funnel's
+static Vector2 PortalPoint(Vector2 p, Vector2 goal, Vector2 a, Vector2 b) {
+  if (a.x == b.x) {
+    float dx = goal.x - p.x;
+    float t  = fabsf(dx) > 1e-6f ? Clamp((a.x - p.x) / dx, 0.0f, 1.0f) : 0.0f;
+    float z  = p.y + (goal.y - p.y) * t;
+    return (Vector2){a.x, Clamp(z, fminf(a.y, b.y), fmaxf(a.y, b.y))};
+  }
+  float dz = goal.y - p.y;
+  float t  = fabsf(dz) > 1e-6f ? Clamp((a.y - p.y) / dz, 0.0f, 1.0f) : 0.0f;
+  float x  = p.x + (goal.x - p.x) * t;
+  return (Vector2){Clamp(x, fminf(a.x, b.x), fmaxf(a.x, b.x)), a.y};
+}
+
+// Polygon containing (x, y), or the nearest one within NAV_MESH_SNAP cells
+static int LocatePoly(const NavMesh *m, int x, int y, int *outX, int *outY) {
+  const NavGrid *g = m->grid;
+  int best = -1, bestD = INT32_MAX;
+  for (int r = 0; r <= NAV_MESH_SNAP && best < 0; r++) {
+    for (int dy = -r; dy <= r; dy++) {
+      for (int dx = -r; dx <= r; dx++) {
+        if (abs(dx) != r && abs(dy) != r) continue; // ring only
+        int nx = x + dx, ny = y + dy;
+        if (!NavGrid_InBounds((NavGrid *)g, nx, ny)) continue;
+        int p = m->cellPoly[ny * g->width + nx];
+        if (p < 0 || dx * dx + dy * dy >= bestD) continue;
+        best  = p;
+        bestD = dx * dx + dy * dy;
+        *outX = nx;
+        *outY = ny;
+      }
+    }
+  }
+  return best;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Funnel                                                            */
+/* ------------------------------------------------------------------ */
+
+// > 0 when c lies left of (counter-clockwise from) the ray a -> b
+static inline float Cross(Vector2 a, Vector2 b, Vector2 c) {
+  return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+static inline bool Same(Vector2 a, Vector2 b) {
+  return fabsf(a.x - b.x) < 1e-5f && fabsf(a.y - b.y) < 1e-5f;
+}
+
+static void PathAppend(NavPath *path, Vector2 p) {
+  NavPath_Reserve(path, path->count + 1);
+  if (path->count > 0) {
+    Vector3 last = path->points[path->count - 1];
+    if (Same((Vector2){last.x, last.z}, p)) return;
+  }
+  path->points[path->count++] = (Vector3){p.x, 0.0f, p.y};
+}
+
+// Simple stupid funnel over portals 0..n-1, where 0 and n-1 are the start
+// and goal as zero-width portals. Appends the corners and the goal.
+static void Funnel(const Vector2 *left, const Vector2 *right, int n,
+                   NavPath *out) {
+  Vector2 apex = left[0], fl = left[0], fr = right[0];
+  int     apexIdx = 0, leftIdx = 0, rightIdx = 0;
+  PathAppend(out, apex);
+
+  for (int i = 1; i < n; i++) {
+    Vector2 l = left[i], r = right[i];
+
+    // Right side: move inward unless it crosses the left side
+    if (Cross(apex, fr, r) >= 0.0f) {
+      if (Same(apex, fr) || Cross(apex, fl, r) < 0.0f) {
+        fr       = r;
+        rightIdx = i;
+      } else {
+        apex    = fl;
+        apexIdx = leftIdx;
+        PathAppend(out, apex);
+        fl = fr = apex;
+        leftIdx = rightIdx = apexIdx;
+        i = apexIdx;
+        continue;
+      }
+    }
+
+    // Left side, mirrored
+    if (Cross(apex, fl, l) <= 0.0f) {
+      if (Same(apex, fl) || Cross(apex, fr, l) > 0.0f) {
+        fl      = l;
+        leftIdx = i;
+      } else {
+        apex    = fr;
+        apexIdx = rightIdx;
+        PathAppend(out, apex);
+        fl = fr = apex;
+        leftIdx = rightIdx = apexIdx;
+        i = apexIdx;
+        continue;
+      }
+    }
+  }
+  PathAppend(out, left[n - 1]);
+}
+
+static void ReservePortals(MeshScratch *s, int n) {
+  if (n <= s->portalCap) return;
+  s->portalCap = n * 2;
+  s->left  = realloc(s->left,  sizeof(Vector2) * s->portalCap);
+  s->right = realloc(s->right, sizeof(Vector2) * s->portalCap);
+}
+
+bool NavMesh_FindPath(NavMesh *mesh, Vector3 startWorld, Vector3 goalWorld,
+                      NavPath *outPath) {
+  NavPath_Clear(outPath);
+  NavGrid *g = mesh->grid;
+  int sx, sy, gx, gy;
+  if (!NavGrid_WorldToCell(g, startWorld, &sx, &sy)) return false;
+  if (!NavGrid_WorldToCell(g, goalWorld, &gx, &gy)) return false;
+
+  int goalPoly = mesh->cellPoly[gy * g->width + gx];
+  if (goalPoly < 0) return false; // as on the grid, a blocked goal is unreachable
+
+  Vector2 start = {startWorld.x, startWorld.z};
+  Vector2 goal  = {goalWorld.x, goalWorld.z};
+  int     px, py;
+  int     startPoly = LocatePoly(mesh, sx, sy, &px, &py);
+  if (startPoly < 0) return false;
+  if (px != sx || py != sy) {
+    // Pushed into a blocked cell: step back onto the mesh first
+    PathAppend(outPath, start);
+    Vector3 c = NavGrid_CellCenter(g, px, py);
+    start     = (Vector2){c.x, c.z};
+  }
+
+  MeshScratch *s = &s_scratch;
+  ScratchBegin(s, mesh->polyCount);
+  Touch(s, startPoly);
+  s->g[startPoly]      = 0.0f;
+  s->parent[startPoly] = -1;
+  s->via[startPoly]    = -1;
+  s->entry[startPoly]  = start;
+  float h0 = Vector2Distance(start, goal);
+  HeapPush(s, (MeshEntry){h0, h0, startPoly});
+
+  bool found = false;
+  while (s->heapSize > 0) {
+    MeshEntry top = HeapPop(s);
+    int       p   = top.node;
+    if (s->closed[p]) continue;
+    if (p == goalPoly) { found = true; break; }
+    s->closed[p] = 1;
+
+    const NavPoly *poly = &mesh->polys[p];
+    float          w    = PolyWeight(poly);
+    for (int k = 0; k < poly->linkCount; k++) {
+      int              li   = poly->firstLink + k;
+      const NavPortal *link = &mesh->links[li];
+      int              q    = link->poly;
+      Touch(s, q);
+      if (s->closed[q]) continue;
+
+      Vector2 e  = PortalPoint(s->entry[p], goal, link->a, link->b);
+      float   ng = s->g[p] + Vector2Distance(s->entry[p], e) * w;
+      float   h  = Vector2Distance(e, goal);
+      if (q == goalPoly) ng += h * PolyWeight(&mesh->polys[q]);
+      if (ng >= s->g[q]) continue;
+
+      s->g[q]      = ng;
+      s->parent[q] = p;
+      s->via[q]    = li;
+      s->entry[q]  = e;
+      HeapPush(s, (MeshEntry){ng + (q == goalPoly ? 0.0f : h), h, q});
+    }
+  }
+  if (!found) {
+    NavPath_Clear(outPath);
+    return false;
+  }
+
+  // Portals along the route, oriented left/right for the direction of travel
+  int n = 0;
+  for (int p = goalPoly; s->via[p] >= 0; p = s->parent[p]) n++;
+  ReservePortals(s, n + 2);
+  s->left[0] = s->right[0] = start;
+  int i = n;
+  for (int p = goalPoly; s->via[p] >= 0; p = s->parent[p], i--) {
+    const NavPortal *link = &mesh->links[s->via[p]];
+    Vector2 from = PolyCenter(g, &mesh->polys[s->parent[p]]);
+    Vector2 to   = PolyCenter(g, &mesh->polys[p]);
+    // Portals are axis-aligned, so travel is along the other axis
+    Vector2 dir  = link->a.x == link->b.x
+                       ? (Vector2){to.x > from.x ? 1.0f : -1.0f, 0.0f}
+                       : (Vector2){0.0f, to.y > from.y ? 1.0f : -1.0f};
+    Vector2 mid  = Vector2Scale(Vector2Add(link->a, link->b), 0.5f);
+    bool    aLeft = Cross(mid, Vector2Add(mid, dir), link->a) > 0.0f;
+    s->left[i]  = aLeft ? link->a : link->b;
+    s->right[i] = aLeft ? link->b : link->a;
+  }
+  s->left[n + 1] = s->right[n + 1] = goal;
+
+  Funnel(s->left, s->right, n + 2, outPath);
+  NavPath_UpdateLengths(outPath);
+  return true;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Line of sight                                                     */
+/* ------------------------------------------------------------------ */
+
+bool NavMesh_HasLOS(NavMesh *mesh, Vector3 from, Vector3 to) {
+  NavGrid *g = mesh->grid;
+  int x, y, tx, ty;
+  if (!NavGrid_WorldToCell(g, from, &x, &y)) return false;
+  if (!NavGrid_WorldToCell(g, to, &tx, &ty)) return false;
+
+  float ox = (from.x - g->origin.x) / g->cellSize; // in cell units
+  float oz = (from.z - g->origin.z) / g->cellSize;
+  float dx = (to.x - from.x) / g->cellSize;
+  float dz = (to.z - from.z) / g->cellSize;
+  bool  first = true;
+
+  while (x != tx || y != ty) {
+    int x0 = x, y0 = y, x1 = x, y1 = y;
+    int p  = mesh->cellPoly[y * g->width + x];
+    if (p >= 0) {
+      // Walkable polygons never block; skip the whole rectangle
+      x0 = mesh->polys[p].x0; y0 = mesh->polys[p].y0;
+      x1 = mesh->polys[p].x1; y1 = mesh->polys[p].y1;
+      if (tx >= x0 && tx <= x1 && ty >= y0 && ty <= y1) return true;
+    } else if (!first) {
+      NavCellType t = g->cells[y * g->width + x].type;
+      if (t == NAV_CELL_WALL || t == NAV_CELL_BLOCKED) return false;
+      // FENCE is LOS-transparent
+    }
+    first = false;
+
+    // Leave the rectangle through the nearer of its two facing sides
+    float txExit = dx > 0 ? (x1 + 1 - ox) / dx : dx < 0 ? (x0 - ox) / dx : FLT_MAX;
+    float tzExit = dz > 0 ? (y1 + 1 - oz) / dz : dz < 0 ? (y0 - oz) / dz : FLT_MAX;
+    float t      = fminf(txExit, tzExit);
+    int   nx     = (int)floorf(ox + dx * t);
+    int   ny     = (int)floorf(oz + dz * t);
+    if (txExit <= tzExit) nx = dx > 0 ? x1 + 1 : x0 - 1;
+    else                  nx = nx < x0 ? x0 : nx > x1 ? x1 : nx;
+    if (tzExit <= txExit) ny = dz > 0 ? y1 + 1 : y0 - 1;
+    else                  ny = ny < y0 ? y0 : ny > y1 ? y1 : ny;
+    if (!NavGrid_InBounds(g, nx, ny)) return false;
+    x = nx;
+    y = ny;
+  }
+  return true;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "nav.h"
+
+// Polygon navmesh over a NavGrid's walkable cells. Runs of walkable cells
+// with equal cost are merged into rectangles (convex polygons), joined by
+// portals along their shared edges. Searches run A* over the polygons and
+// string-pull the result through the portals with the funnel algorithm, so
+// open ground costs one node instead of hundreds of cells. Paths may run
+// along a blocked cell's edge, so use it on grids baked with an agent radius.
+
+#define NAV_MESH_MAX_SPAN  16   // longest polygon side, in cells
+#define NAV_MESH_SNAP      4    // cells searched for a polygon from a blocked start
+#define NAV_MESH_MARGIN    0.5f // portal ends kept this many cells off walls
+
+typedef struct {
+  int     x0, y0, x1, y1; // inclusive cell bounds
+  uint8_t cost;           // cost of every cell in the polygon
+  int32_t firstLink;
+  int32_t linkCount;
+} NavPoly;
+
+typedef struct {
+  int32_t poly;   // polygon on the other side
+  Vector2 a, b;   // portal endpoints in world XZ, wall margin applied
+} NavPortal;
+
+typedef struct NavMesh {
+  NavGrid   *grid;
+  NavPoly   *polys;
+  int        polyCount;
+  NavPortal *links;    // each polygon's portals, contiguous from firstLink
+  int        linkCount;
+  int32_t   *cellPoly; // polygon per cell, -1 for unwalkable
+  bool       dirty;    // cells changed since the last build
+} NavMesh;
+
+// Builds the mesh and attaches it to grid, so NavGrid_FindPathCtx and
+// NavGrid_HasLOS use it. Call again after editing cells (NavGrid_EndEdits).
+void NavMesh_Build(NavMesh *mesh, NavGrid *grid);
+void NavMesh_Destroy(NavMesh *mesh);
+
+bool NavMesh_FindPath(NavMesh *mesh, Vector3 startWorld, Vector3 goalWorld,
+                      NavPath *outPath);
+// Line of sight with the grid's rules (walls and blocked cells stop it,
+// fences and cover don't), traced a whole polygon at a time.
+bool NavMesh_HasLOS(NavMesh *mesh, Vector3 from, Vector3 to);
@@ -0,0 +1,107 @@
+#include "nav_occupancy.h"
+#include <string.h>
+
+void NavOccupancy_Init(NavOccupancy *o, NavGrid *grid) {
+  int cells = grid->width * grid->height;
+  memset(o, 0, sizeof(*o));
+  o->grid = grid;
+  o->head = malloc(sizeof(int32_t) * cells);
+  memset(o->head, 0xFF, sizeof(int32_t) * cells); // all -1
+  grid->occupancy = o;
+}
+
+void NavOccupancy_Destroy(NavOccupancy *o) {
+  if (o->grid && o->grid->occupancy == o) o->grid->occupancy = NULL;
+  free(o->head);
+  free(o->claims);
+  free(o->holders);
+  memset(o, 0, sizeof(*o));
+}
+
+static void Reserve(NavOccupancy *o, uint32_t id) {
+  if (id < o->capacity) return;
+  uint32_t cap = o->capacity ? o->capacity : 64;
+  while (cap <= id) cap *= 2;
+  o->claims  = realloc(o->claims, sizeof(NavClaim) * cap);
+  o->holders = realloc(o->holders, sizeof(uint32_t) * cap);
+  for (uint32_t i = o->capacity; i < cap; i++)
+    o->claims[i] = (NavClaim){0, -1, -1, -1, 0};
+  o->capacity = cap;
+}
+
+void NavOccupancy_Release(NavOccupancy *o, uint32_t id) {
+  if (id >= o->capacity || o->claims[id].cell < 0) return;
+  NavClaim *c = &o->claims[id];
+
+  // Unlink from the cell chain
+  if (c->prev >= 0) o->claims[c->prev].next = c->next;
+  else              o->head[c->cell]        = c->next;
+  if (c->next >= 0) o->claims[c->next].prev = c->prev;
+
+  // Swap-remove from the holder list
+  uint32_t last = o->holders[--o->count];
+  o->holders[c->slot]  = last;
+  o->claims[last].slot = c->slot;
+
+  c->cell = c->prev = c->next = -1;
+}
+
+void NavOccupancy_Acquire(NavOccupancy *o, uint32_t id, uint32_t generation,
+                          int cx, int cy) {
+  if (!NavGrid_InBounds(o->grid, cx, cy)) return;
+  Reserve(o, id);
+  NavOccupancy_Release(o, id);
+
+  int32_t   cell = cy * o->grid->width + cx;
+  NavClaim *c    = &o->claims[id];
+  c->generation  = generation;
+  c->cell        = cell;
+  c->prev        = -1;
+  c->next        = o->head[cell];
+  if (c->next >= 0) o->claims[c->next].prev = (int32_t)id;
+  o->head[cell]  = (int32_t)id;
+  c->slot        = o->count;
+  o->holders[o->count++] = id;
+}
+
+bool NavOccupancy_Get(const NavOccupancy *o, uint32_t id, uint32_t generation,
+                      int *outX, int *outY) {
+  if (id >= o->capacity) return false;
+  const NavClaim *c = &o->claims[id];
+  if (c->cell < 0 || c->generation != generation) return false;
+  *outX = c->cell % o->grid->width;
+  *outY = c->cell / o->grid->width;
+  return true;
+}
+
+// True when cell (x, y) holds a claim by anyone but excludeId
+static inline bool Claimed(const NavOccupancy *o, int x, int y,
+                           uint32_t excludeId) {
+  int32_t id = o->head[y * o->grid->width + x];
+  while (id >= 0 && (uint32_t)id == excludeId) id = o->claims[id].next;
+  return id >= 0;
+}
+
+int NavOccupancy_Nearest(const NavOccupancy *o, int cx, int cy, int maxCells,
+                         uint32_t excludeId) {
+  const NavGrid *g = o->grid;
+  int best = -1, limit = maxCells * maxCells;
+
+  // Ring r holds every cell at Chebyshev distance r, so nothing beyond it
+  // can be closer than r^2
+  for (int r = 0; r <= maxCells; r++) {
+    if (best >= 0 && r * r >= best) break;
+    for (int dy = -r; dy <= r; dy++) {
+      int y = cy + dy;
+      if (y < 0 || y >= g->height) continue;
+      int step = (dy == -r || dy == r) ? 1 : 2 * r; // edges only inside
+      for (int dx = -r; dx <= r; dx += step) {
+        int x = cx + dx;
+        if (x < 0 || x >= g->width || !Claimed(o, x, y, excludeId)) continue;
+        int d2 = dx * dx + dy * dy;
+        if (d2 <= limit && (best < 0 || d2 < best)) best = d2;
+      }
+    }
+  }
+  return best;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "nav.h"
+
+// Cell-keyed position claims over a NavGrid. Each entity id holds at most
+// one claim; claims on the same cell are chained from a per-cell head, and
+// the ids holding one are packed into a dense list for sweeps. Acquire and
+// release are O(1); nearest-claim queries walk square rings out from a
+// cell and stop at a caller-given radius. A claim remembers the generation
+// of the entity that made it, so a recycled id never inherits one.
+
+typedef struct {
+  uint32_t generation;
+  int32_t  cell;       // -1 = no claim
+  int32_t  prev, next; // other ids claiming the same cell, -1 = none
+  uint32_t slot;       // index in NavOccupancy.holders
+} NavClaim;
+
+typedef struct NavOccupancy {
+  NavGrid  *grid;
+  int32_t  *head;     // per cell: first claiming id, -1 = none
+  NavClaim *claims;   // indexed by entity id
+  uint32_t  capacity; // length of claims
+  uint32_t *holders;  // ids holding a claim, densely packed
+  uint32_t  count;
+} NavOccupancy;
+
+// Allocates the per-cell heads and attaches the table to grid.
+void NavOccupancy_Init(NavOccupancy *o, NavGrid *grid);
+void NavOccupancy_Destroy(NavOccupancy *o);
+
+// Moves id's claim to cell (cx, cy), replacing any claim it held, including
+// one made under an older generation.
+void NavOccupancy_Acquire(NavOccupancy *o, uint32_t id, uint32_t generation,
+                          int cx, int cy);
+void NavOccupancy_Release(NavOccupancy *o, uint32_t id);
+// The cell id claimed under this generation. False when it holds none.
+bool NavOccupancy_Get(const NavOccupancy *o, uint32_t id, uint32_t generation,
+                      int *outX, int *outY);
+
+// Squared cell distance from (cx, cy) to the nearest claim not held by
+// excludeId, or -1 when none lies within maxCells.
+int NavOccupancy_Nearest(const NavOccupancy *o, int cx, int cy, int maxCells,
+                         uint32_t excludeId);
@@ -0,0 +1,308 @@
+#include "nav_repair.h"
+#include <string.h>
+
+static const int s_dirs[8][2] = {{1,0},{-1,0},{0,1},{0,-1},{1,1},{-1,1},{1,-1},{-1,-1}};
+
+void NavRepair_Init(NavRepair *r) { memset(r, 0, sizeof(*r)); }
+
+void NavRepair_Destroy(NavRepair *r) {
+  free(r->nodes);
+  free(r->heap);
+  memset(r, 0, sizeof(*r));
+}
+
+/* ------------------------------------------------------------------ */
+/*  Node state (reset in O(1) by bumping the generation)              */
+/* ------------------------------------------------------------------ */
+
+static NavRepairNode *Node(NavRepair *r, int idx) {
+  NavRepairNode *n = &r->nodes[idx];
+  if (n->stamp != r->generation) {
+    n->stamp   = r->generation;
+    n->g       = NAV_REPAIR_INF;
+    n->rhs     = NAV_REPAIR_INF;
+    n->version = 0;
+    n->queued  = 0;
+  }
+  return n;
+}
+
+static inline int32_t G(const NavRepair *r, int idx) {
+  const NavRepairNode *n = &r->nodes[idx];
+  return n->stamp == r->generation ? n->g : NAV_REPAIR_INF;
+}
+
+static inline int32_t Rhs(const NavRepair *r, int idx) {
+  const NavRepairNode *n = &r->nodes[idx];
+  return n->stamp == r->generation ? n->rhs : NAV_REPAIR_INF;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Grid moves                                                        */
+/* ------------------------------------------------------------------ */
+
+static inline bool Walkable(const NavGrid *g, int x, int y) {
+  if (x < 0 || y < 0 || x >= g->width || y >= g->height) return false;
+  NavCellType t = g->cells[y * g->width + x].type;
+  return t != NAV_CELL_WALL && t != NAV_CELL_BLOCKED && t != NAV_CELL_FENCE;
+}
+
+// Cost of stepping from (x, y) in direction d, -1 if the move isn't allowed.
+// The source cell itself may be blocked, as A* allows for its start.
+static int StepCost(const NavGrid *g, int x, int y, int d) {
+  int nx = x + s_dirs[d][0];
+  int ny = y + s_dirs[d][1];
+  if (!Walkable(g, nx, ny)) return -1;
+  bool diagonal = s_dirs[d][0] != 0 && s_dirs[d][1] != 0;
+  if (diagonal && (!Walkable(g, nx, y) || !Walkable(g, x, ny))) return -1;
+  return (diagonal ? 14 : 10) + g->cells[ny * g->width + nx].cost;
+}
+
+// Exact cost on an open grid of cost-1 cells, so consistent
+static inline int32_t Heuristic(const NavGrid *g, int a, int b) {
+  int dx = abs(a % g->width - b % g->width);
+  int dy = abs(a / g->width - b / g->width);
+  int lo = dx < dy ? dx : dy;
+  int hi = dx < dy ? dy : dx;
+  return 11 * (hi - lo) + 15 * lo;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Open set (binary min-heap on [k1, k2])                            */
+/* ------------------------------------------------------------------ */
+
+static inline bool KeyLess(int32_t a1, int32_t a2, int32_t b1, int32_t b2) {
+  return a1 < b1 || (a1 == b1 && a2 < b2);
+}
+
+static void HeapPush(NavRepair *r, NavRepairHeapEntry e) {
+  if (r->heapSize >= r->heapCap) {
+    r->heapCap = r->heapCap ? r->heapCap * 2 : 1024;
+    r->heap    = realloc(r->heap, sizeof(NavRepairHeapEntry) * r->heapCap);
+  }
+  int pos = r->heapSize++;
+  while (pos > 0) {
+    int parent = (pos - 1) / 2;
+    if (!KeyLess(e.k1, e.k2, r->heap[parent].k1, r->heap[parent].k2)) break;
+    r->heap[pos] = r->heap[parent];
+    pos = parent;
+  }
+  r->heap[pos] = e;
+}
+
+static void HeapPop(NavRepair *r) {
+  NavRepairHeapEntry last = r->heap[--r->heapSize];
+  int pos = 0;
+  while (true) {
+    int child = 2 * pos + 1;
+    if (child >= r->heapSize) break;
+    if (child + 1 < r->heapSize &&
+        KeyLess(r->heap[child + 1].k1, r->heap[child + 1].k2,
+                r->heap[child].k1, r->heap[child].k2))
+      child++;
+    if (!KeyLess(r->heap[child].k1, r->heap[child].k2, last.k1, last.k2)) break;
+    r->heap[pos] = r->heap[child];
+    pos = child;
+  }
+  if (r->heapSize > 0) r->heap[pos] = last;
+}
+
+static void CalcKey(const NavRepair *r, int idx, int32_t *k1, int32_t *k2) {
+  int32_t g   = G(r, idx);
+  int32_t rhs = Rhs(r, idx);
+  int32_t m   = g < rhs ? g : rhs;
+  *k2 = m;
+  *k1 = m >= NAV_REPAIR_INF ? NAV_REPAIR_INF
+                            : m + Heuristic(r->grid, r->start, idx) + r->km;
+}
+
+static void Enqueue(NavRepair *r, int idx) {
+  NavRepairNode *n = Node(r, idx);
+  n->version++;
+  n->queued = 1;
+  NavRepairHeapEntry e = {.cell = idx, .version = n->version};
+  CalcKey(r, idx, &e.k1, &e.k2);
+  HeapPush(r, e);
+}
+
+// Drops stale entries off the top. False once the open set is empty.
+static bool HeapPeek(NavRepair *r) {
+  while (r->heapSize > 0) {
+    const NavRepairHeapEntry *top = &r->heap[0];
+    const NavRepairNode      *n   = &r->nodes[top->cell];
+    if (n->stamp == r->generation && n->queued && n->version == top->version)
+      return true;
+    HeapPop(r);
+  }
+  return false;
+}
+
+/* ------------------------------------------------------------------ */
+/*  D* Lite                                                           */
+/* ------------------------------------------------------------------ */
+
+static void UpdateVertex(NavRepair *r, int idx) {
+  const NavGrid *g = r->grid;
+  NavRepairNode *n = Node(r, idx);
+
+  if (idx != r->goal) {
+    int     x    = idx % g->width;
+    int     y    = idx / g->width;
+    int32_t best = NAV_REPAIR_INF;
+    for (int d = 0; d < 8; d++) {
+      int step = StepCost(g, x, y, d);
+      if (step < 0) continue;
+      int32_t gs = G(r, (y + s_dirs[d][1]) * g->width + x + s_dirs[d][0]);
+      if (gs < NAV_REPAIR_INF && gs + step < best) best = gs + step;
+    }
+    n->rhs = best;
+  }
+
+  if (n->g != n->rhs) Enqueue(r, idx);
+  else                n->queued = 0;
+}
+
+// Re-evaluates every cell that can step into idx
+static void UpdatePredecessors(NavRepair *r, int idx) {
+  const NavGrid *g = r->grid;
+  int x = idx % g->width;
+  int y = idx / g->width;
+  for (int d = 0; d < 8; d++) {
+    int px = x + s_dirs[d][0];
+    int py = y + s_dirs[d][1];
+    if (!NavGrid_InBounds(r->grid, px, py)) continue;
+    // Opposite of d: pairs are 0/1 and 2/3, then 4/7 and 5/6
+    int back = d < 4 ? (d ^ 1) : 11 - d;
+    if (StepCost(g, px, py, back) < 0) continue;
+    UpdateVertex(r, py * g->width + px);
+  }
+}
+
+bool NavRepair_Begin(NavRepair *r, NavGrid *grid, Vector3 startWorld,
+                     Vector3 goalWorld) {
+  int sx, sy, gx, gy;
+  if (!NavGrid_WorldToCell(grid, startWorld, &sx, &sy)) return false;
+  if (!NavGrid_WorldToCell(grid, goalWorld, &gx, &gy)) return false;
+
+  int cells = grid->width * grid->height;
+  if (cells > r->capacity) {
+    r->nodes = realloc(r->nodes, sizeof(NavRepairNode) * cells);
+    memset(r->nodes, 0, sizeof(NavRepairNode) * cells);
+    r->capacity   = cells;
+    r->generation = 0;
+  }
+  if (++r->generation == 0) {
+    memset(r->nodes, 0, sizeof(NavRepairNode) * r->capacity);
+    r->generation = 1;
+  }
+
+  r->grid      = grid;
+  r->heapSize  = 0;
+  r->km        = 0;
+  r->expanded  = 0;
+  r->start     = NavGrid_Index(grid, sx, sy);
+  r->lastStart = r->start;
+  r->goal      = NavGrid_Index(grid, gx, gy);
+
+  // A blocked goal is never entered, so it stays unreachable
+  Node(r, r->goal)->rhs = 0;
+  if (Walkable(grid, gx, gy)) Enqueue(r, r->goal);
+  return true;
+}
+
+bool NavRepair_MoveStart(NavRepair *r, Vector3 startWorld) {
+  int sx, sy;
+  if (!r->grid || !NavGrid_WorldToCell(r->grid, startWorld, &sx, &sy))
+    return false;
+  int idx = NavGrid_Index(r->grid, sx, sy);
+  if (idx == r->start) return true;
+  r->start     = idx;
+  r->km       += Heuristic(r->grid, r->lastStart, idx);
+  r->lastStart = idx;
+  return true;
+}
+
+void NavRepair_CellChanged(NavRepair *r, int x, int y) {
+  if (!r->grid) return;
+  // Moves into (x, y) and diagonals cutting past it change cost, so the
+  // cell and all its neighbours may need a new rhs
+  for (int ny = y - 1; ny <= y + 1; ny++) {
+    for (int nx = x - 1; nx <= x + 1; nx++) {
+      if (!NavGrid_InBounds(r->grid, nx, ny)) continue;
+      UpdateVertex(r, NavGrid_Index(r->grid, nx, ny));
+    }
+  }
+}
+
+NavRepairStatus NavRepair_Compute(NavRepair *r, int budget) {
+  r->expanded = 0;
+  if (!r->grid) return NAV_REPAIR_NO_PATH;
+
+  while (HeapPeek(r)) {
+    NavRepairHeapEntry top = r->heap[0];
+    int32_t sk1, sk2;
+    CalcKey(r, r->start, &sk1, &sk2);
+    if (!KeyLess(top.k1, top.k2, sk1, sk2) && G(r, r->start) == Rhs(r, r->start))
+      break;
+    if (r->expanded >= budget) return NAV_REPAIR_PENDING;
+
+    HeapPop(r);
+    r->expanded++;
+
+    int u = top.cell;
+    int32_t k1, k2;
+    CalcKey(r, u, &k1, &k2);
+    if (KeyLess(top.k1, top.k2, k1, k2)) {
+      Enqueue(r, u); // start moved since u was queued
+      continue;
+    }
+
+    NavRepairNode *n = Node(r, u);
+    n->queued = 0;
+    if (n->g > n->rhs) {
+      n->g = n->rhs;
+      UpdatePredecessors(r, u);
+    } else {
+      n->g = NAV_REPAIR_INF;
+      UpdateVertex(r, u);
+      UpdatePredecessors(r, u);
+    }
+  }
+
+  return G(r, r->start) < NAV_REPAIR_INF ? NAV_REPAIR_FOUND : NAV_REPAIR_NO_PATH;
+}
+
+bool NavRepair_ExtractPath(NavRepair *r, NavPath *outPath) {
+  NavPath_Clear(outPath);
+  if (!r->grid || G(r, r->start) >= NAV_REPAIR_INF) return false;
+
+  NavGrid *g     = r->grid;
+  int      cells = g->width * g->height;
+  int      cur   = r->start;
+  while (true) {
+    NavPath_Reserve(outPath, outPath->count + 1);
+    outPath->points[outPath->count++] =
+        NavGrid_CellCenter(g, cur % g->width, cur / g->width);
+    if (cur == r->goal) return true;
+    if (outPath->count > cells) break;
+
+    // Descend g: the neighbour with the cheapest step plus cost-to-goal
+    int     x = cur % g->width, y = cur / g->width;
+    int     next = -1;
+    int32_t best = NAV_REPAIR_INF;
+    for (int d = 0; d < 8; d++) {
+      int step = StepCost(g, x, y, d);
+      if (step < 0) continue;
+      int     nIdx = (y + s_dirs[d][1]) * g->width + x + s_dirs[d][0];
+      int32_t gs   = G(r, nIdx);
+      if (gs < NAV_REPAIR_INF && gs + step < best) {
+        best = gs + step;
+        next = nIdx;
+      }
+    }
+    if (next < 0) break;
+    cur = next;
+  }
+  NavPath_Clear(outPath);
+  return false;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "nav.h"
+
+// Incremental path repair (D* Lite) for one agent and goal on a NavGrid.
+// The search runs backward from the goal, so when cells change only the
+// costs that depend on them are recomputed, and the agent may move between
+// repairs without restarting. Step costs match NavGrid_FindPathAStar.
+
+#define NAV_REPAIR_INF 0x3fffffff
+
+typedef enum {
+  NAV_REPAIR_PENDING = 0, // budget ran out; call NavRepair_Compute again
+  NAV_REPAIR_FOUND,
+  NAV_REPAIR_NO_PATH,
+} NavRepairStatus;
+
+typedef struct {
+  int32_t  g;
+  int32_t  rhs;     // one-step lookahead cost; g == rhs when consistent
+  uint32_t stamp;   // node valid iff stamp == NavRepair.generation
+  uint16_t version; // bumped per queue insert, older heap entries are stale
+  uint8_t  queued;
+} NavRepairNode;
+
+typedef struct {
+  int32_t  k1, k2;
+  int32_t  cell;
+  uint16_t version;
+} NavRepairHeapEntry;
+
+typedef struct {
+  NavGrid       *grid;
+  NavRepairNode *nodes;
+  int            capacity;
+  uint32_t       generation;
+
+  NavRepairHeapEntry *heap; // open set with lazy deletion
+  int                 heapSize;
+  int                 heapCap;
+
+  int32_t start;     // cell the agent was last at
+  int32_t lastStart; // start when km was last folded in
+  int32_t goal;
+  int32_t km;        // key offset accumulated as the start moves
+  int     expanded;  // nodes expanded by the last NavRepair_Compute
+} NavRepair;
+
+void NavRepair_Init(NavRepair *r);
+void NavRepair_Destroy(NavRepair *r);
+
+// Discards any previous state and starts a search from start to goal.
+// False if either point is off the grid.
+bool NavRepair_Begin(NavRepair *r, NavGrid *grid, Vector3 startWorld,
+                     Vector3 goalWorld);
+// Moves the search start to the agent's current position. Keeps all state.
+bool NavRepair_MoveStart(NavRepair *r, Vector3 startWorld);
+// Call after cell (x, y) changed type or cost.
+void NavRepair_CellChanged(NavRepair *r, int x, int y);
+
+// Runs at most budget node expansions.
+NavRepairStatus NavRepair_Compute(NavRepair *r, int budget);
+// Cell centres from start to goal, valid once Compute returned FOUND.
+bool NavRepair_ExtractPath(NavRepair *r, NavPath *outPath);
@@ -0,0 +1,132 @@
+#include "nav_visibility.h"
+
+static inline bool Opaque(const NavGrid *g, int x, int y) {
+  NavCellType t = g->cells[y * g->width + x].type;
+  return t == NAV_CELL_WALL || t == NAV_CELL_BLOCKED;
+}
+
+static inline bool Walkable(const NavGrid *g, int x, int y) {
+  NavCellType t = g->cells[y * g->width + x].type;
+  return t != NAV_CELL_WALL && t != NAV_CELL_BLOCKED && t != NAV_CELL_FENCE;
+}
+
+// Bitset ops inlined for the per-cell loops below
+static inline bool Lit(const bitset_t *b, uint32_t i) {
+  return (b->words[i >> 6] >> (i & 63)) & 1u;
+}
+
+static inline void Light(bitset_t *b, uint32_t i) {
+  b->words[i >> 6] |= 1ull << (i & 63);
+}
+
+void NavVisibility_Init(NavVisibility *v, NavGrid *grid) {
+  uint32_t cells = (uint32_t)(grid->width * grid->height);
+  v->grid     = grid;
+  v->originX  = -1;
+  v->originY  = -1;
+  v->revision = 0;
+  BitsetInit(&v->visible, cells);
+  BitsetInit(&v->peek, cells);
+}
+
+void NavVisibility_Destroy(NavVisibility *v) {
+  BitsetDestroy(&v->visible);
+  BitsetDestroy(&v->peek);
+  v->grid    = NULL;
+  v->originX = -1;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Recursive shadowcasting                                           */
+/*  One octant at a time. Row j runs dy = -j, and (xx, xy, yx, yy)    */
+/*  maps the octant's (dx, dy) onto the grid.                         */
+/* ------------------------------------------------------------------ */
+
+static const int s_octants[8][4] = {
+    {1, 0, 0, 1},   {0, 1, 1, 0},   {0, -1, 1, 0}, {-1, 0, 0, 1},
+    {-1, 0, 0, -1}, {0, -1, -1, 0}, {0, 1, -1, 0}, {1, 0, 0, -1},
+};
+
+static void CastLight(NavVisibility *v, int row, float start, float end,
+                      int radius, const int m[4]) {
+  if (start < end) return;
+  const NavGrid *g = v->grid;
+  float newStart = 0.0f;
+
+  for (int j = row; j <= radius; j++) {
+    int  dy      = -j;
+    bool blocked = false;
+    for (int dx = -j; dx <= 0; dx++) {
+      // Slopes through the cell's corners, as seen from the origin
+      float lSlope = (dx - 0.5f) / (dy + 0.5f);
+      float rSlope = (dx + 0.5f) / (dy - 0.5f);
+      if (start < rSlope) continue;
+      if (end > lSlope) break;
+
+      int  x      = v->originX + dx * m[0] + dy * m[1];
+      int  y      = v->originY + dx * m[2] + dy * m[3];
+      bool inside = NavGrid_InBounds((NavGrid *)g, x, y);
+      if (inside) Light(&v->visible, (uint32_t)(y * g->width + x));
+      bool opaque = !inside || Opaque(g, x, y);
+
+      if (blocked) {
+        if (opaque) {
+          newStart = rSlope;
+          continue;
+        }
+        blocked = false;
+        start   = newStart;
+      } else if (opaque && j < radius) {
+        blocked = true;
+        CastLight(v, j + 1, start, lSlope, radius, m);
+        newStart = rSlope;
+      }
+    }
+    if (blocked) break;
+  }
+}
+
+bool NavVisibility_Update(NavVisibility *v, Vector3 observer) {
+  NavGrid *g = v->grid;
+  int ox, oy;
+  if (!NavGrid_WorldToCell(g, observer, &ox, &oy)) ox = oy = -1;
+  if (ox == v->originX && oy == v->originY && g->revision == v->revision)
+    return false;
+
+  v->originX  = ox;
+  v->originY  = oy;
+  v->revision = g->revision;
+  BitsetClearAll(&v->visible);
+  BitsetClearAll(&v->peek);
+  if (ox < 0) return true;
+
+  Light(&v->visible, (uint32_t)NavGrid_Index(g, ox, oy));
+  int radius = g->width > g->height ? g->width : g->height;
+  for (int o = 0; o < 8; o++) CastLight(v, 1, 1.0f, 0.0f, radius, s_octants[o]);
+
+  for (int y = 0; y < g->height; y++) {
+    for (int x = 0; x < g->width; x++) {
+      uint32_t idx = (uint32_t)(y * g->width + x);
+      if (Lit(&v->visible, idx) || !Walkable(g, x, y)) continue;
+      bool peek = false;
+      for (int ny = y - 1; ny <= y + 1 && !peek; ny++) {
+        for (int nx = x - 1; nx <= x + 1; nx++) {
+          if (!NavGrid_InBounds(g, nx, ny)) continue;
+          uint32_t n = (uint32_t)(ny * g->width + nx);
+          if (Lit(&v->visible, n) && Walkable(g, nx, ny)) {
+            peek = true;
+            break;
+          }
+        }
+      }
+      if (peek) Light(&v->peek, idx);
+    }
+  }
+  return true;
+}
+
+bool NavVisibility_Test(const NavVisibility *v, Vector3 p) {
+  int x, y;
+  if (!NavGrid_WorldToCell(v->grid, p, &x, &y)) return false;
+  return NavVisibility_TestCell(v, x, y);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "../../engine/util/bitset.h"
+#include "nav.h"
+
+// What one observer can see over a NavGrid, as a bit per cell. Computed by
+// recursive shadowcasting from the observer's cell, with walls and blocked
+// cells opaque (fences and cover are see-through, as for NavGrid_HasLOS).
+// Recomputed only when the observer changes cells or the grid is edited,
+// so any number of "can the observer see here?" questions cost a bit test.
+
+typedef struct {
+  NavGrid *grid;
+  bitset_t visible; // cell lit from the observer's cell
+  bitset_t peek;    // walkable, hidden, and next to a visible walkable cell
+  int      originX; // observer cell, -1 before the first update
+  int      originY;
+  uint32_t revision; // grid revision the bits were cast against
+} NavVisibility;
+
+void NavVisibility_Init(NavVisibility *v, NavGrid *grid);
+void NavVisibility_Destroy(NavVisibility *v);
+// Recasts if the observer moved to another cell or the grid changed.
+// Returns true when it recast.
+bool NavVisibility_Update(NavVisibility *v, Vector3 observer);
+
+static inline bool NavVisibility_TestCell(const NavVisibility *v, int x, int y) {
+  return v->originX >= 0 && NavGrid_InBounds(v->grid, x, y) &&
+         BitsetTest(&v->visible, (uint32_t)NavGrid_Index(v->grid, x, y));
+}
+// Hidden positions one step from a line of fire, e.g. for peeking out of cover
+static inline bool NavVisibility_PeekCell(const NavVisibility *v, int x, int y) {
+  return v->originX >= 0 && NavGrid_InBounds(v->grid, x, y) &&
+         BitsetTest(&v->peek, (uint32_t)NavGrid_Index(v->grid, x, y));
+}
+bool NavVisibility_Test(const NavVisibility *v, Vector3 p);
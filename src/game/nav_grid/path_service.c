@@ -0,0 +1,351 @@
+#define _POSIX_C_SOURCE 200809L
+#include "path_service.h"
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PATH_SERVICE_MAX_WORKERS 8
+
+typedef struct {
+  NavGrid *grid;
+  Vector3  start;
+  Vector3  goal;
+  float    radius;
+  uint32_t ownerId;
+  uint32_t ownerGeneration;
+  uint32_t ticket;
+  int      next; // FIFO link while queued, free-list link otherwise
+  bool     live; // false once superseded or cancelled
+} PathJob;
+
+typedef struct {
+  PathResult result;
+  uint32_t   ticket;
+} PathDone;
+
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  s_workReady = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  s_idle      = PTHREAD_COND_INITIALIZER;
+
+static PathJob *s_jobs     = NULL;
+static int      s_jobCap   = 0;
+static int      s_freeJob  = -1;
+static int      s_head[PATH_PRIORITY_COUNT];
+static int      s_tail[PATH_PRIORITY_COUNT];
+static int      s_inFlight = 0;
+
+// Per-owner state, indexed by entity id. Only the main thread writes these.
+static uint32_t *s_ownerTicket = NULL; // ticket of the live request, 0 = none
+static int      *s_ownerJob    = NULL; // queued job slot, -1 = none
+static uint32_t  s_ownerCap    = 0;
+static uint32_t  s_nextTicket  = 0;
+
+static PathDone *s_done     = NULL;
+static int       s_doneCount = 0;
+static int       s_doneCap   = 0;
+
+static pthread_t s_threads[PATH_SERVICE_MAX_WORKERS];
+static int       s_workerCount = 0;
+static bool      s_stop        = false;
+static bool      s_paused      = false;
+static bool      s_queuesReady = false;
+
+static NavSearchContext s_mainCtx; // inline searches without workers
+static NavPath          s_mainPath;
+
+/* ------------------------------------------------------------------ */
+/*  Queue helpers (call with s_lock held)                             */
+/* ------------------------------------------------------------------ */
+
+static void InitQueues(void) {
+  if (s_queuesReady) return;
+  for (int p = 0; p < PATH_PRIORITY_COUNT; p++) s_head[p] = s_tail[p] = -1;
+  s_queuesReady = true;
+}
+
+static int AllocJob(void) {
+  if (s_freeJob < 0) {
+    int oldCap = s_jobCap;
+    s_jobCap   = oldCap ? oldCap * 2 : 64;
+    s_jobs     = realloc(s_jobs, sizeof(PathJob) * s_jobCap);
+    for (int i = s_jobCap - 1; i >= oldCap; i--) {
+      s_jobs[i].next = s_freeJob;
+      s_freeJob      = i;
+    }
+  }
+  int j     = s_freeJob;
+  s_freeJob = s_jobs[j].next;
+  return j;
+}
+
+static void FreeJob(int j) {
+  s_jobs[j].next = s_freeJob;
+  s_freeJob      = j;
+}
+
+static void Enqueue(int j, PathPriority p) {
+  s_jobs[j].next = -1;
+  if (s_tail[p] >= 0) s_jobs[s_tail[p]].next = j;
+  else                s_head[p] = j;
+  s_tail[p] = j;
+}
+
+// Pops the highest-priority live job into *out. Returns false if none.
+static bool PopJob(PathJob *out) {
+  for (int p = PATH_PRIORITY_COUNT - 1; p >= 0; p--) {
+    while (s_head[p] >= 0) {
+      int j     = s_head[p];
+      s_head[p] = s_jobs[j].next;
+      if (s_head[p] < 0) s_tail[p] = -1;
+
+      PathJob job = s_jobs[j];
+      FreeJob(j);
+      if (!job.live) continue;
+
+      if (job.ownerId < s_ownerCap && s_ownerJob[job.ownerId] == j)
+        s_ownerJob[job.ownerId] = -1;
+      *out = job;
+      return true;
+    }
+  }
+  return false;
+}
+
+static void PushDone(const PathJob *job, const NavPath *path, bool found,
+                     uint32_t revision) {
+  if (s_doneCount >= s_doneCap) {
+    s_doneCap = s_doneCap ? s_doneCap * 2 : 64;
+    s_done    = realloc(s_done, sizeof(PathDone) * s_doneCap);
+  }
+  PathDone *d = &s_done[s_doneCount++];
+  d->ticket                 = job->ticket;
+  d->result.ownerId         = job->ownerId;
+  d->result.ownerGeneration = job->ownerGeneration;
+  d->result.found           = found;
+  d->result.revision        = revision;
+  d->result.count           = found ? path->count : 0;
+  d->result.points          = NULL;
+  if (d->result.count > 0) {
+    d->result.points = malloc(sizeof(Vector3) * d->result.count);
+    memcpy(d->result.points, path->points, sizeof(Vector3) * d->result.count);
+  }
+}
+
+static void ClearDone(void) {
+  for (int i = 0; i < s_doneCount; i++) free(s_done[i].result.points);
+  s_doneCount = 0;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Workers                                                           */
+/* ------------------------------------------------------------------ */
+
+static void *WorkerMain(void *arg) {
+  (void)arg;
+  NavSearchContext ctx;
+  NavPath          path;
+  NavSearch_Init(&ctx, 0);
+  NavPath_Init(&path, 64);
+
+  pthread_mutex_lock(&s_lock);
+  while (true) {
+    PathJob job;
+    while (!s_stop && (s_paused || !PopJob(&job)))
+      pthread_cond_wait(&s_workReady, &s_lock);
+    if (s_stop) break;
+
+    s_inFlight++;
+    // Edits only happen while paused, so this holds for the whole search
+    uint32_t revision = job.grid->revision;
+    pthread_mutex_unlock(&s_lock);
+
+    bool found = NavGrid_FindPathRadius(job.grid, &ctx, job.start, job.goal,
+                                        job.radius, &path);
+
+    pthread_mutex_lock(&s_lock);
+    PushDone(&job, &path, found, revision);
+    if (--s_inFlight == 0) pthread_cond_broadcast(&s_idle);
+  }
+  pthread_mutex_unlock(&s_lock);
+
+  NavPath_Destroy(&path);
+  NavSearch_Destroy(&ctx);
+  return NULL;
+}
+
+void PathService_Start(int workerCount) {
+  if (s_workerCount > 0) return;
+
+  if (workerCount <= 0) {
+    long cores  = sysconf(_SC_NPROCESSORS_ONLN);
+    workerCount = cores > 1 ? (int)cores - 1 : 1;
+  }
+  if (workerCount > PATH_SERVICE_MAX_WORKERS)
+    workerCount = PATH_SERVICE_MAX_WORKERS;
+
+  pthread_mutex_lock(&s_lock);
+  InitQueues();
+  s_stop = false;
+  pthread_mutex_unlock(&s_lock);
+
+  for (int i = 0; i < workerCount; i++) {
+    if (pthread_create(&s_threads[s_workerCount], NULL, WorkerMain, NULL) != 0)
+      break;
+    s_workerCount++;
+  }
+}
+
+void PathService_Stop(void) {
+  PathService_CancelAll();
+
+  pthread_mutex_lock(&s_lock);
+  s_stop   = true;
+  s_paused = false;
+  pthread_cond_broadcast(&s_workReady);
+  pthread_mutex_unlock(&s_lock);
+
+  for (int i = 0; i < s_workerCount; i++) pthread_join(s_threads[i], NULL);
+  s_workerCount = 0;
+
+  free(s_jobs);
+  free(s_done);
+  free(s_ownerTicket);
+  free(s_ownerJob);
+  s_jobs = NULL;  s_jobCap = 0;  s_freeJob = -1;
+  s_done = NULL;  s_doneCap = 0; s_doneCount = 0;
+  s_ownerTicket = NULL; s_ownerJob = NULL; s_ownerCap = 0;
+  s_queuesReady = false;
+  NavSearch_Destroy(&s_mainCtx);
+  NavPath_Destroy(&s_mainPath);
+}
+
+int PathService_WorkerCount(void) { return s_workerCount; }
+
+/* ------------------------------------------------------------------ */
+/*  Requests                                                          */
+/* ------------------------------------------------------------------ */
+
+static void ReserveOwners(uint32_t ownerId) {
+  if (ownerId < s_ownerCap) return;
+  uint32_t cap = s_ownerCap ? s_ownerCap : 256;
+  while (cap <= ownerId) cap *= 2;
+  s_ownerTicket = realloc(s_ownerTicket, sizeof(uint32_t) * cap);
+  s_ownerJob    = realloc(s_ownerJob,    sizeof(int)      * cap);
+  for (uint32_t i = s_ownerCap; i < cap; i++) {
+    s_ownerTicket[i] = 0;
+    s_ownerJob[i]    = -1;
+  }
+  s_ownerCap = cap;
+}
+
+bool PathService_Submit(NavGrid *grid, Vector3 start, Vector3 goal, float radius,
+                        uint32_t ownerId, uint32_t ownerGeneration,
+                        PathPriority priority) {
+  if (priority < 0 || priority >= PATH_PRIORITY_COUNT) return false;
+
+  pthread_mutex_lock(&s_lock);
+  InitQueues();
+  ReserveOwners(ownerId);
+
+  if (++s_nextTicket == 0) s_nextTicket = 1;
+  uint32_t ticket        = s_nextTicket;
+  s_ownerTicket[ownerId] = ticket;
+
+  // Dedup: a still-queued request from this owner is superseded
+  if (s_ownerJob[ownerId] >= 0) s_jobs[s_ownerJob[ownerId]].live = false;
+
+  int j     = AllocJob();
+  s_jobs[j] = (PathJob){
+      .grid            = grid,
+      .start           = start,
+      .goal            = goal,
+      .radius          = radius,
+      .ownerId         = ownerId,
+      .ownerGeneration = ownerGeneration,
+      .ticket          = ticket,
+      .live            = true,
+  };
+  Enqueue(j, priority);
+  s_ownerJob[ownerId] = j;
+
+  pthread_cond_signal(&s_workReady);
+  pthread_mutex_unlock(&s_lock);
+  return true;
+}
+
+void PathService_Cancel(uint32_t ownerId) {
+  pthread_mutex_lock(&s_lock);
+  if (ownerId < s_ownerCap) {
+    s_ownerTicket[ownerId] = 0;
+    if (s_ownerJob[ownerId] >= 0) s_jobs[s_ownerJob[ownerId]].live = false;
+    s_ownerJob[ownerId] = -1;
+  }
+  pthread_mutex_unlock(&s_lock);
+}
+
+void PathService_CancelAll(void) {
+  pthread_mutex_lock(&s_lock);
+  InitQueues();
+  PathJob job;
+  while (PopJob(&job)) {}
+  while (s_inFlight > 0) pthread_cond_wait(&s_idle, &s_lock);
+  ClearDone();
+  for (uint32_t i = 0; i < s_ownerCap; i++) {
+    s_ownerTicket[i] = 0;
+    s_ownerJob[i]    = -1;
+  }
+  pthread_mutex_unlock(&s_lock);
+}
+
+void PathService_Pause(void) {
+  pthread_mutex_lock(&s_lock);
+  s_paused = true;
+  while (s_inFlight > 0) pthread_cond_wait(&s_idle, &s_lock);
+  pthread_mutex_unlock(&s_lock);
+}
+
+void PathService_Resume(void) {
+  pthread_mutex_lock(&s_lock);
+  s_paused = false;
+  pthread_cond_broadcast(&s_workReady);
+  pthread_mutex_unlock(&s_lock);
+}
+
+int PathService_Drain(PathResultFn fn, void *user, int syncBudget) {
+  pthread_mutex_lock(&s_lock);
+  InitQueues();
+
+  // No workers: search inline, a bounded number per call
+  if (s_workerCount == 0) {
+    if (!s_mainPath.points) NavPath_Init(&s_mainPath, 64);
+    PathJob job;
+    for (int i = 0; i < syncBudget && PopJob(&job); i++) {
+      bool found = NavGrid_FindPathRadius(job.grid, &s_mainCtx, job.start,
+                                          job.goal, job.radius, &s_mainPath);
+      PushDone(&job, &s_mainPath, found, job.grid->revision);
+    }
+  }
+
+  // Take the completed batch so workers can keep publishing
+  PathDone *batch = s_done;
+  int       count = s_doneCount;
+  s_done      = NULL;
+  s_doneCount = 0;
+  s_doneCap   = 0;
+  pthread_mutex_unlock(&s_lock);
+
+  int delivered = 0;
+  for (int i = 0; i < count; i++) {
+    PathDone *d  = &batch[i];
+    uint32_t  id = d->result.ownerId;
+    // Stale unless it answers the owner's latest request
+    if (id < s_ownerCap && s_ownerTicket[id] == d->ticket) {
+      s_ownerTicket[id] = 0;
+      fn(&d->result, user);
+      delivered++;
+    }
+    free(d->result.points);
+  }
+  free(batch);
+  return delivered;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "nav.h"
+
+// Asynchronous path-finding service. Requests are searched by a pool of
+// worker threads, each with its own NavSearchContext, and the results are
+// handed back to the main thread through a completion queue.
+//
+// Each owner (an entity id) has at most one live request. Resubmitting
+// replaces a queued request, and results from superseded or cancelled
+// requests are dropped. The grid passed with a request must stay alive until
+// PathService_CancelAll returns or the result is drained, and may only be
+// edited between PathService_Pause and PathService_Resume.
+
+typedef enum {
+  PATH_PRIORITY_LOW = 0,
+  PATH_PRIORITY_NORMAL,
+  PATH_PRIORITY_HIGH,
+  PATH_PRIORITY_COUNT,
+} PathPriority;
+
+typedef struct {
+  uint32_t ownerId;
+  uint32_t ownerGeneration;
+  bool     found;
+  uint32_t revision; // NavGrid.revision the search ran against
+  Vector3 *points; // owned by the service; valid during the drain callback
+  int      count;
+} PathResult;
+
+typedef void (*PathResultFn)(const PathResult *result, void *user);
+
+// workerCount <= 0 picks one per spare core. With no workers (or if threads
+// can't be created) PathService_Drain searches on the calling thread.
+void PathService_Start(int workerCount);
+void PathService_Stop(void);
+int  PathService_WorkerCount(void);
+
+// radius is the agent's world radius, see NavGrid_FindPathRadius.
+bool PathService_Submit(NavGrid *grid, Vector3 start, Vector3 goal, float radius,
+                        uint32_t ownerId, uint32_t ownerGeneration,
+                        PathPriority priority);
+void PathService_Cancel(uint32_t ownerId);
+// Drops every queued request and waits for in-flight searches to finish.
+void PathService_CancelAll(void);
+// Waits for in-flight searches and holds the workers, keeping the queue,
+// so the main thread can edit grids. Resume lets them continue.
+void PathService_Pause(void);
+void PathService_Resume(void);
+
+// Delivers completed results to fn. Without workers, first runs up to
+// syncBudget queued searches inline. Returns the number delivered.
+int PathService_Drain(PathResultFn fn, void *user, int syncBudget);
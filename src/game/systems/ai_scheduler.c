@@ -0,0 +1,84 @@
+#define _POSIX_C_SOURCE 200809L
+#include "ai_scheduler.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Monotonic like the profiler's clock; raylib's GetTime needs a window
+static double NowSeconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+void AiScheduler_Destroy(AiScheduler *s) {
+  free(s->slots);
+  memset(s, 0, sizeof(*s));
+}
+
+void AiScheduler_BeginTick(AiScheduler *s) {
+  AiScheduler_Close(s);
+  memcpy(s->last, s->stats, sizeof(s->stats));
+  memset(s->stats, 0, sizeof(s->stats));
+  s->tick++;
+}
+
+int AiScheduler_Bucket(Vector3 pos, Vector3 playerPos, bool visible,
+                       bool urgent, bool idle) {
+  if (urgent) return 0;
+  float dx = playerPos.x - pos.x, dz = playerPos.z - pos.z;
+  float d2 = dx * dx + dz * dz;
+
+  int bucket;
+  if (d2 < AI_LOD_NEAR_DIST * AI_LOD_NEAR_DIST)     bucket = 0;
+  else if (d2 < AI_LOD_MID_DIST * AI_LOD_MID_DIST)  bucket = 1;
+  else if (d2 < AI_LOD_FAR_DIST * AI_LOD_FAR_DIST)  bucket = 2;
+  else                                              bucket = idle ? 3 : 2;
+
+  if (visible && bucket > 0) bucket--;
+  return bucket;
+}
+
+static void Reserve(AiScheduler *s, uint32_t id) {
+  if (id < s->capacity) return;
+  uint32_t cap = s->capacity ? s->capacity : 64;
+  while (cap <= id) cap *= 2;
+  s->slots = realloc(s->slots, sizeof(AiLodSlot) * cap);
+  memset(s->slots + s->capacity, 0, sizeof(AiLodSlot) * (cap - s->capacity));
+  s->capacity = cap;
+}
+
+void AiScheduler_Close(AiScheduler *s) {
+  if (!s->open) return;
+  s->stats[s->open - 1].seconds += NowSeconds() - s->openStart;
+  s->open = 0;
+}
+
+bool AiScheduler_Due(AiScheduler *s, entity_t e, int bucket, float dt,
+                     float *outDt) {
+  AiScheduler_Close(s);
+  Reserve(s, e.id);
+
+  AiLodSlot *slot = &s->slots[e.id];
+  if (slot->generation != e.generation) {
+    // Recycled id: nothing to catch up on
+    slot->generation = e.generation;
+    slot->pendingDt  = 0.0f;
+  }
+  slot->pendingDt += dt;
+
+  // Ids offset the phase, so a bucket's enemies take turns across ticks
+  uint32_t period = 1u << bucket;
+  if (((s->tick + e.id) & (period - 1)) != 0) {
+    s->stats[bucket].skipped++;
+    return false;
+  }
+
+  *outDt          = slot->pendingDt;
+  slot->pendingDt = 0.0f;
+  s->stats[bucket].updates++;
+  s->open      = bucket + 1;
+  s->openStart = NowSeconds();
+  return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "../../engine/ecs/entity.h"
+#include "raylib.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Level-of-detail scheduling for enemy state machines. Each enemy falls in
+// a bucket by distance to the player, visibility and state; bucket b runs
+// every 2^b ticks. Enemies of a bucket are spread across those ticks by id,
+// so each tick updates a fixed share of them, and a skipped enemy's dt is
+// accumulated and handed over on its next update.
+
+#define AI_LOD_BUCKETS   4       // every 1, 2, 4 and 8 ticks
+#define AI_LOD_NEAR_DIST 30.0f   // full rate inside this
+#define AI_LOD_MID_DIST  60.0f
+#define AI_LOD_FAR_DIST  100.0f  // every 4th tick beyond this when hidden,
+                                 // every 8th when also idle
+
+typedef struct {
+  uint32_t generation;
+  float    pendingDt; // simulated time since the last update
+} AiLodSlot;
+
+typedef struct {
+  uint32_t updates;
+  uint32_t skipped;
+  double   seconds; // spent in the state machines of updated enemies
+} AiBucketStats;
+
+typedef struct {
+  AiLodSlot *slots; // indexed by entity id
+  uint32_t   capacity;
+  uint32_t   tick;
+
+  AiBucketStats stats[AI_LOD_BUCKETS]; // tick in progress
+  AiBucketStats last[AI_LOD_BUCKETS];  // last completed tick, for display
+
+  int    open; // 1 + bucket of the update being timed, 0 = none
+  double openStart;
+} AiScheduler;
+
+// A zeroed AiScheduler is ready to use; slots grow with entity ids.
+void AiScheduler_Destroy(AiScheduler *s);
+// Starts a simulation tick: publishes the previous tick's stats.
+void AiScheduler_BeginTick(AiScheduler *s);
+
+// Bucket for an enemy at pos. urgent (mid-attack, retreating) forces full
+// rate; visible pulls far enemies one bucket closer; idle lets the farthest
+// drop one further.
+int AiScheduler_Bucket(Vector3 pos, Vector3 playerPos, bool visible,
+                       bool urgent, bool idle);
+
+// True when e is due this tick; *outDt is then the time it has to catch up.
+// Times the update from here to the next AiScheduler_Due or
+// AiScheduler_Close, so call it right before the enemy's state machine.
+bool AiScheduler_Due(AiScheduler *s, entity_t e, int bucket, float dt,
+                     float *outDt);
+// Ends the timing of the last update. Call after each system's loop.
+void AiScheduler_Close(AiScheduler *s);
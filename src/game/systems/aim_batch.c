@@ -0,0 +1,337 @@
+#include "aim_batch.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define AIM_TWO_PI   6.28318530717958648f
+#define AIM_HALF_PI  1.57079632679489662f
+#define AIM_PIO2_HI  1.57079637050628662f  // pi/2 split for exact reduction
+#define AIM_PIO2_LO -4.37113900018624283e-8f
+
+// Odd minimax polynomial for atan on [0, 1]
+#define AT0  0.99997726f
+#define AT1 -0.33262347f
+#define AT2  0.19354346f
+#define AT3 -0.11643287f
+#define AT4  0.05265332f
+#define AT5 -0.01172120f
+
+// Taylor terms, enough for |r| <= pi/4
+#define SN1 -1.6666667e-1f
+#define SN2  8.3333333e-3f
+#define SN3 -1.9841270e-4f
+#define CS1 -0.5f
+#define CS2  4.1666667e-2f
+#define CS3 -1.3888889e-3f
+#define CS4  2.4801587e-5f
+
+/* ------------------------------------------------------------------ */
+/*  Lanes                                                             */
+/* ------------------------------------------------------------------ */
+
+#define AIM_ARRAYS 20
+#define AIM_PAD    8 // widest vector
+
+void AimLanes_Reserve(AimLanes *l, int n) {
+  l->count = n;
+  if (n <= l->capacity) return;
+
+  int cap = (n + AIM_PAD - 1) / AIM_PAD * AIM_PAD;
+  if (cap < 64) cap = 64;
+  free(l->block);
+  l->block    = calloc((size_t)cap * AIM_ARRAYS, sizeof(float));
+  l->capacity = cap;
+
+  float **arrays[AIM_ARRAYS] = {
+      &l->x,         &l->y,         &l->z,        &l->bodyYaw,
+      &l->offX,      &l->offY,      &l->offZ,     &l->weaponYaw,
+      &l->weaponPitch, &l->step,    &l->aimYaw,   &l->aimPitch,
+      &l->worldYaw,  &l->worldPitch, &l->fwdX,    &l->fwdY,
+      &l->fwdZ,      &l->posX,      &l->posY,     &l->posZ,
+  };
+  for (int i = 0; i < AIM_ARRAYS; i++)
+    *arrays[i] = l->block + (size_t)i * cap;
+}
+
+void AimLanes_Free(AimLanes *l) {
+  free(l->block);
+  memset(l, 0, sizeof(*l));
+}
+
+/* ------------------------------------------------------------------ */
+/*  Scalar approximations                                             */
+/* ------------------------------------------------------------------ */
+
+float AimBatch_Atan2(float y, float x) {
+  float ax = fabsf(x), ay = fabsf(y);
+  float a  = fminf(ax, ay) / fmaxf(fmaxf(ax, ay), 1e-30f);
+  float s  = a * a;
+  float r  = a * (AT0 + s * (AT1 + s * (AT2 + s * (AT3 + s * (AT4 + s * AT5)))));
+  if (ay > ax)  r = AIM_HALF_PI - r;
+  if (x < 0.0f) r = PI - r;
+  return copysignf(r, y);
+}
+
+void AimBatch_SinCos(float a, float *s, float *c) {
+  float q  = rintf(a * (1.0f / AIM_HALF_PI));
+  float r  = (a - q * AIM_PIO2_HI) - q * AIM_PIO2_LO;
+  float r2 = r * r;
+  float sr = r + r * r2 * (SN1 + r2 * (SN2 + r2 * SN3));
+  float cr = 1.0f + r2 * (CS1 + r2 * (CS2 + r2 * (CS3 + r2 * CS4)));
+  int   qi = (int)q;
+  float sv = (qi & 1) ? cr : sr;
+  float cv = (qi & 1) ? sr : cr;
+  *s = (qi & 2) ? -sv : sv;
+  *c = ((qi + 1) & 2) ? -cv : cv;
+}
+
+static inline float WrapPi(float a) {
+  return a - AIM_TWO_PI * rintf(a * (1.0f / AIM_TWO_PI));
+}
+
+/* ------------------------------------------------------------------ */
+/*  Vector primitives                                                 */
+/* ------------------------------------------------------------------ */
+
+#if defined(__AVX2__)
+#define AIM_LANES 8
+typedef __m256  aimVecF;
+typedef __m256i aimVecI;
+#define AIM_SET1(v)       _mm256_set1_ps(v)
+#define AIM_LOAD(p)       _mm256_loadu_ps(p)
+#define AIM_STORE(p, v)   _mm256_storeu_ps(p, v)
+#define AIM_ADD(a, b)     _mm256_add_ps(a, b)
+#define AIM_SUB(a, b)     _mm256_sub_ps(a, b)
+#define AIM_MUL(a, b)     _mm256_mul_ps(a, b)
+#define AIM_DIV(a, b)     _mm256_div_ps(a, b)
+#define AIM_MIN(a, b)     _mm256_min_ps(a, b)
+#define AIM_MAX(a, b)     _mm256_max_ps(a, b)
+#define AIM_SQRT(a)       _mm256_sqrt_ps(a)
+#define AIM_AND(a, b)     _mm256_and_ps(a, b)
+#define AIM_XOR(a, b)     _mm256_xor_ps(a, b)
+#define AIM_ANDNOT(a, b)  _mm256_andnot_ps(a, b)
+#define AIM_LT(a, b)      _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+#define AIM_GT(a, b)      _mm256_cmp_ps(a, b, _CMP_GT_OQ)
+#define AIM_SELECT(m, a, b) _mm256_blendv_ps(b, a, m)
+#define AIM_ROUND(a)      _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+#define AIM_TOINT(a)      _mm256_cvtps_epi32(a)
+#define AIM_SET1I(v)      _mm256_set1_epi32(v)
+#define AIM_ADDI(a, b)    _mm256_add_epi32(a, b)
+#define AIM_ANDI(a, b)    _mm256_and_si256(a, b)
+#define AIM_SLLI(a, n)    _mm256_slli_epi32(a, n)
+#define AIM_EQI(a, b)     _mm256_cmpeq_epi32(a, b)
+#define AIM_ASF(a)        _mm256_castsi256_ps(a)
+#elif defined(__SSE2__)
+#define AIM_LANES 4
+typedef __m128  aimVecF;
+typedef __m128i aimVecI;
+#define AIM_SET1(v)       _mm_set1_ps(v)
+#define AIM_LOAD(p)       _mm_loadu_ps(p)
+#define AIM_STORE(p, v)   _mm_storeu_ps(p, v)
+#define AIM_ADD(a, b)     _mm_add_ps(a, b)
+#define AIM_SUB(a, b)     _mm_sub_ps(a, b)
+#define AIM_MUL(a, b)     _mm_mul_ps(a, b)
+#define AIM_DIV(a, b)     _mm_div_ps(a, b)
+#define AIM_MIN(a, b)     _mm_min_ps(a, b)
+#define AIM_MAX(a, b)     _mm_max_ps(a, b)
+#define AIM_SQRT(a)       _mm_sqrt_ps(a)
+#define AIM_AND(a, b)     _mm_and_ps(a, b)
+#define AIM_XOR(a, b)     _mm_xor_ps(a, b)
+#define AIM_ANDNOT(a, b)  _mm_andnot_ps(a, b)
+#define AIM_LT(a, b)      _mm_cmplt_ps(a, b)
+#define AIM_GT(a, b)      _mm_cmpgt_ps(a, b)
+// SSE2 has no blend or round; cvtps rounds to nearest under the default MXCSR
+#define AIM_SELECT(m, a, b) _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b))
+#define AIM_ROUND(a)      _mm_cvtepi32_ps(_mm_cvtps_epi32(a))
+#define AIM_TOINT(a)      _mm_cvtps_epi32(a)
+#define AIM_SET1I(v)      _mm_set1_epi32(v)
+#define AIM_ADDI(a, b)    _mm_add_epi32(a, b)
+#define AIM_ANDI(a, b)    _mm_and_si128(a, b)
+#define AIM_SLLI(a, n)    _mm_slli_epi32(a, n)
+#define AIM_EQI(a, b)     _mm_cmpeq_epi32(a, b)
+#define AIM_ASF(a)        _mm_castsi128_ps(a)
+#endif
+
+#ifdef AIM_LANES
+#define AIM_SIGN AIM_SET1(-0.0f)
+
+static inline aimVecF aimAbs(aimVecF a) { return AIM_ANDNOT(AIM_SIGN, a); }
+
+static inline aimVecF aimAtan2(aimVecF y, aimVecF x) {
+  aimVecF ax = aimAbs(x), ay = aimAbs(y);
+  aimVecF a  = AIM_DIV(AIM_MIN(ax, ay), AIM_MAX(AIM_MAX(ax, ay), AIM_SET1(1e-30f)));
+  aimVecF s  = AIM_MUL(a, a);
+  aimVecF p  = AIM_ADD(AIM_SET1(AT4), AIM_MUL(s, AIM_SET1(AT5)));
+  p = AIM_ADD(AIM_SET1(AT3), AIM_MUL(s, p));
+  p = AIM_ADD(AIM_SET1(AT2), AIM_MUL(s, p));
+  p = AIM_ADD(AIM_SET1(AT1), AIM_MUL(s, p));
+  p = AIM_ADD(AIM_SET1(AT0), AIM_MUL(s, p));
+  aimVecF r = AIM_MUL(a, p);
+  r = AIM_SELECT(AIM_GT(ay, ax), AIM_SUB(AIM_SET1(AIM_HALF_PI), r), r);
+  r = AIM_SELECT(AIM_LT(x, AIM_SET1(0.0f)), AIM_SUB(AIM_SET1(PI), r), r);
+  return AIM_XOR(r, AIM_AND(y, AIM_SIGN)); // copysign
+}
+
+static inline void aimSinCos(aimVecF a, aimVecF *s, aimVecF *c) {
+  aimVecF q  = AIM_ROUND(AIM_MUL(a, AIM_SET1(1.0f / AIM_HALF_PI)));
+  aimVecF r  = AIM_SUB(AIM_SUB(a, AIM_MUL(q, AIM_SET1(AIM_PIO2_HI))),
+                       AIM_MUL(q, AIM_SET1(AIM_PIO2_LO)));
+  aimVecF r2 = AIM_MUL(r, r);
+
+  aimVecF sp = AIM_ADD(AIM_SET1(SN2), AIM_MUL(r2, AIM_SET1(SN3)));
+  sp = AIM_ADD(AIM_SET1(SN1), AIM_MUL(r2, sp));
+  aimVecF sr = AIM_ADD(r, AIM_MUL(AIM_MUL(r, r2), sp));
+
+  aimVecF cp = AIM_ADD(AIM_SET1(CS3), AIM_MUL(r2, AIM_SET1(CS4)));
+  cp = AIM_ADD(AIM_SET1(CS2), AIM_MUL(r2, cp));
+  cp = AIM_ADD(AIM_SET1(CS1), AIM_MUL(r2, cp));
+  aimVecF cr = AIM_ADD(AIM_SET1(1.0f), AIM_MUL(r2, cp));
+
+  // Odd quadrants swap sin and cos; bit 1 of q (of q + 1 for cos) flips sign
+  aimVecI qi   = AIM_TOINT(q);
+  aimVecF swap = AIM_ASF(AIM_EQI(AIM_ANDI(qi, AIM_SET1I(1)), AIM_SET1I(1)));
+  aimVecF sv   = AIM_SELECT(swap, cr, sr);
+  aimVecF cv   = AIM_SELECT(swap, sr, cr);
+  *s = AIM_XOR(sv, AIM_ASF(AIM_SLLI(AIM_ANDI(qi, AIM_SET1I(2)), 30)));
+  *c = AIM_XOR(cv, AIM_ASF(AIM_SLLI(AIM_ANDI(AIM_ADDI(qi, AIM_SET1I(1)),
+                                             AIM_SET1I(2)), 30)));
+}
+
+static inline aimVecF aimWrapPi(aimVecF a) {
+  aimVecF k = AIM_ROUND(AIM_MUL(a, AIM_SET1(1.0f / AIM_TWO_PI)));
+  return AIM_SUB(a, AIM_MUL(k, AIM_SET1(AIM_TWO_PI)));
+}
+
+// cur moved by delta, at most step; lands exactly on target when in reach
+static inline aimVecF aimStep(aimVecF cur, aimVecF target, aimVecF delta,
+                              aimVecF step) {
+  aimVecF moved = AIM_ADD(cur, AIM_MIN(AIM_MAX(delta, AIM_XOR(step, AIM_SIGN)), step));
+  return AIM_SELECT(AIM_LT(aimAbs(delta), step), target, moved);
+}
+#endif
+
+static inline float StepToward(float cur, float target, float delta,
+                               float step) {
+  if (fabsf(delta) < step) return target;
+  return cur + (delta > 0.0f ? 1.0f : -1.0f) * step;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Kernels                                                           */
+/* ------------------------------------------------------------------ */
+
+void AimBatch_BodyYaw(AimLanes *l, Vector3 target) {
+  int i = 0;
+#ifdef AIM_LANES
+  aimVecF tx = AIM_SET1(target.x), tz = AIM_SET1(target.z);
+  for (; i < l->count; i += AIM_LANES) {
+    aimVecF yaw   = AIM_LOAD(l->bodyYaw + i);
+    aimVecF want  = aimAtan2(AIM_SUB(tx, AIM_LOAD(l->x + i)),
+                             AIM_SUB(tz, AIM_LOAD(l->z + i)));
+    aimVecF delta = aimWrapPi(AIM_SUB(want, yaw));
+    AIM_STORE(l->bodyYaw + i, aimStep(yaw, want, delta, AIM_LOAD(l->step + i)));
+  }
+#endif
+  for (; i < l->count; i++) {
+    float want  = AimBatch_Atan2(target.x - l->x[i], target.z - l->z[i]);
+    float delta = WrapPi(want - l->bodyYaw[i]);
+    l->bodyYaw[i] = StepToward(l->bodyYaw[i], want, delta, l->step[i]);
+  }
+}
+
+void AimBatch_Swivel(AimLanes *l, Vector3 target) {
+  int i = 0;
+#ifdef AIM_LANES
+  aimVecF tx = AIM_SET1(target.x), ty = AIM_SET1(target.y),
+          tz = AIM_SET1(target.z);
+  for (; i < l->count; i += AIM_LANES) {
+    aimVecF dx = AIM_SUB(tx, AIM_LOAD(l->x + i));
+    aimVecF dy = AIM_SUB(ty, AIM_LOAD(l->y + i));
+    aimVecF dz = AIM_SUB(tz, AIM_LOAD(l->z + i));
+    aimVecF step = AIM_LOAD(l->step + i);
+
+    aimVecF horiz = AIM_SQRT(AIM_ADD(AIM_MUL(dx, dx), AIM_MUL(dz, dz)));
+    aimVecF pitch = aimAtan2(AIM_SUB(dy, AIM_LOAD(l->offY + i)), horiz);
+    aimVecF yaw   = aimWrapPi(AIM_SUB(aimAtan2(dx, dz), AIM_LOAD(l->bodyYaw + i)));
+
+    aimVecF aimYaw   = AIM_LOAD(l->aimYaw + i);
+    aimVecF aimPitch = AIM_LOAD(l->aimPitch + i);
+    AIM_STORE(l->aimYaw + i,
+              aimStep(aimYaw, yaw, aimWrapPi(AIM_SUB(yaw, aimYaw)), step));
+    AIM_STORE(l->aimPitch + i,
+              aimStep(aimPitch, pitch, AIM_SUB(pitch, aimPitch), step));
+  }
+#endif
+  for (; i < l->count; i++) {
+    float dx = target.x - l->x[i], dy = target.y - l->y[i], dz = target.z - l->z[i];
+    float pitch = AimBatch_Atan2(dy - l->offY[i], sqrtf(dx * dx + dz * dz));
+    float yaw   = WrapPi(AimBatch_Atan2(dx, dz) - l->bodyYaw[i]);
+    l->aimYaw[i]   = StepToward(l->aimYaw[i], yaw, WrapPi(yaw - l->aimYaw[i]),
+                                l->step[i]);
+    l->aimPitch[i] = StepToward(l->aimPitch[i], pitch, pitch - l->aimPitch[i],
+                                l->step[i]);
+  }
+}
+
+void AimBatch_MuzzleWorld(AimLanes *l) {
+  int i = 0;
+#ifdef AIM_LANES
+  for (; i < l->count; i += AIM_LANES) {
+    aimVecF body = AIM_LOAD(l->bodyYaw + i);
+    aimVecF yaw  = AIM_ADD(AIM_ADD(body, AIM_LOAD(l->aimYaw + i)),
+                           AIM_LOAD(l->weaponYaw + i));
+    aimVecF pitch = AIM_ADD(AIM_LOAD(l->aimPitch + i), AIM_LOAD(l->weaponPitch + i));
+    AIM_STORE(l->worldYaw + i, yaw);
+    AIM_STORE(l->worldPitch + i, pitch);
+
+    aimVecF sb, cb, sy, cy, sp, cp;
+    aimSinCos(body, &sb, &cb);
+    aimSinCos(yaw, &sy, &cy);
+    aimSinCos(pitch, &sp, &cp);
+
+    // Unit by construction; renormalize away the approximation error
+    aimVecF fx = AIM_MUL(cp, sy), fy = sp, fz = AIM_MUL(cp, cy);
+    aimVecF inv = AIM_DIV(AIM_SET1(1.0f),
+                          AIM_SQRT(AIM_ADD(AIM_ADD(AIM_MUL(fx, fx), AIM_MUL(fy, fy)),
+                                           AIM_MUL(fz, fz))));
+    fx = AIM_MUL(fx, inv); fy = AIM_MUL(fy, inv); fz = AIM_MUL(fz, inv);
+    AIM_STORE(l->fwdX + i, fx);
+    AIM_STORE(l->fwdY + i, fy);
+    AIM_STORE(l->fwdZ + i, fz);
+
+    // Pivot: the offset's x swung by the body yaw, then out along forward by z
+    aimVecF ox = AIM_LOAD(l->offX + i), oz = AIM_LOAD(l->offZ + i);
+    AIM_STORE(l->posX + i, AIM_ADD(AIM_ADD(AIM_LOAD(l->x + i), AIM_MUL(ox, cb)),
+                                   AIM_MUL(fx, oz)));
+    AIM_STORE(l->posY + i, AIM_ADD(AIM_ADD(AIM_LOAD(l->y + i), AIM_LOAD(l->offY + i)),
+                                   AIM_MUL(fy, oz)));
+    AIM_STORE(l->posZ + i, AIM_ADD(AIM_ADD(AIM_LOAD(l->z + i), AIM_MUL(ox, sb)),
+                                   AIM_MUL(fz, oz)));
+  }
+#endif
+  for (; i < l->count; i++) {
+    float yaw   = l->bodyYaw[i] + l->aimYaw[i] + l->weaponYaw[i];
+    float pitch = l->aimPitch[i] + l->weaponPitch[i];
+    l->worldYaw[i]   = yaw;
+    l->worldPitch[i] = pitch;
+
+    float sb, cb, sy, cy, sp, cp;
+    AimBatch_SinCos(l->bodyYaw[i], &sb, &cb);
+    AimBatch_SinCos(yaw, &sy, &cy);
+    AimBatch_SinCos(pitch, &sp, &cp);
+
+    float fx = cp * sy, fy = sp, fz = cp * cy;
+    float inv = 1.0f / sqrtf(fx * fx + fy * fy + fz * fz);
+    l->fwdX[i] = fx *= inv;
+    l->fwdY[i] = fy *= inv;
+    l->fwdZ[i] = fz *= inv;
+
+    l->posX[i] = l->x[i] + l->offX[i] * cb + fx * l->offZ[i];
+    l->posY[i] = l->y[i] + l->offY[i] + fy * l->offZ[i];
+    l->posZ[i] = l->z[i] + l->offX[i] * sb + fz * l->offZ[i];
+  }
+}
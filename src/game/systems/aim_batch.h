@@ -0,0 +1,52 @@
+#pragma once
+#include "raylib.h"
+
+// Batched turret aiming over structure-of-arrays lanes. Every kernel runs
+// AVX2 (8 lanes) or SSE2 (4 lanes) when the build targets them, otherwise a
+// scalar loop, and uses the polynomial atan2 and sin/cos below in place of
+// libm: atan2 is within AIM_ATAN2_MAX_ERR radians, sin and cos within
+// AIM_SINCOS_MAX_ERR for angles up to a few turns.
+
+#define AIM_ATAN2_MAX_ERR  2e-6f
+#define AIM_SINCOS_MAX_ERR 1e-6f
+
+// Lanes are padded to a whole vector, so callers fill [0, count) and the
+// kernels may read and write up to capacity.
+typedef struct {
+  int    count;
+  int    capacity;
+  float *block; // one allocation backing every array below
+
+  // Inputs
+  float *x, *y, *z;           // owner position
+  float *bodyYaw;             // owner yaw
+  float *offX, *offY, *offZ;  // muzzle positionOffset
+  float *weaponYaw, *weaponPitch;
+  float *step;                // max turn this tick, radians
+
+  // Updated in place
+  float *aimYaw, *aimPitch;
+
+  // Outputs of AimBatch_MuzzleWorld
+  float *worldYaw, *worldPitch;
+  float *fwdX, *fwdY, *fwdZ;
+  float *posX, *posY, *posZ;
+} AimLanes;
+
+// Grows the arrays to hold at least n lanes and sets count to n.
+void AimLanes_Reserve(AimLanes *l, int n);
+void AimLanes_Free(AimLanes *l);
+
+// Turns bodyYaw toward target in the XZ plane by at most step per lane.
+// Reads x, z, step; updates bodyYaw.
+void AimBatch_BodyYaw(AimLanes *l, Vector3 target);
+// Swivels aimYaw (relative to bodyYaw) and aimPitch toward target by at
+// most step each, as EnemyAimSystem always has.
+void AimBatch_Swivel(AimLanes *l, Vector3 target);
+// World rotation, unit forward and muzzle tip per lane: the offset's x is
+// swung by bodyYaw, its y added, and the tip pushed offZ along forward.
+void AimBatch_MuzzleWorld(AimLanes *l);
+
+// Scalar forms of the approximations the kernels use.
+float AimBatch_Atan2(float y, float x);
+void  AimBatch_SinCos(float a, float *s, float *c);
@@ -1,4 +1,5 @@
 #include "../game.h"
+#include "../input.h"
 #include "../level_creater_helper.h"
 #include "systems.h"
 #include <math.h>
@@ -40,7 +41,7 @@ void BlunderbussSystem(world_t *world, GameWorld *game,
   // ------------------------------------------------------------------
   // LMB — spread shot (single press, semi-auto)
   // ------------------------------------------------------------------
-  if (!m->isOverheated && IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+  if (!m->isOverheated && Input_MousePressed(MOUSE_BUTTON_LEFT)) {
     FireMuzzle(world, game, player, game->playerArchId, m);
 
     m->heat += m->heatPerShot;
@@ -63,7 +64,7 @@ void BlunderbussSystem(world_t *world, GameWorld *game,
   // ------------------------------------------------------------------
   // RMB — fire hook or cancel
   // ------------------------------------------------------------------
-  if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT)) {
+  if (Input_MousePressed(MOUSE_BUTTON_RIGHT)) {
     if (game->hookState == HOOKSTATE_IDLE) {
       game->hookState  = HOOKSTATE_FLYING;
       game->hookOrigin = m->worldPosition;
@@ -188,8 +188,7 @@ void BulletSystem(world_t *world, GameWorld *game, archetype_t *bulletArch,
     Vector3 nextPos = Vector3Add(prevPos, Vector3Scale(vel->value, dt));
     Vector3 delta = Vector3Subtract(nextPos, prevPos);
 
-    float terrainY = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                                   prevPos.x, prevPos.z);
+    float terrainY = TerrainHeight(game, prevPos.x, prevPos.z);
 
     /* --- Terrain collision --- */
     if (prevPos.y <= terrainY) {
@@ -197,6 +196,13 @@ void BulletSystem(world_t *world, GameWorld *game, archetype_t *bulletArch,
       continue;
     }
 
+    // Swept terrain test; clip the step so targets behind a ridge are safe
+    Vector3 terrainHit;
+    bool hitsTerrain = HeightMap_SegmentIntersect(
+        &game->terrainHeightMap, prevPos, nextPos, &terrainHit);
+    if (hitsTerrain)
+      nextPos = terrainHit;
+
     float radius = bulletSphere->radius;
 
     bool hit = false;
@@ -274,11 +280,14 @@ void BulletSystem(world_t *world, GameWorld *game, archetype_t *bulletArch,
 
 #undef CHECK_ARCH
 
-    if (!hit)
-      pos->value = nextPos;
+    pos->value = nextPos;
+    if (hitsTerrain)
+      active->value = false;
   }
 }
 
+#define EXPLOSION_MAX_HITS 128
+
 static void SpawnExplosion(world_t *world, GameWorld *game, Vector3 center,
                            float maxDamage) {
   const float blastRadius = 8.0f;
@@ -290,29 +299,21 @@ static void SpawnExplosion(world_t *world, GameWorld *game, Vector3 center,
   SpawnParticle(world, game, center, (Vector3){0.0f, 1.5f, 0.0f},
                 blastRadius * 0.5f, 1.1f,  (Color){80, 70, 70, 150});
 
-  archetype_t *archs[] = {
-      WorldGetArchetype(world, game->playerArchId),
-      WorldGetArchetype(world, game->enemyGruntArchId),
-      WorldGetArchetype(world, game->enemyRangerArchId),
-      WorldGetArchetype(world, game->enemyMeleeArchId),
-      WorldGetArchetype(world, game->enemyDroneArchId),
-      WorldGetArchetype(world, game->targetStaticArchId),
-      WorldGetArchetype(world, game->targetPatrolArchId),
-  };
-  for (int t = 0; t < 7; t++) {
-    archetype_t *arch = archs[t];
-    if (!arch) continue;
-    for (uint32_t i = 0; i < arch->count; i++) {
-      entity_t ent    = arch->entities[i];
-      Active  *active = ECS_GET(world, ent, Active, COMP_ACTIVE);
-      if (!active || !active->value) continue;
-      Position *epos = ECS_GET(world, ent, Position, COMP_POSITION);
-      if (!epos) continue;
-      float dist = Vector3Distance(center, epos->value);
-      if (dist >= blastRadius) continue;
-      float falloff = 1.0f - (dist / blastRadius);
-      ApplyDamage(world, ent, arch, maxDamage * falloff, 1.0f, 1.0f);
-    }
+  entity_t hits[EXPLOSION_MAX_HITS];
+  int n = WorldQueryRadius(world, center, blastRadius,
+                           (1u << LAYER_PLAYER) | (1u << LAYER_ENEMY), hits,
+                           EXPLOSION_MAX_HITS);
+  for (int i = 0; i < n; i++) {
+    entity_t ent = hits[i];
+    Active *active = ECS_GET(world, ent, Active, COMP_ACTIVE);
+    if (!active || !active->value) continue;
+    Position *epos = ECS_GET(world, ent, Position, COMP_POSITION);
+    if (!epos) continue;
+    float dist = Vector3Distance(center, epos->value);
+    if (dist >= blastRadius) continue;
+    float falloff = 1.0f - (dist / blastRadius);
+    ApplyDamage(world, ent, WorldGetEntityArchetype(world, ent),
+                maxDamage * falloff, 1.0f, 1.0f);
   }
 }
 
@@ -394,8 +395,7 @@ void HomingMissileSystem(world_t *world, GameWorld *game, archetype_t *arch,
     Vector3 prevPos = pos->value;
     Vector3 nextPos = Vector3Add(prevPos, Vector3Scale(vel->value, dt));
 
-    float terrainY = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                                   prevPos.x, prevPos.z);
+    float terrainY = TerrainHeight(game, prevPos.x, prevPos.z);
 
     /* --- Terrain collision --- */
     if (prevPos.y <= terrainY) {
@@ -405,6 +405,12 @@ void HomingMissileSystem(world_t *world, GameWorld *game, archetype_t *arch,
       continue;
     }
 
+    Vector3 terrainHit;
+    bool hitsTerrain = HeightMap_SegmentIntersect(
+        &game->terrainHeightMap, prevPos, nextPos, &terrainHit);
+    if (hitsTerrain)
+      nextPos = terrainHit;
+
     float radius = missileSphere->radius;
 
     bool hit = false;
@@ -474,7 +480,13 @@ void HomingMissileSystem(world_t *world, GameWorld *game, archetype_t *arch,
 
 #undef CHECK_ARCH
 
-    if (!hit)
-      pos->value = nextPos;
+    if (hitsTerrain) {
+      SpawnExplosion(world, game, nextPos, hm->blastDamage);
+      StopLoopSound(&game->soundSystem, e);
+      TryKillEntity(world, e);
+      continue;
+    }
+
+    pos->value = nextPos;
   }
 }
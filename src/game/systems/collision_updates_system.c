@@ -94,153 +94,136 @@ void UpdateObstacleCollision(world_t *world, archetype_t *obstacleArch) {
 //   }
 // }
 
-void UpdateCollisionBounds(world_t *world) {
-  for (int a = 0; a < world->archetypeCount; a++) {
-    archetype_t *arch = &world->archetypes[a];
-
-    if (!ArchetypeHas(arch, COMP_COLLISION_INSTANCE))
-      continue;
-
-    for (int i = 0; i < arch->count; i++) {
-      entity_t e = arch->entities[i];
+/* ------------------------------------------------------------------ */
+/*  Bounds refresh                                                     */
+/* ------------------------------------------------------------------ */
 
-      // Skip inactive
-      if (ArchetypeHas(arch, COMP_ACTIVE)) {
-        Active *active = ECS_GET(world, e, Active, COMP_ACTIVE);
-        if (!active || !active->value)
-          continue;
-      }
+static void *InlineColumn(archetype_t *arch, componentId_t id) {
+  if (!ArchetypeHas(arch, id))
+    return NULL;
 
-      CollisionInstance *ci =
-          ECS_GET(world, e, CollisionInstance, COMP_COLLISION_INSTANCE);
-
-      if (!ci)
-        continue;
-
-      Position *pos = ECS_GET(world, e, Position, COMP_POSITION);
-
-      if (!pos)
-        continue;
+  archetypeColumn_t *col = ArchetypeFindColumn(arch, id);
+  if (!col || col->storageType != ArchetypeStorageInline)
+    return NULL;
 
-      switch (ci->type) {
-      case COLLIDER_SPHERE: {
-        SphereCollider *sphere =
-            ECS_GET(world, e, SphereCollider, COMP_SPHERE_COLLIDER);
-
-        if (!sphere)
-          break;
-
-        sphere->center = pos->value;
-        ci->worldBounds = Sphere_ComputeAABB(sphere);
-      } break;
+  return col->data;
+}
 
-      case COLLIDER_AABB: {
-        AABBCollider *aabb =
-            ECS_GET(world, e, AABBCollider, COMP_AABB_COLLIDER);
+// Refreshes worldBounds for every active, non-static collider in one
+// archetype. Columns are fetched once and walked as flat SoA arrays instead
+// of going through ECS_GET per entity.
+static void RefreshArchetypeBounds(archetype_t *arch, bool syncCapsuleEnds) {
+  CollisionInstance *cis = InlineColumn(arch, COMP_COLLISION_INSTANCE);
+  Position *positions = InlineColumn(arch, COMP_POSITION);
 
-        if (!aabb)
-          break;
+  if (!cis || !positions)
+    return;
 
-        ci->worldBounds.min = (Vector3){pos->value.x - aabb->halfExtents.x,
-                                        pos->value.y - aabb->halfExtents.y,
-                                        pos->value.z - aabb->halfExtents.z};
+  Active *actives = InlineColumn(arch, COMP_ACTIVE);
+  SphereCollider *spheres = InlineColumn(arch, COMP_SPHERE_COLLIDER);
+  AABBCollider *aabbs = InlineColumn(arch, COMP_AABB_COLLIDER);
+  CapsuleCollider *capsules = InlineColumn(arch, COMP_CAPSULE_COLLIDER);
+  WallSegmentCollider *walls = InlineColumn(arch, COMP_WALL_SEGMENT_COLLIDER);
 
-        ci->worldBounds.max = (Vector3){pos->value.x + aabb->halfExtents.x,
-                                        pos->value.y + aabb->halfExtents.y,
-                                        pos->value.z + aabb->halfExtents.z};
-      } break;
+#pragma omp parallel for if (arch->count >= OMP_MIN_ITERATIONS)
+  for (uint32_t i = 0; i < arch->count; i++) {
+    if (actives && !actives[i].value)
+      continue;
 
-      case COLLIDER_CAPSULE: {
-        CapsuleCollider *cap =
-            ECS_GET(world, e, CapsuleCollider, COMP_CAPSULE_COLLIDER);
+    CollisionInstance *ci = &cis[i];
+    if (ci->isStatic)
+      continue;
 
-        if (!cap)
-          break;
+    Vector3 p = positions[i].value;
 
-        ci->worldBounds = Capsule_ComputeAABB(cap);
-      } break;
+    switch (ci->type) {
+    case COLLIDER_SPHERE:
+      if (spheres)
+        Collision_UpdateSphere(ci, &spheres[i], p);
+      break;
 
-      case COLLIDER_WALL_SEGMENT: {
-        WallSegmentCollider *wall =
-            ECS_GET(world, e, WallSegmentCollider, COMP_WALL_SEGMENT_COLLIDER);
+    case COLLIDER_AABB:
+      if (aabbs)
+        Collision_UpdateAABB(ci, &aabbs[i], p);
+      break;
 
-        if (!wall)
-          break;
+    case COLLIDER_CAPSULE:
+      if (capsules) {
+        if (syncCapsuleEnds)
+          Capsule_UpdateWorld(&capsules[i], p);
+        ci->worldBounds = Capsule_ComputeAABB(&capsules[i]);
+      }
+      break;
 
-        Collision_UpdateWallSegment(ci, wall, pos->value);
-      } break;
+    case COLLIDER_WALL_SEGMENT:
+      if (walls)
+        Collision_UpdateWallSegment(ci, &walls[i], p);
+      break;
 
-      default:
-        break;
-      }
+    default:
+      break;
     }
   }
 }
 
+// Every collider is refreshed each tick unless it was marked static, so
+// colliders moved by position alone (patrol targets, scripted props) stay
+// in sync without needing a Velocity.
 void CollisionSyncSystem(world_t *world) {
-  for (int a = 0; a < world->archetypeCount; a++) {
+  for (uint32_t a = 0; a < world->archetypeCount; a++) {
     archetype_t *arch = &world->archetypes[a];
 
     if (!ArchetypeHas(arch, COMP_COLLISION_INSTANCE))
       continue;
-    if (!ArchetypeHas(arch, COMP_VELOCITY)) {
-      continue;
-    }
 
-    for (uint32_t i = 0; i < arch->count; i++) {
-      entity_t e = arch->entities[i];
-
-      // Skip inactive
-      if (ArchetypeHas(arch, COMP_ACTIVE)) {
-        Active *active = ECS_GET(world, e, Active, COMP_ACTIVE);
-        if (!active || !active->value)
-          continue;
-      }
-
-      CollisionInstance *ci =
-          ECS_GET(world, e, CollisionInstance, COMP_COLLISION_INSTANCE);
-
-      Position *pos = ECS_GET(world, e, Position, COMP_POSITION);
-
-      if (!ci || !pos)
-        continue;
-
-      switch (ci->type) {
-      case COLLIDER_AABB: {
-        AABBCollider *aabb =
-            ECS_GET(world, e, AABBCollider, COMP_AABB_COLLIDER);
-
-        if (!aabb)
-          break;
-
-        Collision_UpdateAABB(ci, aabb, pos->value);
-      } break;
-
-      case COLLIDER_SPHERE: {
-        SphereCollider *sphere =
-            ECS_GET(world, e, SphereCollider, COMP_SPHERE_COLLIDER);
+    RefreshArchetypeBounds(arch, true);
+  }
+}
 
-        if (!sphere)
-          break;
+// Computes bounds once for a collider that never moves on its own and
+// excludes it from the per-tick refresh. Code that relocates a static
+// collider (editor) must refresh its bounds explicitly.
+void CollisionMarkStatic(world_t *world, entity_t e) {
+  CollisionInstance *ci =
+      ECS_GET(world, e, CollisionInstance, COMP_COLLISION_INSTANCE);
+  Position *pos = ECS_GET(world, e, Position, COMP_POSITION);
 
-        Collision_UpdateSphere(ci, sphere, pos->value);
-      } break;
+  if (!ci || !pos)
+    return;
 
-      case COLLIDER_CAPSULE: {
-        CapsuleCollider *cap =
-            ECS_GET(world, e, CapsuleCollider, COMP_CAPSULE_COLLIDER);
+  switch (ci->type) {
+  case COLLIDER_SPHERE: {
+    SphereCollider *sphere =
+        ECS_GET(world, e, SphereCollider, COMP_SPHERE_COLLIDER);
+    if (sphere)
+      Collision_UpdateSphere(ci, sphere, pos->value);
+  } break;
 
-        if (!cap)
-          break;
+  case COLLIDER_AABB: {
+    AABBCollider *aabb = ECS_GET(world, e, AABBCollider, COMP_AABB_COLLIDER);
+    if (aabb)
+      Collision_UpdateAABB(ci, aabb, pos->value);
+  } break;
+
+  case COLLIDER_CAPSULE: {
+    CapsuleCollider *cap =
+        ECS_GET(world, e, CapsuleCollider, COMP_CAPSULE_COLLIDER);
+    if (cap) {
+      Capsule_UpdateWorld(cap, pos->value);
+      ci->worldBounds = Capsule_ComputeAABB(cap);
+    }
+  } break;
 
-        Capsule_UpdateWorld(cap, pos->value);
-        ci->worldBounds = Capsule_ComputeAABB(cap);
-      } break;
+  case COLLIDER_WALL_SEGMENT: {
+    WallSegmentCollider *wall =
+        ECS_GET(world, e, WallSegmentCollider, COMP_WALL_SEGMENT_COLLIDER);
+    if (wall)
+      Collision_UpdateWallSegment(ci, wall, pos->value);
+  } break;
 
-      case COLLIDER_WALL_SEGMENT:
-      default:
-        break;
-      }
-    }
+  default:
+    break;
   }
+
+  ci->isStatic = true;
 }
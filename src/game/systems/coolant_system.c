@@ -6,6 +6,7 @@
 #define COOLANT_GRAVITY        18.0f
 #define COOLANT_BOUNCE_DAMP    0.45f
 #define COOLANT_TRAIL_INTERVAL 0.05f
+#define PICKUP_MAX_HITS        32
 
 void CoolantSystem(world_t *world, GameWorld *game, float dt) {
   archetype_t *arch = WorldGetArchetype(world, game->coolantArchId);
@@ -32,8 +33,7 @@ void CoolantSystem(world_t *world, GameWorld *game, float dt) {
     vel->value.y -= COOLANT_GRAVITY * dt;
 
     // Terrain bounce
-    float ty = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                              pos->value.x, pos->value.z);
+    float ty = TerrainHeight(game, pos->value.x, pos->value.z);
     if (pos->value.y <= ty) {
       pos->value.y = ty;
       vel->value.y = fabsf(vel->value.y) * COOLANT_BOUNCE_DAMP;
@@ -75,21 +75,26 @@ void CoolantSystem(world_t *world, GameWorld *game, float dt) {
         }
       }
     }
+  }
 
-    // Pickup — XZ only: player eye is high above orb, 3D distance always fails
-    float dx = ppos->value.x - pos->value.x;
-    float dz = ppos->value.z - pos->value.z;
-    if (sqrtf(dx*dx + dz*dz) < COOLANT_PICKUP_RADIUS) {
-      if (mc) {
-        for (int k = 0; k < mc->count; k++) {
-          Muzzle_t *m = &mc->Muzzles[k];
-          m->heat -= 0.20f;
-          if (m->heat < 0.0f) m->heat = 0.0f;
-          if (m->isOverheated && m->heat < m->overheatThreshold)
-            m->isOverheated = false;
-        }
+  // Pickup — XZ only: player eye is high above orb, 3D distance always fails
+  entity_t near[PICKUP_MAX_HITS];
+  int n = WorldQueryRadiusXZ(world, ppos->value, COOLANT_PICKUP_RADIUS,
+                             1u << LAYER_PICKUP, near, PICKUP_MAX_HITS);
+  for (int k = 0; k < n; k++) {
+    if (!ECS_GET(world, near[k], Coolant, COMP_COOLANT)) continue;
+    Active *active = ECS_GET(world, near[k], Active, COMP_ACTIVE);
+    if (!active || !active->value) continue;
+
+    if (mc) {
+      for (int j = 0; j < mc->count; j++) {
+        Muzzle_t *m = &mc->Muzzles[j];
+        m->heat -= 0.20f;
+        if (m->heat < 0.0f) m->heat = 0.0f;
+        if (m->isOverheated && m->heat < m->overheatThreshold)
+          m->isOverheated = false;
       }
-      active->value = false;
     }
+    active->value = false;
   }
 }
@@ -0,0 +1,189 @@
+#include "crowd.h"
+#include "../ecs_get.h"
+#include "raymath.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+void CrowdGrid_Init(CrowdGrid *g, Vector3 origin, float worldSize,
+                    float cellSize) {
+  memset(g, 0, sizeof(*g));
+  g->cellSize = cellSize;
+  g->origin = origin;
+  g->width = (int)ceilf(worldSize / cellSize);
+  g->height = g->width;
+  g->cellStart = calloc((size_t)g->width * g->height + 1, sizeof(int));
+}
+
+void CrowdGrid_Destroy(CrowdGrid *g) {
+  free(g->cellStart);
+  free(g->agents);
+  free(g->agentCell);
+  free(g->order);
+  free(g->steering);
+  memset(g, 0, sizeof(*g));
+}
+
+void CrowdGrid_Clear(CrowdGrid *g) { g->agentCount = 0; }
+
+static bool Grow(CrowdGrid *g) {
+  int cap = g->agentCapacity ? g->agentCapacity * 2 : 128;
+
+  CrowdAgent *agents = realloc(g->agents, cap * sizeof(CrowdAgent));
+  if (!agents)
+    return false;
+  g->agents = agents;
+
+  int *agentCell = realloc(g->agentCell, cap * sizeof(int));
+  if (!agentCell)
+    return false;
+  g->agentCell = agentCell;
+
+  int *order = realloc(g->order, cap * sizeof(int));
+  if (!order)
+    return false;
+  g->order = order;
+
+  Vector3 *steering = realloc(g->steering, cap * sizeof(Vector3));
+  if (!steering)
+    return false;
+  g->steering = steering;
+
+  g->agentCapacity = cap;
+  return true;
+}
+
+int CrowdGrid_Add(CrowdGrid *g, entity_t e, Vector3 position, float radius,
+                  bool steer) {
+  if (g->agentCount == g->agentCapacity && !Grow(g))
+    return -1;
+
+  int idx = g->agentCount++;
+  g->agents[idx] = (CrowdAgent){e, position, radius, steer};
+  return idx;
+}
+
+// Agents outside the grid are clamped onto the border cells so they are
+// still found by queries near the edge.
+static void CellCoords(const CrowdGrid *g, Vector3 p, int *cx, int *cz) {
+  int x = (int)floorf((p.x - g->origin.x) / g->cellSize);
+  int z = (int)floorf((p.z - g->origin.z) / g->cellSize);
+  *cx = x < 0 ? 0 : (x >= g->width ? g->width - 1 : x);
+  *cz = z < 0 ? 0 : (z >= g->height ? g->height - 1 : z);
+}
+
+void CrowdGrid_Build(CrowdGrid *g) {
+  if (!g->cellStart)
+    return;
+
+  int cellCount = g->width * g->height;
+  memset(g->cellStart, 0, (cellCount + 1) * sizeof(int));
+
+  // Counting sort: histogram, exclusive prefix sum, scatter
+  for (int i = 0; i < g->agentCount; i++) {
+    int cx, cz;
+    CellCoords(g, g->agents[i].position, &cx, &cz);
+    g->agentCell[i] = cz * g->width + cx;
+    g->cellStart[g->agentCell[i] + 1]++;
+  }
+
+  for (int c = 0; c < cellCount; c++)
+    g->cellStart[c + 1] += g->cellStart[c];
+
+  // cellStart[c] is used as the write cursor, then restored by shifting
+  for (int i = 0; i < g->agentCount; i++)
+    g->order[g->cellStart[g->agentCell[i]]++] = i;
+
+  for (int c = cellCount; c > 0; c--)
+    g->cellStart[c] = g->cellStart[c - 1];
+  g->cellStart[0] = 0;
+}
+
+int CrowdGrid_QueryRadius(const CrowdGrid *g, Vector3 center, float radius,
+                          int *out, int maxOut) {
+  if (!g->cellStart || g->agentCount == 0)
+    return 0;
+
+  int x0, z0, x1, z1;
+  CellCoords(g, (Vector3){center.x - radius, 0, center.z - radius}, &x0, &z0);
+  CellCoords(g, (Vector3){center.x + radius, 0, center.z + radius}, &x1, &z1);
+
+  float r2 = radius * radius;
+  int count = 0;
+
+  for (int z = z0; z <= z1; z++) {
+    for (int x = x0; x <= x1; x++) {
+      int c = z * g->width + x;
+      for (int k = g->cellStart[c]; k < g->cellStart[c + 1]; k++) {
+        int idx = g->order[k];
+        float dx = g->agents[idx].position.x - center.x;
+        float dz = g->agents[idx].position.z - center.z;
+        if (dx * dx + dz * dz > r2)
+          continue;
+        if (count == maxOut)
+          return count;
+        out[count++] = idx;
+      }
+    }
+  }
+  return count;
+}
+
+// Stable pseudo-random direction for exactly coincident agents (spawners),
+// so a stacked pair still splits apart instead of pushing with zero length.
+static Vector3 TieBreakDir(int a, int b) {
+  uint32_t h = (uint32_t)a * 2654435761u ^ (uint32_t)b * 40503u;
+  float ang = (float)(h & 0xFFFF) / 65535.0f * 2.0f * PI;
+  return (Vector3){cosf(ang), 0.0f, sinf(ang)};
+}
+
+void CrowdGrid_ComputeSeparation(CrowdGrid *g, float strength) {
+#pragma omp parallel for if (g->agentCount >= OMP_MIN_ITERATIONS)
+  for (int i = 0; i < g->agentCount; i++) {
+    CrowdAgent *self = &g->agents[i];
+    Vector3 push = {0};
+
+    if (self->steer) {
+      int cx = g->agentCell[i] % g->width;
+      int cz = g->agentCell[i] / g->width;
+
+      for (int z = cz - 1; z <= cz + 1; z++) {
+        if (z < 0 || z >= g->height)
+          continue;
+        for (int x = cx - 1; x <= cx + 1; x++) {
+          if (x < 0 || x >= g->width)
+            continue;
+
+          int c = z * g->width + x;
+          for (int k = g->cellStart[c]; k < g->cellStart[c + 1]; k++) {
+            int j = g->order[k];
+            if (j == i)
+              continue;
+
+            const CrowdAgent *other = &g->agents[j];
+            float sepDist = self->radius + other->radius + CROWD_SEP_MARGIN;
+
+            float dx = self->position.x - other->position.x;
+            float dz = self->position.z - other->position.z;
+            float d2 = dx * dx + dz * dz;
+            if (d2 >= sepDist * sepDist)
+              continue;
+
+            float dist = sqrtf(d2);
+            Vector3 dir = dist > 0.001f
+                              ? (Vector3){dx / dist, 0.0f, dz / dist}
+                              : TieBreakDir(i < j ? i : j, i < j ? j : i);
+            if (dist <= 0.001f && i > j)
+              dir = Vector3Negate(dir);
+
+            float w = (sepDist - dist) / sepDist;
+            push.x += dir.x * w * strength;
+            push.z += dir.z * w * strength;
+          }
+        }
+      }
+    }
+
+    g->steering[i] = push;
+  }
+}
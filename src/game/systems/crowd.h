@@ -0,0 +1,51 @@
+#pragma once
+#include "../../engine/ecs/entity.h"
+#include "raylib.h"
+#include <stdbool.h>
+
+// Uniform XZ grid of enemy agents, rebuilt every tick with a counting sort.
+// Provides neighbour queries and separation steering in O(n) for evenly
+// spread crowds instead of the O(n^2) all-pairs scan.
+
+#define CROWD_CELL_SIZE    4.0f  // >= largest pair separation distance
+#define CROWD_SEP_MARGIN   0.5f  // extra gap kept between agent radii
+#define CROWD_SEP_STRENGTH 12.0f // push speed at full overlap (m/s)
+
+typedef struct {
+  entity_t entity;
+  Vector3 position;
+  float radius;
+  bool steer; // false: acts as an obstacle only (e.g. mid-lunge)
+} CrowdAgent;
+
+typedef struct {
+  int width;
+  int height;
+  float cellSize;
+  Vector3 origin;
+
+  int *cellStart; // width * height + 1 offsets into order[]
+
+  CrowdAgent *agents;
+  int *agentCell;    // grid cell of each agent
+  int *order;        // agent indices sorted by cell
+  Vector3 *steering; // XZ separation velocity per agent
+  int agentCount;
+  int agentCapacity;
+} CrowdGrid;
+
+void CrowdGrid_Init(CrowdGrid *g, Vector3 origin, float worldSize,
+                    float cellSize);
+void CrowdGrid_Destroy(CrowdGrid *g);
+
+void CrowdGrid_Clear(CrowdGrid *g);
+int CrowdGrid_Add(CrowdGrid *g, entity_t e, Vector3 position, float radius,
+                  bool steer);
+void CrowdGrid_Build(CrowdGrid *g);
+
+// Writes indices of agents whose centres lie within radius of center (XZ).
+int CrowdGrid_QueryRadius(const CrowdGrid *g, Vector3 center, float radius,
+                          int *out, int maxOut);
+
+// Fills g->steering with the separation velocity for every steering agent.
+void CrowdGrid_ComputeSeparation(CrowdGrid *g, float strength);
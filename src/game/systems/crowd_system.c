@@ -0,0 +1,82 @@
+#include "../game.h"
+#include "crowd.h"
+#include "systems.h"
+
+static void AddArchetypeAgents(world_t *world, CrowdGrid *crowd,
+                               archetype_t *arch, float defaultRadius) {
+  bool hasCapsule = ArchetypeHas(arch, COMP_CAPSULE_COLLIDER);
+  bool hasMelee = ArchetypeHas(arch, COMP_MELEE_ENEMY);
+
+  for (uint32_t i = 0; i < arch->count; i++) {
+    entity_t e = arch->entities[i];
+
+    Active *active = ECS_GET(world, e, Active, COMP_ACTIVE);
+    if (!active || !active->value)
+      continue;
+
+    Position *pos = ECS_GET(world, e, Position, COMP_POSITION);
+    if (!pos)
+      continue;
+
+    float radius = defaultRadius;
+    if (hasCapsule) {
+      CapsuleCollider *cap =
+          ECS_GET(world, e, CapsuleCollider, COMP_CAPSULE_COLLIDER);
+      if (cap)
+        radius = cap->radius;
+    }
+
+    // A lunging melee enemy still blocks others but is not pushed itself
+    bool steer = true;
+    if (hasMelee) {
+      MeleeEnemy *me = ECS_GET(world, e, MeleeEnemy, COMP_MELEE_ENEMY);
+      if (me && me->state == MELEE_LUNGING)
+        steer = false;
+    }
+
+    CrowdGrid_Add(crowd, e, pos->value, radius, steer);
+  }
+}
+
+static bool Walkable(NavGrid *grid, Vector3 p) {
+  int cx, cy;
+  if (!NavGrid_WorldToCell(grid, p, &cx, &cy))
+    return false;
+  NavCellType t = grid->cells[NavGrid_Index(grid, cx, cy)].type;
+  return t != NAV_CELL_WALL && t != NAV_CELL_BLOCKED && t != NAV_CELL_FENCE;
+}
+
+// Separates all ground enemies (grunt, ranger, melee) from each other.
+// Runs after the AI state machines so the push is applied on top of the
+// movement they chose this tick.
+void CrowdSystem(world_t *world, GameWorld *game, float dt) {
+  CrowdGrid *crowd = &game->crowd;
+  if (!crowd->cellStart)
+    return;
+
+  CrowdGrid_Clear(crowd);
+  AddArchetypeAgents(world, crowd,
+                     WorldGetArchetype(world, game->enemyGruntArchId), 1.0f);
+  AddArchetypeAgents(world, crowd,
+                     WorldGetArchetype(world, game->enemyRangerArchId), 1.0f);
+  AddArchetypeAgents(world, crowd,
+                     WorldGetArchetype(world, game->enemyMeleeArchId), 1.0f);
+  CrowdGrid_Build(crowd);
+
+  CrowdGrid_ComputeSeparation(crowd, CROWD_SEP_STRENGTH);
+
+  for (int i = 0; i < crowd->agentCount; i++) {
+    Vector3 push = crowd->steering[i];
+    if (push.x == 0.0f && push.z == 0.0f)
+      continue;
+
+    Position *pos =
+        ECS_GET(world, crowd->agents[i].entity, Position, COMP_POSITION);
+    Vector3 next = {pos->value.x + push.x * dt, pos->value.y,
+                    pos->value.z + push.z * dt};
+
+    // Never shove an agent into geometry the pathfinder routes around
+    if (Walkable(&game->navGrid, next))
+      pos->value = next;
+  }
+}
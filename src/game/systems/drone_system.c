@@ -12,15 +12,24 @@
 #define DRONE_BOB_FREQ           1.2f
 #define DRONE_BOB_AMP            0.25f
 
+// Enemy layer also holds drones and target dummies; only these get shields
+static bool IsShieldableAlly(world_t *world, entity_t e, void *ctx) {
+  const GameWorld *game = ctx;
+  archetype_t     *arch = WorldGetEntityArchetype(world, e);
+  if (arch != WorldGetArchetype(world, game->enemyGruntArchId) &&
+      arch != WorldGetArchetype(world, game->enemyRangerArchId) &&
+      arch != WorldGetArchetype(world, game->enemyMeleeArchId))
+    return false;
+  Active *active = ECS_GET(world, e, Active, COMP_ACTIVE);
+  return active && active->value;
+}
+
 void EnemyDroneAISystem(world_t *world, GameWorld *game,
                          archetype_t *arch, float dt) {
-  if (!arch) return;
+  Position *playerPos = ECS_GET(world, game->player, Position, COMP_POSITION);
+  if (!arch || !playerPos) return;
 
-  uint32_t allyArchIds[] = {
-    game->enemyGruntArchId,
-    game->enemyRangerArchId,
-    game->enemyMeleeArchId,
-  };
+  const float *ground = SampleArchetypeGround(world, game, arch);
 
   for (uint32_t i = 0; i < arch->count; i++) {
     entity_t e = arch->entities[i];
@@ -33,8 +42,15 @@ void EnemyDroneAISystem(world_t *world, GameWorld *game,
     DroneEnemy  *dr  = ECS_GET(world, e, DroneEnemy,  COMP_DRONE_ENEMY);
     if (!pos || !vel || !ori || !dr) continue;
 
-    dr->bobTimer       += dt;
-    dr->retargetTimer  -= dt;
+    // Drones away from the fight retarget and regen on fewer, longer steps;
+    // hovering runs every tick so their motion stays smooth
+    float stepDt = 0.0f;
+    int   lod = AiScheduler_Bucket(pos->value, playerPos->value,
+                                   NavVisibility_Test(&game->playerVis, pos->value),
+                                   false, !dr->hasTarget);
+    bool  due = AiScheduler_Due(&game->aiScheduler, e, lod, dt, &stepDt);
+
+    dr->bobTimer += dt;
 
     // Validate existing target
     bool targetValid = false;
@@ -43,44 +59,36 @@ void EnemyDroneAISystem(world_t *world, GameWorld *game,
       targetValid = (ta && ta->value);
     }
 
-    // Scan for a new target when needed
-    if (!targetValid || dr->retargetTimer <= 0.0f) {
-      float    bestDist = 1e9f;
-      entity_t bestEnt  = {0};
-      bool     found    = false;
-
-      for (int ai = 0; ai < 3; ai++) {
-        archetype_t *allyArch = WorldGetArchetype(world, allyArchIds[ai]);
-        if (!allyArch) continue;
-        for (uint32_t j = 0; j < allyArch->count; j++) {
-          entity_t ally = allyArch->entities[j];
-          Active *aa = ECS_GET(world, ally, Active, COMP_ACTIVE);
-          if (!aa || !aa->value) continue;
-          Position *ap = ECS_GET(world, ally, Position, COMP_POSITION);
-          if (!ap) continue;
-          float dx = ap->value.x - pos->value.x;
-          float dz = ap->value.z - pos->value.z;
-          float dist = sqrtf(dx*dx + dz*dz);
-          if (dist < bestDist) { bestDist = dist; bestEnt = ally; found = true; }
-        }
+    // Pick the nearest shieldable ally when needed
+    if (due) {
+      dr->retargetTimer -= stepDt;
+      if (!targetValid || dr->retargetTimer <= 0.0f) {
+        entity_t bestEnt = {0};
+        bool     found   = WorldQueryKNearestFiltered(
+                             world, pos->value, 2.0f * game->arenaRadius,
+                             1u << LAYER_ENEMY, IsShieldableAlly, game,
+                             &bestEnt, 1) == 1;
+
+        dr->hasTarget     = found;
+        dr->target        = found ? bestEnt : (entity_t){0};
+        dr->retargetTimer = 3.0f;
+        targetValid       = found;
       }
-
-      dr->hasTarget     = found;
-      dr->target        = found ? bestEnt : (entity_t){0};
-      dr->retargetTimer = 3.0f;
-      targetValid       = found;
     }
 
-    float terrainY = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                                    pos->value.x, pos->value.z);
+    float terrainY = ground ? ground[i]
+                            : TerrainHeight(game, pos->value.x, pos->value.z);
     float bob      = sinf(dr->bobTimer * DRONE_BOB_FREQ) * DRONE_BOB_AMP;
     float desiredY = terrainY + DRONE_HOVER_HEIGHT + bob;
 
-    Vector3 desired = pos->value;  // default: hover in place
+    // Default: hover in place
+    Vector3   desired = {pos->value.x, desiredY, pos->value.z};
+    Position *tpos    = targetValid
+                            ? ECS_GET(world, dr->target, Position, COMP_POSITION)
+                            : NULL;
+    if (targetValid && !tpos) dr->hasTarget = false;
 
-    if (targetValid) {
-      Position *tpos = ECS_GET(world, dr->target, Position, COMP_POSITION);
-      if (!tpos) { dr->hasTarget = false; goto move; }
+    if (tpos) {
       desired = (Vector3){tpos->value.x, desiredY, tpos->value.z};
 
       // Face the ally
@@ -95,21 +103,18 @@ void EnemyDroneAISystem(world_t *world, GameWorld *game,
       }
 
       // Regen ally shield when close (works even if enemy has no innate shield)
-      float xzDist = sqrtf((tpos->value.x - pos->value.x)*(tpos->value.x - pos->value.x) +
-                           (tpos->value.z - pos->value.z)*(tpos->value.z - pos->value.z));
-      if (xzDist < DRONE_REGEN_RADIUS) {
+      float xzDist = sqrtf(dx * dx + dz * dz);
+      if (due && xzDist < DRONE_REGEN_RADIUS) {
         Shield *sh = ECS_GET(world, dr->target, Shield, COMP_SHIELD);
         if (sh) {
           float cap = sh->max > 0.0f ? sh->max : DRONE_BONUS_SHIELD_MAX;
-          sh->current += DRONE_REGEN_RATE * dt;
+          sh->current += DRONE_REGEN_RATE * stepDt;
           if (sh->current > cap) sh->current = cap;
         }
       }
-    } else {
-      desired.y = desiredY;
     }
+    AiScheduler_Close(&game->aiScheduler); // time decisions, not the hover
 
-move:;
     // Spring toward desired position, with drag
     Vector3 toDesired = Vector3Subtract(desired, pos->value);
     vel->value = Vector3Add(vel->value, Vector3Scale(toDesired, DRONE_SPRING * dt));
@@ -120,4 +125,5 @@ move:;
     // Never clip below terrain
     if (pos->value.y < terrainY + 0.5f) pos->value.y = terrainY + 0.5f;
   }
+  AiScheduler_Close(&game->aiScheduler);
 }
@@ -2,74 +2,102 @@
 #include "enemy_behaviour.h"
 #include "systems.h"
 #include <math.h>
+#include <string.h>
 
 /* ------------------------------------------------------------------ */
-/*  Path request queue                                                 */
-/*  Spreads A* calls across frames to avoid wave-start spikes.        */
+/*  Path requests                                                      */
+/*  Searched by the path service's worker pool; results are applied   */
+/*  here on the main thread, looked up by entity so component storage  */
+/*  may move while a search is in flight.                              */
 /* ------------------------------------------------------------------ */
 
-#define PATH_QUEUE_CAP 64
-
-typedef struct {
-  NavGrid       *grid;
-  Vector3        start;
-  Vector3        goal;
-  NavPath       *outPath;
-  bool          *pendingFlag;
-  CombatState_t *combat;
-  entity_t       owner;
-} PathRequest;
+static bool *PathPendingFlag(world_t *world, entity_t e) {
+  CombatState_t *combat = ECS_GET(world, e, CombatState_t, COMP_COMBAT_STATE);
+  if (combat) return &combat->pathPending;
+  MeleeEnemy *me = ECS_GET(world, e, MeleeEnemy, COMP_MELEE_ENEMY);
+  return me ? &me->pathPending : NULL;
+}
 
-static PathRequest s_pathQueue[PATH_QUEUE_CAP];
-static int         s_pathHead  = 0;
-static int         s_pathTail  = 0;
-static int         s_pathCount = 0;
+float EnemyNavRadius(world_t *world, entity_t e) {
+  CapsuleCollider *cap = ECS_GET(world, e, CapsuleCollider, COMP_CAPSULE_COLLIDER);
+  return cap ? cap->radius : 0.0f;
+}
 
 bool EnemyPathQueue_Submit(NavGrid *grid, Vector3 start, Vector3 goal,
-                           NavPath *outPath, bool *pendingFlag,
-                           CombatState_t *combat, entity_t owner) {
-  if (s_pathCount >= PATH_QUEUE_CAP) return false;
-
-  s_pathQueue[s_pathTail] = (PathRequest){
-      .grid        = grid,
-      .start       = start,
-      .goal        = goal,
-      .outPath     = outPath,
-      .pendingFlag = pendingFlag,
-      .combat      = combat,
-      .owner       = owner,
-  };
-  s_pathTail = (s_pathTail + 1) % PATH_QUEUE_CAP;
-  s_pathCount++;
+                           float radius, bool *pendingFlag, entity_t owner,
+                           PathPriority priority) {
+  if (!PathService_Submit(grid, start, goal, radius, owner.id,
+                          owner.generation, priority))
+    return false;
   *pendingFlag = true;
   return true;
 }
 
-void EnemyPathQueue_Reset(void) {
-  s_pathHead  = 0;
-  s_pathTail  = 0;
-  s_pathCount = 0;
+void EnemyPathQueue_Reset(void) { PathService_CancelAll(); }
+
+static void ApplyPathResult(const PathResult *result, void *user) {
+  world_t *world = user;
+  entity_t owner = {result->ownerId, result->ownerGeneration, 0};
+
+  // Skip if the requesting entity died since the request was submitted
+  if (!EntityIsAlive(&world->entityManager, owner)) return;
+
+  NavPath *path = ECS_GET(world, owner, NavPath, COMP_NAVPATH);
+  if (path) {
+    NavPath_Assign(path, result->points, result->count);
+    path->revision = result->revision;
+  }
+
+  bool *pending = PathPendingFlag(world, owner);
+  if (pending) *pending = false;
 }
 
 void EnemyPathQueue_Flush(world_t *world, int maxPerFrame) {
-  int processed = 0;
-  while (s_pathCount > 0 && processed < maxPerFrame) {
-    PathRequest *req = &s_pathQueue[s_pathHead];
-    s_pathHead = (s_pathHead + 1) % PATH_QUEUE_CAP;
-    s_pathCount--;
-    processed++;
-
-    // Skip if the requesting entity died since the request was submitted
-    if (!EntityIsAlive(&world->entityManager, req->owner)) {
-      *req->pendingFlag = false;
-      continue;
-    }
+  PathService_Drain(ApplyPathResult, world, maxPerFrame);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Batched ground sampling                                           */
+/* ------------------------------------------------------------------ */
 
-    bool ok = NavGrid_FindPath(req->grid, req->start, req->goal, req->outPath);
-    *req->pendingFlag = false;
-    if (ok && req->combat)
-      req->combat->state = ENEMY_STATE_MOVING;
+static bool GrowSamples(float **buf, uint32_t cap) {
+  float *grown = realloc(*buf, sizeof(float) * cap);
+  if (!grown) return false;
+  *buf = grown;
+  return true;
+}
+
+// Terrain height under every entity of the archetype, indexed like
+// arch->entities. Valid until the next call; NULL if the scratch buffers
+// could not grow, in which case callers sample per entity.
+const float *SampleArchetypeGround(world_t *world, GameWorld *game,
+                                   archetype_t *arch) {
+  GroundSamples *gs = &game->groundSamples;
+  if (arch->count > gs->capacity) {
+    uint32_t cap = gs->capacity ? gs->capacity : 64;
+    while (cap < arch->count) cap *= 2;
+    if (!GrowSamples(&gs->x, cap) || !GrowSamples(&gs->z, cap) ||
+        !GrowSamples(&gs->y, cap))
+      return NULL;
+    gs->capacity = cap;
   }
+
+  for (uint32_t i = 0; i < arch->count; i++) {
+    Position *pos = ECS_GET(world, arch->entities[i], Position, COMP_POSITION);
+    gs->x[i] = pos ? pos->value.x : 0.0f;
+    gs->z[i] = pos ? pos->value.z : 0.0f;
+  }
+
+  TerrainHeightBatch(game, gs->x, gs->z, gs->y, (int)arch->count);
+  return gs->y;
+}
+
+void GroundSamples_Free(GameWorld *game) {
+  GroundSamples *gs = &game->groundSamples;
+  free(gs->x);
+  free(gs->z);
+  free(gs->y);
+  *gs = (GroundSamples){0};
 }
 
 /* ------------------------------------------------------------------ */
@@ -86,13 +114,39 @@ static float PathRemainingLength(NavPath *path, Position *pos) {
   Vector3 posXZ = {pos->value.x, 0.0f, pos->value.z};
   Vector3 wpXZ  = {path->points[path->currentIndex].x, 0.0f,
                    path->points[path->currentIndex].z};
-  float total = Vector3Distance(posXZ, wpXZ);
-  for (int i = path->currentIndex; i < path->count - 1; i++) {
-    Vector3 a = {path->points[i].x,   0.0f, path->points[i].z};
-    Vector3 b = {path->points[i+1].x, 0.0f, path->points[i+1].z};
-    total += Vector3Distance(a, b);
+  return Vector3Distance(posXZ, wpXZ) + path->remaining[path->currentIndex];
+}
+
+// Turns toward dir at rotateSpeed and moves along it once roughly facing,
+// accelerating from rest up to targetSpeed.
+static void SteerToward(Velocity *vel, Orientation *ori, Vector3 dir,
+                        float targetSpeed, float maxSpeed, float rotateSpeed,
+                        float dt) {
+  float targetYaw = atan2f(dir.x, dir.z);
+  float delta     = targetYaw - ori->yaw;
+  while (delta >  PI) delta -= 2.0f * PI;
+  while (delta < -PI) delta += 2.0f * PI;
+
+  float maxStep = rotateSpeed * dt;
+  if (fabsf(delta) <= maxStep)
+    ori->yaw = targetYaw;
+  else
+    ori->yaw += (delta > 0.0f ? 1.0f : -1.0f) * maxStep;
+
+  float curSpeedSq = vel->value.x * vel->value.x + vel->value.z * vel->value.z;
+  float curSpeed   = sqrtf(curSpeedSq);
+  float accelRate  = maxSpeed / 0.5f; // reach full speed in ~0.5s
+  float newSpeed   = (curSpeed < targetSpeed)
+                         ? fminf(curSpeed + accelRate * dt, targetSpeed)
+                         : targetSpeed;
+
+  if (fabsf(delta) < FACE_THRESHOLD) {
+    vel->value.x = dir.x * newSpeed;
+    vel->value.z = dir.z * newSpeed;
+  } else {
+    vel->value.x = 0.0f;
+    vel->value.z = 0.0f;
   }
-  return total;
 }
 
 // Returns true when the entity has fully arrived at the end of its path.
@@ -120,8 +174,7 @@ bool EnemyFollowPath(world_t *world, GameWorld *game, entity_t e,
   }
 
   // Snap to terrain
-  pos->value.y = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                               pos->value.x, pos->value.z);
+  pos->value.y = TerrainHeight(game, pos->value.x, pos->value.z);
 
   Vector3 target   = path->points[path->currentIndex];
   Vector3 toTarget = Vector3Subtract(target, pos->value);
@@ -140,122 +193,122 @@ bool EnemyFollowPath(world_t *world, GameWorld *game, entity_t e,
     return false;
   }
 
-  // Rotate body toward current waypoint
-  Vector3 dir      = Vector3Normalize(toTarget);
-  float targetYaw  = atan2f(dir.x, dir.z);
-  float delta      = targetYaw - ori->yaw;
-  while (delta >  PI) delta -= 2.0f * PI;
-  while (delta < -PI) delta += 2.0f * PI;
-
-  float maxStep = rotateSpeed * dt;
-  if (fabsf(delta) <= maxStep)
-    ori->yaw = targetYaw;
-  else
-    ori->yaw += (delta > 0.0f ? 1.0f : -1.0f) * maxStep;
-
   // Speed: decelerate approaching the final waypoint, accelerate from rest
   float remaining   = PathRemainingLength(path, pos);
   float speedFactor = (remaining < ENEMY_DECEL_DIST)
                           ? fmaxf(ENEMY_MIN_SPEED_FACTOR, remaining / ENEMY_DECEL_DIST)
                           : 1.0f;
-  float targetSpeed = maxSpeed * speedFactor;
 
-  float curSpeedSq = vel->value.x * vel->value.x + vel->value.z * vel->value.z;
-  float curSpeed   = sqrtf(curSpeedSq);
-  float accelRate  = maxSpeed / 0.5f; // reach full speed in ~0.5s
-  float newSpeed   = (curSpeed < targetSpeed)
-                         ? fminf(curSpeed + accelRate * dt, targetSpeed)
-                         : targetSpeed;
+  SteerToward(vel, ori, Vector3Normalize(toTarget), maxSpeed * speedFactor,
+              maxSpeed, rotateSpeed, dt);
+  return false;
+}
 
-  if (fabsf(delta) < FACE_THRESHOLD) {
-    vel->value.x = dir.x * newSpeed;
-    vel->value.z = dir.z * newSpeed;
-  } else {
-    vel->value.x = 0.0f;
-    vel->value.z = 0.0f;
-  }
+bool EnemyFollowFlow(world_t *world, GameWorld *game, entity_t e,
+                     float maxSpeed, float rotateSpeed, float dt) {
+  Position    *pos = ECS_GET(world, e, Position,    COMP_POSITION);
+  Velocity    *vel = ECS_GET(world, e, Velocity,    COMP_VELOCITY);
+  Orientation *ori = ECS_GET(world, e, Orientation, COMP_ORIENTATION);
+  if (!pos || !vel || !ori) return false;
 
-  return false;
+  Vector3 dir;
+  if (!FlowField_Direction(&game->playerFlow, &game->navGrid, pos->value, &dir))
+    return false;
+
+  SteerToward(vel, ori, dir, maxSpeed, maxSpeed, rotateSpeed, dt);
+  return true;
 }
 
 /* ------------------------------------------------------------------ */
-/*  Claim table — soft spread-out (enemies avoid each other's spots)  */
+/*  Player flow field                                                 */
 /* ------------------------------------------------------------------ */
 
-#define CLAIM_CAP 64
-typedef struct { entity_t entity; int cx, cy; } Claim;
-static Claim s_claims[CLAIM_CAP];
-static int   s_claimCount = 0;
+void PlayerFlowFieldSystem(world_t *world, GameWorld *game) {
+  if (!game->playerFlow.ready.cost) return;
 
-static void ClaimPurgeDeadEntities(world_t *world) {
-  int i = 0;
-  while (i < s_claimCount) {
-    Active *a = ECS_GET(world, s_claims[i].entity, Active, COMP_ACTIVE);
-    if (!a || !a->value) { s_claims[i] = s_claims[--s_claimCount]; }
-    else                 { i++; }
+  Position *playerPos = ECS_GET(world, game->player, Position, COMP_POSITION);
+  if (!playerPos) return;
+
+  // Same clamp melee uses for its A* goal, so the goal cell stays on the grid
+  Vector3 goal = playerPos->value;
+  float   r    = sqrtf(goal.x * goal.x + goal.z * goal.z);
+  if (r > game->arenaRadius) {
+    float s = game->arenaRadius / r;
+    goal.x *= s;
+    goal.z *= s;
   }
-}
 
-static void ClaimRelease(uint32_t id) {
-  for (int i = 0; i < s_claimCount; i++) {
-    if (s_claims[i].entity.id == id) { s_claims[i] = s_claims[--s_claimCount]; return; }
+  // Melee chasers are the ones steering by this field, so keep it out of
+  // gaps their capsule can't fit through
+  archetype_t *melee = WorldGetArchetype(world, game->enemyMeleeArchId);
+  if (melee && melee->count > 0 && game->navGrid.clearance) {
+    float extra = EnemyNavRadius(world, melee->entities[0]) -
+                  game->navGrid.bakedRadius;
+    FlowField_SetClearance(
+        &game->playerFlow, &game->navGrid,
+        extra > 0.0f ? NavClearance_Required(game->navGrid.clearance, extra)
+                     : 0);
   }
+
+  FlowField_SetGoal(&game->playerFlow, &game->navGrid, goal);
+  FlowField_Step(&game->playerFlow, &game->navGrid, PLAYER_FLOW_BUDGET);
 }
 
-static void ClaimAcquire(entity_t e, int cx, int cy) {
-  ClaimRelease(e.id);
-  if (s_claimCount < CLAIM_CAP)
-    s_claims[s_claimCount++] = (Claim){e, cx, cy};
+/* ------------------------------------------------------------------ */
+/*  Player visibility                                                 */
+/* ------------------------------------------------------------------ */
+
+void PlayerVisibilitySystem(world_t *world, GameWorld *game) {
+  if (!game->playerVis.grid) return;
+  Position *playerPos = ECS_GET(world, game->player, Position, COMP_POSITION);
+  if (!playerPos) return;
+  NavVisibility_Update(&game->playerVis, playerPos->value);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Claim table — soft spread-out (enemies avoid each other's spots)  */
+/* ------------------------------------------------------------------ */
+
+/* Claims live in game->navClaims; each is also stamped into the tactical
+   map's ally layer, so the two are only changed together here */
+
+static void ClaimRelease(GameWorld *game, entity_t e) {
+  NavOccupancy *occ = &game->navClaims;
+  if (e.id >= occ->capacity || occ->claims[e.id].cell < 0) return;
+  int cell = occ->claims[e.id].cell;
+  TacticalMap_AddAlly(&game->tactical, cell % occ->grid->width,
+                      cell / occ->grid->width, -1);
+  NavOccupancy_Release(occ, e.id);
 }
 
-static float ClaimNearestDist(uint32_t selfId, int cx, int cy) {
-  float minD = 9999.0f;
-  for (int i = 0; i < s_claimCount; i++) {
-    if (s_claims[i].entity.id == selfId) continue;
-    float dx = (float)(s_claims[i].cx - cx);
-    float dy = (float)(s_claims[i].cy - cy);
-    float d = sqrtf(dx*dx + dy*dy);
-    if (d < minD) minD = d;
+static void ClaimPurgeDeadEntities(world_t *world, GameWorld *game) {
+  NavOccupancy *occ = &game->navClaims;
+  uint32_t i = 0;
+  while (i < occ->count) {
+    uint32_t id = occ->holders[i];
+    entity_t e  = {id, occ->claims[id].generation, 0};
+    Active  *a  = EntityIsAlive(&world->entityManager, e)
+                    ? ECS_GET(world, e, Active, COMP_ACTIVE) : NULL;
+    if (!a || !a->value) { ClaimRelease(game, e); } /* swaps in the last holder */
+    else                 { i++; }
   }
-  return minD;
+}
+
+static void ClaimAcquire(GameWorld *game, entity_t e, int cx, int cy) {
+  if (!game->navClaims.grid) return;
+  ClaimRelease(game, e);
+  NavOccupancy_Acquire(&game->navClaims, e.id, e.generation, cx, cy);
+  TacticalMap_AddAlly(&game->tactical, cx, cy, +1);
 }
 
 /* ------------------------------------------------------------------ */
-/*  Position scoring                                                   */
+/*  Tactical map                                                       */
 /* ------------------------------------------------------------------ */
 
-static float ScorePosition(NavGrid *grid, int cx, int cy,
-                            float distToPlayer, float selfDistToPlayer,
-                            float minDist, float maxDist,
-                            uint32_t selfId, bool isRanger) {
-  NavCellType type = grid->cells[NavGrid_Index(grid, cx, cy)].type;
-  if (type == NAV_CELL_WALL || type == NAV_CELL_BLOCKED ||
-      type == NAV_CELL_FENCE) return -9999.0f;
-
-  /* Hard exclusion: refuse any cell that overlaps another claim */
-  float nearDist = ClaimNearestDist(selfId, cx, cy);
-  if (nearDist < 3.5f) return -9999.0f;
-
-  float score = 0.0f;
-  if (!isRanger) {
-    if (type == NAV_CELL_COVER_LOW)  score += 35.0f;
-    if (type == NAV_CELL_COVER_HIGH) score += 25.0f;
-    if (type == NAV_CELL_FLANK)      score += 30.0f;
-    if (type == NAV_CELL_SNIPE)      score +=  5.0f;
-  } else {
-    if (type == NAV_CELL_SNIPE)      score += 50.0f;
-    if (type == NAV_CELL_COVER_HIGH) score += 10.0f;
-    if (type == NAV_CELL_COVER_LOW)  score +=  5.0f;
-    if (type == NAV_CELL_FLANK)      score -= 10.0f;
-  }
-  /* Combat range bonus */
-  if (distToPlayer >= minDist && distToPlayer <= maxDist) score += 20.0f;
-  /* Soft spread bonus */
-  if (nearDist > 8.0f) score += 10.0f;
-  if (nearDist < 6.0f) score -= 15.0f;
-  /* Drift: reward positions that bring us a bit closer to the player */
-  if (distToPlayer < selfDistToPlayer - 5.0f) score += 15.0f;
-  return score;
+void TacticalMapSystem(world_t *world, GameWorld *game) {
+  (void)world;
+  if (!game->tactical.grid || !game->playerVis.grid) return;
+  TacticalMap_Update(&game->tactical, &game->playerVis);
 }
 
 /* ------------------------------------------------------------------ */
@@ -264,47 +317,34 @@ static float ScorePosition(NavGrid *grid, int cx, int cy,
 
 static bool SelectTacticalPosition(world_t *world, GameWorld *game,
                                     Vector3 from, Vector3 playerPos,
-                                    float minDist, float maxDist,
-                                    float maxMoveRadius,
-                                    uint32_t selfId, bool isRanger,
+                                    entity_t self, bool isRanger,
                                     Vector3 *outPos) {
-  NavGrid *grid = &game->navGrid;
-  /* Search centered on THIS ENEMY so moves are local — prevents cross-map walks */
-  int eCX, eCY;
-  if (!NavGrid_WorldToCell(grid, from, &eCX, &eCY)) return false;
+  NavGrid     *grid = &game->navGrid;
+  TacticalMap *map  = &game->tactical;
+  TacticalRole role = isRanger ? TACTICAL_RANGER : TACTICAL_GRUNT;
+  float maxMoveRadius = isRanger ? RANGER_MAX_MOVE_RADIUS : GRUNT_MAX_MOVE_RADIUS;
+  if (!map->grid) return false;
 
   float selfDistToPlayer = sqrtf((from.x-playerPos.x)*(from.x-playerPos.x) +
                                   (from.z-playerPos.z)*(from.z-playerPos.z));
-  int searchR = (int)(maxMoveRadius / grid->cellSize) + 1;
-  if (searchR > TACTICAL_SEARCH_RADIUS) searchR = TACTICAL_SEARCH_RADIUS;
+
+  /* Our own claim must not crowd us out of the spot we're standing on */
+  int selfX, selfY;
+  if (!NavOccupancy_Get(&game->navClaims, self.id, self.generation, &selfX,
+                        &selfY))
+    selfX = selfY = -1;
 
   float bestScore = -9998.0f;
   Vector3 bestPos = {0};
   bool found = false;
 
-  for (int dy = -searchR; dy <= searchR; dy++) {
-    for (int dx = -searchR; dx <= searchR; dx++) {
-      int cx = eCX + dx, cy = eCY + dy;
-      if (!NavGrid_InBounds(grid, cx, cy)) continue;
-
-      Vector3 cPos = NavGrid_CellCenter(grid, cx, cy);
-      /* Limit to move radius (circular) */
-      float moveDist = sqrtf((cPos.x-from.x)*(cPos.x-from.x)+(cPos.z-from.z)*(cPos.z-from.z));
-      if (moveDist > maxMoveRadius) continue;
-      /* Arena bounds */
-      if (sqrtf(cPos.x*cPos.x + cPos.z*cPos.z) > game->arenaRadius) continue;
-
-      float dist = sqrtf((cPos.x-playerPos.x)*(cPos.x-playerPos.x) +
-                         (cPos.z-playerPos.z)*(cPos.z-playerPos.z));
-      float score = ScorePosition(grid, cx, cy, dist, selfDistToPlayer,
-                                   minDist, maxDist, selfId, isRanger);
-      if (score > bestScore) {
-        bestScore = score;
-        cPos.y = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap, cPos.x, cPos.z);
-        bestPos = cPos;
-        found = true;
-      }
-    }
+  /* Search centered on THIS ENEMY so moves are local — prevents cross-map walks */
+  int bx, by;
+  if (TacticalMap_BestTactical(map, role, from, maxMoveRadius, selfDistToPlayer,
+                               selfX, selfY, &bx, &by)) {
+    bestPos   = NavGrid_CellCenter(grid, bx, by);
+    bestPos.y = TerrainHeight(game, bestPos.x, bestPos.z);
+    found     = true;
   }
 
   /* Fallback: random candidates near THIS ENEMY */
@@ -314,15 +354,14 @@ static bool SelectTacticalPosition(world_t *world, GameWorld *game,
       float radius = (float)GetRandomValue(5, (int)maxMoveRadius);
       Vector3 cand = {from.x + cosf(angle)*radius, 0.0f, from.z + sinf(angle)*radius};
       if (sqrtf(cand.x*cand.x + cand.z*cand.z) > game->arenaRadius) continue;
-      cand.y = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap, cand.x, cand.z);
       int cx, cy;
       if (!NavGrid_WorldToCell(grid, cand, &cx, &cy)) continue;
-      float dist  = sqrtf((cand.x-playerPos.x)*(cand.x-playerPos.x) +
-                          (cand.z-playerPos.z)*(cand.z-playerPos.z));
-      float score = ScorePosition(grid, cx, cy, dist, selfDistToPlayer,
-                                   minDist, maxDist, selfId, isRanger);
+      float score = TacticalMap_Score(map, role, cx, cy, selfDistToPlayer,
+                                      selfX, selfY);
       if (score > bestScore) { bestScore = score; bestPos = cand; found = true; }
     }
+    if (found)
+      bestPos.y = TerrainHeight(game, bestPos.x, bestPos.z);
   }
 
   if (found) *outPos = bestPos;
@@ -333,55 +372,23 @@ static bool SelectRetreatPosition(world_t *world, GameWorld *game,
                                    Vector3 from, Vector3 playerPos,
                                    bool isRanger, Vector3 *outPos) {
   NavGrid *grid = &game->navGrid;
-  /* Search centered on THIS ENEMY — retreat is relative to where we are */
-  int eCX, eCY;
-  if (!NavGrid_WorldToCell(grid, from, &eCX, &eCY)) return false;
+  if (!game->tactical.grid) return false;
 
   float selfDist   = sqrtf((from.x-playerPos.x)*(from.x-playerPos.x)+
                             (from.z-playerPos.z)*(from.z-playerPos.z));
   float maxMoveR   = isRanger ? RANGER_MAX_MOVE_RADIUS : GRUNT_MAX_MOVE_RADIUS;
-  int   searchR    = (int)(maxMoveR / grid->cellSize) + 1;
-  if (searchR > TACTICAL_SEARCH_RADIUS) searchR = TACTICAL_SEARCH_RADIUS;
 
-  float bestScore = -9999.0f;
   Vector3 bestPos = {0};
   bool found = false;
 
-  for (int dy = -searchR; dy <= searchR; dy++) {
-    for (int dx = -searchR; dx <= searchR; dx++) {
-      int cx = eCX + dx, cy = eCY + dy;
-      if (!NavGrid_InBounds(grid, cx, cy)) continue;
-      NavCellType t = grid->cells[NavGrid_Index(grid, cx, cy)].type;
-      if (t == NAV_CELL_WALL || t == NAV_CELL_BLOCKED || t == NAV_CELL_FENCE) continue;
-
-      Vector3 cPos = NavGrid_CellCenter(grid, cx, cy);
-      if (sqrtf(cPos.x*cPos.x + cPos.z*cPos.z) > game->arenaRadius) continue;
-
-      /* Within move radius */
-      float moveDist = sqrtf((cPos.x-from.x)*(cPos.x-from.x)+(cPos.z-from.z)*(cPos.z-from.z));
-      if (moveDist > maxMoveR) continue;
-
-      float dist = sqrtf((cPos.x-playerPos.x)*(cPos.x-playerPos.x)+
-                         (cPos.z-playerPos.z)*(cPos.z-playerPos.z));
-      if (dist < selfDist - 2.0f) continue; /* must move away from player */
-
-      float score = 0.0f;
-      if (!isRanger) {
-        if (t == NAV_CELL_COVER_HIGH) score += 60.0f;
-        else if (t == NAV_CELL_COVER_LOW) score += 30.0f;
-      } else {
-        if (t == NAV_CELL_SNIPE)      score += 50.0f;
-      }
-      score += (dist - selfDist) * 0.8f;
-      if (ClaimNearestDist(0xFFFFFFFFu, cx, cy) < 3.5f) score -= 30.0f;
-
-      if (score > bestScore) {
-        bestScore = score;
-        cPos.y = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap, cPos.x, cPos.z);
-        bestPos = cPos;
-        found = true;
-      }
-    }
+  /* Search centered on THIS ENEMY — retreat is relative to where we are */
+  int bx, by;
+  if (TacticalMap_BestRetreat(&game->tactical,
+                              isRanger ? TACTICAL_RANGER : TACTICAL_GRUNT, from,
+                              maxMoveR, selfDist, &bx, &by)) {
+    bestPos   = NavGrid_CellCenter(grid, bx, by);
+    bestPos.y = TerrainHeight(game, bestPos.x, bestPos.z);
+    found     = true;
   }
 
   if (!found) {
@@ -390,6 +397,9 @@ static bool SelectRetreatPosition(world_t *world, GameWorld *game,
     float len  = sqrtf(fdx*fdx + fdz*fdz);
     if (len < 0.001f) return false;
     fdx /= len; fdz /= len;
+    /* Prefer a step that doesn't land on someone else's claim */
+    Vector3 crowded = {0};
+    bool    haveCrowded = false;
     for (float step = maxMoveR; step >= 5.0f; step -= 5.0f) {
       Vector3 cand = {from.x + fdx*step, 0.0f, from.z + fdz*step};
       float flatR  = sqrtf(cand.x*cand.x + cand.z*cand.z);
@@ -397,13 +407,19 @@ static bool SelectRetreatPosition(world_t *world, GameWorld *game,
         float s = game->arenaRadius * 0.97f / flatR;
         cand.x *= s; cand.z *= s;
       }
-      cand.y = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap, cand.x, cand.z);
+      cand.y = TerrainHeight(game, cand.x, cand.z);
       int cx2, cy2;
       if (!NavGrid_WorldToCell(grid, cand, &cx2, &cy2)) continue;
       NavCellType t2 = grid->cells[NavGrid_Index(grid, cx2, cy2)].type;
       if (t2 == NAV_CELL_WALL || t2 == NAV_CELL_BLOCKED || t2 == NAV_CELL_FENCE) continue;
+      if (game->navClaims.grid &&
+          NavOccupancy_Nearest(&game->navClaims, cx2, cy2, 3, 0xFFFFFFFFu) >= 0) {
+        if (!haveCrowded) { crowded = cand; haveCrowded = true; }
+        continue;
+      }
       bestPos = cand; found = true; break;
     }
+    if (!found && haveCrowded) { bestPos = crowded; found = true; }
   }
 
   if (found) *outPos = bestPos;
@@ -418,7 +434,7 @@ static void ArriveAtPosition(world_t *world, GameWorld *game, entity_t e,
   NavCellType type = NAV_CELL_EMPTY;
   if (NavGrid_WorldToCell(&game->navGrid, pos->value, &cx, &cy)) {
     type = game->navGrid.cells[NavGrid_Index(&game->navGrid, cx, cy)].type;
-    ClaimAcquire(e, cx, cy);
+    ClaimAcquire(game, e, cx, cy);
     combat->claimedCX = (int16_t)cx;
     combat->claimedCY = (int16_t)cy;
   }
@@ -438,7 +454,7 @@ void EnemyGruntAISystem(world_t *world, GameWorld *game,
   Position *playerPos = ECS_GET(world, game->player, Position, COMP_POSITION);
   if (!playerPos) return;
 
-  ClaimPurgeDeadEntities(world);
+  ClaimPurgeDeadEntities(world, game);
 
   for (uint32_t i = 0; i < enemyArch->count; i++) {
     entity_t e = enemyArch->entities[i];
@@ -452,14 +468,22 @@ void EnemyGruntAISystem(world_t *world, GameWorld *game,
     Health        *health = ECS_GET(world, e, Health,        COMP_HEALTH);
     if (!pos || !path || !combat) continue;
 
+    /* Far or idle enemies think less often and catch up on the time missed */
+    float stepDt;
+    int   lod = AiScheduler_Bucket(pos->value, playerPos->value, combat->hasLOS,
+                                   combat->state == ENEMY_AI_RETREAT,
+                                   combat->state == ENEMY_AI_COVER ||
+                                   combat->state == ENEMY_AI_SUPPRESS);
+    if (!AiScheduler_Due(&game->aiScheduler, e, lod, dt, &stepDt)) continue;
+
     /* Tick timers */
-    if (combat->settleTimer > 0.0f)    combat->settleTimer    -= dt;
-    combat->repositionTimer            -= dt;
-    combat->losCheckTimer              -= dt;
+    if (combat->settleTimer > 0.0f)    combat->settleTimer    -= stepDt;
+    combat->repositionTimer            -= stepDt;
+    combat->losCheckTimer              -= stepDt;
 
     /* LOS check (throttled) */
     if (combat->losCheckTimer <= 0.0f) {
-      combat->hasLOS       = NavGrid_HasLOS(&game->navGrid, pos->value, playerPos->value);
+      combat->hasLOS       = NavVisibility_Test(&game->playerVis, pos->value);
       combat->losCheckTimer = GRUNT_LOS_CHECK_INTERVAL;
     }
 
@@ -476,21 +500,22 @@ void EnemyGruntAISystem(world_t *world, GameWorld *game,
     case ENEMY_AI_REPOSITION: {
       if (shouldRetreat && !combat->pathPending) {
         NavPath_Clear(path);
-        ClaimRelease(e.id);
+        ClaimRelease(game, e);
         Vector3 dest;
         if (SelectRetreatPosition(world, game, pos->value, playerPos->value, false, &dest))
-          EnemyPathQueue_Submit(&game->navGrid, pos->value, dest, path, &combat->pathPending, NULL, e);
+          EnemyPathQueue_Submit(&game->navGrid, pos->value, dest,
+                                EnemyNavRadius(world, e), &combat->pathPending,
+                                e, PATH_PRIORITY_HIGH);
         combat->state = ENEMY_AI_RETREAT;
         break;
       }
       if (combat->pathPending) {
-        pos->value.y = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                                     pos->value.x, pos->value.z);
+        pos->value.y = TerrainHeight(game, pos->value.x, pos->value.z);
         Velocity *vel = ECS_GET(world, e, Velocity, COMP_VELOCITY);
         if (vel) { vel->value.x = 0.0f; vel->value.z = 0.0f; }
         break;
       }
-      bool arrived = EnemyFollowPath(world, game, e, moveSpeeds[0], rotateSpeeds[0], dt);
+      bool arrived = EnemyFollowPath(world, game, e, moveSpeeds[0], rotateSpeeds[0], stepDt);
       if (arrived)
         ArriveAtPosition(world, game, e, pos, combat, GRUNT_REPOSITION_BASE, GRUNT_REPOSITION_JITTER);
       break;
@@ -501,10 +526,12 @@ void EnemyGruntAISystem(world_t *world, GameWorld *game,
     case ENEMY_AI_COVER: {
       if (shouldRetreat) {
         NavPath_Clear(path);
-        ClaimRelease(e.id);
+        ClaimRelease(game, e);
         Vector3 dest;
         if (SelectRetreatPosition(world, game, pos->value, playerPos->value, false, &dest))
-          EnemyPathQueue_Submit(&game->navGrid, pos->value, dest, path, &combat->pathPending, NULL, e);
+          EnemyPathQueue_Submit(&game->navGrid, pos->value, dest,
+                                EnemyNavRadius(world, e), &combat->pathPending,
+                                e, PATH_PRIORITY_HIGH);
         combat->state = ENEMY_AI_RETREAT;
         break;
       }
@@ -512,11 +539,13 @@ void EnemyGruntAISystem(world_t *world, GameWorld *game,
       if (!combat->hasLOS && combat->repositionTimer > GRUNT_LOS_REPOSITION)
         combat->repositionTimer = GRUNT_LOS_REPOSITION;
       if (combat->repositionTimer <= 0.0f && !combat->pathPending) {
-        ClaimRelease(e.id);
+        ClaimRelease(game, e);
         Vector3 dest;
         if (SelectTacticalPosition(world, game, pos->value, playerPos->value,
-                                   GRUNT_MIN_DIST, GRUNT_MAX_DIST, GRUNT_MAX_MOVE_RADIUS, e.id, false, &dest)) {
-          EnemyPathQueue_Submit(&game->navGrid, pos->value, dest, path, &combat->pathPending, NULL, e);
+                                   e, false, &dest)) {
+          EnemyPathQueue_Submit(&game->navGrid, pos->value, dest,
+                                EnemyNavRadius(world, e), &combat->pathPending,
+                                e, PATH_PRIORITY_NORMAL);
           combat->state = ENEMY_AI_REPOSITION;
         } else {
           combat->repositionTimer = GRUNT_REPOSITION_BASE;
@@ -527,8 +556,7 @@ void EnemyGruntAISystem(world_t *world, GameWorld *game,
 
     /* ---- Retreating to cover ---- */
     case ENEMY_AI_RETREAT: {
-      pos->value.y = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                                   pos->value.x, pos->value.z);
+      pos->value.y = TerrainHeight(game, pos->value.x, pos->value.z);
       if (combat->pathPending) {
         Velocity *vel = ECS_GET(world, e, Velocity, COMP_VELOCITY);
         if (vel) { vel->value.x = 0.0f; vel->value.z = 0.0f; }
@@ -539,7 +567,7 @@ void EnemyGruntAISystem(world_t *world, GameWorld *game,
         ArriveAtPosition(world, game, e, pos, combat, GRUNT_REPOSITION_BASE, GRUNT_REPOSITION_JITTER);
         break;
       }
-      bool arrived = EnemyFollowPath(world, game, e, moveSpeeds[0] * 1.25f, rotateSpeeds[0], dt);
+      bool arrived = EnemyFollowPath(world, game, e, moveSpeeds[0] * 1.25f, rotateSpeeds[0], stepDt);
       if (arrived)
         ArriveAtPosition(world, game, e, pos, combat, GRUNT_REPOSITION_BASE, GRUNT_REPOSITION_JITTER);
       break;
@@ -549,8 +577,10 @@ void EnemyGruntAISystem(world_t *world, GameWorld *game,
     default: {
       Vector3 dest;
       if (SelectTacticalPosition(world, game, pos->value, playerPos->value,
-                                 GRUNT_MIN_DIST, GRUNT_MAX_DIST, GRUNT_MAX_MOVE_RADIUS, e.id, false, &dest)) {
-        EnemyPathQueue_Submit(&game->navGrid, pos->value, dest, path, &combat->pathPending, NULL, e);
+                                 e, false, &dest)) {
+        EnemyPathQueue_Submit(&game->navGrid, pos->value, dest,
+                              EnemyNavRadius(world, e), &combat->pathPending,
+                              e, PATH_PRIORITY_LOW);
       }
       combat->state           = ENEMY_AI_ADVANCE;
       combat->repositionTimer = GRUNT_REPOSITION_BASE;
@@ -558,6 +588,7 @@ void EnemyGruntAISystem(world_t *world, GameWorld *game,
     }
     }
   }
+  AiScheduler_Close(&game->aiScheduler);
 }
 
 /* ------------------------------------------------------------------ */
@@ -583,12 +614,20 @@ void EnemyRangerAISystem(world_t *world, GameWorld *game,
     Health        *health = ECS_GET(world, e, Health,        COMP_HEALTH);
     if (!pos || !path || !combat) continue;
 
-    if (combat->settleTimer > 0.0f)    combat->settleTimer    -= dt;
-    combat->repositionTimer            -= dt;
-    combat->losCheckTimer              -= dt;
+    /* Far or idle enemies think less often and catch up on the time missed */
+    float stepDt;
+    int   lod = AiScheduler_Bucket(pos->value, playerPos->value, combat->hasLOS,
+                                   combat->state == ENEMY_AI_RETREAT,
+                                   combat->state == ENEMY_AI_COVER ||
+                                   combat->state == ENEMY_AI_SUPPRESS);
+    if (!AiScheduler_Due(&game->aiScheduler, e, lod, dt, &stepDt)) continue;
+
+    if (combat->settleTimer > 0.0f)    combat->settleTimer    -= stepDt;
+    combat->repositionTimer            -= stepDt;
+    combat->losCheckTimer              -= stepDt;
 
     if (combat->losCheckTimer <= 0.0f) {
-      combat->hasLOS        = NavGrid_HasLOS(&game->navGrid, pos->value, playerPos->value);
+      combat->hasLOS        = NavVisibility_Test(&game->playerVis, pos->value);
       combat->losCheckTimer = RANGER_LOS_CHECK_INTERVAL;
     }
 
@@ -604,21 +643,22 @@ void EnemyRangerAISystem(world_t *world, GameWorld *game,
     case ENEMY_AI_REPOSITION: {
       if (shouldRetreat && !combat->pathPending) {
         NavPath_Clear(path);
-        ClaimRelease(e.id);
+        ClaimRelease(game, e);
         Vector3 dest;
         if (SelectRetreatPosition(world, game, pos->value, playerPos->value, true, &dest))
-          EnemyPathQueue_Submit(&game->navGrid, pos->value, dest, path, &combat->pathPending, NULL, e);
+          EnemyPathQueue_Submit(&game->navGrid, pos->value, dest,
+                                EnemyNavRadius(world, e), &combat->pathPending,
+                                e, PATH_PRIORITY_HIGH);
         combat->state = ENEMY_AI_RETREAT;
         break;
       }
       if (combat->pathPending) {
-        pos->value.y = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                                     pos->value.x, pos->value.z);
+        pos->value.y = TerrainHeight(game, pos->value.x, pos->value.z);
         Velocity *vel = ECS_GET(world, e, Velocity, COMP_VELOCITY);
         if (vel) { vel->value.x = 0.0f; vel->value.z = 0.0f; }
         break;
       }
-      bool arrived = EnemyFollowPath(world, game, e, moveSpeeds[1], rotateSpeeds[1], dt);
+      bool arrived = EnemyFollowPath(world, game, e, moveSpeeds[1], rotateSpeeds[1], stepDt);
       if (arrived)
         ArriveAtPosition(world, game, e, pos, combat, RANGER_REPOSITION_BASE, RANGER_REPOSITION_JITTER);
       break;
@@ -628,10 +668,12 @@ void EnemyRangerAISystem(world_t *world, GameWorld *game,
     case ENEMY_AI_COVER: {
       if (shouldRetreat) {
         NavPath_Clear(path);
-        ClaimRelease(e.id);
+        ClaimRelease(game, e);
         Vector3 dest;
         if (SelectRetreatPosition(world, game, pos->value, playerPos->value, true, &dest))
-          EnemyPathQueue_Submit(&game->navGrid, pos->value, dest, path, &combat->pathPending, NULL, e);
+          EnemyPathQueue_Submit(&game->navGrid, pos->value, dest,
+                                EnemyNavRadius(world, e), &combat->pathPending,
+                                e, PATH_PRIORITY_HIGH);
         combat->state = ENEMY_AI_RETREAT;
         break;
       }
@@ -641,11 +683,13 @@ void EnemyRangerAISystem(world_t *world, GameWorld *game,
         /* Also reposition if player too close or too far */
         bool outOfRange = distToPlayer < RANGER_MIN_DIST || distToPlayer > RANGER_MAX_DIST;
         if (outOfRange || combat->repositionTimer <= 0.0f) {
-          ClaimRelease(e.id);
+          ClaimRelease(game, e);
           Vector3 dest;
           if (SelectTacticalPosition(world, game, pos->value, playerPos->value,
-                                     RANGER_MIN_DIST, RANGER_MAX_DIST, RANGER_MAX_MOVE_RADIUS, e.id, true, &dest)) {
-            EnemyPathQueue_Submit(&game->navGrid, pos->value, dest, path, &combat->pathPending, NULL, e);
+                                     e, true, &dest)) {
+            EnemyPathQueue_Submit(&game->navGrid, pos->value, dest,
+                                  EnemyNavRadius(world, e), &combat->pathPending,
+                                  e, PATH_PRIORITY_NORMAL);
             combat->state = ENEMY_AI_REPOSITION;
           } else {
             combat->repositionTimer = RANGER_REPOSITION_BASE;
@@ -656,8 +700,7 @@ void EnemyRangerAISystem(world_t *world, GameWorld *game,
     }
 
     case ENEMY_AI_RETREAT: {
-      pos->value.y = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                                   pos->value.x, pos->value.z);
+      pos->value.y = TerrainHeight(game, pos->value.x, pos->value.z);
       if (combat->pathPending) {
         Velocity *vel = ECS_GET(world, e, Velocity, COMP_VELOCITY);
         if (vel) { vel->value.x = 0.0f; vel->value.z = 0.0f; }
@@ -667,7 +710,7 @@ void EnemyRangerAISystem(world_t *world, GameWorld *game,
         ArriveAtPosition(world, game, e, pos, combat, RANGER_REPOSITION_BASE, RANGER_REPOSITION_JITTER);
         break;
       }
-      bool arrived = EnemyFollowPath(world, game, e, moveSpeeds[1] * 1.3f, rotateSpeeds[1], dt);
+      bool arrived = EnemyFollowPath(world, game, e, moveSpeeds[1] * 1.3f, rotateSpeeds[1], stepDt);
       if (arrived)
         ArriveAtPosition(world, game, e, pos, combat, RANGER_REPOSITION_BASE, RANGER_REPOSITION_JITTER);
       break;
@@ -676,8 +719,10 @@ void EnemyRangerAISystem(world_t *world, GameWorld *game,
     default: {
       Vector3 dest;
       if (SelectTacticalPosition(world, game, pos->value, playerPos->value,
-                                 RANGER_MIN_DIST, RANGER_MAX_DIST, RANGER_MAX_MOVE_RADIUS, e.id, true, &dest)) {
-        EnemyPathQueue_Submit(&game->navGrid, pos->value, dest, path, &combat->pathPending, NULL, e);
+                                 e, true, &dest)) {
+        EnemyPathQueue_Submit(&game->navGrid, pos->value, dest,
+                              EnemyNavRadius(world, e), &combat->pathPending,
+                              e, PATH_PRIORITY_LOW);
       }
       combat->state           = ENEMY_AI_ADVANCE;
       combat->repositionTimer = RANGER_REPOSITION_BASE;
@@ -685,6 +730,7 @@ void EnemyRangerAISystem(world_t *world, GameWorld *game,
     }
     }
   }
+  AiScheduler_Close(&game->aiScheduler);
 }
 
 /* ------------------------------------------------------------------ */
@@ -27,7 +27,8 @@ static const float muzzleAimSpeeds[] = { 8.0f,  6.0f};
 #define GRUNT_REPOSITION_JITTER   3.0f
 #define GRUNT_LOS_REPOSITION      2.5f
 #define GRUNT_LOS_CHECK_INTERVAL  0.40f
-#define TACTICAL_SEARCH_RADIUS    45
+#define TACTICAL_LOS_BONUS        10.0f   // candidate cell sees the player
+#define TACTICAL_PEEK_BONUS       15.0f   // hidden cover cell next to a line of fire
 #define GRUNT_MAX_MOVE_RADIUS     42.0f   // max world-units moved per reposition cycle
 #define RANGER_MAX_MOVE_RADIUS    58.0f
 
@@ -1,4 +1,5 @@
 #include "../game.h"
+#include "aim_batch.h"
 #include "enemy_behaviour.h"
 #include "systems.h"
 
@@ -9,35 +10,6 @@
 #define RF_LOG(...)
 #endif
 
-void MuzzleCollection_UpdateWorld(Position *pos, Orientation *entityOri,
-                                  MuzzleCollection_t *muzzles) {
-  if (!pos || !entityOri || !muzzles) return;
-
-  for (int i = 0; i < muzzles->count; i++) {
-    Muzzle_t *m = &muzzles->Muzzles[i];
-    Vector3 offset = m->positionOffset.value;
-
-    float ey  = entityOri->yaw;
-    float cey = cosf(ey), sey = sinf(ey);
-
-    Vector3 pivotLocal = {offset.x, offset.y, 0};
-    Vector3 pivotWorld = {pivotLocal.x * cey - pivotLocal.z * sey, pivotLocal.y,
-                          pivotLocal.x * sey + pivotLocal.z * cey};
-    pivotWorld = Vector3Add(pos->value, pivotWorld);
-
-    m->worldRot.yaw   = entityOri->yaw + m->aimRot.yaw + m->weaponOffset.yaw;
-    m->worldRot.pitch = m->aimRot.pitch + m->weaponOffset.pitch;
-
-    float yaw   = m->worldRot.yaw;
-    float pitch = m->worldRot.pitch;
-    Vector3 forward = {cosf(pitch) * sinf(yaw), sinf(pitch),
-                       cosf(pitch) * cosf(yaw)};
-    m->forward = Vector3Normalize(forward);
-
-    m->worldPosition = Vector3Add(pivotWorld, Vector3Scale(m->forward, offset.z));
-  }
-}
-
 /* Helper: XZ body forward dot product vs player direction */
 static float BodyDotToPlayer(Orientation *ori, Position *pos,
                               Vector3 playerAimPos) {
@@ -58,75 +30,132 @@ static inline bool EnemyCanFire(EnemyState_e s) {
 }
 
 /* ------------------------------------------------------------------ */
-/*  Grunt aim                                                          */
+/*  Batched aim (grunts and rangers)                                   */
 /* ------------------------------------------------------------------ */
 
-void EnemyAimSystem(world_t *world, GameWorld *game, archetype_t *enemyArch,
-                    float dt) {
+typedef struct {
+  entity_t            entity;
+  Orientation        *ori;
+  MuzzleCollection_t *muzzles;
+  int                 firstLane; // of its muzzles in s_muzzleLanes
+} AimOwner;
+
+static AimOwner *s_owners      = NULL;
+static int       s_ownerCap    = 0;
+static AimLanes  s_bodyLanes   = {0};
+static AimLanes  s_muzzleLanes = {0};
+
+// Turns bodies toward the player while they hold a position, swivels every
+// muzzle and refreshes its world transform, all through the lane kernels.
+// kind indexes the speed tables; missile muzzles stay pointed up when
+// fixMissiles is set.
+static void AimArchetype(world_t *world, GameWorld *game, archetype_t *arch,
+                         int kind, bool fixMissiles, float dt) {
   Position *playerPos = ECS_GET(world, game->player, Position, COMP_POSITION);
-  if (!playerPos) return;
+  if (!playerPos || !arch) return;
 
   Vector3 playerAimPos = playerPos->value;
   playerAimPos.y -= 0.5f;
 
-  for (uint32_t i = 0; i < enemyArch->count; i++) {
-    entity_t e = enemyArch->entities[i];
+  if ((int)arch->count > s_ownerCap) {
+    s_ownerCap = (int)arch->count;
+    s_owners   = realloc(s_owners, sizeof(AimOwner) * s_ownerCap);
+  }
+  AimLanes_Reserve(&s_bodyLanes, (int)arch->count);
+
+  // Gather owners and body lanes
+  int n = 0, lanes = 0;
+  for (uint32_t i = 0; i < arch->count; i++) {
+    entity_t e = arch->entities[i];
 
     Active *active = ECS_GET(world, e, Active, COMP_ACTIVE);
     if (!active || !active->value) continue;
 
-    Position          *pos    = ECS_GET(world, e, Position,          COMP_POSITION);
-    Orientation       *ori    = ECS_GET(world, e, Orientation,       COMP_ORIENTATION);
+    Position           *pos     = ECS_GET(world, e, Position,           COMP_POSITION);
+    Orientation        *ori     = ECS_GET(world, e, Orientation,        COMP_ORIENTATION);
     MuzzleCollection_t *muzzles = ECS_GET(world, e, MuzzleCollection_t, COMP_MUZZLES);
-    CombatState_t     *combat = ECS_GET(world, e, CombatState_t,     COMP_COMBAT_STATE);
+    CombatState_t      *combat  = ECS_GET(world, e, CombatState_t,      COMP_COMBAT_STATE);
     if (!pos || !ori || !muzzles || !combat) continue;
 
     // Rotate body toward player only while in combat
-    if (EnemyIsStationary(combat->state)) {
-      Vector3 toPlayer = Vector3Subtract(playerAimPos, pos->value);
-      float targetYaw  = atan2f(toPlayer.x, toPlayer.z);
-      float delta      = targetYaw - ori->yaw;
-      while (delta >  PI) delta -= 2.0f * PI;
-      while (delta < -PI) delta += 2.0f * PI;
-      float step = bodyAimSpeeds[0] * dt;
-      if (fabsf(delta) < step) ori->yaw = targetYaw;
-      else                     ori->yaw += (delta > 0.0f ? 1.0f : -1.0f) * step;
+    s_bodyLanes.x[n]       = pos->value.x;
+    s_bodyLanes.y[n]       = pos->value.y;
+    s_bodyLanes.z[n]       = pos->value.z;
+    s_bodyLanes.bodyYaw[n] = ori->yaw;
+    s_bodyLanes.step[n]    = EnemyIsStationary(combat->state) ? bodyAimSpeeds[kind] * dt : 0.0f;
+
+    s_owners[n++] = (AimOwner){e, ori, muzzles, lanes};
+    lanes        += muzzles->count;
+  }
+  s_bodyLanes.count = n;
+  AimBatch_BodyYaw(&s_bodyLanes, playerAimPos);
+
+  // Muzzle lanes, against the bodies' new yaw
+  AimLanes *ml = &s_muzzleLanes;
+  AimLanes_Reserve(ml, lanes);
+  float swivel = muzzleAimSpeeds[kind] * dt;
+  for (int k = 0; k < n; k++) {
+    AimOwner *o = &s_owners[k];
+    o->ori->yaw = s_bodyLanes.bodyYaw[k];
+    for (int m = 0; m < o->muzzles->count; m++) {
+      const Muzzle_t *mz = &o->muzzles->Muzzles[m];
+      int j = o->firstLane + m;
+      ml->x[j]           = s_bodyLanes.x[k];
+      ml->y[j]           = s_bodyLanes.y[k];
+      ml->z[j]           = s_bodyLanes.z[k];
+      ml->bodyYaw[j]     = o->ori->yaw;
+      ml->offX[j]        = mz->positionOffset.value.x;
+      ml->offY[j]        = mz->positionOffset.value.y;
+      ml->offZ[j]        = mz->positionOffset.value.z;
+      ml->weaponYaw[j]   = mz->weaponOffset.yaw;
+      ml->weaponPitch[j] = mz->weaponOffset.pitch;
+      ml->aimYaw[j]      = mz->aimRot.yaw;
+      ml->aimPitch[j]    = mz->aimRot.pitch;
+      ml->step[j]        = swivel;
     }
+  }
 
-    // Swivel muzzles
-    for (int m = 0; m < muzzles->count; m++) {
-      Muzzle_t *mz = &muzzles->Muzzles[m];
-      Vector3 toPlayer = Vector3Subtract(playerAimPos, pos->value);
-
-      float targetWorldYaw  = atan2f(toPlayer.x, toPlayer.z);
-      float horizontalDist  = sqrtf(toPlayer.x * toPlayer.x + toPlayer.z * toPlayer.z);
-      float targetPitch     = atan2f(toPlayer.y - mz->positionOffset.value.y,
-                                     horizontalDist);
-      float targetLocalYaw  = targetWorldYaw - ori->yaw;
-      while (targetLocalYaw >  PI) targetLocalYaw -= 2.0f * PI;
-      while (targetLocalYaw < -PI) targetLocalYaw += 2.0f * PI;
-
-      float swivelSpeed = muzzleAimSpeeds[0] * dt;
-
-      float yawDelta = targetLocalYaw - mz->aimRot.yaw;
-      while (yawDelta >  PI) yawDelta -= 2.0f * PI;
-      while (yawDelta < -PI) yawDelta += 2.0f * PI;
-      if (fabsf(yawDelta) < swivelSpeed) mz->aimRot.yaw = targetLocalYaw;
-      else                               mz->aimRot.yaw += (yawDelta > 0.0f ? 1.0f : -1.0f) * swivelSpeed;
-
-      float pitchDelta = targetPitch - mz->aimRot.pitch;
-      if (fabsf(pitchDelta) < swivelSpeed) mz->aimRot.pitch = targetPitch;
-      else                                 mz->aimRot.pitch += (pitchDelta > 0.0f ? 1.0f : -1.0f) * swivelSpeed;
+  AimBatch_Swivel(ml, playerAimPos);
+  if (fixMissiles) {
+    for (int k = 0; k < n; k++) {
+      for (int m = 0; m < s_owners[k].muzzles->count; m++) {
+        if (s_owners[k].muzzles->Muzzles[m].bulletType != BULLET_TYPE_MISSILE) continue;
+        ml->aimYaw[s_owners[k].firstLane + m]   = 0.0f;
+        ml->aimPitch[s_owners[k].firstLane + m] = PI / 2.0f;
+      }
+    }
+  }
+  AimBatch_MuzzleWorld(ml);
+
+  // Scatter back
+  for (int k = 0; k < n; k++) {
+    AimOwner *o = &s_owners[k];
+    for (int m = 0; m < o->muzzles->count; m++) {
+      Muzzle_t *mz = &o->muzzles->Muzzles[m];
+      int j = o->firstLane + m;
+      mz->aimRot.yaw     = ml->aimYaw[j];
+      mz->aimRot.pitch   = ml->aimPitch[j];
+      mz->worldRot.yaw   = ml->worldYaw[j];
+      mz->worldRot.pitch = ml->worldPitch[j];
+      mz->forward        = (Vector3){ml->fwdX[j], ml->fwdY[j], ml->fwdZ[j]};
+      mz->worldPosition  = (Vector3){ml->posX[j], ml->posY[j], ml->posZ[j]};
     }
 
-    MuzzleCollection_UpdateWorld(pos, ori, muzzles);
-
-    ModelCollection_t *mc = ECS_GET(world, e, ModelCollection_t, COMP_MODEL);
-    if (mc && mc->count > 2)
-      mc->models[2].rotation.x = -muzzles->Muzzles[0].aimRot.pitch;
+    ModelCollection_t *mc = ECS_GET(world, o->entity, ModelCollection_t, COMP_MODEL);
+    if (mc && mc->count > 2 && o->muzzles->count > 0)
+      mc->models[2].rotation.x = -o->muzzles->Muzzles[0].aimRot.pitch;
   }
 }
 
+/* ------------------------------------------------------------------ */
+/*  Grunt aim                                                          */
+/* ------------------------------------------------------------------ */
+
+void EnemyAimSystem(world_t *world, GameWorld *game, archetype_t *enemyArch,
+                    float dt) {
+  AimArchetype(world, game, enemyArch, 0, false, dt);
+}
+
 /* ------------------------------------------------------------------ */
 /*  Grunt fire                                                         */
 /* ------------------------------------------------------------------ */
@@ -192,72 +221,7 @@ void EnemyFireSystem(world_t *world, GameWorld *game, archetype_t *enemyArch) {
 
 void EnemyRangerAimSystem(world_t *world, GameWorld *game,
                            archetype_t *enemyArch, float dt) {
-  Position *playerPos = ECS_GET(world, game->player, Position, COMP_POSITION);
-  if (!playerPos) return;
-
-  Vector3 playerAimPos = playerPos->value;
-  playerAimPos.y -= 0.5f;
-
-  for (uint32_t i = 0; i < enemyArch->count; i++) {
-    entity_t e = enemyArch->entities[i];
-
-    Active *active = ECS_GET(world, e, Active, COMP_ACTIVE);
-    if (!active || !active->value) continue;
-
-    Position          *pos     = ECS_GET(world, e, Position,           COMP_POSITION);
-    Orientation       *ori     = ECS_GET(world, e, Orientation,        COMP_ORIENTATION);
-    MuzzleCollection_t *muzzles = ECS_GET(world, e, MuzzleCollection_t, COMP_MUZZLES);
-    CombatState_t     *combat  = ECS_GET(world, e, CombatState_t,      COMP_COMBAT_STATE);
-    if (!pos || !ori || !muzzles || !combat) continue;
-
-    if (EnemyIsStationary(combat->state)) {
-      Vector3 toPlayer = Vector3Subtract(playerAimPos, pos->value);
-      float targetYaw  = atan2f(toPlayer.x, toPlayer.z);
-      float delta      = targetYaw - ori->yaw;
-      while (delta >  PI) delta -= 2.0f * PI;
-      while (delta < -PI) delta += 2.0f * PI;
-      float step = bodyAimSpeeds[1] * dt;
-      if (fabsf(delta) < step) ori->yaw = targetYaw;
-      else                     ori->yaw += (delta > 0.0f ? 1.0f : -1.0f) * step;
-    }
-
-    for (int m = 0; m < muzzles->count; m++) {
-      Muzzle_t *mz = &muzzles->Muzzles[m];
-
-      if (mz->bulletType == BULLET_TYPE_MISSILE) {
-        mz->aimRot.yaw   = 0.0f;
-        mz->aimRot.pitch = PI / 2.0f;
-        continue;
-      }
-
-      Vector3 toPlayer      = Vector3Subtract(playerAimPos, pos->value);
-      float targetWorldYaw  = atan2f(toPlayer.x, toPlayer.z);
-      float horizontalDist  = sqrtf(toPlayer.x * toPlayer.x + toPlayer.z * toPlayer.z);
-      float targetPitch     = atan2f(toPlayer.y - mz->positionOffset.value.y,
-                                     horizontalDist);
-      float targetLocalYaw  = targetWorldYaw - ori->yaw;
-      while (targetLocalYaw >  PI) targetLocalYaw -= 2.0f * PI;
-      while (targetLocalYaw < -PI) targetLocalYaw += 2.0f * PI;
-
-      float swivelSpeed = muzzleAimSpeeds[1] * dt;
-
-      float yawDelta = targetLocalYaw - mz->aimRot.yaw;
-      while (yawDelta >  PI) yawDelta -= 2.0f * PI;
-      while (yawDelta < -PI) yawDelta += 2.0f * PI;
-      if (fabsf(yawDelta) < swivelSpeed) mz->aimRot.yaw = targetLocalYaw;
-      else                               mz->aimRot.yaw += (yawDelta > 0.0f ? 1.0f : -1.0f) * swivelSpeed;
-
-      float pitchDelta = targetPitch - mz->aimRot.pitch;
-      if (fabsf(pitchDelta) < swivelSpeed) mz->aimRot.pitch = targetPitch;
-      else                                 mz->aimRot.pitch += (pitchDelta > 0.0f ? 1.0f : -1.0f) * swivelSpeed;
-    }
-
-    MuzzleCollection_UpdateWorld(pos, ori, muzzles);
-
-    ModelCollection_t *mc = ECS_GET(world, e, ModelCollection_t, COMP_MODEL);
-    if (mc && mc->count > 2)
-      mc->models[2].rotation.x = -muzzles->Muzzles[0].aimRot.pitch;
-  }
+  AimArchetype(world, game, enemyArch, 1, true, dt);
 }
 
 /* ------------------------------------------------------------------ */
@@ -7,6 +7,7 @@
 #define HEALTH_ORB_BOUNCE_DAMP    0.45f
 #define HEALTH_ORB_TRAIL_INTERVAL 0.05f
 #define HEALTH_ORB_HEAL           25.0f
+#define PICKUP_MAX_HITS           32
 
 void HealthOrbSystem(world_t *world, GameWorld *game, float dt) {
   archetype_t *arch = WorldGetArchetype(world, game->healthOrbArchId);
@@ -33,8 +34,7 @@ void HealthOrbSystem(world_t *world, GameWorld *game, float dt) {
     vel->value.y -= HEALTH_ORB_GRAVITY * dt;
 
     // Terrain bounce
-    float ty = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                              pos->value.x, pos->value.z);
+    float ty = TerrainHeight(game, pos->value.x, pos->value.z);
     if (pos->value.y <= ty) {
       pos->value.y  = ty;
       vel->value.y  = fabsf(vel->value.y) * HEALTH_ORB_BOUNCE_DAMP;
@@ -71,17 +71,22 @@ void HealthOrbSystem(world_t *world, GameWorld *game, float dt) {
         }
       }
     }
+  }
 
-    // Pickup — XZ only (same reason as coolant: player eye height)
-    float dx = ppos->value.x - pos->value.x;
-    float dz = ppos->value.z - pos->value.z;
-    if (sqrtf(dx*dx + dz*dz) < HEALTH_ORB_PICKUP_RADIUS) {
-      if (phealth) {
-        phealth->current += HEALTH_ORB_HEAL;
-        if (phealth->current > phealth->max)
-          phealth->current = phealth->max;
-      }
-      active->value = false;
+  // Pickup — XZ only (same reason as coolant: player eye height)
+  entity_t near[PICKUP_MAX_HITS];
+  int n = WorldQueryRadiusXZ(world, ppos->value, HEALTH_ORB_PICKUP_RADIUS,
+                             1u << LAYER_PICKUP, near, PICKUP_MAX_HITS);
+  for (int k = 0; k < n; k++) {
+    if (!ECS_GET(world, near[k], HealthOrb, COMP_HEALTH_ORB)) continue;
+    Active *active = ECS_GET(world, near[k], Active, COMP_ACTIVE);
+    if (!active || !active->value) continue;
+
+    if (phealth) {
+      phealth->current += HEALTH_ORB_HEAL;
+      if (phealth->current > phealth->max)
+        phealth->current = phealth->max;
     }
+    active->value = false;
   }
 }
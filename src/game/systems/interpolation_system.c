@@ -0,0 +1,114 @@
+#include "../game.h"
+#include "systems.h"
+#include <string.h>
+
+// Moves larger than this in one tick are teleports (pool reuse, respawn)
+// and are snapped instead of blended.
+#define INTERP_SNAP_DIST 10.0f
+
+static void EnsureCapacity(TransformHistory *history, uint32_t id) {
+  if (id < history->capacity)
+    return;
+
+  uint32_t newCap = history->capacity ? history->capacity : 256;
+  while (newCap <= id)
+    newCap *= 2;
+
+  PrevTransform *grown =
+      realloc(history->entries, newCap * sizeof(PrevTransform));
+  if (!grown)
+    return;
+
+  for (uint32_t i = history->capacity; i < newCap; ++i)
+    grown[i].generation = UINT32_MAX;
+
+  history->entries = grown;
+  history->capacity = newCap;
+}
+
+void TransformSnapshotSystem(world_t *world, TransformHistory *history) {
+  for (uint32_t a = 0; a < world->archetypeCount; ++a) {
+    archetype_t *arch = &world->archetypes[a];
+
+    if (!ArchetypeHas(arch, COMP_POSITION))
+      continue;
+    if (!ArchetypeHas(arch, COMP_MODEL) && !ArchetypeHas(arch, COMP_TYPE_PLAYER))
+      continue;
+
+    bool hasActive = ArchetypeHas(arch, COMP_ACTIVE);
+    bool hasOri = ArchetypeHas(arch, COMP_ORIENTATION);
+
+    for (uint32_t i = 0; i < arch->count; ++i) {
+      entity_t e = arch->entities[i];
+
+      EnsureCapacity(history, e.id);
+      if (e.id >= history->capacity)
+        continue;
+
+      PrevTransform *prev = &history->entries[e.id];
+
+      // Inactive pooled entities get no sample so they snap on reactivation
+      if (hasActive) {
+        Active *active = ECS_GET(world, e, Active, COMP_ACTIVE);
+        if (!active->value) {
+          prev->generation = UINT32_MAX;
+          continue;
+        }
+      }
+
+      prev->position = ECS_GET(world, e, Position, COMP_POSITION)->value;
+      if (hasOri)
+        prev->orientation =
+            *ECS_GET(world, e, Orientation, COMP_ORIENTATION);
+      prev->generation = e.generation;
+    }
+  }
+}
+
+void TransformHistory_Clear(TransformHistory *history) {
+  for (uint32_t i = 0; i < history->capacity; ++i)
+    history->entries[i].generation = UINT32_MAX;
+}
+
+void TransformHistory_Free(TransformHistory *history) {
+  free(history->entries);
+  history->entries = NULL;
+  history->capacity = 0;
+}
+
+static const PrevTransform *Lookup(const TransformHistory *history,
+                                   entity_t e) {
+  if (!history || e.id >= history->capacity)
+    return NULL;
+
+  const PrevTransform *prev = &history->entries[e.id];
+  return prev->generation == e.generation ? prev : NULL;
+}
+
+Vector3 TransformHistory_LerpPosition(const TransformHistory *history,
+                                      entity_t e, Vector3 current,
+                                      float alpha) {
+  const PrevTransform *prev = Lookup(history, e);
+  if (!prev)
+    return current;
+
+  if (Vector3DistanceSqr(prev->position, current) >
+      INTERP_SNAP_DIST * INTERP_SNAP_DIST)
+    return current;
+
+  return Vector3Lerp(prev->position, current, alpha);
+}
+
+Orientation TransformHistory_LerpOrientation(const TransformHistory *history,
+                                             entity_t e, Orientation current,
+                                             float alpha) {
+  const PrevTransform *prev = Lookup(history, e);
+  if (!prev)
+    return current;
+
+  return (Orientation){
+      .yaw = LerpAngle(prev->orientation.yaw, current.yaw, alpha),
+      .pitch = prev->orientation.pitch +
+               (current.pitch - prev->orientation.pitch) * alpha,
+  };
+}
@@ -11,10 +11,11 @@
 #define MELEE_DAMAGE         25.0f
 #define MELEE_REPATH_INTERVAL 1.5f
 #define MELEE_ROTATE_SPEED   10.0f
-#define MELEE_SEP_RADIUS      2.5f
-#define MELEE_SEP_STRENGTH   12.0f
 
 static bool MeleeClearLOS(GameWorld *game, Vector3 from, Vector3 to) {
+  if (game->navGrid.clearance &&
+      NavClearance_SegmentClear(game->navGrid.clearance, from, to))
+    return true;
   Vector3 diff = {to.x - from.x, 0.0f, to.z - from.z};
   float dist = sqrtf(diff.x * diff.x + diff.z * diff.z);
   if (dist < 0.001f) return true;
@@ -55,6 +56,8 @@ void EnemyMeleeAISystem(world_t *world, GameWorld *game,
   archetype_t *playerArch = WorldGetArchetype(world, game->playerArchId);
   if (!playerPos || !playerArch) return;
 
+  const float *ground = SampleArchetypeGround(world, game, arch);
+
   for (uint32_t i = 0; i < arch->count; i++) {
     entity_t e = arch->entities[i];
 
@@ -67,14 +70,21 @@ void EnemyMeleeAISystem(world_t *world, GameWorld *game,
     MeleeEnemy  *me  = ECS_GET(world, e, MeleeEnemy,  COMP_MELEE_ENEMY);
     if (!pos || !vel || !ori || !me) continue;
 
-    float terrainY = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                                    pos->value.x, pos->value.z);
+    // Chasers far from the player steer less often; attacks run every tick
+    float stepDt;
+    int   lod = AiScheduler_Bucket(pos->value, playerPos->value,
+                                   NavVisibility_Test(&game->playerVis, pos->value),
+                                   me->state != MELEE_CHASING, false);
+    if (!AiScheduler_Due(&game->aiScheduler, e, lod, dt, &stepDt)) continue;
+
+    float terrainY = ground ? ground[i]
+                            : TerrainHeight(game, pos->value.x, pos->value.z);
 
     Vector3 toPlayer = Vector3Subtract(playerPos->value, pos->value);
     toPlayer.y = 0.0f;
     float distXZ = Vector3Length(toPlayer);
 
-    if (me->repathTimer > 0.0f) me->repathTimer -= dt;
+    if (me->repathTimer > 0.0f) me->repathTimer -= stepDt;
 
     // Keep ground enemies glued to terrain except during lunge
     if (me->state != MELEE_LUNGING) {
@@ -95,8 +105,12 @@ void EnemyMeleeAISystem(world_t *world, GameWorld *game,
         break;
       }
 
+      // Shared flow field first; a per-enemy A* path only where it can't help
+      if (EnemyFollowFlow(world, game, e, MELEE_CHASE_SPEED,
+                          MELEE_ROTATE_SPEED, stepDt))
+        break;
+
       if (!me->pathPending && me->repathTimer <= 0.0f) {
-        NavPath *path = ECS_GET(world, e, NavPath, COMP_NAVPATH);
         Vector3 goal  = playerPos->value;
         // Clamp goal to within safe play radius so nav grid stays in bounds
         float gr = sqrtf(goal.x * goal.x + goal.z * goal.z);
@@ -104,19 +118,19 @@ void EnemyMeleeAISystem(world_t *world, GameWorld *game,
           float s = 175.0f / gr;
           goal.x *= s; goal.z *= s;
         }
-        goal.y = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                               goal.x, goal.z);
+        goal.y = TerrainHeight(game, goal.x, goal.z);
         int cx, cy;
         if (NavGrid_WorldToCell(&game->navGrid, goal, &cx, &cy) &&
             game->navGrid.cells[NavGrid_Index(&game->navGrid, cx, cy)].type
                 != NAV_CELL_WALL) {
           EnemyPathQueue_Submit(&game->navGrid, pos->value, goal,
-                                path, &me->pathPending, NULL, e);
+                                EnemyNavRadius(world, e), &me->pathPending, e,
+                                PATH_PRIORITY_NORMAL);
         }
         me->repathTimer = MELEE_REPATH_INTERVAL;
       }
       if (!me->pathPending)
-        EnemyFollowPath(world, game, e, MELEE_CHASE_SPEED, MELEE_ROTATE_SPEED, dt);
+        EnemyFollowPath(world, game, e, MELEE_CHASE_SPEED, MELEE_ROTATE_SPEED, stepDt);
     } break;
 
     case MELEE_WINDING_UP: {
@@ -125,7 +139,7 @@ void EnemyMeleeAISystem(world_t *world, GameWorld *game,
       if (distXZ > 0.001f)
         ori->yaw = atan2f(toPlayer.x / distXZ, toPlayer.z / distXZ);
 
-      me->windupTimer -= dt;
+      me->windupTimer -= stepDt;
       if (me->windupTimer <= 0.0f) {
         Vector3 toLunge = Vector3Subtract(me->lungeTarget, pos->value);
         toLunge.y = 0.0f;
@@ -145,7 +159,7 @@ void EnemyMeleeAISystem(world_t *world, GameWorld *game,
     case MELEE_LUNGING: {
       if (pos->value.y < terrainY) pos->value.y = terrainY;
 
-      me->lungeTimer -= dt;
+      me->lungeTimer -= stepDt;
 
       if (!me->hasHit) {
         float distToPlayer = Vector3Distance(pos->value, playerPos->value);
@@ -169,7 +183,7 @@ void EnemyMeleeAISystem(world_t *world, GameWorld *game,
     case MELEE_RECOVERING: {
       pos->value.y = terrainY;
       vel->value   = (Vector3){0, 0, 0};
-      me->recoverTimer -= dt;
+      me->recoverTimer -= stepDt;
       if (me->recoverTimer <= 0.0f) {
         NavPath *path = ECS_GET(world, e, NavPath, COMP_NAVPATH);
         if (path) NavPath_Clear(path);
@@ -178,25 +192,6 @@ void EnemyMeleeAISystem(world_t *world, GameWorld *game,
       }
     } break;
     }
-
-    // Separation: push away from nearby melee siblings (skip during lunge)
-    if (me->state != MELEE_LUNGING) {
-      for (uint32_t j = 0; j < arch->count; j++) {
-        if (j == i) continue;
-        Active *oa = ECS_GET(world, arch->entities[j], Active, COMP_ACTIVE);
-        if (!oa || !oa->value) continue;
-        Position *opos = ECS_GET(world, arch->entities[j], Position, COMP_POSITION);
-        if (!opos) continue;
-        Vector3 diff = Vector3Subtract(pos->value, opos->value);
-        diff.y = 0.0f;
-        float dist = Vector3Length(diff);
-        if (dist < MELEE_SEP_RADIUS && dist > 0.001f) {
-          float push = (MELEE_SEP_RADIUS - dist) / MELEE_SEP_RADIUS;
-          Vector3 nudge = Vector3Scale(Vector3Normalize(diff), push * MELEE_SEP_STRENGTH * dt);
-          pos->value.x += nudge.x;
-          pos->value.z += nudge.z;
-        }
-      }
-    }
   }
+  AiScheduler_Close(&game->aiScheduler);
 }
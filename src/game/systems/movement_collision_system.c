@@ -176,8 +176,7 @@ void PlayerMoveAndCollide(world_t *world, GameWorld *game, float dt) {
     BuildPlayerCapsule(pos, cap, ci);
     ResolveCapsuleVsObstacles(world, game, pos, vel, cap, ci, true);
 
-    float terrainY = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                                   pos->value.x, pos->value.z);
+    float terrainY = TerrainHeight(game, pos->value.x, pos->value.z);
 
     float eyeHeight = 1.65f;
     float footY = pos->value.y - eyeHeight;
@@ -0,0 +1,215 @@
+#include "../game.h"
+#include "../nav_grid/nav_repair.h"
+#include "systems.h"
+
+/* ------------------------------------------------------------------ */
+/*  Runtime nav edits                                                 */
+/*  Edits are queued and applied once per tick while the path service */
+/*  is paused. Paths they cut are repaired here with per-agent D* Lite */
+/*  state instead of going back through the path queue, so a closing  */
+/*  gate costs a budget of expansions rather than a burst of A*.      */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+  int         x, y;
+  NavCellType type;
+} NavEdit;
+
+typedef struct {
+  NavRepair repair;
+  entity_t  owner;
+  bool      used;    // repair holds search state for owner
+  bool      running; // NavRepair_Compute hasn't finished yet
+  uint32_t  lastUse; // tick of the last repair, for eviction
+} RepairSlot;
+
+static NavEdit   *s_edits     = NULL;
+static int        s_editCount = 0;
+static int        s_editCap   = 0;
+static RepairSlot s_slots[NAV_REPAIR_SLOTS];
+static int        s_nextSlot  = 0;
+static uint32_t   s_tick      = 0;
+static NavPath    s_scratch;
+
+void NavDynamic_SetCell(int x, int y, NavCellType type) {
+  if (s_editCount >= s_editCap) {
+    s_editCap = s_editCap ? s_editCap * 2 : 64;
+    s_edits   = realloc(s_edits, sizeof(NavEdit) * s_editCap);
+  }
+  s_edits[s_editCount++] = (NavEdit){x, y, type};
+}
+
+void NavDynamic_SetArea(GameWorld *game, Vector3 min, Vector3 max,
+                        NavCellType type) {
+  NavGrid *g  = &game->navGrid;
+  int      x0 = (int)floorf((min.x - g->origin.x) / g->cellSize);
+  int      y0 = (int)floorf((min.z - g->origin.z) / g->cellSize);
+  int      x1 = (int)floorf((max.x - g->origin.x) / g->cellSize);
+  int      y1 = (int)floorf((max.z - g->origin.z) / g->cellSize);
+  for (int y = y0; y <= y1; y++)
+    for (int x = x0; x <= x1; x++)
+      if (NavGrid_InBounds(g, x, y)) NavDynamic_SetCell(x, y, type);
+}
+
+void NavDynamic_Reset(void) {
+  for (int i = 0; i < NAV_REPAIR_SLOTS; i++) {
+    NavRepair_Destroy(&s_slots[i].repair);
+    s_slots[i].used    = false;
+    s_slots[i].running = false;
+  }
+  s_editCount = 0;
+}
+
+static void ApplyEdits(GameWorld *game) {
+  NavGrid *grid    = &game->navGrid;
+  bool     changed = false;
+
+  PathService_Pause();
+  for (int i = 0; i < s_editCount; i++) {
+    NavEdit *ed = &s_edits[i];
+    if (!NavGrid_InBounds(grid, ed->x, ed->y)) continue;
+    if (grid->cells[NavGrid_Index(grid, ed->x, ed->y)].type == ed->type) continue;
+
+    NavGrid_SetCell(grid, ed->x, ed->y, ed->type);
+    for (int s = 0; s < NAV_REPAIR_SLOTS; s++)
+      if (s_slots[s].used) NavRepair_CellChanged(&s_slots[s].repair, ed->x, ed->y);
+    changed = true;
+  }
+  if (changed) NavGrid_EndEdits(grid);
+  PathService_Resume();
+  s_editCount = 0;
+
+  if (changed && game->playerFlow.ready.cost)
+    FlowField_Invalidate(&game->playerFlow, grid);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Repair slots                                                      */
+/* ------------------------------------------------------------------ */
+
+static bool SameEntity(entity_t a, entity_t b) {
+  return a.id == b.id && a.generation == b.generation;
+}
+
+// Keeps an owner's previous search when its goal is unchanged, so only
+// the edits since then are re-expanded.
+static void RequestRepair(GameWorld *game, entity_t e, Vector3 pos,
+                          Vector3 goal) {
+  NavGrid *grid  = &game->navGrid;
+  int      found = -1;
+  int      evict = -1;
+  for (int i = 0; i < NAV_REPAIR_SLOTS; i++) {
+    RepairSlot *s = &s_slots[i];
+    if (s->used && SameEntity(s->owner, e)) { found = i; break; }
+    if (s->running) continue;
+    if (evict < 0 || !s->used ||
+        (s_slots[evict].used && s->lastUse < s_slots[evict].lastUse))
+      evict = i;
+  }
+
+  if (found >= 0) {
+    RepairSlot *s = &s_slots[found];
+    if (s->running) return;
+    int gx, gy;
+    if (NavGrid_WorldToCell(grid, goal, &gx, &gy) &&
+        NavGrid_Index(grid, gx, gy) == s->repair.goal &&
+        s->repair.grid == grid && NavRepair_MoveStart(&s->repair, pos)) {
+      s->running = true;
+      return;
+    }
+    evict = found;
+  }
+  if (evict < 0) return; // every slot busy; retried next tick
+
+  RepairSlot *s = &s_slots[evict];
+  s->used    = NavRepair_Begin(&s->repair, grid, pos, goal);
+  s->running = s->used;
+  s->owner   = e;
+}
+
+static void FinishRepair(world_t *world, GameWorld *game, RepairSlot *s,
+                         NavRepairStatus status) {
+  NavGrid *grid = &game->navGrid;
+  NavPath *path = ECS_GET(world, s->owner, NavPath, COMP_NAVPATH);
+  // A fresh search landed meanwhile, or the agent moved on to a new goal
+  if (!path || path->revision == grid->revision || path->count == 0) return;
+
+  int gx, gy;
+  if (!NavGrid_WorldToCell(grid, path->points[path->count - 1], &gx, &gy) ||
+      NavGrid_Index(grid, gx, gy) != s->repair.goal)
+    return;
+
+  if (status == NAV_REPAIR_FOUND && NavRepair_ExtractPath(&s->repair, &s_scratch)) {
+    NavPath_Smooth(grid, &s_scratch);
+    NavPath_Assign(path, s_scratch.points, s_scratch.count);
+  } else {
+    NavPath_Clear(path); // goal cut off; the AI picks a new one
+  }
+  path->revision = grid->revision;
+}
+
+static void RunRepairs(world_t *world, GameWorld *game) {
+  if (!s_scratch.points) NavPath_Init(&s_scratch, 64);
+
+  int budget = NAV_REPAIR_BUDGET;
+  for (int k = 0; k < NAV_REPAIR_SLOTS && budget > 0; k++) {
+    RepairSlot *s = &s_slots[(s_nextSlot + k) % NAV_REPAIR_SLOTS];
+    if (!s->running) continue;
+
+    Position *pos = ECS_GET(world, s->owner, Position, COMP_POSITION);
+    if (!EntityIsAlive(&world->entityManager, s->owner) || !pos) {
+      s->running = false;
+      s->used    = false;
+      continue;
+    }
+    NavRepair_MoveStart(&s->repair, pos->value);
+
+    NavRepairStatus status = NavRepair_Compute(&s->repair, budget);
+    budget -= s->repair.expanded;
+    if (status == NAV_REPAIR_PENDING) continue;
+
+    s->running = false;
+    s->lastUse = s_tick;
+    FinishRepair(world, game, s, status);
+  }
+  // Rotate so one long repair can't starve the others
+  s_nextSlot = (s_nextSlot + 1) % NAV_REPAIR_SLOTS;
+}
+
+/* ------------------------------------------------------------------ */
+/*  System                                                            */
+/* ------------------------------------------------------------------ */
+
+void NavDynamicSystem(world_t *world, GameWorld *game) {
+  NavGrid *grid = &game->navGrid;
+  if (!grid->cells) return;
+  s_tick++;
+
+  if (s_editCount > 0) ApplyEdits(game);
+  if (grid->revision == 0) return; // never edited, every path is current
+
+  // Paths planned before the latest edit: keep the ones still walkable,
+  // repair the rest. Results the path service searched against an older
+  // grid land here too.
+  for (uint32_t a = 0; a < world->archetypeCount; a++) {
+    archetype_t *arch = &world->archetypes[a];
+    if (!ArchetypeHas(arch, COMP_NAVPATH) || !ArchetypeHas(arch, COMP_POSITION))
+      continue;
+
+    for (uint32_t i = 0; i < arch->count; i++) {
+      entity_t e    = arch->entities[i];
+      NavPath *path = ECS_GET(world, e, NavPath, COMP_NAVPATH);
+      if (path->revision == grid->revision) continue;
+
+      Position *pos = ECS_GET(world, e, Position, COMP_POSITION);
+      if (path->currentIndex >= path->count ||
+          NavPath_IsClear(grid, path, pos->value)) {
+        path->revision = grid->revision;
+        continue;
+      }
+      RequestRepair(game, e, pos->value, path->points[path->count - 1]);
+    }
+  }
+
+  RunRepairs(world, game);
+}
@@ -1,5 +1,6 @@
 #include "../../engine/util/bitset.h"
 #include "../game.h"
+#include "../input.h"
 #include "../level_creater_helper.h"
 #include "systems.h"
 #include <raymath.h>
@@ -50,8 +51,8 @@ void PlayerShootSystem(world_t *world, GameWorld *game, entity_t player,
   if (m->isOverheated)
     return;
 
-  bool trigger = (m->fireRate > 0.0f) ? IsMouseButtonDown(MOUSE_BUTTON_LEFT)
-                                      : IsMouseButtonPressed(MOUSE_BUTTON_LEFT);
+  bool trigger = (m->fireRate > 0.0f) ? Input_MouseDown(MOUSE_BUTTON_LEFT)
+                                      : Input_MousePressed(MOUSE_BUTTON_LEFT);
   if (!trigger)
     return;
 
@@ -110,16 +111,16 @@ void PlayerWeaponSwitchSystem(world_t *world, GameWorld *game,
   // index 0 = body, weapons are indices 1..count-1
   uint32_t weaponCount = mc->count > 1 ? mc->count - 1 : 0;
 
-  if (IsKeyPressed(KEY_ONE) && weaponCount >= 1)
+  if (Input_KeyPressed(KEY_ONE) && weaponCount >= 1)
     game->playerActiveWeapon = 0;
 
-  if (IsKeyPressed(KEY_TWO) && weaponCount >= 2)
+  if (Input_KeyPressed(KEY_TWO) && weaponCount >= 2)
     game->playerActiveWeapon = 1;
 
-  if (IsKeyPressed(KEY_THREE) && weaponCount >= 3)
+  if (Input_KeyPressed(KEY_THREE) && weaponCount >= 3)
     game->playerActiveWeapon = 2;
 
-  if (IsKeyPressed(KEY_FOUR) && weaponCount >= 4)
+  if (Input_KeyPressed(KEY_FOUR) && weaponCount >= 4)
     game->playerActiveWeapon = 3;
 
   // Clamp safety
@@ -160,7 +161,7 @@ void PlayerControlSystem(world_t *world, GameWorld *game, entity_t player,
     coyoteTimer->value = 0.0f;
 
   // CAMERA (only when NOT dashing)
-  Vector2 mouse = GetMouseDelta();
+  Vector2 mouse = Input_MouseDelta();
   ori->yaw -= mouse.x * mouseSensitivity;
   ori->pitch -= mouse.y * mouseSensitivity;
   ori->pitch = Clamp(ori->pitch, -PI / 2 + 0.001f, PI / 2 - 0.001f);
@@ -179,17 +180,17 @@ void PlayerControlSystem(world_t *world, GameWorld *game, entity_t player,
   float vy = vel->value.y;
   vel->value = (Vector3){0, vy, 0};
 
-  if (IsKeyDown(KEY_W))
+  if (Input_KeyDown(KEY_W))
     vel->value = Vector3Add(vel->value, forward);
-  if (IsKeyDown(KEY_S))
+  if (Input_KeyDown(KEY_S))
     vel->value = Vector3Subtract(vel->value, forward);
-  if (IsKeyDown(KEY_A))
+  if (Input_KeyDown(KEY_A))
     vel->value = Vector3Add(vel->value, right);
-  if (IsKeyDown(KEY_D))
+  if (Input_KeyDown(KEY_D))
     vel->value = Vector3Subtract(vel->value, right);
 
   // DASH TRIGGER
-  if (IsKeyPressed(KEY_LEFT_SHIFT) && dashCooldown->value <= 0) {
+  if (Input_KeyPressed(KEY_LEFT_SHIFT) && dashCooldown->value <= 0) {
     Vector3 horiz = {vel->value.x, 0.0f, vel->value.z};
     dashCooldown->value = dashCooldownMax;
     if (Vector3Length(horiz) > 0.01f) {
@@ -208,7 +209,7 @@ void PlayerControlSystem(world_t *world, GameWorld *game, entity_t player,
   // JUMP
   bool canJump = (coyoteTimer->value > 0.0f);
 
-  if (IsKeyPressed(KEY_SPACE) && canJump) {
+  if (Input_KeyPressed(KEY_SPACE) && canJump) {
     vel->value.y = jumpVelocity;
     coyoteTimer->value = 0.0f;
   }
@@ -431,9 +432,9 @@ void RocketLauncherSystem(world_t *world, GameWorld *game,
     return;
   }
 
-  bool lmbHeld     = IsMouseButtonDown(MOUSE_BUTTON_LEFT);
-  bool lmbReleased = IsMouseButtonReleased(MOUSE_BUTTON_LEFT);
-  bool rmbPressed  = IsMouseButtonPressed(MOUSE_BUTTON_RIGHT);
+  bool lmbHeld     = Input_MouseDown(MOUSE_BUTTON_LEFT);
+  bool lmbReleased = Input_MouseReleased(MOUSE_BUTTON_LEFT);
+  bool rmbPressed  = Input_MousePressed(MOUSE_BUTTON_RIGHT);
 
   // Cancel: RMB while charging
   if (rmbPressed && lmbHeld) {
@@ -467,7 +468,11 @@ void RocketLauncherSystem(world_t *world, GameWorld *game,
   game->rocketLockAngle += spinRate * dt;
 
   // Scan ALL enemies in reticle, collect up to ROCKET_MAX_TARGETS
+#ifdef GAME_HEADLESS
+  int sw = game->resWidth, sh = game->resHeight; // no window to measure
+#else
   int sw = GetScreenWidth(), sh = GetScreenHeight();
+#endif
   Vector2 center = {(float)(sw / 2), (float)(sh / 2)};
 
   uint32_t archIds[] = {
@@ -493,7 +498,7 @@ void RocketLauncherSystem(world_t *world, GameWorld *game,
       Vector3 camFwd  = Vector3Normalize(Vector3Subtract(camera->target, camera->position));
       Vector3 toEnemy = Vector3Subtract(epos->value, camera->position);
       if (Vector3DotProduct(camFwd, toEnemy) <= 0.0f) continue;
-      Vector2 screen = GetWorldToScreen(epos->value, *camera);
+      Vector2 screen = GetWorldToScreenEx(epos->value, *camera, sw, sh);
       if (Vector2Distance(screen, center) <= ROCKET_LOCK_RADIUS)
         game->rocketLockTargets[game->rocketLockTargetCount++] = e;
     }
@@ -1,3 +1,4 @@
+#include "../../engine/util/profiler.h"
 #include "../game.h"
 #include "../level_creater_helper.h"
 #include "rlgl.h"
@@ -260,8 +261,11 @@ void RenderArchetype(world_t *world, archetype_t *arch) {
   }
 }
 
-void ComputeArchetypeTransforms(world_t *world, archetype_t *arch) {
+void ComputeArchetypeTransforms(world_t *world, archetype_t *arch,
+                                const TransformHistory *history, float alpha) {
   bool hasActive = BitsetContainsAll(&arch->mask, &activeMask);
+  // Player look is sampled every frame, so only its position is blended
+  bool lerpOri = !ArchetypeHas(arch, COMP_TYPE_PLAYER);
 
 #pragma omp parallel for if (arch->count >= OMP_MIN_ITERATIONS)
   for (uint32_t i = 0; i < arch->count; ++i) {
@@ -273,10 +277,21 @@ void ComputeArchetypeTransforms(world_t *world, archetype_t *arch) {
         continue;
     }
 
-    Position *pos = ECS_GET(world, e, Position, COMP_POSITION);
-    Orientation *ori = ECS_GET(world, e, Orientation, COMP_ORIENTATION);
+    Position *curPos = ECS_GET(world, e, Position, COMP_POSITION);
+    Orientation *curOri = ECS_GET(world, e, Orientation, COMP_ORIENTATION);
     ModelCollection_t *mc = ECS_GET(world, e, ModelCollection_t, COMP_MODEL);
 
+    // Blend the previous and current tick so motion is smooth at any FPS
+    Position interpPos = {
+        TransformHistory_LerpPosition(history, e, curPos->value, alpha)};
+    Orientation interpOri = {0};
+    if (curOri)
+      interpOri = lerpOri ? TransformHistory_LerpOrientation(history, e,
+                                                             *curOri, alpha)
+                          : *curOri;
+    Position *pos = &interpPos;
+    Orientation *ori = &interpOri;
+
     for (uint32_t m = 0; m < mc->count; ++m) {
       ModelInstance_t *mi = &mc->models[m];
 
@@ -370,8 +385,7 @@ static void DrawPlanarShadows(world_t *world, GameWorld *game) {
       ModelCollection_t *mc = ECS_GET(world, e, ModelCollection_t, COMP_MODEL);
       if (!pos || !mc) continue;
 
-      float terrainY = HeightMap_GetHeightCatmullRom(&game->terrainHeightMap,
-                                                      pos->value.x, pos->value.z);
+      float terrainY = TerrainHeight(game, pos->value.x, pos->value.z);
       float h = pos->value.y - terrainY;
       if (h < 0.0f) h = 0.0f;
       if (h > 18.0f) continue;
@@ -700,6 +714,38 @@ static void DrawAIStateLabels(world_t *world, GameWorld *game, Camera *camera) {
   }
 }
 
+// Per-zone timings from the profiler's last completed frame, indented by
+// nesting depth. avg is smoothed over recent frames, max decays slowly.
+static void DrawProfilerOverlay(void) {
+  const ProfZoneStats *zones;
+  int count = Prof_GetStats(&zones);
+
+  const int rowH = 12, pw = 300, px = 4, py = 34;
+  int rows = count < (GetScreenHeight() - py - 30) / rowH
+                 ? count
+                 : (GetScreenHeight() - py - 30) / rowH;
+  int ph = 30 + rows * rowH;
+  DrawRectangle(px, py, pw, ph, (Color){0, 0, 0, 180});
+  DrawRectangleLines(px, py, pw, ph, (Color){80, 200, 255, 200});
+  DrawText(TextFormat("PROFILER [F10]  frame %.2f ms  [F11] trace",
+                      Prof_FrameMs()),
+           px + 6, py + 5, 10, (Color){80, 200, 255, 255});
+  DrawText("zone", px + 6, py + 17, 10, GRAY);
+  DrawText("ms   avg   max  n", px + pw - 112, py + 17, 10, GRAY);
+
+  for (int i = 0; i < rows; i++) {
+    const ProfZoneStats *z = &zones[i];
+    int   y   = py + 30 + i * rowH;
+    Color col = z->avgMs > 2.0f ? (Color){255, 110, 80, 255}
+                : z->calls      ? RAYWHITE
+                                : DARKGRAY;
+    DrawText(z->name, px + 6 + z->depth * 8, y, 10, col);
+    DrawText(TextFormat("%5.2f %5.2f %5.2f %2d", z->ms, z->avgMs, z->maxMs,
+                        z->calls),
+             px + pw - 120, y, 10, col);
+  }
+}
+
 void RenderLevelSystem(world_t *world, GameWorld *game, Camera *camera) {
 
   EnsureModelMask();
@@ -711,7 +757,8 @@ void RenderLevelSystem(world_t *world, GameWorld *game, Camera *camera) {
     if (!BitsetContainsAll(&arch->mask, &modelMask))
       continue;
 
-    ComputeArchetypeTransforms(world, arch);
+    ComputeArchetypeTransforms(world, arch, &game->transformHistory,
+                               game->renderAlpha);
   }
 
   // ---- PHASE 2: Render (main thread only)
@@ -980,7 +1027,7 @@ void RenderLevelSystem(world_t *world, GameWorld *game, Camera *camera) {
 
   // --- Debug overlay HUD ---
   if (game->debugView) {
-    const int pw = 160, ph = 122, px = screenW - pw - 4, py = 180;
+    const int pw = 160, ph = 174, px = screenW - pw - 4, py = 180;
     DrawRectangle(px, py, pw, ph, (Color){0, 0, 0, 180});
     DrawRectangleLines(px, py, pw, ph, (Color){255, 80, 0, 200});
     DrawText("DEBUG [F12]", px + 6, py + 5, 11, (Color){255, 80, 0, 255});
@@ -1011,6 +1058,15 @@ void RenderLevelSystem(world_t *world, GameWorld *game, Camera *camera) {
       SpawnEnemyMelee(world, game, spawnPos);
 
     #undef DBG_BTN
+
+    // AI LOD buckets: enemies updated / skipped and state machine time
+    DrawText("AI LOD  run/skip    ms", px + 6, py + 108, 10, (Color){255, 80, 0, 255});
+    for (int b = 0; b < AI_LOD_BUCKETS; b++) {
+      const AiBucketStats *st = &game->aiScheduler.last[b];
+      DrawText(TextFormat("1/%-2d  %4u/%-4u  %.3f", 1 << b, st->updates,
+                          st->skipped, st->seconds * 1000.0),
+               px + 6, py + 122 + b * 12, 10, (Color){220, 150, 100, 255});
+    }
   }
 
   int centerX = screenW / 2;
@@ -1285,5 +1341,7 @@ void RenderLevelSystem(world_t *world, GameWorld *game, Camera *camera) {
     EndBlendMode();
   }
 
+  if (game->profilerView) DrawProfilerOverlay();
+
   EndDrawing();
 }
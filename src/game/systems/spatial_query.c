@@ -0,0 +1,265 @@
+#include "spatial_query.h"
+#include "../game.h"
+#include "systems.h"
+#include <string.h>
+
+typedef struct {
+  entity_t entity;
+  Vector3 position;
+  uint32_t layerMask;
+} SpatialEntry;
+
+static int s_width;
+static int s_height;
+static Vector3 s_origin;
+static int *s_cellStart; // s_width * s_height + 1
+
+static SpatialEntry *s_entries; // gathered this tick, unsorted
+static SpatialEntry *s_sorted;  // same entries grouped by cell
+static int *s_entryCell;
+static int s_count;
+static int s_capacity;
+
+void SpatialIndex_Reset(void) {
+  free(s_cellStart);
+  free(s_entries);
+  free(s_sorted);
+  free(s_entryCell);
+  s_cellStart = NULL;
+  s_entries = s_sorted = NULL;
+  s_entryCell = NULL;
+  s_width = s_height = s_count = s_capacity = 0;
+}
+
+static bool EnsureGrid(NavGrid *nav) {
+  int w = (int)ceilf(nav->width * nav->cellSize / SPATIAL_CELL_SIZE);
+  int h = (int)ceilf(nav->height * nav->cellSize / SPATIAL_CELL_SIZE);
+
+  if (s_cellStart && w == s_width && h == s_height &&
+      s_origin.x == nav->origin.x && s_origin.z == nav->origin.z)
+    return true;
+
+  free(s_cellStart);
+  s_cellStart = calloc((size_t)w * h + 1, sizeof(int));
+  s_width = s_cellStart ? w : 0;
+  s_height = s_cellStart ? h : 0;
+  s_origin = nav->origin;
+  return s_cellStart != NULL;
+}
+
+static void Push(entity_t e, Vector3 p, uint32_t layerMask) {
+  if (s_count == s_capacity) {
+    int cap = s_capacity ? s_capacity * 2 : 256;
+    SpatialEntry *entries = realloc(s_entries, cap * sizeof(SpatialEntry));
+    if (!entries)
+      return;
+    s_entries = entries;
+    SpatialEntry *sorted = realloc(s_sorted, cap * sizeof(SpatialEntry));
+    if (!sorted)
+      return;
+    s_sorted = sorted;
+    int *cells = realloc(s_entryCell, cap * sizeof(int));
+    if (!cells)
+      return;
+    s_entryCell = cells;
+    s_capacity = cap;
+  }
+  s_entries[s_count++] = (SpatialEntry){e, p, layerMask};
+}
+
+static void CellOf(float x, float z, int *cx, int *cz) {
+  int ix = (int)floorf((x - s_origin.x) / SPATIAL_CELL_SIZE);
+  int iz = (int)floorf((z - s_origin.z) / SPATIAL_CELL_SIZE);
+  *cx = ix < 0 ? 0 : (ix >= s_width ? s_width - 1 : ix);
+  *cz = iz < 0 ? 0 : (iz >= s_height ? s_height - 1 : iz);
+}
+
+// Counting sort into s_sorted so each cell's entries are contiguous
+static void BuildCells(void) {
+  int cellCount = s_width * s_height;
+  memset(s_cellStart, 0, (cellCount + 1) * sizeof(int));
+
+  for (int i = 0; i < s_count; i++) {
+    int cx, cz;
+    CellOf(s_entries[i].position.x, s_entries[i].position.z, &cx, &cz);
+    s_entryCell[i] = cz * s_width + cx;
+    s_cellStart[s_entryCell[i] + 1]++;
+  }
+  for (int c = 0; c < cellCount; c++)
+    s_cellStart[c + 1] += s_cellStart[c];
+  for (int i = 0; i < s_count; i++)
+    s_sorted[s_cellStart[s_entryCell[i]]++] = s_entries[i];
+  for (int c = cellCount; c > 0; c--)
+    s_cellStart[c] = s_cellStart[c - 1];
+  s_cellStart[0] = 0;
+}
+
+void SpatialIndexSystem(world_t *world, GameWorld *game) {
+  s_count = 0;
+  if (!game->navGrid.cells || !EnsureGrid(&game->navGrid))
+    return;
+
+  for (uint32_t a = 0; a < world->archetypeCount; a++) {
+    archetype_t *arch = &world->archetypes[a];
+
+    if (!ArchetypeHas(arch, COMP_POSITION))
+      continue;
+
+    bool hasCollision = ArchetypeHas(arch, COMP_COLLISION_INSTANCE);
+    bool isPickup = ArchetypeHas(arch, COMP_HEALTH_ORB) ||
+                    ArchetypeHas(arch, COMP_COOLANT);
+    if (!hasCollision && !isPickup)
+      continue;
+
+    bool hasActive = ArchetypeHas(arch, COMP_ACTIVE);
+
+    for (uint32_t i = 0; i < arch->count; i++) {
+      entity_t e = arch->entities[i];
+
+      if (hasActive) {
+        Active *active = ECS_GET(world, e, Active, COMP_ACTIVE);
+        if (!active->value)
+          continue;
+      }
+
+      uint32_t layers = isPickup ? (1u << LAYER_PICKUP) : 0;
+      if (hasCollision)
+        layers |= ECS_GET(world, e, CollisionInstance,
+                          COMP_COLLISION_INSTANCE)->layerMask;
+      if (!layers)
+        continue;
+
+      Push(e, ECS_GET(world, e, Position, COMP_POSITION)->value, layers);
+    }
+  }
+
+  BuildCells();
+}
+
+static int QueryRange(Vector3 center, float radius, uint32_t layerMask,
+                      bool planar, entity_t *out, int maxOut) {
+  if (!s_cellStart || s_count == 0 || maxOut <= 0)
+    return 0;
+
+  int x0, z0, x1, z1;
+  CellOf(center.x - radius, center.z - radius, &x0, &z0);
+  CellOf(center.x + radius, center.z + radius, &x1, &z1);
+
+  float r2 = radius * radius;
+  int n = 0;
+
+  for (int z = z0; z <= z1; z++) {
+    for (int x = x0; x <= x1; x++) {
+      int c = z * s_width + x;
+      for (int k = s_cellStart[c]; k < s_cellStart[c + 1]; k++) {
+        const SpatialEntry *se = &s_sorted[k];
+        if (!(se->layerMask & layerMask))
+          continue;
+
+        float dx = se->position.x - center.x;
+        float dz = se->position.z - center.z;
+        float dy = planar ? 0.0f : se->position.y - center.y;
+        if (dx * dx + dy * dy + dz * dz >= r2)
+          continue;
+
+        out[n++] = se->entity;
+        if (n == maxOut)
+          return n;
+      }
+    }
+  }
+  return n;
+}
+
+int WorldQueryRadius(world_t *world, Vector3 center, float radius,
+                     uint32_t layerMask, entity_t *out, int maxOut) {
+  (void)world;
+  return QueryRange(center, radius, layerMask, false, out, maxOut);
+}
+
+int WorldQueryRadiusXZ(world_t *world, Vector3 center, float radius,
+                       uint32_t layerMask, entity_t *out, int maxOut) {
+  (void)world;
+  return QueryRange(center, radius, layerMask, true, out, maxOut);
+}
+
+#define KNN_MAX 32
+
+int WorldQueryKNearest(world_t *world, Vector3 center, float maxRadius,
+                       uint32_t layerMask, entity_t *out, int k) {
+  return WorldQueryKNearestFiltered(world, center, maxRadius, layerMask, NULL,
+                                    NULL, out, k);
+}
+
+int WorldQueryKNearestFiltered(world_t *world, Vector3 center,
+                               float maxRadius, uint32_t layerMask,
+                               SpatialFilterFn filter, void *ctx,
+                               entity_t *out, int k) {
+  if (!s_cellStart || s_count == 0 || k <= 0)
+    return 0;
+  if (k > KNN_MAX)
+    k = KNN_MAX;
+
+  float bestD2[KNN_MAX];
+  entity_t best[KNN_MAX];
+  int n = 0;
+
+  int cx, cz;
+  CellOf(center.x, center.z, &cx, &cz);
+
+  float maxR2 = maxRadius * maxRadius;
+  int maxRing = (int)ceilf(maxRadius / SPATIAL_CELL_SIZE) + 1;
+  int gridSpan = s_width > s_height ? s_width : s_height;
+  if (maxRing > gridSpan)
+    maxRing = gridSpan;
+
+  // Walk square rings outward; every cell in ring r+1 is at least
+  // r * cellSize away, so stop once the k-th best is closer than that.
+  for (int r = 0; r <= maxRing; r++) {
+    float ringMin = (r > 0 ? r - 1 : 0) * SPATIAL_CELL_SIZE;
+    if (ringMin * ringMin > maxR2)
+      break;
+    if (n == k && bestD2[n - 1] <= ringMin * ringMin)
+      break;
+
+    for (int z = cz - r; z <= cz + r; z++) {
+      if (z < 0 || z >= s_height)
+        continue;
+      bool edgeRow = (z == cz - r || z == cz + r);
+
+      for (int x = cx - r; x <= cx + r; x += edgeRow ? 1 : 2 * r) {
+        if (x >= 0 && x < s_width) {
+          int c = z * s_width + x;
+          for (int i = s_cellStart[c]; i < s_cellStart[c + 1]; i++) {
+            const SpatialEntry *se = &s_sorted[i];
+            if (!(se->layerMask & layerMask))
+              continue;
+
+            float dx = se->position.x - center.x;
+            float dz = se->position.z - center.z;
+            float d2 = dx * dx + dz * dz;
+            if (d2 > maxR2 || (n == k && d2 >= bestD2[n - 1]))
+              continue;
+            if (filter && !filter(world, se->entity, ctx))
+              continue;
+
+            // Insertion into the sorted best list
+            int slot = n < k ? n++ : k - 1;
+            while (slot > 0 && bestD2[slot - 1] > d2) {
+              bestD2[slot] = bestD2[slot - 1];
+              best[slot] = best[slot - 1];
+              slot--;
+            }
+            bestD2[slot] = d2;
+            best[slot] = se->entity;
+          }
+        }
+        if (r == 0)
+          break;
+      }
+    }
+  }
+
+  memcpy(out, best, n * sizeof(entity_t));
+  return n;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "../../engine/ecs/world.h"
+#include "raylib.h"
+#include <stdint.h>
+
+typedef struct GameWorld GameWorld;
+
+// Shared XZ spatial index over every active entity that has a Position and
+// either a CollisionInstance (indexed under its layerMask) or is a pickup
+// (LAYER_PICKUP). Rebuilt once per tick by SpatialIndexSystem; positions are
+// as of the start of the tick.
+
+#define SPATIAL_CELL_SIZE 8.0f
+
+void SpatialIndexSystem(world_t *world, GameWorld *game);
+// Frees the index; the next SpatialIndexSystem call rebuilds it.
+void SpatialIndex_Reset(void);
+
+// Entities within a sphere of radius around center.
+int WorldQueryRadius(world_t *world, Vector3 center, float radius,
+                     uint32_t layerMask, entity_t *out, int maxOut);
+
+// Entities within a vertical cylinder (distance measured in XZ only).
+int WorldQueryRadiusXZ(world_t *world, Vector3 center, float radius,
+                       uint32_t layerMask, entity_t *out, int maxOut);
+
+// Up to k entities nearest to center in XZ within maxRadius, closest first.
+int WorldQueryKNearest(world_t *world, Vector3 center, float maxRadius,
+                       uint32_t layerMask, entity_t *out, int k);
+
+// As WorldQueryKNearest, counting only entities filter accepts, so a small
+// k still finds matches behind a crowd of rejected neighbours.
+typedef bool (*SpatialFilterFn)(world_t *world, entity_t e, void *ctx);
+int WorldQueryKNearestFiltered(world_t *world, Vector3 center,
+                               float maxRadius, uint32_t layerMask,
+                               SpatialFilterFn filter, void *ctx,
+                               entity_t *out, int k);
@@ -7,6 +7,8 @@
 #include "../components/transform.h"
 #include "../ecs_get.h"
 #include "../nav_grid/nav.h"
+#include "../nav_grid/path_service.h"
+#include "spatial_query.h"
 #include "raylib.h"
 #include "raymath.h"
 #include <stdint.h>
@@ -34,13 +36,22 @@ void ApplyGravity(world_t *world, GameWorld *game, float dt);
 void MovementSystem(world_t *world, archetype_t *arch, float dt);
 
 void PlayerMoveAndCollide(world_t *world, GameWorld *game, float dt);
-void UpdateCollisionBounds(world_t *world);
+void CollisionMarkStatic(world_t *world, entity_t e);
 void UpdatePlayerCollision(world_t *world, entity_t e);
 void UpdateObstacleCollision(world_t *world, archetype_t *obstacleArch);
 void UpdateBulletCollision(world_t *world, archetype_t *bulletArch);
 
 void RenderLevelSystem(world_t *world, GameWorld *game, Camera *camera);
 
+void TransformSnapshotSystem(world_t *world, TransformHistory *history);
+void TransformHistory_Clear(TransformHistory *history);
+void TransformHistory_Free(TransformHistory *history);
+Vector3 TransformHistory_LerpPosition(const TransformHistory *history,
+                                      entity_t e, Vector3 current, float alpha);
+Orientation TransformHistory_LerpOrientation(const TransformHistory *history,
+                                             entity_t e, Orientation current,
+                                             float alpha);
+
 void RenderMainMenu(GameWorld *game);
 
 void TimerSystem(componentPool_t *timerPool, float dt);
@@ -50,12 +61,47 @@ void EnemyGruntAISystem(world_t *world, GameWorld *game, archetype_t *enemyArch,
                         float dt);
 bool EnemyFollowPath(world_t *world, GameWorld *game, entity_t e,
                      float maxSpeed, float rotateSpeed, float dt);
+// Steers along game->playerFlow. False if the field has no direction here,
+// in which case the caller should fall back to its own path.
+bool EnemyFollowFlow(world_t *world, GameWorld *game, entity_t e,
+                     float maxSpeed, float rotateSpeed, float dt);
+// Node expansions per tick spent rebuilding the player flow field
+#define PLAYER_FLOW_BUDGET 4096
+// Integrates game->playerFlow toward the player, avoiding cells too narrow
+// for the melee capsule
+void PlayerFlowFieldSystem(world_t *world, GameWorld *game);
+// Recasts game->playerVis when the player changes nav cells or the grid is
+// edited; enemy LOS and tactical scoring read it
+void PlayerVisibilitySystem(world_t *world, GameWorld *game);
+// Brings game->tactical up to date with grid edits and the latest recast
+void TacticalMapSystem(world_t *world, GameWorld *game);
+// Streams game->terrainTiles around the player and active enemies. Runs on
+// the main thread at the start of a tick, before anything samples heights.
+#define TERRAIN_STREAM_RADIUS 24.0f
+void TerrainStreamSystem(world_t *world, GameWorld *game);
+void TerrainStream_Free(GameWorld *game);
+const float *SampleArchetypeGround(world_t *world, GameWorld *game,
+                                   archetype_t *arch);
+void GroundSamples_Free(GameWorld *game);
+// Agent radius for radius-aware paths: the capsule's, or 0 without one.
+float EnemyNavRadius(world_t *world, entity_t e);
 bool EnemyPathQueue_Submit(NavGrid *grid, Vector3 start, Vector3 goal,
-                           NavPath *outPath, bool *pendingFlag,
-                           CombatState_t *combat, entity_t owner);
+                           float radius, bool *pendingFlag, entity_t owner,
+                           PathPriority priority);
 void EnemyPathQueue_Reset(void);
+// Inline search budget when the path service has no worker threads
 #define NAV_PATHS_PER_FRAME 2
 void EnemyPathQueue_Flush(world_t *world, int maxPerFrame);
+// Runtime nav edits (gates, destructible cover, barricades). Queued edits
+// apply at the next NavDynamicSystem, which then repairs every path they
+// cut with per-agent incremental searches instead of new path requests.
+#define NAV_REPAIR_SLOTS  8    // agents with live repair state
+#define NAV_REPAIR_BUDGET 4096 // node expansions per tick across all repairs
+void NavDynamic_SetCell(int x, int y, NavCellType type);
+void NavDynamic_SetArea(GameWorld *game, Vector3 min, Vector3 max,
+                        NavCellType type);
+void NavDynamic_Reset(void);
+void NavDynamicSystem(world_t *world, GameWorld *game);
 void EnemyAimSystem(world_t *world, GameWorld *game, archetype_t *enemyArch,
                     float dt);
 void EnemyFireSystem(world_t *world, GameWorld *game, archetype_t *enemyArch);
@@ -79,6 +125,7 @@ void ParticleSystem(world_t *world, archetype_t *arch, float dt);
 
 void EnemyMeleeAISystem(world_t *world, GameWorld *game,
                          archetype_t *arch, float dt);
+void CrowdSystem(world_t *world, GameWorld *game, float dt);
 
 void DrawSpawnerWireframes(world_t *world, uint32_t spawnerArchId);
 
@@ -0,0 +1,372 @@
+#include "tactical_map.h"
+#include "enemy_behaviour.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Block refresh flags
+#define DIRTY_COVER   1
+#define DIRTY_THREAT  2
+#define DIRTY_SUMMARY 4
+
+// Ally spacing rings, as squared cell distances
+static const int s_ringDist2[TACTICAL_ALLY_RINGS] = {12, 35, 64}; // < 3.5, < 6, <= 8
+#define ALLY_REACH 8
+#define ALLY_CLEAR 10.0f // tactical: nobody within 8 cells
+
+#define DRIFT_BONUS    15.0f // tactical: moving at least 5 m closer to the player
+#define RETREAT_WEIGHT 0.8f  // retreat: score per metre gained from the player
+
+/* ------------------------------------------------------------------ */
+/*  Per-cell values                                                   */
+/* ------------------------------------------------------------------ */
+
+static float CoverValue(TacticalRole role, NavCellType type) {
+  if (role == TACTICAL_GRUNT) {
+    switch (type) {
+    case NAV_CELL_COVER_LOW:  return 35.0f;
+    case NAV_CELL_COVER_HIGH: return 25.0f;
+    case NAV_CELL_FLANK:      return 30.0f;
+    case NAV_CELL_SNIPE:      return  5.0f;
+    default:                  return  0.0f;
+    }
+  }
+  switch (type) {
+  case NAV_CELL_SNIPE:      return  50.0f;
+  case NAV_CELL_COVER_HIGH: return  10.0f;
+  case NAV_CELL_COVER_LOW:  return   5.0f;
+  case NAV_CELL_FLANK:      return -10.0f;
+  default:                  return   0.0f;
+  }
+}
+
+static float RetreatCoverValue(TacticalRole role, NavCellType type) {
+  if (role == TACTICAL_GRUNT) {
+    if (type == NAV_CELL_COVER_HIGH) return 60.0f;
+    if (type == NAV_CELL_COVER_LOW)  return 30.0f;
+    return 0.0f;
+  }
+  return type == NAV_CELL_SNIPE ? 50.0f : 0.0f;
+}
+
+static const float s_minDist[TACTICAL_ROLE_COUNT] = {GRUNT_MIN_DIST, RANGER_MIN_DIST};
+static const float s_maxDist[TACTICAL_ROLE_COUNT] = {GRUNT_MAX_DIST, RANGER_MAX_DIST};
+
+static inline float AllyTactical(const TacticalMap *m, int idx) {
+  if (m->ally[0][idx]) return TACTICAL_UNUSABLE;
+  if (m->ally[1][idx]) return -15.0f;
+  if (m->ally[2][idx]) return 0.0f;
+  return ALLY_CLEAR;
+}
+
+// AllyTactical at (x, y) without the claim stamped at (ignoreX, ignoreY)
+static float AllyTacticalIgnoring(const TacticalMap *m, int x, int y,
+                                  int ignoreX, int ignoreY) {
+  int idx = y * m->grid->width + x;
+  if (ignoreX < 0) return AllyTactical(m, idx);
+  int d2 = (x - ignoreX) * (x - ignoreX) + (y - ignoreY) * (y - ignoreY);
+  int count[TACTICAL_ALLY_RINGS];
+  for (int i = 0; i < TACTICAL_ALLY_RINGS; i++)
+    count[i] = m->ally[i][idx] - (d2 <= s_ringDist2[i] ? 1 : 0);
+  if (count[0] > 0) return TACTICAL_UNUSABLE;
+  if (count[1] > 0) return -15.0f;
+  if (count[2] > 0) return 0.0f;
+  return ALLY_CLEAR;
+}
+
+static inline float AllyRetreat(const TacticalMap *m, int idx) {
+  return m->ally[0][idx] ? -30.0f : 0.0f;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Lifecycle                                                         */
+/* ------------------------------------------------------------------ */
+
+void TacticalMap_Init(TacticalMap *m, NavGrid *grid, float arenaRadius) {
+  int cells = grid->width * grid->height;
+  memset(m, 0, sizeof(*m));
+  m->grid        = grid;
+  m->arenaRadius = arenaRadius;
+  m->blocksX     = (grid->width + TACTICAL_BLOCK - 1) / TACTICAL_BLOCK;
+  m->blocksY     = (grid->height + TACTICAL_BLOCK - 1) / TACTICAL_BLOCK;
+  int blocks     = m->blocksX * m->blocksY;
+
+  for (int r = 0; r < TACTICAL_ROLE_COUNT; r++) {
+    m->cover[r]        = malloc(sizeof(float) * cells);
+    m->retreatCover[r] = malloc(sizeof(float) * cells);
+    m->threat[r]       = malloc(sizeof(float) * cells);
+    m->summary[r]      = malloc(sizeof(TacticalSummary) * blocks);
+  }
+  m->playerDist = malloc(sizeof(float) * cells);
+  for (int i = 0; i < TACTICAL_ALLY_RINGS; i++)
+    m->ally[i] = calloc(cells, sizeof(uint16_t));
+  m->blockDirty = malloc(blocks);
+  memset(m->blockDirty, DIRTY_COVER | DIRTY_THREAT | DIRTY_SUMMARY, blocks);
+  m->playerX      = -1;
+  m->playerY      = -1;
+  m->gridRevision = grid->revision;
+}
+
+void TacticalMap_Destroy(TacticalMap *m) {
+  for (int r = 0; r < TACTICAL_ROLE_COUNT; r++) {
+    free(m->cover[r]);
+    free(m->retreatCover[r]);
+    free(m->threat[r]);
+    free(m->summary[r]);
+  }
+  free(m->playerDist);
+  for (int i = 0; i < TACTICAL_ALLY_RINGS; i++) free(m->ally[i]);
+  free(m->blockDirty);
+  memset(m, 0, sizeof(*m));
+}
+
+static void MarkAll(TacticalMap *m, uint8_t flags) {
+  int blocks = m->blocksX * m->blocksY;
+  for (int b = 0; b < blocks; b++) m->blockDirty[b] |= flags;
+}
+
+void TacticalMap_Update(TacticalMap *m, const NavVisibility *playerVis) {
+  if (m->grid->revision != m->gridRevision) {
+    m->gridRevision = m->grid->revision;
+    MarkAll(m, DIRTY_COVER | DIRTY_THREAT | DIRTY_SUMMARY);
+  }
+  if (playerVis->originX != m->playerX || playerVis->originY != m->playerY ||
+      playerVis->revision != m->visRevision) {
+    m->playerX     = playerVis->originX;
+    m->playerY     = playerVis->originY;
+    m->visRevision = playerVis->revision;
+    MarkAll(m, DIRTY_THREAT | DIRTY_SUMMARY);
+  }
+  m->vis = playerVis;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Block refresh                                                     */
+/*  Layers are only brought up to date where a query looks, so a      */
+/*  player moving between cells costs nothing until somebody asks.    */
+/* ------------------------------------------------------------------ */
+
+static void RefreshBlock(TacticalMap *m, int bx, int by) {
+  int      b     = by * m->blocksX + bx;
+  uint8_t  dirty = m->blockDirty[b];
+  if (!dirty) return;
+
+  NavGrid *g  = m->grid;
+  int      x0 = bx * TACTICAL_BLOCK, y0 = by * TACTICAL_BLOCK;
+  int      x1 = x0 + TACTICAL_BLOCK > g->width  ? g->width  : x0 + TACTICAL_BLOCK;
+  int      y1 = y0 + TACTICAL_BLOCK > g->height ? g->height : y0 + TACTICAL_BLOCK;
+  float    r2 = m->arenaRadius * m->arenaRadius;
+  Vector3  pc = m->playerX >= 0 ? NavGrid_CellCenter(g, m->playerX, m->playerY)
+                                : (Vector3){0};
+
+  TacticalSummary best[TACTICAL_ROLE_COUNT];
+  for (int r = 0; r < TACTICAL_ROLE_COUNT; r++)
+    best[r] = (TacticalSummary){TACTICAL_UNUSABLE, TACTICAL_UNUSABLE,
+                                TACTICAL_UNUSABLE};
+
+  for (int y = y0; y < y1; y++) {
+    for (int x = x0; x < x1; x++) {
+      int         idx  = y * g->width + x;
+      NavCellType type = g->cells[idx].type;
+      Vector3     c    = NavGrid_CellCenter(g, x, y);
+
+      if (dirty & DIRTY_COVER) {
+        bool unusable = type == NAV_CELL_WALL || type == NAV_CELL_BLOCKED ||
+                        type == NAV_CELL_FENCE || c.x * c.x + c.z * c.z > r2;
+        for (int r = 0; r < TACTICAL_ROLE_COUNT; r++) {
+          m->cover[r][idx]        = unusable ? TACTICAL_UNUSABLE : CoverValue(r, type);
+          m->retreatCover[r][idx] = unusable ? TACTICAL_UNUSABLE : RetreatCoverValue(r, type);
+        }
+      }
+
+      if (dirty & DIRTY_THREAT) {
+        float dx = c.x - pc.x, dz = c.z - pc.z;
+        float d  = sqrtf(dx * dx + dz * dz);
+        bool  cover = type == NAV_CELL_COVER_LOW || type == NAV_CELL_COVER_HIGH;
+        float fire  = 0.0f;
+        if (NavVisibility_TestCell(m->vis, x, y))
+          fire = TACTICAL_LOS_BONUS;
+        else if (cover && NavVisibility_PeekCell(m->vis, x, y))
+          fire = TACTICAL_PEEK_BONUS;
+        m->playerDist[idx] = d;
+        for (int r = 0; r < TACTICAL_ROLE_COUNT; r++)
+          m->threat[r][idx] =
+              fire + ((d >= s_minDist[r] && d <= s_maxDist[r]) ? 20.0f : 0.0f);
+      }
+
+      float allyT = AllyTactical(m, idx), allyR = AllyRetreat(m, idx);
+      for (int r = 0; r < TACTICAL_ROLE_COUNT; r++) {
+        if (m->cover[r][idx] <= TACTICAL_UNUSABLE) continue;
+        float open = m->cover[r][idx] + m->threat[r][idx];
+        if (open > best[r].open) best[r].open = open;
+        if (allyT > TACTICAL_UNUSABLE && open + allyT > best[r].tactical)
+          best[r].tactical = open + allyT;
+        float rt = m->retreatCover[r][idx] + RETREAT_WEIGHT * m->playerDist[idx] + allyR;
+        if (rt > best[r].retreat) best[r].retreat = rt;
+      }
+    }
+  }
+
+  for (int r = 0; r < TACTICAL_ROLE_COUNT; r++) m->summary[r][b] = best[r];
+  m->blockDirty[b] = 0;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Allies                                                            */
+/* ------------------------------------------------------------------ */
+
+void TacticalMap_AddAlly(TacticalMap *m, int cx, int cy, int delta) {
+  NavGrid *g = m->grid;
+  if (!m->blockDirty || !NavGrid_InBounds(g, cx, cy)) return;
+  for (int y = cy - ALLY_REACH; y <= cy + ALLY_REACH; y++) {
+    for (int x = cx - ALLY_REACH; x <= cx + ALLY_REACH; x++) {
+      if (!NavGrid_InBounds(g, x, y)) continue;
+      int d2  = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+      int idx = y * g->width + x;
+      for (int i = 0; i < TACTICAL_ALLY_RINGS; i++)
+        if (d2 <= s_ringDist2[i]) m->ally[i][idx] += delta;
+    }
+  }
+  int bx0 = (cx - ALLY_REACH) / TACTICAL_BLOCK, bx1 = (cx + ALLY_REACH) / TACTICAL_BLOCK;
+  int by0 = (cy - ALLY_REACH) / TACTICAL_BLOCK, by1 = (cy + ALLY_REACH) / TACTICAL_BLOCK;
+  for (int by = by0 < 0 ? 0 : by0; by <= by1 && by < m->blocksY; by++)
+    for (int bx = bx0 < 0 ? 0 : bx0; bx <= bx1 && bx < m->blocksX; bx++)
+      m->blockDirty[by * m->blocksX + bx] |= DIRTY_SUMMARY;
+}
+
+void TacticalMap_ClearAllies(TacticalMap *m) {
+  if (!m->blockDirty) return;
+  int cells = m->grid->width * m->grid->height;
+  for (int i = 0; i < TACTICAL_ALLY_RINGS; i++)
+    memset(m->ally[i], 0, sizeof(uint16_t) * cells);
+  MarkAll(m, DIRTY_SUMMARY);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Queries                                                           */
+/* ------------------------------------------------------------------ */
+
+float TacticalMap_Score(TacticalMap *m, TacticalRole role, int cx, int cy,
+                        float selfDist, int ignoreX, int ignoreY) {
+  if (!NavGrid_InBounds(m->grid, cx, cy)) return TACTICAL_UNUSABLE;
+  RefreshBlock(m, cx / TACTICAL_BLOCK, cy / TACTICAL_BLOCK);
+  int   idx  = cy * m->grid->width + cx;
+  float ally = AllyTacticalIgnoring(m, cx, cy, ignoreX, ignoreY);
+  if (m->cover[role][idx] <= TACTICAL_UNUSABLE || ally <= TACTICAL_UNUSABLE)
+    return TACTICAL_UNUSABLE;
+  float score = m->cover[role][idx] + m->threat[role][idx] + ally;
+  if (m->playerDist[idx] < selfDist - 5.0f) score += DRIFT_BONUS;
+  return score;
+}
+
+static float RetreatScore(const TacticalMap *m, TacticalRole role, int idx,
+                          float selfDist) {
+  if (m->retreatCover[role][idx] <= TACTICAL_UNUSABLE) return TACTICAL_UNUSABLE;
+  if (m->playerDist[idx] < selfDist - 2.0f) return TACTICAL_UNUSABLE;
+  return m->retreatCover[role][idx] +
+         RETREAT_WEIGHT * (m->playerDist[idx] - selfDist) + AllyRetreat(m, idx);
+}
+
+typedef struct {
+  float bound;
+  int   bx, by;
+} BlockBound;
+
+// Whether block (bx, by) holds cells within reach of the claim at (ix, iy)
+static bool NearClaim(int bx, int by, int ix, int iy) {
+  if (ix < 0) return false;
+  return bx >= (ix - ALLY_REACH) / TACTICAL_BLOCK &&
+         bx <= (ix + ALLY_REACH) / TACTICAL_BLOCK &&
+         by >= (iy - ALLY_REACH) / TACTICAL_BLOCK &&
+         by <= (iy + ALLY_REACH) / TACTICAL_BLOCK;
+}
+
+// Blocks touching the move circle, ordered by the best score they allow.
+// Summaries count every claim, so blocks near the ignored one are bounded by
+// their ally-free score instead.
+static int GatherBlocks(TacticalMap *m, TacticalRole role, Vector3 from,
+                        float maxMove, float selfDist, bool retreat,
+                        int ignoreX, int ignoreY, BlockBound *out, int cap) {
+  NavGrid *g   = m->grid;
+  float    cs  = g->cellSize * TACTICAL_BLOCK;
+  float    fx  = from.x - g->origin.x, fz = from.z - g->origin.z;
+  int      bx0 = (int)floorf((fx - maxMove) / cs), bx1 = (int)floorf((fx + maxMove) / cs);
+  int      by0 = (int)floorf((fz - maxMove) / cs), by1 = (int)floorf((fz + maxMove) / cs);
+  int      n   = 0;
+
+  for (int by = by0 < 0 ? 0 : by0; by <= by1 && by < m->blocksY; by++) {
+    for (int bx = bx0 < 0 ? 0 : bx0; bx <= bx1 && bx < m->blocksX; bx++) {
+      // Nearest point of the block to the mover
+      float nx = Clamp(fx, bx * cs, (bx + 1) * cs);
+      float nz = Clamp(fz, by * cs, (by + 1) * cs);
+      if ((nx - fx) * (nx - fx) + (nz - fz) * (nz - fz) > maxMove * maxMove) continue;
+
+      RefreshBlock(m, bx, by);
+      const TacticalSummary *s = &m->summary[role][by * m->blocksX + bx];
+      float best  = retreat                               ? s->retreat
+                    : NearClaim(bx, by, ignoreX, ignoreY) ? s->open + ALLY_CLEAR
+                                                          : s->tactical;
+      if (best <= TACTICAL_UNUSABLE) continue;
+      float bound = retreat ? best - RETREAT_WEIGHT * selfDist
+                            : best + DRIFT_BONUS;
+      if (n >= cap) break;
+
+      // Insertion keeps the list sorted, best bound first
+      int i = n++;
+      while (i > 0 && out[i - 1].bound < bound) {
+        out[i] = out[i - 1];
+        i--;
+      }
+      out[i] = (BlockBound){bound, bx, by};
+    }
+  }
+  return n;
+}
+
+#define TACTICAL_MAX_BLOCKS 256
+
+static bool Best(TacticalMap *m, TacticalRole role, Vector3 from, float maxMove,
+                 float selfDist, bool retreat, int ignoreX, int ignoreY,
+                 int *outX, int *outY) {
+  BlockBound blocks[TACTICAL_MAX_BLOCKS];
+  int n = GatherBlocks(m, role, from, maxMove, selfDist, retreat, ignoreX,
+                       ignoreY, blocks, TACTICAL_MAX_BLOCKS);
+
+  NavGrid *g         = m->grid;
+  float    bestScore = TACTICAL_UNUSABLE;
+  float    move2     = maxMove * maxMove;
+  for (int k = 0; k < n && blocks[k].bound > bestScore; k++) {
+    int x0 = blocks[k].bx * TACTICAL_BLOCK, y0 = blocks[k].by * TACTICAL_BLOCK;
+    int x1 = x0 + TACTICAL_BLOCK > g->width  ? g->width  : x0 + TACTICAL_BLOCK;
+    int y1 = y0 + TACTICAL_BLOCK > g->height ? g->height : y0 + TACTICAL_BLOCK;
+    for (int y = y0; y < y1; y++) {
+      for (int x = x0; x < x1; x++) {
+        Vector3 c  = NavGrid_CellCenter(g, x, y);
+        float   dx = c.x - from.x, dz = c.z - from.z;
+        if (dx * dx + dz * dz > move2) continue;
+        float score = retreat
+                          ? RetreatScore(m, role, y * g->width + x, selfDist)
+                          : TacticalMap_Score(m, role, x, y, selfDist,
+                                              ignoreX, ignoreY);
+        if (score > bestScore) {
+          bestScore = score;
+          *outX     = x;
+          *outY     = y;
+        }
+      }
+    }
+  }
+  return bestScore > TACTICAL_UNUSABLE;
+}
+
+bool TacticalMap_BestTactical(TacticalMap *m, TacticalRole role, Vector3 from,
+                              float maxMove, float selfDist, int ignoreX,
+                              int ignoreY, int *outX, int *outY) {
+  return Best(m, role, from, maxMove, selfDist, false, ignoreX, ignoreY, outX,
+              outY);
+}
+
+bool TacticalMap_BestRetreat(TacticalMap *m, TacticalRole role, Vector3 from,
+                             float maxMove, float selfDist, int *outX, int *outY) {
+  return Best(m, role, from, maxMove, selfDist, true, -1, -1, outX, outY);
+}
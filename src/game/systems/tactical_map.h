@@ -0,0 +1,75 @@
+#pragma once
+#include "../nav_grid/nav.h"
+#include "../nav_grid/nav_visibility.h"
+#include <stdbool.h>
+
+// Layered influence maps over the nav grid for enemy position selection:
+//   cover   - what each cell's type is worth to a role (static until edits)
+//   threat  - player-relative value: combat range band and line of fire,
+//             refreshed when the player visibility map recasts
+//   ally    - how many claimed positions lie within each spacing ring,
+//             stamped and unstamped as claims come and go
+// Cells are grouped into TACTICAL_BLOCK-sized blocks that keep their best
+// base score. Queries walk the blocks in a move radius best-bound first and
+// only scan cells of blocks that can still beat the best found so far.
+
+#define TACTICAL_BLOCK      8
+#define TACTICAL_UNUSABLE   (-9999.0f)
+#define TACTICAL_ALLY_RINGS 3 // claims within 3.5, 6 and 8 cells
+
+typedef enum {
+  TACTICAL_GRUNT = 0,
+  TACTICAL_RANGER,
+  TACTICAL_ROLE_COUNT,
+} TacticalRole;
+
+typedef struct {
+  float tactical; // best cover + threat + ally in the block
+  float open;     // best cover + threat, ignoring allies
+  float retreat;  // best retreat cover + ally + distance from the player
+} TacticalSummary;
+
+typedef struct {
+  NavGrid *grid;
+  float    arenaRadius;
+  int      blocksX, blocksY;
+
+  float    *cover[TACTICAL_ROLE_COUNT];        // TACTICAL_UNUSABLE: never pick
+  float    *retreatCover[TACTICAL_ROLE_COUNT];
+  float    *threat[TACTICAL_ROLE_COUNT];
+  float    *playerDist;                        // cell centre to player cell centre
+  uint16_t *ally[TACTICAL_ALLY_RINGS];
+
+  TacticalSummary *summary[TACTICAL_ROLE_COUNT];
+  uint8_t         *blockDirty;
+
+  uint32_t gridRevision; // layers were built against these
+  int      playerX, playerY;
+  uint32_t visRevision;
+  const NavVisibility *vis;
+} TacticalMap;
+
+void TacticalMap_Init(TacticalMap *m, NavGrid *grid, float arenaRadius);
+void TacticalMap_Destroy(TacticalMap *m);
+// Invalidates the cover layer after grid edits and the threat layer after the
+// player visibility map recasts; blocks are rebuilt when a query next reaches
+// them. Call once per tick, after the recast.
+void TacticalMap_Update(TacticalMap *m, const NavVisibility *playerVis);
+
+// Stamps (+1) or removes (-1) a claimed position's spacing rings.
+void TacticalMap_AddAlly(TacticalMap *m, int cx, int cy, int delta);
+void TacticalMap_ClearAllies(TacticalMap *m);
+
+// Score of one cell for a tactical move by an enemy selfDist from the player.
+// The claim stamped at (ignoreX, ignoreY) - the mover's own - is not counted
+// against it; pass -1 when the mover holds no claim.
+float TacticalMap_Score(TacticalMap *m, TacticalRole role, int cx, int cy,
+                        float selfDist, int ignoreX, int ignoreY);
+// Best cell within maxMove of from, ignoring the claim at (ignoreX, ignoreY)
+// as TacticalMap_Score does. False if none is usable.
+bool TacticalMap_BestTactical(TacticalMap *m, TacticalRole role, Vector3 from,
+                              float maxMove, float selfDist, int ignoreX,
+                              int ignoreY, int *outX, int *outY);
+// Best cell within maxMove of from that doesn't close on the player.
+bool TacticalMap_BestRetreat(TacticalMap *m, TacticalRole role, Vector3 from,
+                             float maxMove, float selfDist, int *outX, int *outY);
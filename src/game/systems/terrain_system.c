@@ -0,0 +1,62 @@
+#include "../game.h"
+#include "systems.h"
+
+// Keeps the terrain tiles around the player and every active enemy
+// resident; tiles nobody stands near are evicted past the tile budget.
+// Queries outside the streamed area still work, they just build their
+// tile on first use.
+
+static bool PushStreamPoint(GameWorld *game, int *count, Vector3 p) {
+  if (*count == game->terrainStreamCap) {
+    int cap = game->terrainStreamCap ? game->terrainStreamCap * 2 : 64;
+    Vector3 *points =
+        realloc(game->terrainStreamPoints, sizeof(Vector3) * cap);
+    if (!points)
+      return false;
+    game->terrainStreamPoints = points;
+    game->terrainStreamCap = cap;
+  }
+  game->terrainStreamPoints[(*count)++] = p;
+  return true;
+}
+
+static void PushArchetype(world_t *world, GameWorld *game, uint32_t archId,
+                          int *count) {
+  archetype_t *arch = WorldGetArchetype(world, archId);
+  if (!arch)
+    return;
+
+  for (uint32_t i = 0; i < arch->count; i++) {
+    entity_t e = arch->entities[i];
+    Active *active = ECS_GET(world, e, Active, COMP_ACTIVE);
+    if (active && !active->value)
+      continue;
+    Position *pos = ECS_GET(world, e, Position, COMP_POSITION);
+    if (pos && !PushStreamPoint(game, count, pos->value))
+      return;
+  }
+}
+
+void TerrainStreamSystem(world_t *world, GameWorld *game) {
+  if (!game->terrainTiles.tiles)
+    return;
+
+  int count = 0;
+  Position *ppos = ECS_GET(world, game->player, Position, COMP_POSITION);
+  if (ppos)
+    PushStreamPoint(game, &count, ppos->value);
+
+  PushArchetype(world, game, game->enemyGruntArchId, &count);
+  PushArchetype(world, game, game->enemyRangerArchId, &count);
+  PushArchetype(world, game, game->enemyMeleeArchId, &count);
+  PushArchetype(world, game, game->enemyDroneArchId, &count);
+
+  TiledHeightMap_Stream(&game->terrainTiles, game->terrainStreamPoints, count,
+                        TERRAIN_STREAM_RADIUS);
+}
+
+void TerrainStream_Free(GameWorld *game) {
+  free(game->terrainStreamPoints);
+  game->terrainStreamPoints = NULL;
+  game->terrainStreamCap = 0;
+}
@@ -1,7 +1,10 @@
 #include "world_spawn.h"
 #include "../engine/util/json_reader.h"
+#include "../engine/util/profiler.h"
 #include "archetype_loader.h"
+#include "assets.h"
 #include "level_creater_helper.h"
+#include "nav_grid/nav_bake.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -193,46 +196,47 @@ GameWorld GameWorldCreate(Engine *engine, world_t *world) {
   gw.arenaRadius = 175.0;
 
   gw.fov        = 75.0f;
+  gw.simTickRate = SIM_DEFAULT_TICK_RATE;
   gw.resWidth   = 1280;
   gw.resHeight  = 720;
   gw.fullscreen = false;
 
   gw.soundSystem = InitSoundSystem();
 
-  gw.terrainModel  = LoadModel("assets/models/terrain-level1.glb");
+  gw.terrainModel  = Assets_LoadModel("assets/models/terrain-level1.glb");
   strncpy(gw.terrainModelPath, "assets/models/terrain-level1.glb",
           sizeof(gw.terrainModelPath) - 1);
-  gw.obstacleModel      = LoadModel("assets/models/obstacle.glb");
-  gw.infoBoxMarkerModel = LoadModel("assets/models/exclamation-mark.glb");
-  gw.gunModel           = LoadModel("assets/models/gun1.glb");
-  gw.plasmaGunModel     = LoadModel("assets/models/gun2-plasma.glb");
-  gw.rocketLauncherModel = LoadModel("assets/models/gun3-rocketlauncher.glb");
-  gw.blunderbussModel    = LoadModel("assets/models/gun4-blunderbus.glb");
-  gw.missileModel        = LoadModel("assets/models/gun-3-1-missile.glb");
-  gw.harpoonModel        = LoadModel("assets/models/gun4-1-harpoon.glb");
-  gw.bulletModel   = LoadModel("assets/models/bullet.glb");
+  gw.obstacleModel      = Assets_LoadModel("assets/models/obstacle.glb");
+  gw.infoBoxMarkerModel = Assets_LoadModel("assets/models/exclamation-mark.glb");
+  gw.gunModel           = Assets_LoadModel("assets/models/gun1.glb");
+  gw.plasmaGunModel     = Assets_LoadModel("assets/models/gun2-plasma.glb");
+  gw.rocketLauncherModel = Assets_LoadModel("assets/models/gun3-rocketlauncher.glb");
+  gw.blunderbussModel    = Assets_LoadModel("assets/models/gun4-blunderbus.glb");
+  gw.missileModel        = Assets_LoadModel("assets/models/gun-3-1-missile.glb");
+  gw.harpoonModel        = Assets_LoadModel("assets/models/gun4-1-harpoon.glb");
+  gw.bulletModel   = Assets_LoadModel("assets/models/bullet.glb");
   gw.sunDirection  = Vector3Normalize((Vector3){0.6f, -0.5f, 0.25f});
-  gw.enemyModel    = LoadModel("assets/models/enemy-target.glb");
-  gw.gruntGun      = LoadModel("assets/models/enemies/grunt/grunt-gun.glb");
-  gw.gruntSaw      = LoadModel("assets/models/enemies/grunt/saw.glb");
-  gw.gruntLegs     = LoadModel("assets/models/enemies/grunt/grunt-legs.glb");
-  gw.gruntTorso    = LoadModel("assets/models/enemies/grunt/grunt-torso.glb");
-  gw.rangerLegs    = LoadModel("assets/models/enemies/ranger/ranger-legs.glb");
-  gw.rangerTorso   = LoadModel("assets/models/enemies/ranger/ranger-torso.glb");
-
-  gw.outlineShader       = LoadShader("assets/shaders/outline.vs",
-                                      "assets/shaders/outline.fs");
-  gw.outlineColorLoc     = GetShaderLocation(gw.outlineShader, "outlineColor");
-  gw.outlineThicknessLoc = GetShaderLocation(gw.outlineShader, "outlineThickness");
-
-  gw.terrainShader = LoadShader("assets/shaders/terrain.vs",
-                                "assets/shaders/terrain.fs");
+  gw.enemyModel    = Assets_LoadModel("assets/models/enemy-target.glb");
+  gw.gruntGun      = Assets_LoadModel("assets/models/enemies/grunt/grunt-gun.glb");
+  gw.gruntSaw      = Assets_LoadModel("assets/models/enemies/grunt/saw.glb");
+  gw.gruntLegs     = Assets_LoadModel("assets/models/enemies/grunt/grunt-legs.glb");
+  gw.gruntTorso    = Assets_LoadModel("assets/models/enemies/grunt/grunt-torso.glb");
+  gw.rangerLegs    = Assets_LoadModel("assets/models/enemies/ranger/ranger-legs.glb");
+  gw.rangerTorso   = Assets_LoadModel("assets/models/enemies/ranger/ranger-torso.glb");
+
+  gw.outlineShader       = Assets_LoadShader("assets/shaders/outline.vs",
+                                             "assets/shaders/outline.fs");
+  gw.outlineColorLoc     = Assets_ShaderLocation(gw.outlineShader, "outlineColor");
+  gw.outlineThicknessLoc = Assets_ShaderLocation(gw.outlineShader, "outlineThickness");
+
+  gw.terrainShader = Assets_LoadShader("assets/shaders/terrain.vs",
+                                       "assets/shaders/terrain.fs");
   for (int mi = 0; mi < gw.terrainModel.materialCount; mi++)
     gw.terrainModel.materials[mi].shader = gw.terrainShader;
 
-  gw.shadowShader   = LoadShader("assets/shaders/shadow.vs",
-                                  "assets/shaders/shadow.fs");
-  gw.shadowAlphaLoc = GetShaderLocation(gw.shadowShader, "shadowAlpha");
+  gw.shadowShader   = Assets_LoadShader("assets/shaders/shadow.vs",
+                                         "assets/shaders/shadow.fs");
+  gw.shadowAlphaLoc = Assets_ShaderLocation(gw.shadowShader, "shadowAlpha");
 
   RegisterAllArchetypes(engine, &gw, world);
 
@@ -345,7 +349,7 @@ static Model GetOrLoadPropModel(const char *path) {
     if (strcmp(s_propModelPaths[i], path) == 0) return s_propModels[i];
   if (s_propModelCount < MAX_PROP_MODELS) {
     strncpy(s_propModelPaths[s_propModelCount], path, 255);
-    s_propModels[s_propModelCount] = LoadModel(path);
+    s_propModels[s_propModelCount] = Assets_LoadModel(path);
     return s_propModels[s_propModelCount++];
   }
   return s_propModels[0]; // cache full, reuse first
@@ -608,12 +612,80 @@ static int LoadTargetsFromJSON(const char *text, LevelTarget *targets, int maxCo
   return count;
 }
 
-static void SpawnLevelBase(world_t *world, GameWorld *gw, const char *navmapPath) {
-  MessageSystem_Init(&gw->messageSystem);
+void LoadTerrainHeightMap(GameWorld *gw) {
+  const char *cachePath = gw->terrainModelPath[0]
+                              ? TextFormat("%s.hmap", gw->terrainModelPath)
+                              : NULL;
+  HeightMap_Free(&gw->terrainHeightMap);
+  TiledHeightMap_Free(&gw->terrainTiles);
+#ifdef GAME_HEADLESS
+  // The stub terrain is only a box. Take the real surface from a cache the
+  // windowed build left behind, and never overwrite it with the box.
+  if (cachePath && HeightMap_LoadCache(cachePath, &gw->terrainHeightMap))
+    return;
+  cachePath = NULL;
+#endif
+  Mesh mesh = gw->terrainModel.meshes[0];
+  HeightMapMeshData data = HeightMap_MeshData(mesh);
+
+  // raylib narrows glTF indices to 16 bits, so take the triangles from the
+  // file. Its vertices are kept when they line up, being what gets drawn;
+  // headless builds only have the stub's box and use the file's.
+  AssetTriangles tris = {0};
+  if (gw->terrainModelPath[0] &&
+      Assets_LoadTriangles(gw->terrainModelPath, &tris)) {
+    data.indices16 = NULL;
+    data.indices32 = tris.indices;
+    data.triangleCount = tris.triangleCount;
+    if (tris.vertexCount != mesh.vertexCount) {
+      data.vertices = tris.vertices;
+      data.vertexCount = tris.vertexCount;
+    }
+  }
+
   gw->terrainHeightMap =
-      HeightMap_FromMesh(gw->terrainModel.meshes[0], MatrixIdentity());
+      HeightMap_FromMeshDataCached(&data, MatrixIdentity(), cachePath);
+
+  // Tiles only bin the triangles here; TerrainStreamSystem rasterizes them
+  // around the player and enemies as they move.
+  TiledHeightMapDesc desc = TiledHeightMap_DefaultDesc();
+  gw->terrainTiles = TiledHeightMap_Create(&data, MatrixIdentity(), &desc);
+  Assets_FreeTriangles(&tris);
+}
+
+// Geometry and settings for baking a level's nav grid
+typedef struct {
+  NavBakeInput  input;
+  NavBakeParams params;
+  char          cachePath[256];
+  bool          buildMesh; // path over a polygon navmesh instead of cells
+} LevelNavBake;
+
+// Bakes the grid when bake is given, keeping the painted navmap only as
+// designer annotations; otherwise loads the painted navmap as is.
+static void LoadLevelNavGrid(GameWorld *gw, const char *navmapPath,
+                             const LevelNavBake *bake) {
+  if (bake) {
+    NavBake_RunCached(&gw->navGrid, &bake->input, &bake->params, bake->cachePath);
+    NavGrid paint = {0};
+    if (navmapPath[0] &&
+        NavGrid_LoadFromImage(&paint, navmapPath, 2, (Vector3){-180, 0, -180})) {
+      NavBake_ApplyPaint(&gw->navGrid, &paint);
+      NavGrid_Destroy(&paint);
+    }
+    return;
+  }
   if (!NavGrid_LoadFromImage(&gw->navGrid, navmapPath, 2, (Vector3){-180, 0, -180}))
     NavGrid_Init(&gw->navGrid, 180, 180, 2.0f, (Vector3){-180, 0, -180});
+}
+
+static void SpawnLevelBase(world_t *world, GameWorld *gw, const char *navmapPath,
+                           const LevelNavBake *bake) {
+  MessageSystem_Init(&gw->messageSystem);
+  LoadTerrainHeightMap(gw);
+  PROF_ZONE("LoadLevelNavGrid", LoadLevelNavGrid(gw, navmapPath, bake));
+  CrowdGrid_Init(&gw->crowd, gw->navGrid.origin,
+                 gw->navGrid.width * gw->navGrid.cellSize, CROWD_CELL_SIZE);
   // Block cells outside the circular arena so A* never routes through the
   // rectangular grid corners (which extend to ~254 units vs 175-unit radius).
   {
@@ -630,6 +702,15 @@ static void SpawnLevelBase(world_t *world, GameWorld *gw, const char *navmapPath
       }
     }
   }
+  NavGrid_RefreshJumpFlags(&gw->navGrid);
+  PROF_ZONE("NavHierarchy_Build", NavHierarchy_Build(&gw->navHierarchy, &gw->navGrid));
+  PROF_ZONE("NavClearance_Build", NavClearance_Build(&gw->navClearance, &gw->navGrid));
+  NavVisibility_Init(&gw->playerVis, &gw->navGrid);
+  NavOccupancy_Init(&gw->navClaims, &gw->navGrid);
+  TacticalMap_Init(&gw->tactical, &gw->navGrid, gw->arenaRadius);
+  if (bake && bake->buildMesh)
+    PROF_ZONE("NavMesh_Build", NavMesh_Build(&gw->navMesh, &gw->navGrid));
+  FlowField_Init(&gw->playerFlow, &gw->navGrid);
   gw->player = SpawnPlayer(world, gw, (Vector3){0, 1.8f, 0});
   SpawnBulletPool(world, gw);
   SpawnParticlePool(world, gw);
@@ -637,20 +718,26 @@ static void SpawnLevelBase(world_t *world, GameWorld *gw, const char *navmapPath
   SpawnHealthOrbPool(world, gw);
 }
 
-// Derive a level-specific navmap path: "assets/levels/foo.json" -> "assets/levels/foo.navmap.png"
-static void NavmapPathFromLevel(const char *levelPath, char *out, int maxLen) {
+// Swap a level path's extension: "assets/levels/foo.json" -> "assets/levels/foo<ext>"
+static void LevelSidecarPath(const char *levelPath, const char *ext, char *out,
+                             int maxLen) {
   strncpy(out, levelPath, maxLen - 1);
   out[maxLen - 1] = '\0';
   char *dot = strrchr(out, '.');
-  if (dot) strcpy(dot, ".navmap.png");
-  else strncat(out, ".navmap.png", maxLen - (int)strlen(out) - 1);
+  if (dot) *dot = '\0';
+  strncat(out, ext, maxLen - (int)strlen(out) - 1);
+}
+
+// Derive a level-specific navmap path: "assets/levels/foo.json" -> "assets/levels/foo.navmap.png"
+static void NavmapPathFromLevel(const char *levelPath, char *out, int maxLen) {
+  LevelSidecarPath(levelPath, ".navmap.png", out, maxLen);
 }
 
 void SpawnLevelFromFile(world_t *world, GameWorld *gw, const char *path) {
   char *text = LoadFileText(path);
   if (!text) {
     printf("SpawnLevelFromFile: could not read %s\n", path);
-    SpawnLevelBase(world, gw, "");
+    SpawnLevelBase(world, gw, "", NULL);
     return;
   }
 
@@ -660,7 +747,7 @@ void SpawnLevelFromFile(world_t *world, GameWorld *gw, const char *path) {
   JsonReadString(text, "terrain", terrainPath, sizeof(terrainPath));
   if (strcmp(terrainPath, gw->terrainModelPath) != 0) {
     UnloadModel(gw->terrainModel);
-    gw->terrainModel = LoadModel(terrainPath);
+    gw->terrainModel = Assets_LoadModel(terrainPath);
     strncpy(gw->terrainModelPath, terrainPath, sizeof(gw->terrainModelPath) - 1);
   }
 
@@ -710,14 +797,6 @@ void SpawnLevelFromFile(world_t *world, GameWorld *gw, const char *path) {
     }
   }
 
-  SpawnLevelBase(world, gw, navmapPath);
-
-  // Override player spawn position if level defines one
-  if (hasSpawn) {
-    Position *ppos = ECS_GET(world, gw->player, Position, COMP_POSITION);
-    if (ppos) ppos->value = spawnPos;
-  }
-
   static LevelBox      boxes[MAX_LEVEL_BOXES];
   static LevelSpawner  spawners[MAX_LEVEL_SPAWNERS];
   static LevelProp     props[MAX_LEVEL_PROPS];
@@ -730,8 +809,54 @@ void SpawnLevelFromFile(world_t *world, GameWorld *gw, const char *path) {
   int nInfoBoxes = LoadInfoBoxesFromJSON(text, infoboxes, MAX_LEVEL_INFOBOXES);
   int nWallSegs  = LoadWallSegsFromJSON(text,  wallsegs,  MAX_LEVEL_WALLSEGS);
   int nTargets   = LoadTargetsFromJSON(text,   targets,   MAX_LEVEL_TARGETS);
+
+  // Nav grid — baked from the boxes and walls when "navbake": 1, at
+  // "navcell" metres per cell; cached next to the level as foo.navbake.
+  // Levels without the flag keep their painted navmap, walls included.
+  // "navmesh": 1 paths over merged polygons instead of single cells
+  static NavBakeBox   bakeBoxes[MAX_LEVEL_BOXES];
+  static NavBakeWall  bakeWalls[MAX_LEVEL_WALLSEGS];
+  static LevelNavBake bake;
+  bool doBake = false;
+  {
+    float nb = 0;
+    JsonReadFloat(text, "navbake", &nb);
+    doBake = (nb != 0.0f);
+    float nm = 0;
+    JsonReadFloat(text, "navmesh", &nm);
+    bake.buildMesh = (nm != 0.0f);
+
+    bake.params = NavBake_DefaultParams();
+    JsonReadFloat(text, "navcell",   &bake.params.cellSize);
+    JsonReadFloat(text, "navradius", &bake.params.agentRadius);
+    JsonReadFloat(text, "navslope",  &bake.params.maxSlope);
+    if (bake.params.cellSize < 0.25f) bake.params.cellSize = 0.25f;
+
+    for (int i = 0; i < nBoxes; i++)
+      bakeBoxes[i] = (NavBakeBox){boxes[i].pos, Vector3Scale(boxes[i].scale, 0.5f)};
+    // Segments that don't block the player don't block walkers either
+    int nBakeWalls = 0;
+    for (int i = 0; i < nWallSegs; i++) {
+      LevelWallSeg *ws = &wallsegs[i];
+      if (!ws->blockPlayer) continue;
+      bakeWalls[nBakeWalls++] =
+          (NavBakeWall){ws->ax, ws->az, ws->bx, ws->bz, ws->yBottom,
+                        ws->yTop, ws->radius, ws->blockProjectiles};
+    }
+    bake.input = (NavBakeInput){bakeBoxes, nBoxes, bakeWalls, nBakeWalls,
+                                &gw->terrainHeightMap};
+    LevelSidecarPath(path, ".navbake", bake.cachePath, sizeof(bake.cachePath));
+  }
   UnloadFileText(text);
 
+  SpawnLevelBase(world, gw, navmapPath, doBake ? &bake : NULL);
+
+  // Override player spawn position if level defines one
+  if (hasSpawn) {
+    Position *ppos = ECS_GET(world, gw->player, Position, COMP_POSITION);
+    if (ppos) ppos->value = spawnPos;
+  }
+
   ClearPropModelCache();
   for (int i = 0; i < nBoxes; i++)
     SpawnBoxModel(world, gw, boxes[i].pos, boxes[i].scale);
@@ -768,10 +893,10 @@ void SpawnLevelFromFile(world_t *world, GameWorld *gw, const char *path) {
 
 // --- LEVEL 1 SPAWNER (hardcoded enemies) ---
 void SpawnLevel01(world_t *world, GameWorld *gw) {
-  SpawnLevelBase(world, gw, "");
+  SpawnLevelBase(world, gw, "", NULL);
 
   SpawnEnemyRanger(world, gw,
-      (Vector3){2, HeightMap_GetHeightCatmullRom(&gw->terrainHeightMap, 2, 50), 50});
+      (Vector3){2, TerrainHeight(gw, 2, 50), 50});
   SpawnEnemyGrunt(world, gw, (Vector3){2,  0, 23});
   SpawnEnemyGrunt(world, gw, (Vector3){35, 0, 16});
   SpawnEnemyGrunt(world, gw, (Vector3){25, 0, 10});
@@ -797,6 +922,6 @@ void SpawnLevel01(world_t *world, GameWorld *gw) {
   SpawnBoxModel(world, gw, (Vector3){105.39,  27,    -95.661}, (Vector3){11,   4,    11});
 }
 
-void SpawnLevel02(world_t *world, GameWorld *gw) { SpawnLevelBase(world, gw, ""); }
-void SpawnLevel03(world_t *world, GameWorld *gw) { SpawnLevelBase(world, gw, ""); }
-void SpawnLevel04(world_t *world, GameWorld *gw) { SpawnLevelBase(world, gw, ""); }
+void SpawnLevel02(world_t *world, GameWorld *gw) { SpawnLevelBase(world, gw, "", NULL); }
+void SpawnLevel03(world_t *world, GameWorld *gw) { SpawnLevelBase(world, gw, "", NULL); }
+void SpawnLevel04(world_t *world, GameWorld *gw) { SpawnLevelBase(world, gw, "", NULL); }
@@ -8,6 +8,12 @@
 
 GameWorld GameWorldCreate(Engine *engine, world_t *world);
 void RegisterAllArchetypes(Engine *engine, GameWorld *gw, world_t *world);
+// Rebuilds gw->terrainHeightMap and gw->terrainTiles from gw->terrainModel,
+// with indices read from the glTF at full width, reusing the
+// "<terrain>.hmap" cache next to the model when it is still valid. Headless
+// builds use that cache whatever mesh it came from, else the glTF's own
+// triangles.
+void LoadTerrainHeightMap(GameWorld *gw);
 void SpawnLevelFromFile(world_t *world, GameWorld *gw, const char *path);
 void SpawnLevel01(world_t *world, GameWorld *gw);
 void SpawnLevel02(world_t *world, GameWorld *gw);
@@ -0,0 +1,194 @@
+#define _POSIX_C_SOURCE 200809L
+#include "../engine/util/profiler.h"
+#include "../game/component_registry_setup.h"
+#include "../game/game.h"
+#include "../game/input.h"
+#include "../game/world_spawn.h"
+#include "input_script.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Runs a level's simulation with no window, audio or GPU: one fixed tick
+// per frame, input from a script, and a timing report at the end. Built as
+// the GameHeadless target (GAME_HEADLESS), for load and soak tests and
+// benchmarks on machines without a display.
+
+#define HEADLESS_DEFAULT_TICKS 3600 // one minute at the default tick rate
+
+// Walks a slow circle with the primary weapon held, so waves find and
+// engage the player without anyone scripting it.
+static const char *s_defaultScript = "0 -1 W LMB look 3 0\n";
+
+typedef struct {
+  const char *levelPath;
+  const char *scriptPath;
+  const char *tracePath;
+  int         ticks;
+  int         tickRate;
+  int         seed; // 0 = leave the generator unseeded
+  bool        quiet;
+} HeadlessOptions;
+
+static void PrintUsage(const char *exe) {
+  fprintf(stderr,
+          "usage: %s --level <level.json> [options]\n"
+          "  --ticks <n>      simulation ticks to run (default %d)\n"
+          "  --rate <hz>      ticks per simulated second (default %d)\n"
+          "  --script <file>  scripted input, see src/headless/input_script.h\n"
+          "  --seed <n>       seed the random generator for repeatable runs\n"
+          "  --trace <file>   write a chrome://tracing profile at the end\n"
+          "  --quiet          only print the final report\n",
+          exe, HEADLESS_DEFAULT_TICKS, SIM_DEFAULT_TICK_RATE);
+}
+
+static bool ParseOptions(int argc, char **argv, HeadlessOptions *o) {
+  *o = (HeadlessOptions){.ticks    = HEADLESS_DEFAULT_TICKS,
+                         .tickRate = SIM_DEFAULT_TICK_RATE};
+  for (int i = 1; i < argc; i++) {
+    const char *arg   = argv[i];
+    const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+    if (strcmp(arg, "--quiet") == 0) {
+      o->quiet = true;
+      continue;
+    }
+    if (!value) return false;
+    if (strcmp(arg, "--level") == 0)       o->levelPath  = value;
+    else if (strcmp(arg, "--script") == 0) o->scriptPath = value;
+    else if (strcmp(arg, "--trace") == 0)  o->tracePath  = value;
+    else if (strcmp(arg, "--ticks") == 0)  o->ticks      = atoi(value);
+    else if (strcmp(arg, "--rate") == 0)   o->tickRate   = atoi(value);
+    else if (strcmp(arg, "--seed") == 0)   o->seed       = atoi(value);
+    else return false;
+    i++;
+  }
+  return o->levelPath && o->ticks > 0 && o->tickRate > 0;
+}
+
+static double NowSeconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static bool LoadScript(const HeadlessOptions *o, InputScript *script) {
+  if (!o->scriptPath) return InputScript_Parse(script, s_defaultScript);
+
+  char *text = LoadFileText(o->scriptPath);
+  if (!text) {
+    fprintf(stderr, "headless: could not read %s\n", o->scriptPath);
+    return false;
+  }
+  bool ok = InputScript_Parse(script, text);
+  UnloadFileText(text);
+  return ok;
+}
+
+// Per-zone profiler totals over the whole run, indexed like
+// Prof_GetStats (zones are only ever appended).
+typedef struct {
+  double ms[PROF_MAX_ZONES];
+  long   calls[PROF_MAX_ZONES];
+} ZoneTotals;
+
+static void AccumulateZones(ZoneTotals *t) {
+  const ProfZoneStats *zones;
+  int count = Prof_GetStats(&zones);
+  for (int i = 0; i < count; i++) {
+    t->ms[i]    += zones[i].ms;
+    t->calls[i] += zones[i].calls;
+  }
+}
+
+static void PrintReport(const HeadlessOptions *o, const GameWorld *game,
+                        const ZoneTotals *totals, double wallSec,
+                        int deaths) {
+  double ms = wallSec * 1000.0;
+  printf("level        %s\n", o->levelPath);
+  printf("ticks        %d at %d Hz (%.1f s simulated)\n", o->ticks,
+         o->tickRate, (double)o->ticks / o->tickRate);
+  printf("wall         %.1f ms, %.3f ms/tick, %.0f ticks/s\n", ms,
+         ms / o->ticks, o->ticks / wallSec);
+  printf("wave         %d, %d enemies alive, %d player deaths\n",
+         game->waveState.currentWave, game->waveState.enemiesAlive, deaths);
+
+  const ProfZoneStats *zones;
+  int count = Prof_GetStats(&zones);
+  if (count == 0) return; // built without GAME_PROFILER
+  printf("\n%-28s %10s %10s %9s\n", "zone", "total ms", "ms/tick", "calls");
+  for (int i = 0; i < count; i++)
+    printf("%*s%-*s %10.2f %10.4f %9ld\n", zones[i].depth * 2, "",
+           28 - zones[i].depth * 2, zones[i].name, totals->ms[i],
+           totals->ms[i] / o->ticks, totals->calls[i]);
+}
+
+int main(int argc, char **argv) {
+  HeadlessOptions opts;
+  if (!ParseOptions(argc, argv, &opts)) {
+    PrintUsage(argv[0]);
+    return 2;
+  }
+  if (!FileExists(opts.levelPath)) {
+    fprintf(stderr, "headless: no level at %s\n", opts.levelPath);
+    return 1;
+  }
+  static InputScript script; // large; keep it off the stack
+  if (!LoadScript(&opts, &script)) return 1;
+
+  SetTraceLogLevel(opts.quiet ? LOG_ERROR : LOG_WARNING);
+  if (opts.seed) SetRandomSeed((unsigned int)opts.seed);
+  Prof_SetThreadName("Main");
+
+  Engine engine = EngineInit();
+  SetupComponentRegistry(&engine.componentRegistry, &engine);
+  GameWorld game = GameWorldCreate(&engine, engine.world);
+  game.simTickRate = opts.tickRate;
+  snprintf(game.targetLevelPath, sizeof(game.targetLevelPath), "%s",
+           opts.levelPath);
+  PathService_Start(0);
+
+  LoadLevel(&engine, &game);
+  Prof_FrameEnd(); // keep the load out of the first tick's numbers
+
+  // One tick per frame: the accumulator steps exactly once for dt = tickDt
+  float             tickDt = 1.0f / (float)opts.tickRate;
+  static ZoneTotals totals;
+  int               deaths = 0;
+  double            start  = NowSeconds();
+
+  for (int frame = 0; frame < opts.ticks; frame++) {
+    InputFrame input;
+    InputScript_Frame(&script, frame, &input);
+    Input_Push(&input);
+
+    PROF_BEGIN("Frame");
+    UpdateLevelFrame(&engine, &game, tickDt);
+    PROF_END();
+    Prof_FrameEnd();
+    AccumulateZones(&totals);
+
+    Active *pa = ECS_GET(engine.world, game.player, Active, COMP_ACTIVE);
+    if (pa && !pa->value) {
+      // Keep soaking: restart the level rather than stop at game over
+      deaths++;
+      if (!opts.quiet)
+        printf("tick %d: player died (wave %d), reloading\n", frame,
+               game.waveState.currentWave);
+      LoadLevel(&engine, &game);
+      Prof_FrameEnd();
+    }
+  }
+
+  double wallSec = NowSeconds() - start;
+  PrintReport(&opts, &game, &totals, wallSec, deaths);
+
+  if (opts.tracePath && !Prof_WriteChromeTrace(opts.tracePath))
+    fprintf(stderr, "headless: could not write %s\n", opts.tracePath);
+
+  PathService_Stop();
+  SpatialIndex_Reset();
+  TransformHistory_Free(&game.transformHistory);
+  EngineShutdown(&engine);
+  return 0;
+}
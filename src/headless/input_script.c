@@ -0,0 +1,122 @@
+#include "input_script.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const struct {
+  const char *name;
+  int         key;
+} s_namedKeys[] = {
+    {"SPACE", KEY_SPACE},
+    {"SHIFT", KEY_LEFT_SHIFT},
+    {"CTRL", KEY_LEFT_CONTROL},
+};
+
+static const struct {
+  const char *name;
+  int         button;
+} s_buttons[] = {
+    {"LMB", MOUSE_BUTTON_LEFT},
+    {"RMB", MOUSE_BUTTON_RIGHT},
+    {"MMB", MOUSE_BUTTON_MIDDLE},
+};
+
+// Raylib key named by word, or -1.
+static int KeyFromWord(const char *word) {
+  if (word[0] && !word[1]) {
+    char c = (char)toupper((unsigned char)word[0]);
+    if (c >= 'A' && c <= 'Z') return KEY_A + (c - 'A');
+    if (c >= '0' && c <= '9') return KEY_ZERO + (c - '0');
+  }
+  for (size_t i = 0; i < sizeof(s_namedKeys) / sizeof(s_namedKeys[0]); i++)
+    if (strcmp(word, s_namedKeys[i].name) == 0) return s_namedKeys[i].key;
+  return -1;
+}
+
+static int ButtonFromWord(const char *word) {
+  for (size_t i = 0; i < sizeof(s_buttons) / sizeof(s_buttons[0]); i++)
+    if (strcmp(word, s_buttons[i].name) == 0) return s_buttons[i].button;
+  return -1;
+}
+
+static bool ParseLine(InputSpan *span, char *line) {
+  char *tok = strtok(line, " \t\r");
+  if (!tok) return false;
+  span->first = atoi(tok);
+  tok = strtok(NULL, " \t\r");
+  if (!tok) return false;
+  span->last = atoi(tok);
+  if (span->first < 0 || (span->last >= 0 && span->last < span->first))
+    return false;
+
+  while ((tok = strtok(NULL, " \t\r")) != NULL) {
+    int key, button;
+    if ((key = KeyFromWord(tok)) >= 0) {
+      span->input.keys[key] = true;
+    } else if ((button = ButtonFromWord(tok)) >= 0) {
+      span->input.buttons[button] = true;
+    } else if (strcmp(tok, "look") == 0) {
+      char *dx = strtok(NULL, " \t\r");
+      char *dy = dx ? strtok(NULL, " \t\r") : NULL;
+      if (!dy) return false;
+      span->input.mouseDelta = (Vector2){strtof(dx, NULL), strtof(dy, NULL)};
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool InputScript_Parse(InputScript *s, const char *text) {
+  s->count = 0;
+  bool ok  = true;
+  int  n   = 0;
+
+  while (*text) {
+    const char *end = strchr(text, '\n');
+    size_t      len = end ? (size_t)(end - text) : strlen(text);
+    char        line[256];
+    n++;
+    if (len >= sizeof(line)) len = sizeof(line) - 1;
+    memcpy(line, text, len);
+    line[len] = '\0';
+    text += end ? len + 1 : len;
+
+    char *hash = strchr(line, '#');
+    if (hash) *hash = '\0';
+    char *p = line;
+    while (isspace((unsigned char)*p)) p++;
+    if (!*p) continue;
+
+    if (s->count == INPUT_SCRIPT_MAX_SPANS) {
+      fprintf(stderr, "input script: more than %d spans, rest ignored\n",
+              INPUT_SCRIPT_MAX_SPANS);
+      return false;
+    }
+    InputSpan *span = &s->spans[s->count];
+    memset(span, 0, sizeof(*span));
+    if (ParseLine(span, p)) {
+      s->count++;
+    } else {
+      fprintf(stderr, "input script: bad line %d\n", n);
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+void InputScript_Frame(const InputScript *s, int frame, InputFrame *out) {
+  memset(out, 0, sizeof(*out));
+  for (int i = 0; i < s->count; i++) {
+    const InputSpan *span = &s->spans[i];
+    if (frame < span->first || (span->last >= 0 && frame > span->last))
+      continue;
+    for (int k = 0; k < INPUT_MAX_KEYS; k++)
+      out->keys[k] |= span->input.keys[k];
+    for (int b = 0; b < INPUT_MAX_BUTTONS; b++)
+      out->buttons[b] |= span->input.buttons[b];
+    out->mouseDelta.x += span->input.mouseDelta.x;
+    out->mouseDelta.y += span->input.mouseDelta.y;
+  }
+}
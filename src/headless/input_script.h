@@ -0,0 +1,33 @@
+#pragma once
+#include "../game/input.h"
+#include <stdbool.h>
+
+// Scripted player input for the headless runner. One line per held input
+// span, frames counted from the level start, both ends inclusive; a last
+// frame of -1 holds to the end of the run. Spans that overlap add up:
+//
+//   # first  last  inputs
+//   0        -1    W look 2 0     # walk forward, turning right
+//   120      239   LMB            # hold fire for two seconds
+//   300      300   2              # tap weapon 2
+//
+// Inputs are a letter or digit key, SPACE, SHIFT, CTRL, LMB, RMB, MMB, or
+// "look <dx> <dy>" for a per-frame mouse delta. '#' starts a comment.
+
+#define INPUT_SCRIPT_MAX_SPANS 256
+
+typedef struct {
+  int        first;
+  int        last; // -1 = open-ended
+  InputFrame input;
+} InputSpan;
+
+typedef struct {
+  InputSpan spans[INPUT_SCRIPT_MAX_SPANS];
+  int       count;
+} InputScript;
+
+// Parses text, reporting bad lines to stderr. False if any line was bad.
+bool InputScript_Parse(InputScript *s, const char *text);
+// Sum of every span covering frame.
+void InputScript_Frame(const InputScript *s, int frame, InputFrame *out);
@@ -0,0 +1,191 @@
+// Checks the aim_batch approximations against libm and the lane kernels
+// against a lane-by-lane scalar reference. Run through ctest.
+
+#include "game/systems/aim_batch.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define KERNEL_TOL 2e-5f // relative, kernel vs scalar reference
+
+static int s_failures = 0;
+
+static void Check(bool ok, const char *what, double err, double tol) {
+  printf("%-28s max err %.3g (tol %.3g) %s\n", what, err, tol,
+         ok ? "ok" : "FAIL");
+  if (!ok) s_failures++;
+}
+
+static uint32_t s_seed = 12345u;
+
+static float Rand(float lo, float hi) {
+  s_seed = s_seed * 1664525u + 1013904223u;
+  return lo + (hi - lo) * (float)(s_seed >> 8) / 16777216.0f;
+}
+
+static double WrapPiD(double a) {
+  const double twoPi = 6.28318530717958647692;
+  return a - twoPi * floor(a / twoPi + 0.5);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Approximations vs libm                                            */
+/* ------------------------------------------------------------------ */
+
+static void TestAtan2(void) {
+  double worst = 0.0;
+  for (int i = 0; i < 1000000; i++) {
+    float y = Rand(-100.0f, 100.0f), x = Rand(-100.0f, 100.0f);
+    if (i % 7 == 0) x = 0.0f;
+    if (i % 11 == 0) y = 0.0f;
+    if (i % 13 == 0) x *= 1e-4f; // steep ratios
+    double err = fabs(WrapPiD((double)AimBatch_Atan2(y, x) - atan2(y, x)));
+    if (err > worst) worst = err;
+  }
+  Check(worst <= AIM_ATAN2_MAX_ERR, "AimBatch_Atan2 vs atan2", worst,
+        AIM_ATAN2_MAX_ERR);
+}
+
+static void TestSinCos(void) {
+  double worst = 0.0;
+  for (int i = 0; i < 1000000; i++) {
+    float a = Rand(-4.0f * PI, 4.0f * PI), s, c;
+    AimBatch_SinCos(a, &s, &c);
+    double es = fabs(s - sin(a)), ec = fabs(c - cos(a));
+    if (es > worst) worst = es;
+    if (ec > worst) worst = ec;
+  }
+  Check(worst <= AIM_SINCOS_MAX_ERR, "AimBatch_SinCos vs sin/cos", worst,
+        AIM_SINCOS_MAX_ERR);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Kernels vs scalar reference                                       */
+/* ------------------------------------------------------------------ */
+
+static float WrapPi(float a) {
+  return a - 2.0f * PI * rintf(a * (1.0f / (2.0f * PI)));
+}
+
+// Same rule as the kernels; *edge is set when |delta| is too close to step
+// for the two paths' rounding to be sure of agreeing on the branch.
+static float StepToward(float cur, float target, float delta, float step,
+                        bool *edge) {
+  if (fabsf(fabsf(delta) - step) < 1e-4f) *edge = true;
+  if (fabsf(delta) < step) return target;
+  return cur + (delta > 0.0f ? 1.0f : -1.0f) * step;
+}
+
+static float RelErr(float got, float want) {
+  return fabsf(got - want) / fmaxf(1.0f, fabsf(want));
+}
+
+static void FillLanes(AimLanes *l, int n) {
+  AimLanes_Reserve(l, n);
+  for (int i = 0; i < n; i++) {
+    l->x[i]           = Rand(-100.0f, 100.0f);
+    l->y[i]           = Rand(0.0f, 5.0f);
+    l->z[i]           = Rand(-100.0f, 100.0f);
+    l->bodyYaw[i]     = Rand(-5.0f, 5.0f);
+    l->offX[i]        = Rand(-1.0f, 1.0f);
+    l->offY[i]        = Rand(0.0f, 2.0f);
+    l->offZ[i]        = Rand(0.0f, 2.0f);
+    l->weaponYaw[i]   = Rand(0.0f, 0.2f);
+    l->weaponPitch[i] = Rand(0.0f, 0.2f);
+    l->aimYaw[i]      = Rand(-3.0f, 3.0f);
+    l->aimPitch[i]    = Rand(-0.5f, 0.5f);
+    l->step[i]        = i % 3 == 0 ? 0.1f : (i % 3 == 1 ? 0.0f : 5.0f);
+  }
+}
+
+static void TestKernels(int n) {
+  AimLanes l = {0};
+  FillLanes(&l, n);
+  Vector3 target = {3.0f, 1.3f, -7.0f};
+
+  // Reference: the scalar tail loops of aim_batch.c, lane by lane
+  float *ref  = malloc(sizeof(float) * n * 11);
+  bool  *edge = calloc(n, sizeof(bool));
+  for (int i = 0; i < n; i++) {
+    float *r = ref + i * 11;
+
+    float want = AimBatch_Atan2(target.x - l.x[i], target.z - l.z[i]);
+    float body = StepToward(l.bodyYaw[i], want, WrapPi(want - l.bodyYaw[i]),
+                            l.step[i], &edge[i]);
+
+    float dx = target.x - l.x[i], dy = target.y - l.y[i], dz = target.z - l.z[i];
+    float pitch = AimBatch_Atan2(dy - l.offY[i], sqrtf(dx * dx + dz * dz));
+    float yaw   = WrapPi(AimBatch_Atan2(dx, dz) - body);
+    float aimY  = StepToward(l.aimYaw[i], yaw, WrapPi(yaw - l.aimYaw[i]),
+                             l.step[i], &edge[i]);
+    float aimP  = StepToward(l.aimPitch[i], pitch, pitch - l.aimPitch[i],
+                             l.step[i], &edge[i]);
+
+    float wYaw = body + aimY + l.weaponYaw[i];
+    float wPit = aimP + l.weaponPitch[i];
+    float sb, cb, sy, cy, sp, cp;
+    AimBatch_SinCos(body, &sb, &cb);
+    AimBatch_SinCos(wYaw, &sy, &cy);
+    AimBatch_SinCos(wPit, &sp, &cp);
+    float fx = cp * sy, fy = sp, fz = cp * cy;
+    float inv = 1.0f / sqrtf(fx * fx + fy * fy + fz * fz);
+    fx *= inv;
+    fy *= inv;
+    fz *= inv;
+
+    r[0] = body;
+    r[1] = aimY;
+    r[2] = aimP;
+    r[3] = fx;
+    r[4] = fy;
+    r[5] = fz;
+    r[6] = l.x[i] + l.offX[i] * cb + fx * l.offZ[i];
+    r[7] = l.y[i] + l.offY[i] + fy * l.offZ[i];
+    r[8] = l.z[i] + l.offX[i] * sb + fz * l.offZ[i];
+    r[9]  = wYaw;
+    r[10] = wPit;
+  }
+
+  AimBatch_BodyYaw(&l, target);
+  AimBatch_Swivel(&l, target);
+  AimBatch_MuzzleWorld(&l);
+
+  float worst   = 0.0f;
+  int   skipped = 0;
+  for (int i = 0; i < n; i++) {
+    if (edge[i]) {
+      skipped++;
+      continue;
+    }
+    const float *r = ref + i * 11;
+    float got[11] = {l.bodyYaw[i], l.aimYaw[i],   l.aimPitch[i], l.fwdX[i],
+                     l.fwdY[i],    l.fwdZ[i],     l.posX[i],     l.posY[i],
+                     l.posZ[i],    l.worldYaw[i], l.worldPitch[i]};
+    for (int k = 0; k < 11; k++) {
+      float err = RelErr(got[k], r[k]);
+      if (err > worst) worst = err;
+    }
+  }
+
+  char what[64];
+  snprintf(what, sizeof(what), "kernels, %d lanes", n);
+  Check(worst <= KERNEL_TOL && skipped < n, what, worst, KERNEL_TOL);
+
+  free(ref);
+  free(edge);
+  AimLanes_Free(&l);
+}
+
+int main(void) {
+  TestAtan2();
+  TestSinCos();
+
+  // Counts that leave a partial vector for both 4 and 8 lanes
+  const int counts[] = {1, 3, 8, 13, 29, 1003};
+  for (int i = 0; i < (int)(sizeof(counts) / sizeof(counts[0])); i++)
+    TestKernels(counts[i]);
+
+  return s_failures == 0 ? 0 : 1;
+}